@@ -1,5 +1,6 @@
 #include "adxl343.h"
 #include "board.h"
+#include "i2cq/i2cq.h"
 #include <stdint.h>
 
 /**************************************************************************/
@@ -19,7 +20,7 @@ bool adxl343_writeRegister(uint8_t data[], uint8_t size) {
                        .txSz = size,
                        .rxBuff = NULL,
                        .rxSz = 0};
-    I2C_STATUS_T status = Chip_I2C_MasterTransfer(I2C0, &xfer);
+    I2C_STATUS_T status = I2CQ_Transfer(&xfer);
     return status == I2C_STATUS_DONE;
 }
 
@@ -42,7 +43,7 @@ bool adxl343_readRegister(uint8_t reg, uint8_t data[], uint8_t size) {
                        .txSz = 1,
                        .rxBuff = data,
                        .rxSz = size};
-    I2C_STATUS_T status = Chip_I2C_MasterTransfer(I2C0, &xfer);
+    I2C_STATUS_T status = I2CQ_Transfer(&xfer);
     return status == I2C_STATUS_DONE;
 
 }
@@ -162,6 +163,116 @@ bool adxl343_getXYZ(int16_t *x, int16_t *y, int16_t *z) {
 
 }
 
+/**************************************************************************/
+/*!
+    @brief  Puts the FIFO in stream mode and raises the watermark interrupt
+            on the given pin as long as at least @p watermark samples are
+            stored. The pin is active high.
+    @param watermark Number of samples that raises the interrupt, from 1 to
+           ADXL343_FIFO_SIZE - 1
+    @param pin The pin to signal the watermark interrupt on
+    @return True if the operation was successful, otherwise false.
+*/
+/**************************************************************************/
+bool adxl343_enableFifo(uint8_t watermark, adxl3xx_int_pin pin) {
+    if ((watermark < 1) || (watermark >= ADXL343_FIFO_SIZE)) {
+        return false;
+    }
+
+    uint8_t message[2] = {ADXL3XX_REG_INT_ENABLE, 0}; // Disable interrupts while reconfiguring
+    if(!adxl343_writeRegister(message, 2))
+    {
+        return false;
+    }
+    message[0] = ADXL3XX_REG_INT_MAP; // A set bit maps the interrupt to INT2
+    message[1] = (pin == ADXL343_INT2) ? ADXL343_INT_WATERMARK : 0;
+    if(!adxl343_writeRegister(message, 2))
+    {
+        return false;
+    }
+    message[0] = ADXL3XX_REG_FIFO_CTL; // Stream mode, trigger bit unused
+    message[1] = (uint8_t)((ADXL343_FIFO_STREAM << 6) | watermark);
+    if(!adxl343_writeRegister(message, 2))
+    {
+        return false;
+    }
+    message[0] = ADXL3XX_REG_INT_ENABLE;
+    message[1] = ADXL343_INT_WATERMARK;
+    return adxl343_writeRegister(message, 2);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the number of samples stored in the FIFO
+    @return The number of samples, from 0 to ADXL343_FIFO_SIZE, or -1 on
+            error.
+*/
+/**************************************************************************/
+int adxl343_getFifoCount(void) {
+    uint8_t status;
+
+    if(adxl343_readRegister(ADXL3XX_REG_FIFO_STATUS, &status, 1)) {
+        return status & ADXL343_FIFO_ENTRIES_MASK;
+    }
+    else {
+        return -1;
+    }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Drains the FIFO, oldest sample first.
+
+    Each 6-byte read of the data registers pops one sample: the reads are
+    submitted to the I2C queue ahead of time, so they are chained under
+    interrupt and the CPU only wakes up once per completed read.
+
+    @param samples Receives the samples
+    @param size Capacity of @p samples
+    @return The number of samples read, or -1 on error.
+    @note No other transfers may be submitted to the I2C queue meanwhile.
+*/
+/**************************************************************************/
+int adxl343_readFifo(adxl343_sample_t samples[], int size) {
+    uint8_t reg = ADXL3XX_REG_DATAX0;
+    I2C_XFER_T xfers[I2CQ_QUEUE_SIZE];
+    int submitted = 0;
+    int done = 0;
+    bool ok = true;
+
+    int count = adxl343_getFifoCount();
+    if (count < 0) {
+        return -1;
+    }
+    if (count > size) {
+        count = size;
+    }
+
+    while (done < count) {
+        while (ok && (submitted < count) && (submitted - done < I2CQ_QUEUE_SIZE)) {
+            I2C_XFER_T *xfer = &xfers[submitted % I2CQ_QUEUE_SIZE];
+            *xfer = (I2C_XFER_T){.slaveAddr = ADXL343_ADDRESS,
+                                 .txBuff = &reg,
+                                 .txSz = 1,
+                                 .rxBuff = (uint8_t *)&samples[submitted],
+                                 .rxSz = sizeof(adxl343_sample_t)};
+            ok = I2CQ_Submit(xfer);
+            if (ok) {
+                submitted++;
+            }
+        }
+        if (done == submitted) {
+            break; // Nothing left in flight after an error
+        }
+        // The transfers are on the stack: wait for all of them, also after an error
+        if (I2CQ_Wait(&xfers[done % I2CQ_QUEUE_SIZE]) != I2C_STATUS_DONE) {
+            ok = false;
+        }
+        done++;
+    }
+    return ok ? count : -1;
+}
+
 /**************************************************************************/
 /*!
     @brief  Setups the HW (reads coefficients values, etc.)
@@ -277,18 +388,20 @@ bool adxl343_begin() {
 //   return (adxl34x_range_t)range_bits.read();
 // }
 
-// /**************************************************************************/
-// /*!
-//     @brief  Sets the data rate for the ADXL343 (controls power consumption)
+/**************************************************************************/
+/*!
+    @brief  Sets the data rate for the ADXL343 (controls power consumption)
 
-//     @param dataRate The data rate to set, based on adxl3xx_dataRate_t
-// */
-// /**************************************************************************/
-// void adxl343_setDataRate(adxl3xx_dataRate_t dataRate) {
-//   /* Note: The LOW_POWER bits are currently ignored and we always keep
-//      the device in 'normal' mode */
-//   writeRegister(ADXL3XX_REG_BW_RATE, dataRate);
-// }
+    @param dataRate The data rate to set, based on adxl3xx_dataRate_t
+
+    @return True if the operation was successful, otherwise false.
+*/
+/**************************************************************************/
+bool adxl343_setDataRate(adxl3xx_dataRate_t dataRate) {
+    /* Note: The LOW_POWER bit is left cleared: the device stays in 'normal' mode */
+    uint8_t message[2] = {ADXL3XX_REG_BW_RATE, (uint8_t)dataRate};
+    return adxl343_writeRegister(message, 2);
+}
 
 // /**************************************************************************/
 // /*!
@@ -52,6 +52,14 @@
 #define ADXL343_MG2G_MULTIPLIER (0.004) /**< 4mg per lsb */
 /*=========================================================================*/
 
+/*=========================================================================
+    FIFO
+    -----------------------------------------------------------------------*/
+#define ADXL343_FIFO_SIZE (32)            /**< Number of FIFO entries */
+#define ADXL343_FIFO_ENTRIES_MASK (0x3F)  /**< Entries bits in FIFO_STATUS */
+#define ADXL343_INT_WATERMARK (0x02)      /**< Watermark bit in INT_ENABLE, INT_MAP and INT_SOURCE */
+/*=========================================================================*/
+
 /** Used with register 0x2C (ADXL3XX_REG_BW_RATE) to set bandwidth */
 typedef enum {
   ADXL343_DATARATE_3200_HZ = 0b1111, /**< 3200Hz Bandwidth */
@@ -102,6 +110,21 @@ typedef enum {
   ADXL34X_RANGE_2_G = 0b00   /**< +/- 2g (default value) */
 } adxl34x_range_t;
 
+/** Used with register 0x38 (ADXL3XX_REG_FIFO_CTL) to set the FIFO mode */
+typedef enum {
+  ADXL343_FIFO_BYPASS = 0b00,  /**< No FIFO (default value) */
+  ADXL343_FIFO_FIFO = 0b01,    /**< Collects samples until full, then stops */
+  ADXL343_FIFO_STREAM = 0b10,  /**< Holds the latest samples, the oldest is dropped when full */
+  ADXL343_FIFO_TRIGGER = 0b11  /**< Holds the samples around a trigger event */
+} adxl343_fifoMode_t;
+
+/** One sample of the three axes, in LSB of the configured range. Matches the DATAX0..DATAZ1 register layout. */
+typedef struct {
+  int16_t x; /**< X-axis */
+  int16_t y; /**< Y-axis */
+  int16_t z; /**< Z-axis */
+} adxl343_sample_t;
+
 /** Possible interrupts sources on the ADXL343. */
 union int_config {
   uint8_t value; /**< Composite 8-bit value of the bitfield.*/
@@ -135,7 +158,7 @@ typedef enum {
 bool adxl343_begin();
 void adxl343_setRange(adxl34x_range_t range);
 adxl34x_range_t adxl343_getRange(void);
-void adxl343_setDataRate(adxl3xx_dataRate_t dataRate);
+bool adxl343_setDataRate(adxl3xx_dataRate_t dataRate);
 adxl3xx_dataRate_t adxl343_getDataRate(void);
 
 uint8_t adxl343_getDeviceID(void);
@@ -155,5 +178,9 @@ int16_t adxl343_getY(void);
 int16_t adxl343_getZ(void);
 bool adxl343_getXYZ(int16_t *x, int16_t *y, int16_t *z);
 
+bool adxl343_enableFifo(uint8_t watermark, adxl3xx_int_pin pin);
+int adxl343_getFifoCount(void);
+int adxl343_readFifo(adxl343_sample_t samples[], int size);
+
 
 #endif
\ No newline at end of file
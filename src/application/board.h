@@ -13,7 +13,9 @@
 #define __BOARD_H_
 
 #define LED_COUNT 1
+#ifndef CORE_M0PLUS /* The host simulation defines it on the command line. */
 #define CORE_M0PLUS
+#endif
 
 #define I2CBBM_DEFAULT_I2C_ADDRESS I2C_SLAVE_ADDRESS
 #define I2CBBM_SYSTEM_CLOCK_DIVIDER 16 /* SysClock @ 500 kHz */
@@ -22,6 +24,30 @@
 #define I2C_SLAVE_TX_SIZE 180
 #define I2C_MASTER_TX_SIZE 2
 
+/* Diversity settings of the event and storage mods: the motion events in the first EEPROM rows, the motion features
+ * of each window after them, one record per window with a bit size per feature. The host benchmarks compile some
+ * application sources with their own settings. */
+#ifndef STORAGE_TYPE
+#include "motion_record.h"
+#define EVENT_EEPROM_FIRST_ROW 2
+#define EVENT_EEPROM_LAST_ROW 20
+#define STORAGE_TYPE motion_record_t
+#define STORAGE_FIELD_COUNT MOTION_RECORD_FIELD_COUNT
+#define STORAGE_FIELD_TYPE int16_t
+#define STORAGE_FIELD_BITSIZES MOTION_RECORD_BITSIZES
+#define STORAGE_BITSIZE MOTION_RECORD_BITSIZE
+#define STORAGE_SIGNED 1
+#define STORAGE_EEPROM_FIRST_ROW 21
+#define STORAGE_EEPROM_LAST_ROW (EEPROM_NR_OF_RW_ROWS - 1)
+#endif
+
+/** PIO0 pin wired to the ADXL343 INT1 output. The sensor drives it push-pull, active high. */
+#define ACCEL_INT_PIN 2
+#define ACCEL_INT_IOCON IOCON_PIO0_2
+
+/** Diversity setting of the runloop mod: Deep Sleep mode powers down the DAC, main.c vetoes it while the DAC is on. */
+#define RUNLOOP_DEEPSLEEP_CB App_DeepSleepCb
+
 /**
  * The LED properties for the supported LEDs of the Demo PCB.
  * @see LED_PROPERTIES_T
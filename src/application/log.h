@@ -0,0 +1,52 @@
+#ifndef __LOG_H_
+#define __LOG_H_
+
+#include "trace.h"
+
+/**
+ * Deferred-format logging: LOG("Failed ADXL343 INIT") or LOG("Bad sample %d of %d", n, count).
+ *
+ * The format string is interned in the @c logstr section, which the linker script keeps out of the image: it only
+ * exists in main.elf. A #TRACE_EVENT_LOG record carries the offset of the string in that section and the
+ * arguments, and tools/trace_decode.py --elf main.elf formats the message on the host.
+ *
+ * - At most #LOG_ARGS_MAX arguments, each sent as 32 bits: integers and characters only.
+ * - Supported conversions: @c %d @c %i @c %u @c %x @c %X @c %o @c %c and @c %%, with flags and width.
+ *   There is no @c %s or @c %f: the string or value would have to be copied into the record.
+ */
+#define LOG(...) LOG_SELECT_(__VA_ARGS__, LOG_4_, LOG_3_, LOG_2_, LOG_1_, LOG_0_, unused)(__VA_ARGS__)
+
+/** Maximum number of arguments of #LOG */
+#define LOG_ARGS_MAX 4
+
+/** Offsets in the @c logstr section are relative to this symbol; the linker script sets it to 0 on target. */
+extern const char __start_logstr[];
+
+#define LOG_SELECT_(fmt, a, b, c, d, macro, ...) macro
+#define LOG_STRING_(fmt) static const char sLogString_[] __attribute__((section("logstr"), used)) = fmt
+#define LOG_0_(fmt) do { \
+        LOG_STRING_(fmt); \
+        Trace_Log((uintptr_t)sLogString_ - (uintptr_t)__start_logstr, NULL, 0); \
+    } while (0)
+#define LOG_1_(fmt, a) do { \
+        LOG_STRING_(fmt); \
+        const uint32_t args_[] = {(uint32_t)(a)}; \
+        Trace_Log((uintptr_t)sLogString_ - (uintptr_t)__start_logstr, args_, 1); \
+    } while (0)
+#define LOG_2_(fmt, a, b) do { \
+        LOG_STRING_(fmt); \
+        const uint32_t args_[] = {(uint32_t)(a), (uint32_t)(b)}; \
+        Trace_Log((uintptr_t)sLogString_ - (uintptr_t)__start_logstr, args_, 2); \
+    } while (0)
+#define LOG_3_(fmt, a, b, c) do { \
+        LOG_STRING_(fmt); \
+        const uint32_t args_[] = {(uint32_t)(a), (uint32_t)(b), (uint32_t)(c)}; \
+        Trace_Log((uintptr_t)sLogString_ - (uintptr_t)__start_logstr, args_, 3); \
+    } while (0)
+#define LOG_4_(fmt, a, b, c, d) do { \
+        LOG_STRING_(fmt); \
+        const uint32_t args_[] = {(uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d)}; \
+        Trace_Log((uintptr_t)sLogString_ - (uintptr_t)__start_logstr, args_, 4); \
+    } while (0)
+
+#endif
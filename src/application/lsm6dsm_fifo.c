@@ -0,0 +1,225 @@
+#include "lsm6dsm_fifo.h"
+#include "board.h"
+#include "i2cq/i2cq.h"
+#include <string.h>
+
+/** Longest register write done by the ST driver, excluding the register address */
+#define LSM6DSM_WRITE_MAX (8)
+
+/** The four FIFO_STATUS registers, read at once */
+typedef struct {
+    lsm6dsm_fifo_status1_t status1;
+    lsm6dsm_fifo_status2_t status2;
+    lsm6dsm_fifo_status3_t status3;
+    lsm6dsm_fifo_status4_t status4;
+} fifoStatus_t;
+
+static int32_t platformWrite(void *handle, uint8_t reg, const uint8_t *data, uint16_t len);
+static int32_t platformRead(void *handle, uint8_t reg, uint8_t *data, uint16_t len);
+
+static uint8_t sAddress = LSM6DSM_ADDRESS;
+
+stmdev_ctx_t lsm6dsm_ctx = {.write_reg = platformWrite, .read_reg = platformRead, .mdelay = NULL, .handle = &sAddress};
+
+static uint8_t sBurst[LSM6DSM_FIFO_BURST_WORDS * 2];
+static int16_t sAxes[2][3]; /**< Axes of the sample being assembled, per tag: a sample can span two drains */
+static lsm6dsm_sample_t sRing[LSM6DSM_RING_SIZE];
+static int sRingHead; /**< Index of the oldest sample */
+static int sRingCount;
+static int sDropCount;
+
+/**************************************************************************/
+/*!
+    @brief  stmdev_ctx_t write callback: register address and data go out
+            in one transfer
+    @param handle Pointer to the 7-bit slave address
+    @param reg Register to write
+    @param data Bytes to write, auto-incrementing from @p reg
+    @param len Number of bytes, at most LSM6DSM_WRITE_MAX
+    @return 0 on success
+*/
+/**************************************************************************/
+static int32_t platformWrite(void *handle, uint8_t reg, const uint8_t *data, uint16_t len) {
+    uint8_t message[1 + LSM6DSM_WRITE_MAX];
+
+    if (len > LSM6DSM_WRITE_MAX) {
+        return -1;
+    }
+    message[0] = reg;
+    memcpy(&message[1], data, len);
+    I2C_XFER_T xfer = {.slaveAddr = *(uint8_t *)handle,
+                       .txBuff = message,
+                       .txSz = (int)(1 + len),
+                       .rxBuff = NULL,
+                       .rxSz = 0};
+    return (I2CQ_Transfer(&xfer) == I2C_STATUS_DONE) ? 0 : -1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  stmdev_ctx_t read callback: writes the register address, then
+            reads with a repeated start
+    @param handle Pointer to the 7-bit slave address
+    @param reg First register to read
+    @param data Receives the bytes
+    @param len Number of bytes
+    @return 0 on success
+*/
+/**************************************************************************/
+static int32_t platformRead(void *handle, uint8_t reg, uint8_t *data, uint16_t len) {
+    I2C_XFER_T xfer = {.slaveAddr = *(uint8_t *)handle,
+                       .txBuff = &reg,
+                       .txSz = 1,
+                       .rxBuff = data,
+                       .rxSz = len};
+    return (I2CQ_Transfer(&xfer) == I2C_STATUS_DONE) ? 0 : -1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Stores one FIFO word. Completes and queues a sample after its
+            Z axis; the oldest sample is dropped when the ring is full.
+    @param pattern Position of the word in the FIFO pattern
+    @param word The word read from the FIFO
+    @return 1 when a sample was queued, otherwise 0
+*/
+/**************************************************************************/
+static int storeWord(int pattern, int16_t word) {
+    uint8_t tag = (pattern < 3) ? LSM6DSM_TAG_GYRO : LSM6DSM_TAG_ACCEL;
+    int axis = pattern % 3;
+
+    sAxes[tag][axis] = word;
+    if (axis < 2) {
+        return 0;
+    }
+    if (sRingCount == LSM6DSM_RING_SIZE) {
+        sRingHead = (sRingHead + 1) % LSM6DSM_RING_SIZE;
+        sRingCount--;
+        sDropCount++;
+    }
+    sRing[(sRingHead + sRingCount) % LSM6DSM_RING_SIZE] =
+        (lsm6dsm_sample_t){.tag = tag, .x = sAxes[tag][0], .y = sAxes[tag][1], .z = sAxes[tag][2]};
+    sRingCount++;
+    return 1;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Resets the sensor and lets it batch both the gyroscope and the
+            accelerometer, without decimation, in a FIFO in stream mode.
+    @param odr Output data rate of both sensors and of the FIFO
+    @param watermark FIFO level in 16-bit words that sets the watermark flag:
+           a gyro + accel pair takes LSM6DSM_FIFO_PATTERN_WORDS words
+    @return True if the sensor was found and configured, otherwise false.
+*/
+/**************************************************************************/
+bool lsm6dsm_beginFifo(lsm6dsm_odr_fifo_t odr, uint16_t watermark) {
+    uint8_t value = 0;
+    int32_t ret;
+
+    if ((lsm6dsm_device_id_get(&lsm6dsm_ctx, &value) != 0) || (value != LSM6DSM_ID)) {
+        return false;
+    }
+    ret = lsm6dsm_reset_set(&lsm6dsm_ctx, PROPERTY_ENABLE);
+    for (int tries = 0; (ret == 0) && (tries < 10); tries++) {
+        // The reset takes 50 us, less than one register read at 100 kHz
+        ret = lsm6dsm_reset_get(&lsm6dsm_ctx, &value);
+        if (value == 0) {
+            break;
+        }
+    }
+    if ((ret != 0) || (value != 0)) {
+        return false;
+    }
+
+    // The FIFO and both sensors share the ODR enumeration values
+    ret = lsm6dsm_block_data_update_set(&lsm6dsm_ctx, PROPERTY_ENABLE);
+    ret |= lsm6dsm_fifo_mode_set(&lsm6dsm_ctx, LSM6DSM_BYPASS_MODE);
+    ret |= lsm6dsm_fifo_watermark_set(&lsm6dsm_ctx, watermark);
+    ret |= lsm6dsm_fifo_xl_batch_set(&lsm6dsm_ctx, LSM6DSM_FIFO_XL_NO_DEC);
+    ret |= lsm6dsm_fifo_gy_batch_set(&lsm6dsm_ctx, LSM6DSM_FIFO_GY_NO_DEC);
+    ret |= lsm6dsm_fifo_data_rate_set(&lsm6dsm_ctx, odr);
+    ret |= lsm6dsm_fifo_mode_set(&lsm6dsm_ctx, LSM6DSM_STREAM_MODE);
+    ret |= lsm6dsm_xl_data_rate_set(&lsm6dsm_ctx, (lsm6dsm_odr_xl_t)odr);
+    ret |= lsm6dsm_gy_data_rate_set(&lsm6dsm_ctx, (lsm6dsm_odr_g_t)odr);
+
+    memset(sAxes, 0, sizeof(sAxes));
+    sRingHead = 0;
+    sRingCount = 0;
+    sDropCount = 0;
+    return ret == 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Moves all samples from the sensor FIFO to the ring buffer.
+
+    One transfer reads the four FIFO_STATUS registers, then each further
+    transfer reads up to LSM6DSM_FIFO_BURST_WORDS words: the address rolls
+    back from FIFO_DATA_OUT_H to FIFO_DATA_OUT_L on auto-increment. The
+    FIFO pattern tells the sensor and axis of each word.
+
+    @return The number of samples queued, or -1 on error.
+*/
+/**************************************************************************/
+int lsm6dsm_drainFifo(void) {
+    fifoStatus_t status;
+    int queued = 0;
+
+    if (lsm6dsm_read_reg(&lsm6dsm_ctx, LSM6DSM_FIFO_STATUS1, (uint8_t *)&status, sizeof(status)) != 0) {
+        return -1;
+    }
+    int words = (status.status2.diff_fifo << 8) | status.status1.diff_fifo;
+    int pattern = (status.status4.fifo_pattern << 8) | status.status3.fifo_pattern;
+
+    while (words > 0) {
+        int n = (words < LSM6DSM_FIFO_BURST_WORDS) ? words : LSM6DSM_FIFO_BURST_WORDS;
+        if (lsm6dsm_fifo_raw_data_get(&lsm6dsm_ctx, sBurst, (uint8_t)(n * 2)) != 0) {
+            return -1;
+        }
+        for (int i = 0; i < n; i++) {
+            int16_t word = (int16_t)(sBurst[2 * i] | (sBurst[2 * i + 1] << 8));
+            queued += storeWord(pattern, word);
+            pattern = (pattern + 1) % LSM6DSM_FIFO_PATTERN_WORDS;
+        }
+        words -= n;
+    }
+    return queued;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Takes the oldest sample out of the ring buffer
+    @param sample Receives the sample
+    @return False when the ring buffer is empty.
+*/
+/**************************************************************************/
+bool lsm6dsm_popSample(lsm6dsm_sample_t *sample) {
+    if (sRingCount == 0) {
+        return false;
+    }
+    *sample = sRing[sRingHead];
+    sRingHead = (sRingHead + 1) % LSM6DSM_RING_SIZE;
+    sRingCount--;
+    return true;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Counts the samples in the ring buffer
+    @return The number of samples that can be popped.
+*/
+/**************************************************************************/
+int lsm6dsm_getSampleCount(void) {
+    return sRingCount;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Counts the samples dropped because the ring buffer was full
+    @return The number of dropped samples since lsm6dsm_beginFifo.
+*/
+/**************************************************************************/
+int lsm6dsm_getDropCount(void) {
+    return sDropCount;
+}
@@ -0,0 +1,48 @@
+#ifndef __LSM6DSM_FIFO_H_
+#define __LSM6DSM_FIFO_H_
+
+#include "lsm6dsm.h"
+#include <stdbool.h>
+
+/*=========================================================================
+    I2C ADDRESS/BITS
+    -----------------------------------------------------------------------*/
+#if !defined(LSM6DSM_ADDRESS)
+#define LSM6DSM_ADDRESS (LSM6DSM_I2C_ADD_L >> 1) /**< Assumes SDO/SA0 pin low */
+#endif
+/*=========================================================================*/
+
+/*=========================================================================
+    FIFO READOUT
+    -----------------------------------------------------------------------*/
+#if !defined(LSM6DSM_RING_SIZE)
+#define LSM6DSM_RING_SIZE (64) /**< Samples buffered between drain and pop, 8 bytes each */
+#endif
+#define LSM6DSM_FIFO_BURST_WORDS (96) /**< FIFO words read per transfer: 16 gyro + accel pairs, 192 bytes */
+#define LSM6DSM_FIFO_PATTERN_WORDS (6) /**< Gyro X, Y, Z followed by accel X, Y, Z */
+/*=========================================================================*/
+
+/** Tells which sensor a sample comes from */
+typedef enum {
+  LSM6DSM_TAG_GYRO = 0,  /**< Angular rate, in LSB of the gyroscope full scale */
+  LSM6DSM_TAG_ACCEL = 1, /**< Acceleration, in LSB of the accelerometer full scale */
+} lsm6dsm_tag_t;
+
+/** One sample of the three axes of one sensor. */
+typedef struct {
+  uint8_t tag; /**< One of lsm6dsm_tag_t */
+  int16_t x;   /**< X-axis */
+  int16_t y;   /**< Y-axis */
+  int16_t z;   /**< Z-axis */
+} lsm6dsm_sample_t;
+
+/** Binding of the ST driver to the I2C master: pass it to any lsm6dsm_* function. */
+extern stmdev_ctx_t lsm6dsm_ctx;
+
+bool lsm6dsm_beginFifo(lsm6dsm_odr_fifo_t odr, uint16_t watermark);
+int lsm6dsm_drainFifo(void);
+bool lsm6dsm_popSample(lsm6dsm_sample_t *sample);
+int lsm6dsm_getSampleCount(void);
+int lsm6dsm_getDropCount(void);
+
+#endif
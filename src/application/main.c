@@ -1,10 +1,19 @@
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 
 #include "board.h"
 #include "ndeft2t/ndeft2t.h"
+#include "event/event.h"
+#include "i2cq/i2cq.h"
+#include "ringbuf/ringbuf.h"
+#include "runloop/runloop.h"
+#include "sched/sched.h"
+#include "storage/storage.h"
 #include "SEGGER_RTT.h"
 #include "adxl343.h"
+#include "motion.h"
+#include "log.h"
 
 /* ------------------------------------------------------------------------- */
 
@@ -14,6 +23,27 @@
 #define ADC_OFF 0
 #define ADC_MAX  4095
 
+/** Accelerometer samples collected in the sensor FIFO before the CPU is woken up: 160 ms at 100 Hz. */
+#define ACCEL_FIFO_WATERMARK 16
+
+/** Scheduler priority of the accelerometer events: the sensor FIFO overflows when they wait too long. */
+#define PRIORITY_SENSOR 0
+
+/** Scheduler priority of the NFC events. */
+#define PRIORITY_NFC 1
+
+/** NFC field transitions that can be queued before the main loop handles them. Must be a power of two. */
+#define FIELD_RING_CAPACITY 8
+
+/** Time between two addresses probed by the I2C scan, in ms. */
+#define SCAN_ADDRESS_INTERVAL 10
+
+/** Time between the end of an I2C scan and the start of the next one, in ms. */
+#define SCAN_INTERVAL 2000
+
+/** Time between two writes of the event and storage bookkeeping to EEPROM, in ms: what a reset may lose at most. */
+#define PERSIST_INTERVAL 60000
+
 /** The URL will be used in a single-record NDEF message. */
 #define MAX_URI_PAYLOAD (254 - NDEFT2T_MSG_OVERHEAD(true, NDEFT2T_URI_RECORD_OVERHEAD(true)))
 
@@ -38,25 +68,66 @@ static uint8_t sBytes[MAX_MIME_PAYLOAD] = {0, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE};
  * - @c false: generate a dual-record NDEF message containing a TEXT and a MIME record.
  */
 
-static volatile bool sButtonPressed = false; /** @c true when the WAKEUP button is pressed on the Demo PCB */
-static volatile bool sMsgAvailable = false; /** @c true when a new NDEF message has been written by the tag reader. */
-static volatile bool sFieldPresent = true; /** @c true when an NFC field is detected and the tag is selected. */
+static int sDacValue = ADC_OFF; /** The level last set with #setDAC */
+static uint8_t sFieldRingData[FIELD_RING_CAPACITY];
+static RINGBUF_T sFieldRing; /** Each NFC field transition: @c 1 when the tag got selected, @c 0 when the field left. */
 
 static void GenerateNdef_TextMime(void);
 static void ParseNdef(void);
+static void Accel_Drain(void *pArg);
+static void Nfc_FieldChanged(void *pArg);
+static void Nfc_MsgAvailable(void *pArg);
+static void Persist(void *pArg);
 void initDAC(void);
 void setDAC(int value);
 
 /* ------------------------------------------------------------------------- */
 
 /**
- * Handler for PIO0_0 / WAKEUP pin.
+ * Handler for the ADXL343 interrupt pin: the only PIO0 interrupt enabled.
  * Overrides the WEAK function in the startup module.
  */
 void PIO0_IRQHandler(void)
 {
-    Chip_GPIO_ClearInts(NSS_GPIO, 0, 1);
-    sButtonPressed = true; /* Handled in main loop */
+    uint32_t ints = Chip_GPIO_GetMaskedInts(NSS_GPIO, 0);
+
+    if (ints & (1 << ACCEL_INT_PIN)) {
+        /* Level triggered: masked until the FIFO is drained, it would fire continuously otherwise. */
+        Chip_GPIO_DisableInt(NSS_GPIO, 0, 1 << ACCEL_INT_PIN);
+        Sched_Post(Accel_Drain, NULL, PRIORITY_SENSOR);
+    }
+    Chip_GPIO_ClearInts(NSS_GPIO, 0, ints);
+    RunLoop_Wake();
+}
+
+/**
+ * Start logic handler of PIO0_2, the ADXL343 interrupt pin: the pin ends Deep Sleep mode this way.
+ * The data is handled by #PIO0_IRQHandler. Overrides the WEAK function in the startup module.
+ */
+void PIO0_2_IRQHandler(void)
+{
+    Chip_SysCon_StartLogic_ClearStatus((SYSCON_STARTSOURCE_T)(1 << ACCEL_INT_PIN));
+}
+
+/**
+ * Start logic handler of the NFC block: a tag reader ends Deep Sleep mode this way.
+ * The data is handled by the ndeft2t mod. Overrides the WEAK function in the startup module.
+ */
+void RFFIELD_IRQHandler(void)
+{
+    Chip_SysCon_StartLogic_ClearStatus(SYSCON_STARTSOURCE_NFC);
+}
+
+/**
+ * Deep Sleep mode powers down the analog blocks: the DAC would then no longer drive the level set by the tag reader.
+ * Called in thread mode with interrupts disabled.
+ * @see RUNLOOP_DEEPSLEEP_CB
+ * @see pRunLoop_DeepSleep_Cb_t
+ */
+bool App_DeepSleepCb(int ms)
+{
+    (void)ms;
+    return sDacValue == ADC_OFF;
 }
 
 /**
@@ -72,7 +143,14 @@ void App_FieldStatusCb(bool status)
     else {
         LED_Off(LED_RED);
     }
-    sFieldPresent = status; /* Handled in main loop */
+    /* Each transition is kept: a reader that comes and goes before the main loop looks is not missed. One event
+     * suffices for all queued transitions, as its handler empties the ring. */
+    uint8_t present = status;
+    bool wasEmpty = (RingBuf_GetCount(&sFieldRing) == 0);
+    RingBuf_Push(&sFieldRing, &present, 1);
+    if (wasEmpty) {
+        Sched_Post(Nfc_FieldChanged, NULL, PRIORITY_NFC);
+    }
 }
 
 /**
@@ -82,23 +160,22 @@ void App_FieldStatusCb(bool status)
  */
 void App_MsgAvailableCb(void)
 {
-    sMsgAvailable = true; /* Handled in main loop */
+    Sched_Post(Nfc_MsgAvailable, NULL, PRIORITY_NFC);
 }
 
 /* ------------------------------------------------------------------------- */
 
-/** Generates a dual-record NDEF message containing a TEXT and a MIME record, and copies it to the NFC shared memory. */
+/** Generates a dual-record NDEF message containing a TEXT and a MIME record, directly in the NFC shared memory. */
 static void GenerateNdef_TextMime(void)
 {
     uint8_t instance[NDEFT2T_INSTANCE_SIZE];
-    uint8_t buffer[NFC_SHARED_MEM_BYTE_SIZE ];
     NDEFT2T_CREATE_RECORD_INFO_T textRecordInfo = {.pString = (uint8_t *)"en" /* language code */,
                                                    .shortRecord = true,
                                                    .uriCode = 0 /* don't care */};
     NDEFT2T_CREATE_RECORD_INFO_T mimeRecordInfo = {.pString = (uint8_t *)MIME /* mime type */,
                                                    .shortRecord = true,
                                                    .uriCode = 0 /* don't care */};
-    NDEFT2T_CreateMessage(instance, buffer, NFC_SHARED_MEM_BYTE_SIZE, true);
+    NDEFT2T_CreateMessageDirect(instance);
     if (NDEFT2T_CreateTextRecord(instance, &textRecordInfo)) {
         if (NDEFT2T_WriteRecordPayload(instance, sText, sizeof(sText) - 1 /* exclude NUL char */)) {
             NDEFT2T_CommitRecord(instance);
@@ -109,7 +186,7 @@ static void GenerateNdef_TextMime(void)
             NDEFT2T_CommitRecord(instance);
         }
     }
-    NDEFT2T_CommitMessage(instance); /* Copies the generated message to NFC shared memory. */
+    NDEFT2T_CommitMessage(instance); /* Publishes the generated message by writing its length. */
 }
 
 /** Parses the NDEF message in the NFC shared memory, and copies the TEXT and MIME payloads. */
@@ -152,6 +229,72 @@ static void ParseNdef(void)
     }
 }
 
+/**
+ * Event handler: drains the ADXL343 FIFO into the motion feature engine. Only the features of each full window are
+ * stored and traced, not the samples.
+ */
+static void Accel_Drain(void *pArg)
+{
+    adxl343_sample_t samples[ADXL343_FIFO_SIZE];
+
+    (void)pArg;
+    int count = adxl343_readFifo(samples, ADXL343_FIFO_SIZE);
+    Chip_GPIO_EnableInt(NSS_GPIO, 0, 1 << ACCEL_INT_PIN);
+    if(count < 0)
+    {
+        Trace_Event(TRACE_EVENT_ACCEL_ERROR);
+    }
+    else if(Motion_AddSamples(samples, count) > 0)
+    {
+        /* The record ends with the last field: the padding of the structure is not traced. */
+        Trace_Write(TRACE_EVENT_MOTION, Motion_GetFeatures(), (int)offsetof(motion_features_t, detected) + 1);
+    }
+}
+
+/**
+ * Event handler: publishes a fresh NDEF message when a tag reader came in range. All queued transitions are taken in
+ * one go: a single message serves them all.
+ */
+static void Nfc_FieldChanged(void *pArg)
+{
+    uint8_t transitions[FIELD_RING_CAPACITY];
+    bool arrived = false;
+    int count;
+
+    (void)pArg;
+    while((count = RingBuf_Pop(&sFieldRing, transitions, FIELD_RING_CAPACITY)) > 0)
+    {
+        for(int i = 0; i < count; i++)
+        {
+            arrived |= (transitions[i] != 0);
+        }
+    }
+    if(arrived)
+    {
+        GenerateNdef_TextMime();
+    }
+}
+
+/** Event handler: takes over the NDEF message written by the tag reader. */
+static void Nfc_MsgAvailable(void *pArg)
+{
+    (void)pArg;
+    ParseNdef();
+}
+
+/**
+ * Run loop job: writes the bookkeeping of the event and storage mods to EEPROM, which they otherwise only keep in RAM.
+ * Without it, a reset loses the stored events, and the storage mod falls back to searching its marker.
+ */
+static void Persist(void *pArg)
+{
+    (void)pArg;
+    Event_DeInit();
+    Event_Init(false);
+    Storage_DeInit();
+    Storage_Init();
+}
+
 void initDAC(void) {
     Chip_IOCON_SetPinConfig(NSS_IOCON, IOCON_ANA0_0, IOCON_FUNC_1);
     Chip_ADCDAC_Init(NSS_ADCDAC0);
@@ -161,6 +304,7 @@ void initDAC(void) {
 
 void setDAC(int value) {
     Chip_ADCDAC_WriteOutputDAC(NSS_ADCDAC0, value);
+    sDacValue = value;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -192,9 +336,12 @@ static void Master_Init(void)
     Chip_I2C_Init(I2C0);
     Chip_I2C_SetClockRate(I2C0, I2C_BITRATE);
 
-    /* Finish initialization for master I2C communication. */
-    Chip_I2C_SetMasterEventHandler(I2C0, Chip_I2C_EventHandler);
-    NVIC_EnableIRQ(I2C0_IRQn);
+    /* Finish initialization for master I2C communication: transfers are queued, the CPU sleeps while they run. */
+    I2CQ_Init();
+
+    /* The NFC callbacks hand their work over from here on. */
+    RingBuf_Init(&sFieldRing, sFieldRingData, sizeof(sFieldRingData[0]), FIELD_RING_CAPACITY);
+    Sched_Init();
 
     /* Extra initialization required for master-build functionality:
      * - prepare NDEF message creation
@@ -206,45 +353,77 @@ static void Master_Init(void)
     Chip_GPIO_SetPinOutHigh(NSS_GPIO, 0, 3);
 }
 
-uint8_t scanI2C()
+/**
+ * Configures the ADXL343 interrupt pin as a level triggered input, which also ends Deep Sleep mode through the start
+ * logic. The GPIO interrupt itself is enabled by the caller.
+ */
+static void AccelInt_Init(void)
 {
-    Master_Init();
-
-    Chip_Clock_System_BusyWait_ms(1000); // Might not be need: to stop bricking
-
-    SEGGER_RTT_ConfigUpBuffer(0, NULL, NULL, 0, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-
-    //SEGGER_RTT_WriteString(0, "SEGGER Real-Time-Terminal Sample\r\n\r\n");
-    //SEGGER_RTT_WriteString(0, "###### Testing SEGGER_printf() ######\r\n");
+    Chip_IOCON_SetPinConfig(NSS_IOCON, ACCEL_INT_IOCON, IOCON_FUNC_0 | IOCON_RMODE_INACT);
+    Chip_GPIO_SetPinDIRInput(NSS_GPIO, 0, ACCEL_INT_PIN);
+    Chip_GPIO_SetupPinInt(NSS_GPIO, 0, ACCEL_INT_PIN, GPIO_INT_ACTIVE_HIGH_LEVEL);
+    NVIC_EnableIRQ(PIO0_IRQn);
+
+    Chip_SysCon_StartLogic_SetPIORisingEdge((SYSCON_STARTSOURCE_T)(Chip_SysCon_StartLogic_GetPIORisingEdge()
+                                                                   | (1 << ACCEL_INT_PIN)));
+    Chip_SysCon_StartLogic_SetEnabledMask((SYSCON_STARTSOURCE_T)(Chip_SysCon_StartLogic_GetEnabledMask()
+                                                                 | (1 << ACCEL_INT_PIN)));
+    Chip_SysCon_StartLogic_ClearStatus((SYSCON_STARTSOURCE_T)(1 << ACCEL_INT_PIN));
+    NVIC_EnableIRQ((IRQn_Type)(PIO0_0_IRQn + ACCEL_INT_PIN));
+}
 
+/**
+ * Run loop job: probes the next I2C address. The next address follows #SCAN_ADDRESS_INTERVAL ms later, and the next
+ * scan #SCAN_INTERVAL ms after the last address.
+ */
+static void ScanI2C_Probe(void *pArg)
+{
+    static uint8_t address = 0;
     uint16_t offset = 0;
     uint8_t text[I2C_SLAVE_TX_SIZE + 1];
-    // I2C_STATUS_T i2c_status = 0;
-    // I2C_XFER_T i2cPacket;
-    I2C_XFER_T i2cPacket = {.slaveAddr = 0,
+    I2C_XFER_T i2cPacket = {.slaveAddr = address,
             .txBuff = (uint8_t *)&offset,
             .txSz = I2C_MASTER_TX_SIZE,
             .rxBuff = text,
             .rxSz = I2C_SLAVE_TX_SIZE};
-    while(1)
-    {   SEGGER_RTT_WriteString(0, "Scanning i2c Address\r\n");
-        for(uint8_t i = 0; i < 128; i++)
-        {
-            i2cPacket.slaveAddr = i;            
-            I2C_STATUS_T i2c_status = Chip_I2C_MasterTransfer(I2C0, &i2cPacket);
-
-            
-            if(i2c_status == 0)
-            {
-                SEGGER_RTT_printf(0, "Address: %d: ", i);
-                SEGGER_RTT_printf(0, "AWK\n", i);
-            }
 
-            Chip_Clock_System_BusyWait_ms(10);
-        }
+    (void)pArg;
+    if(address == 0)
+    {
+        Trace_Event(TRACE_EVENT_I2C_SCAN);
+    }
+    if(Chip_I2C_MasterTransfer(I2C0, &i2cPacket) == I2C_STATUS_DONE)
+    {
+        Trace_Event16(TRACE_EVENT_I2C_ACK, address);
+    }
 
-        SEGGER_RTT_WriteString(0, "Scanning Complete\r\n");
-        Chip_Clock_System_BusyWait_ms(2000);
+    address = (uint8_t)((address + 1) % 128);
+    if(address == 0)
+    {
+        Trace_Event(TRACE_EVENT_I2C_SCAN_DONE);
+        RunLoop_AddOneShotJob(ScanI2C_Probe, NULL, SCAN_INTERVAL);
+    }
+    else
+    {
+        RunLoop_AddOneShotJob(ScanI2C_Probe, NULL, SCAN_ADDRESS_INTERVAL);
+    }
+}
+
+uint8_t scanI2C()
+{
+    Master_Init();
+
+    Chip_Clock_System_BusyWait_ms(1000); // Might not be need: to stop bricking
+
+    SEGGER_RTT_ConfigUpBuffer(0, NULL, NULL, 0, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+    Trace_Init();
+
+    /* The core sleeps between the probes instead of busy waiting. */
+    RunLoop_Init();
+    RunLoop_AddOneShotJob(ScanI2C_Probe, NULL, 0);
+    while(1)
+    {
+        RunLoop_Step();
     }
 
 
@@ -259,28 +438,47 @@ int main(void)
 
     SEGGER_RTT_ConfigUpBuffer(0, NULL, NULL, 0, SEGGER_RTT_MODE_NO_BLOCK_SKIP);
 
-    SEGGER_RTT_printf(0, "Program Started\n");
+    /* All output goes to the binary trace channel, formatted on the host: decode it with tools/trace_decode.py. */
+    Trace_Init();
+    Trace_Event(TRACE_EVENT_START);
 
     if(!adxl343_begin())
     {
-        SEGGER_RTT_printf(0, "Failed ADXL343 INIT\n");
+        LOG("Failed ADXL343 INIT");
         return 0;
     }
 
-    SEGGER_RTT_printf(0, "SUCCESS ADXL343 INIT\n");
+    LOG("SUCCESS ADXL343 INIT");
 
-    while(1)
-    {   
-        int16_t x, y, z;
-        if(adxl343_getXYZ(&x, &y, &z))
-        {
-            SEGGER_RTT_printf(0, "ACCEL: %d, %d, %d\n", x, y, z);
-        }
-        else {
-            SEGGER_RTT_printf(0, "Bad DATA\n");
-        }
-        Chip_Clock_System_BusyWait_ms(100);
+    /* Motion events and the features of each window are kept in EEPROM. Nothing reads them out yet: a later NFC
+     * command can, as they survive a reset once Persist ran. */
+    Chip_EEPROM_Init(NSS_EEPROM);
+    Event_Init(false);
+    Storage_Init();
+    Motion_Init();
+
+    /* The sensor buffers the samples: the CPU sleeps until the watermark is reached, then drains the FIFO at once. */
+    AccelInt_Init();
+    if(!adxl343_setDataRate(ADXL343_DATARATE_100_HZ) || !adxl343_enableFifo(ACCEL_FIFO_WATERMARK, ADXL343_INT1))
+    {
+        LOG("Failed ADXL343 FIFO");
+        return 0;
     }
+    Chip_GPIO_EnableInt(NSS_GPIO, 0, 1 << ACCEL_INT_PIN);
+
+    /* A tag reader ends Deep Sleep mode too; the messages it writes drive the DAC. While the DAC drives a level,
+     * App_DeepSleepCb keeps the run loop out of Deep Sleep mode. */
+    initDAC();
+    Chip_SysCon_StartLogic_SetEnabledMask((SYSCON_STARTSOURCE_T)(Chip_SysCon_StartLogic_GetEnabledMask()
+                                                                 | SYSCON_STARTSOURCE_NFC));
+    Chip_SysCon_StartLogic_ClearStatus(SYSCON_STARTSOURCE_NFC);
+    NVIC_EnableIRQ(RFFIELD_IRQn);
+
+    /* The interrupts only post events. These are handled one by one, sensor first; in between, the run loop sleeps in
+     * the deepest power mode its jobs allow. */
+    RunLoop_Init();
+    RunLoop_AddPeriodicJob(Persist, NULL, PERSIST_INTERVAL);
+    Sched_Run();
 
 
     return 0;
@@ -0,0 +1,224 @@
+#include "motion.h"
+#include "dsp/dsp.h"
+#include "event/event.h"
+#include "storage/storage.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Running sums of the window being filled, per axis */
+typedef struct {
+    int32_t sum;
+    uint64_t sumSquares;
+    int16_t min;
+    int16_t max;
+    int8_t sign;        /**< Side of the reference of the last sample that was not on it */
+    uint8_t crossings;
+} axis_t;
+
+static axis_t sAxes[3];
+static int sFill;                 /**< Samples in the window being filled */
+static uint8_t sShocks;
+static uint32_t sPeakSquared;     /**< Largest squared magnitude in the window being filled */
+static int16_t sReference[3];     /**< Mean of the previous window: the level the crossings are counted around */
+static int16_t sOrientation[3];   /**< Mean of the first window: the orientation tilts are measured against */
+static uint8_t sDetected;         /**< Conditions seen in the previous window */
+static motion_features_t sFeatures;
+static int sWindowCount;
+
+/**************************************************************************/
+/*!
+    @brief  Starts an empty window
+*/
+/**************************************************************************/
+static void startWindow(void) {
+    for (int axis = 0; axis < 3; axis++) {
+        sAxes[axis] = (axis_t){.sum = 0, .sumSquares = 0, .min = INT16_MAX, .max = INT16_MIN, .sign = 0,
+                               .crossings = 0};
+    }
+    sFill = 0;
+    sShocks = 0;
+    sPeakSquared = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Clamps a feature to the range Storage_Write keeps of its field
+    @param value The feature
+    @param bitSize The bit size of its field in motion_record_t, sign bit
+           included
+*/
+/**************************************************************************/
+static int16_t toField(int32_t value, int bitSize) {
+    int32_t max = (1 << (bitSize - 1)) - 1;
+
+    if (value > max) {
+        value = max;
+    } else if (value < -max - 1) {
+        value = -max - 1;
+    }
+    return (int16_t)value;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Sets an event when a condition starts: a condition lasting
+            several windows is reported once
+    @param event The condition
+    @param strength Stored with the event: how far the threshold was exceeded
+*/
+/**************************************************************************/
+static void report(motion_event_t event, uint16_t strength) {
+    sFeatures.detected |= (uint8_t)MOTION_DETECTED(event);
+    if (!(sDetected & MOTION_DETECTED(event))) {
+        Event_Set((uint8_t)event, &strength, sizeof(strength));
+    }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Computes the features of the full window, sets the events of
+            the conditions that start, and stores the features
+*/
+/**************************************************************************/
+static void completeWindow(void) {
+    motion_record_t record;
+    uint16_t rms = 0;
+    uint16_t peakToPeak = 0;
+    uint16_t tilt = 0;
+    int crossings = 0;
+
+    sFeatures.detected = 0;
+    sFeatures.shocks = sShocks;
+    for (int axis = 0; axis < 3; axis++) {
+        axis_t *pAxis = &sAxes[axis];
+        int32_t mean = pAxis->sum >> MOTION_WINDOW_SHIFT;
+        int64_t variance = (int64_t)(pAxis->sumSquares >> MOTION_WINDOW_SHIFT) - (int64_t)mean * mean;
+        sFeatures.mean[axis] = (int16_t)mean;
+        sFeatures.rms[axis] = Dsp_Sqrt((variance > 0) ? (uint32_t)variance : 0);
+        sFeatures.peakToPeak[axis] = (uint16_t)(pAxis->max - pAxis->min);
+        sFeatures.crossings[axis] = pAxis->crossings;
+
+        if (sWindowCount == 0) {
+            sOrientation[axis] = (int16_t)mean;
+        }
+        int deviation = abs(mean - sOrientation[axis]);
+        tilt = (deviation > tilt) ? (uint16_t)deviation : tilt;
+        rms = (sFeatures.rms[axis] > rms) ? sFeatures.rms[axis] : rms;
+        peakToPeak = (sFeatures.peakToPeak[axis] > peakToPeak) ? sFeatures.peakToPeak[axis] : peakToPeak;
+        crossings = (pAxis->crossings > crossings) ? pAxis->crossings : crossings;
+        sReference[axis] = (int16_t)mean;
+    }
+
+    /* A shock dominates the other statistics of its window: the window is not classified further. */
+    if (sShocks > 0) {
+        report(MOTION_EVENT_SHOCK, Dsp_Sqrt(sPeakSquared));
+    } else if (crossings >= MOTION_VIBRATION_CROSSINGS) {
+        if (rms >= MOTION_VIBRATION_THRESHOLD) {
+            report(MOTION_EVENT_VIBRATION, rms);
+        }
+    } else if (peakToPeak >= MOTION_SHAKE_THRESHOLD) {
+        report(MOTION_EVENT_SHAKE, peakToPeak);
+    }
+    if (tilt >= MOTION_TILT_THRESHOLD) {
+        report(MOTION_EVENT_TILT, tilt);
+    }
+    sDetected = sFeatures.detected;
+
+    for (int axis = 0; axis < 3; axis++) {
+        record.mean[axis] = toField(sFeatures.mean[axis], MOTION_MEAN_BITSIZE);
+        record.rms[axis] = toField(sFeatures.rms[axis], MOTION_RMS_BITSIZE);
+        record.peakToPeak[axis] = toField(sFeatures.peakToPeak[axis], MOTION_PEAKTOPEAK_BITSIZE);
+        record.crossings[axis] = toField(sFeatures.crossings[axis], MOTION_CROSSINGS_BITSIZE);
+    }
+    record.shocks = toField(sFeatures.shocks, MOTION_SHOCKS_BITSIZE);
+    Storage_Write(&record, 1);
+
+    sWindowCount++;
+    startWindow();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Forgets all samples and the reference orientation: the mean of
+            the next full window becomes the orientation tilts are measured
+            against.
+    @pre    The event and storage mods are initialized.
+*/
+/**************************************************************************/
+void Motion_Init(void) {
+    startWindow();
+    memset(&sFeatures, 0, sizeof(sFeatures));
+    sDetected = 0;
+    sWindowCount = 0;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Feeds samples to the feature engine. Each time a window is full,
+            its features are computed and stored, and the events of the
+            conditions that start in it are set.
+    @param samples The samples, oldest first
+    @param count Number of samples in @p samples
+    @return The number of windows completed by these samples
+*/
+/**************************************************************************/
+int Motion_AddSamples(const adxl343_sample_t *samples, int count) {
+    const uint32_t shockSquared = (uint32_t)MOTION_SHOCK_THRESHOLD * MOTION_SHOCK_THRESHOLD;
+    int windows = 0;
+
+    for (int i = 0; i < count; i++) {
+        const int16_t values[3] = {samples[i].x, samples[i].y, samples[i].z};
+        uint32_t squared = 0;
+
+        if ((sWindowCount == 0) && (sFill == 0)) {
+            memcpy(sReference, values, sizeof(sReference));
+        }
+        for (int axis = 0; axis < 3; axis++) {
+            axis_t *pAxis = &sAxes[axis];
+            int32_t value = values[axis];
+            pAxis->sum += value;
+            pAxis->sumSquares += (uint32_t)(value * value);
+            pAxis->min = (values[axis] < pAxis->min) ? values[axis] : pAxis->min;
+            pAxis->max = (values[axis] > pAxis->max) ? values[axis] : pAxis->max;
+            squared += (uint32_t)(value * value);
+
+            int8_t sign = (int8_t)((value > sReference[axis]) - (value < sReference[axis]));
+            if (sign != 0) {
+                if ((pAxis->sign != 0) && (sign != pAxis->sign)) {
+                    pAxis->crossings++;
+                }
+                pAxis->sign = sign;
+            }
+        }
+        if (squared > shockSquared) {
+            sShocks++;
+        }
+        sPeakSquared = (squared > sPeakSquared) ? squared : sPeakSquared;
+
+        if (++sFill == MOTION_WINDOW_SIZE) {
+            completeWindow();
+            windows++;
+        }
+    }
+    return windows;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Gives the features of the last full window
+    @return All zero until the first window is full
+*/
+/**************************************************************************/
+const motion_features_t *Motion_GetFeatures(void) {
+    return &sFeatures;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Counts the full windows
+    @return The number of windows since Motion_Init
+*/
+/**************************************************************************/
+int Motion_GetWindowCount(void) {
+    return sWindowCount;
+}
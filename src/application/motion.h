@@ -0,0 +1,75 @@
+#ifndef __MOTION_H_
+#define __MOTION_H_
+
+#include "adxl343.h"
+#include "motion_record.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*=========================================================================
+    WINDOW
+    -----------------------------------------------------------------------*/
+#if !defined(MOTION_WINDOW_SHIFT)
+#define MOTION_WINDOW_SHIFT (6) /**< Log2 of the samples per window: 64 samples, 640 ms at 100 Hz */
+#endif
+#define MOTION_WINDOW_SIZE (1 << MOTION_WINDOW_SHIFT) /**< Samples per window */
+#if (MOTION_WINDOW_SHIFT < 1) || (MOTION_WINDOW_SHIFT > 7)
+#error MOTION_WINDOW_SHIFT must be in the range [1, 7]
+#endif
+#if (MOTION_WINDOW_SIZE > (1 << (MOTION_CROSSINGS_BITSIZE - 1))) \
+    || (MOTION_WINDOW_SIZE >= (1 << (MOTION_SHOCKS_BITSIZE - 1)))
+#error The crossings and shocks of a window do not fit their fields in motion_record_t
+#endif
+/*=========================================================================*/
+
+/*=========================================================================
+    THRESHOLDS, in LSB of the sensor: 256 LSB/g in the ADXL343 +/-2 g range
+    -----------------------------------------------------------------------*/
+#if !defined(MOTION_SHOCK_THRESHOLD)
+#define MOTION_SHOCK_THRESHOLD (448) /**< Magnitude of the acceleration vector above which a sample counts as a shock: 1.75 g */
+#endif
+#if !defined(MOTION_SHAKE_THRESHOLD)
+#define MOTION_SHAKE_THRESHOLD (256) /**< Peak-to-peak on any axis of a slow movement that counts as shaking: 1 g */
+#endif
+#if !defined(MOTION_VIBRATION_THRESHOLD)
+#define MOTION_VIBRATION_THRESHOLD (13) /**< RMS on any axis of a fast movement that counts as vibration: 50 mg */
+#endif
+#if !defined(MOTION_VIBRATION_CROSSINGS)
+#define MOTION_VIBRATION_CROSSINGS (16) /**< Crossings per window from which a movement is fast: 12.5 Hz at 100 Hz */
+#endif
+#if !defined(MOTION_TILT_THRESHOLD)
+#define MOTION_TILT_THRESHOLD (64) /**< Change of the mean on any axis that counts as a tilt: 0.25 g, about 15 degrees */
+#endif
+/*=========================================================================*/
+
+/**
+ * The event tags set by the feature engine. The values equal those of
+ * EVENT_TAG_SHOCK..EVENT_TAG_TILT in the tlogger demo, so its protocol reports
+ * them as APP_MSG_EVENT_SHOCK..APP_MSG_EVENT_TILT.
+ */
+typedef enum {
+  MOTION_EVENT_SHOCK = 12,     /**< A sample exceeded MOTION_SHOCK_THRESHOLD */
+  MOTION_EVENT_SHAKE = 13,     /**< Slow movement beyond MOTION_SHAKE_THRESHOLD */
+  MOTION_EVENT_VIBRATION = 14, /**< Fast movement beyond MOTION_VIBRATION_THRESHOLD */
+  MOTION_EVENT_TILT = 15,      /**< Orientation changed by more than MOTION_TILT_THRESHOLD */
+} motion_event_t;
+
+/** Bit in motion_features_t.detected of a motion_event_t */
+#define MOTION_DETECTED(event) (1 << ((event) - MOTION_EVENT_SHOCK))
+
+/** The features of one window of samples, per axis X, Y, Z. */
+typedef struct {
+  int16_t mean[3];        /**< Average, rounded down */
+  uint16_t rms[3];        /**< RMS of the deviation from the mean: the movement without gravity */
+  uint16_t peakToPeak[3]; /**< Largest minus smallest value */
+  uint8_t crossings[3];   /**< Sign changes around the mean of the previous window */
+  uint8_t shocks;         /**< Samples with a magnitude above MOTION_SHOCK_THRESHOLD */
+  uint8_t detected;       /**< MOTION_DETECTED bits of the conditions seen in this window */
+} motion_features_t;
+
+void Motion_Init(void);
+int Motion_AddSamples(const adxl343_sample_t *samples, int count);
+const motion_features_t *Motion_GetFeatures(void);
+int Motion_GetWindowCount(void);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef __MOTION_RECORD_H_
+#define __MOTION_RECORD_H_
+
+#include <stdint.h>
+
+/*=========================================================================
+    FIELD BIT SIZES of the stored record, sign bit included: the storage
+    mod keeps each field signed. In LSB of the ADXL343 +/-2 g range.
+    -----------------------------------------------------------------------*/
+#define MOTION_MEAN_BITSIZE (10)       /**< Mean: the whole sensor range, -512..511 */
+#define MOTION_RMS_BITSIZE (10)        /**< RMS: at most half of the peak-to-peak */
+#define MOTION_PEAKTOPEAK_BITSIZE (11) /**< Peak-to-peak: at most 1023 */
+#define MOTION_CROSSINGS_BITSIZE (7)   /**< Crossings: fewer than the samples of a window, at most 63 */
+#define MOTION_SHOCKS_BITSIZE (8)      /**< Shocks: at most the samples of a window, 64 */
+/*=========================================================================*/
+
+/**
+ * The features of one window as stored: one record of the storage mod. Each
+ * field becomes a plane of its own when a block moves to FLASH. Values beyond
+ * the bit size of their field are clamped.
+ */
+typedef struct {
+  int16_t mean[3];
+  int16_t rms[3];
+  int16_t peakToPeak[3];
+  int16_t crossings[3];
+  int16_t shocks;
+} motion_record_t;
+
+/** Number of fields of motion_record_t */
+#define MOTION_RECORD_FIELD_COUNT (13)
+
+/** The bit sizes of the fields of motion_record_t, in order: for STORAGE_FIELD_BITSIZES */
+#define MOTION_RECORD_BITSIZES                                                  \
+  MOTION_MEAN_BITSIZE, MOTION_MEAN_BITSIZE, MOTION_MEAN_BITSIZE,                \
+  MOTION_RMS_BITSIZE, MOTION_RMS_BITSIZE, MOTION_RMS_BITSIZE,                   \
+  MOTION_PEAKTOPEAK_BITSIZE, MOTION_PEAKTOPEAK_BITSIZE, MOTION_PEAKTOPEAK_BITSIZE, \
+  MOTION_CROSSINGS_BITSIZE, MOTION_CROSSINGS_BITSIZE, MOTION_CROSSINGS_BITSIZE, \
+  MOTION_SHOCKS_BITSIZE
+
+/** Bits per stored record: the sum of MOTION_RECORD_BITSIZES, for STORAGE_BITSIZE */
+#define MOTION_RECORD_BITSIZE                                                   \
+  (3 * (MOTION_MEAN_BITSIZE + MOTION_RMS_BITSIZE + MOTION_PEAKTOPEAK_BITSIZE +  \
+        MOTION_CROSSINGS_BITSIZE) + MOTION_SHOCKS_BITSIZE)
+
+#endif
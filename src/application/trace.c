@@ -0,0 +1,181 @@
+#include "trace.h"
+#include "board.h"
+#include "SEGGER_RTT.h"
+#include "profile/profile.h"
+#include <string.h>
+
+/** Longest argument list of a record, in bytes: a MOTION record */
+#define TRACE_ARGS_MAX (9 * 2 + 5)
+
+static uint8_t sBuffer[TRACE_BUFFER_SIZE];
+static int sDropCount;
+
+/**************************************************************************/
+/*!
+    @brief  Configures the trace RTT channel, and starts the cycle counter of
+            the profile mod (CT32B0) for the timestamps.
+*/
+/**************************************************************************/
+void Trace_Init(void) {
+    SEGGER_RTT_ConfigUpBuffer(TRACE_RTT_CHANNEL, "Trace", sBuffer, sizeof(sBuffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+    sDropCount = 0;
+    Profile_Init();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Reads the timestamp used in the trace records
+    @return System clock cycles since Trace_Init, wrapping after 2^32 cycles:
+            71 minutes at 1 MHz. The host converts them to time: no divide
+            on the target.
+*/
+/**************************************************************************/
+uint32_t Trace_GetTimestamp(void) {
+    return Profile_GetCycles();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds one record to the trace channel. The record is written
+            whole or not at all: when the debug probe does not keep up, it
+            is dropped and counted.
+
+    Safe to call under interrupt: the RTT buffer is locked while writing.
+
+    @param id The event
+    @param args The arguments as laid out in the record, little endian
+    @param size Number of bytes in @p args, at most TRACE_ARGS_MAX
+*/
+/**************************************************************************/
+void Trace_Write(trace_event_t id, const void *args, int size) {
+    uint8_t record[TRACE_HEADER_SIZE + TRACE_ARGS_MAX];
+
+    if ((size < 0) || (size > TRACE_ARGS_MAX)) {
+        return;
+    }
+    record[0] = (uint8_t)id;
+    if (size > 0) {
+        memcpy(&record[TRACE_HEADER_SIZE], args, (size_t)size);
+    }
+
+    SEGGER_RTT_LOCK();
+    /* Taken under the lock: the timestamps of the records in the channel never go backwards. */
+    uint32_t timestamp = Trace_GetTimestamp();
+    record[1] = (uint8_t)timestamp;
+    record[2] = (uint8_t)(timestamp >> 8);
+    record[3] = (uint8_t)(timestamp >> 16);
+    record[4] = (uint8_t)(timestamp >> 24);
+    if (SEGGER_RTT_WriteSkipNoLock(TRACE_RTT_CHANNEL, record, (unsigned)(TRACE_HEADER_SIZE + size)) == 0) {
+        sDropCount++;
+    }
+    SEGGER_RTT_UNLOCK();
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a record without arguments
+    @param id The event
+*/
+/**************************************************************************/
+void Trace_Event(trace_event_t id) {
+    Trace_Write(id, NULL, 0);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a record with one 16-bit argument
+    @param id The event
+    @param a The argument, signed or not as told by the event's struct code
+*/
+/**************************************************************************/
+void Trace_Event16(trace_event_t id, uint16_t a) {
+    uint8_t args[2] = {(uint8_t)a, (uint8_t)(a >> 8)};
+    Trace_Write(id, args, sizeof(args));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a record with three 16-bit arguments, e.g. the axes of a sample
+    @param id The event
+    @param a First argument
+    @param b Second argument
+    @param c Third argument
+*/
+/**************************************************************************/
+void Trace_Event16x3(trace_event_t id, uint16_t a, uint16_t b, uint16_t c) {
+    uint8_t args[6] = {(uint8_t)a, (uint8_t)(a >> 8), (uint8_t)b, (uint8_t)(b >> 8), (uint8_t)c, (uint8_t)(c >> 8)};
+    Trace_Write(id, args, sizeof(args));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a record with one 32-bit argument
+    @param id The event
+    @param a The argument
+*/
+/**************************************************************************/
+void Trace_Event32(trace_event_t id, uint32_t a) {
+    uint8_t args[4] = {(uint8_t)a, (uint8_t)(a >> 8), (uint8_t)(a >> 16), (uint8_t)(a >> 24)};
+    Trace_Write(id, args, sizeof(args));
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds a LOG record: the format string stays on the host
+    @param stringOffset Offset of the format string in the logstr section
+    @param args The arguments, one per conversion in the format string
+    @param count Number of @p args, at most 4
+*/
+/**************************************************************************/
+void Trace_Log(uintptr_t stringOffset, const uint32_t *args, int count) {
+    uint8_t record[TRACE_ARGS_MAX] = {(uint8_t)stringOffset, (uint8_t)(stringOffset >> 8)};
+    int size = 2;
+
+    for (int i = 0; (i < count) && (size < TRACE_ARGS_MAX); i++) {
+        record[size++] = (uint8_t)args[i];
+        record[size++] = (uint8_t)(args[i] >> 8);
+        record[size++] = (uint8_t)(args[i] >> 16);
+        record[size++] = (uint8_t)(args[i] >> 24);
+    }
+    Trace_Write(TRACE_EVENT_LOG, record, size);
+}
+
+/**************************************************************************/
+/*!
+    @brief  Adds the measurements of the profiling scopes: one PROFILE record
+            per called scope, followed by a PROFILE_BIN record per non-empty
+            histogram bin. Nothing is added unless PROFILE_ENABLED is set.
+*/
+/**************************************************************************/
+void Trace_Profile(void) {
+    const PROFILE_SCOPE_T *scope;
+
+    for (int id = 0; (scope = Profile_GetScope(id)) != NULL; id++) {
+        if (scope->count == 0) {
+            continue;
+        }
+        uint8_t args[TRACE_ARGS_MAX] = {(uint8_t)id};
+        memcpy(&args[1], &scope->count, 4);
+        memcpy(&args[5], &scope->min, 4);
+        memcpy(&args[9], &scope->max, 4);
+        memcpy(&args[13], &scope->total, 8);
+        Trace_Write(TRACE_EVENT_PROFILE, args, sizeof(args));
+        for (int bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++) {
+            if (scope->histogram[bin] > 0) {
+                uint8_t binArgs[4] = {(uint8_t)id, (uint8_t)bin};
+                memcpy(&binArgs[2], &scope->histogram[bin], 2);
+                Trace_Write(TRACE_EVENT_PROFILE_BIN, binArgs, sizeof(binArgs));
+            }
+        }
+    }
+}
+
+/**************************************************************************/
+/*!
+    @brief  Counts the records dropped because the RTT buffer was full
+    @return The number of dropped records since Trace_Init.
+*/
+/**************************************************************************/
+int Trace_GetDropCount(void) {
+    return sDropCount;
+}
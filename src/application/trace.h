@@ -0,0 +1,35 @@
+#ifndef __TRACE_H_
+#define __TRACE_H_
+
+#include "trace_events.h"
+#include <stdint.h>
+
+/*=========================================================================
+    RTT CHANNEL
+    -----------------------------------------------------------------------*/
+#if !defined(TRACE_RTT_CHANNEL)
+#define TRACE_RTT_CHANNEL (1) /**< RTT up-buffer of the trace records; channel 0 stays the text terminal */
+#endif
+#if !defined(TRACE_BUFFER_SIZE)
+#define TRACE_BUFFER_SIZE (512) /**< Bytes buffered for the debug probe: 46 accelerometer records */
+#endif
+/*=========================================================================*/
+
+/**
+ * Size of the record header: the event id followed by the timestamp, in
+ * system clock cycles of CT32B0. The arguments follow, all little endian.
+ */
+#define TRACE_HEADER_SIZE (1 + 4)
+
+void Trace_Init(void);
+uint32_t Trace_GetTimestamp(void);
+void Trace_Write(trace_event_t id, const void *args, int size);
+void Trace_Event(trace_event_t id);
+void Trace_Event16(trace_event_t id, uint16_t a);
+void Trace_Event16x3(trace_event_t id, uint16_t a, uint16_t b, uint16_t c);
+void Trace_Event32(trace_event_t id, uint32_t a);
+void Trace_Log(uintptr_t stringOffset, const uint32_t *args, int count);
+void Trace_Profile(void);
+int Trace_GetDropCount(void);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef __TRACE_EVENTS_H_
+#define __TRACE_EVENTS_H_
+
+/**
+ * The trace events, one per line: X(id, format, args)
+ * - @c id: the name of the event; its value is its position in the list.
+ * - @c format: printf-like text the host decoder fills in with the arguments.
+ * - @c args: the arguments following the timestamp, as Python struct codes:
+ *   @c b / @c B for 8-bit, @c h / @c H for 16-bit, @c i / @c I for 32-bit and
+ *   @c q / @c Q for 64-bit values. @c * marks a #LOG
+ *   record: a 16-bit string offset, then one 32-bit value per conversion in
+ *   the string.
+ *
+ * tools/trace_decode.py parses this list: keep one event per line, and only
+ * append so older captures keep decoding.
+ */
+#define TRACE_EVENTS(X) \
+    X(TRACE_EVENT_START, "Program started", "") \
+    X(TRACE_EVENT_ACCEL, "ACCEL: %d, %d, %d", "hhh") \
+    X(TRACE_EVENT_ACCEL_ERROR, "Bad DATA", "") \
+    X(TRACE_EVENT_I2C_SCAN, "Scanning i2c Address", "") \
+    X(TRACE_EVENT_I2C_ACK, "Address: %d: AWK", "H") \
+    X(TRACE_EVENT_I2C_SCAN_DONE, "Scanning Complete", "") \
+    X(TRACE_EVENT_LOG, "%s", "*") \
+    X(TRACE_EVENT_PROFILE, "PROFILE %u: %u calls, %u..%u cycles, %u in total", "BIIIQ") \
+    X(TRACE_EVENT_PROFILE_BIN, "PROFILE %u: bin %u: %u calls", "BBH") \
+    X(TRACE_EVENT_MOTION, "MOTION mean %d %d %d, rms %u %u %u, p2p %u %u %u, crossings %u %u %u, shocks %u, detected 0x%x", "hhhHHHHHHBBBBB")
+
+#define TRACE_EVENT_ENUM_(id, format, args) id,
+/** Trace event ids */
+typedef enum {
+    TRACE_EVENTS(TRACE_EVENT_ENUM_)
+    TRACE_EVENT_COUNT
+} trace_event_t;
+#undef TRACE_EVENT_ENUM_
+
+#endif
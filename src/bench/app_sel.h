@@ -0,0 +1,56 @@
+#ifndef __APP_SEL_H_
+#define __APP_SEL_H_
+
+/**
+ * @addtogroup BENCH_BOARD
+ * Diversity settings of the mods used by the benchmarks. As in the SDK applications, this file is force-included in
+ * every compilation unit (@c -include app_sel.h).
+ * @{
+ */
+
+#include <stdint.h>
+
+#define SW_MAJOR_VERSION 1
+#define SW_MINOR_VERSION 0
+
+/* Diversities tweaking the msg module. */
+#define MSG_ENABLE_CHECKBATTERY 0
+#define MSG_RESPONSE_BUFFER_SIZE 256
+#define MSG_RESPONSE_BUFFER Bench_ResponseBuffer
+#define MSG_ENABLE_GETRESPONSES 1
+#define MSG_ENABLE_GETPROFILE 1
+
+/* Diversities tweaking the profile module: the benchmarks report the time spent per scope. */
+#define PROFILE_ENABLED 1
+
+/* Diversities tweaking the i2cq module: the ring buffer benchmark reads samples under interrupt. */
+#define I2CQ_DONE_CB Bench_I2cDoneCb
+
+/* Diversities tweaking the ndeft2t module. */
+#define NDEFT2T_EEPROM_COPY_SUPPPORT 0
+#define NDEFT2T_FIELD_STATUS_CB Bench_FieldStatusCb
+#define NDEFT2T_MSG_AVAILABLE_CB Bench_MsgAvailableCb
+#define NDEFT2T_DIFFERENTIAL_COMMIT 1
+
+/* Diversities tweaking the event module. */
+#define EVENT_EEPROM_FIRST_ROW 2
+#define EVENT_EEPROM_LAST_ROW 20
+#define EVENT_OVERHEAD_CHOICE EVENT_OVERHEAD_CHOICE_B
+
+/* Diversities tweaking the storage module. */
+#define STORAGE_TYPE int16_t
+#define STORAGE_BITSIZE 11
+#define STORAGE_SIGNED 1
+#define STORAGE_EEPROM_FIRST_ROW 21
+#define STORAGE_EEPROM_LAST_ROW (EEPROM_NR_OF_RW_ROWS - 1)
+#define STORAGE_FLASH_FIRST_PAGE 128 /**< There is no linker script: the first 8 kB are assumed to hold the program. */
+#define STORAGE_FIRST_ALON_REGISTER 3
+#define STORAGE_COMPRESS_CB Bench_CompressCb
+#define STORAGE_DECOMPRESS_CB Bench_DecompressCb
+
+/* Diversities tweaking the compress module: the samples given by the storage module vary slowly. */
+#define COMPRESS_CODEC COMPRESS_CODEC_DELTA
+#define COMPRESS_DELTA_BITSIZE STORAGE_BITSIZE
+
+/** @} */
+#endif
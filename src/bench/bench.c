@@ -0,0 +1,1764 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "board.h"
+#include "compress/compress.h"
+#include "dsp/dsp.h"
+#include "event/event.h"
+#include "i2cq/i2cq.h"
+#include "msg/msg.h"
+#include "ndeft2t/ndeft2t.h"
+#include "profile/profile.h"
+#include "ringbuf/ringbuf.h"
+#include "runloop/runloop.h"
+#include "sched/sched.h"
+#include "storage/storage.h"
+#include "adxl343.h"
+#include "lsm6dsm_fifo.h"
+#include "log.h"
+#include "SEGGER_RTT.h"
+
+/**
+ * @defgroup BENCH bench: Host-native benchmarks of the mods on top of the simulated peripherals
+ * @ingroup SIM
+ * Each benchmark starts from a freshly initialized @ref SIM "simulator", exercises one code path the way an
+ * application does, verifies the outcome and prints one line per simulated peripheral:
+ *  @code
+ *      bench=storage time_ns=... host_ns=... peripheral=eeprom ops=... busy_ns=... busy_cycles=... ...
+ *      bench=storage time_ns=... host_ns=... core=arm active_ns=... sleep_ns=... deep_sleep_ns=...
+ *  @endcode
+ * @c time_ns is the virtual time the code path took on the target, @c host_ns the processor time the host needed to
+ * run it. Then follows one line per @ref MODS_NSS_PROFILE "profiling scope" that was entered:
+ *  @code
+ *      bench=storage time_ns=... host_ns=... scope=storage_move count=... min_cycles=... max_cycles=... ...
+ *  @endcode
+ * A failed verification aborts the executable with a non-zero exit code.
+ *
+ * Usage: @c bench [name...] - without arguments, all benchmarks are run.
+ * @{
+ */
+
+/* ------------------------------------------------------------------------- */
+
+/** Number of samples written to and read back from the storage module. */
+#define BENCH_STORAGE_SAMPLES 3000
+
+/** Number of samples handed over in one call to #Storage_Write and #Storage_Read. */
+#define BENCH_STORAGE_CHUNK 12
+
+/** First EEPROM row written by the EEPROM cache benchmark: the rows of the storage module. */
+#define BENCH_EEPROM_FIRST_ROW STORAGE_EEPROM_FIRST_ROW
+
+/** Number of EEPROM rows written by the EEPROM cache benchmark. */
+#define BENCH_EEPROM_ROWS 32
+
+/** Bytes handed over in one call to #Chip_EEPROM_Write: a row takes four calls. */
+#define BENCH_EEPROM_CHUNK 16
+
+/** Time the application spends on other work between two writes. */
+#define BENCH_EEPROM_WORK_NS 1000000ULL
+
+/** Minimum number of events that must fit in the EEPROM rows assigned to the event module. */
+#define BENCH_EVENT_MIN_COUNT 100
+
+/** Number of command/response exchanges over NFC. */
+#define BENCH_NDEF_ROUNDTRIPS 50
+
+/** Number of times a status message is refreshed while a tag reader is present. */
+#define BENCH_NDEF_REFRESHES 100
+
+/** Size of the MIME payload of the refreshed status message. Only its first 4 bytes change. */
+#define BENCH_NDEF_STATUS_SIZE 40
+
+/** Number of responses built in the response buffer, then fetched over NFC. */
+#define BENCH_MSG_RESPONSES 50
+
+/** Payload size of those responses: the size of a page of measurements. */
+#define BENCH_MSG_RESPONSE_SIZE 180
+
+/** Message id of those responses. */
+#define BENCH_MSG_RESPONSE_ID 0x50
+
+/** Number of times a batch of small responses is queued, then fetched over NFC. */
+#define BENCH_MSG_BATCHES 20
+
+/** Number of responses in a batch: asynchronous results, each with a 6 byte payload. */
+#define BENCH_MSG_BATCH_SIZE 4
+
+/** Size of the blocks compressed and decompressed. */
+#define BENCH_COMPRESS_SIZE 1024
+
+/** Number of blocks compressed and decompressed. */
+#define BENCH_COMPRESS_ROUNDS 20
+
+/** Number of accelerometer samples read. */
+#define BENCH_I2C_SAMPLES 200
+
+/** Number of accelerometer samples drained from the sensor FIFO. */
+#define BENCH_FIFO_SAMPLES 1000
+
+/** Sample period of the simulated accelerometer: 100 Hz. */
+#define BENCH_FIFO_PERIOD_NS 10000000ULL
+
+/** FIFO level at which the simulated accelerometer raises its interrupt pin. */
+#define BENCH_FIFO_WATERMARK 16
+
+/** Number of gyroscope + accelerometer sample pairs drained from the LSM6DSM FIFO. */
+#define BENCH_IMU_PAIRS 1000
+
+/** Output data rate of the simulated LSM6DSM: 416 Hz, about half the I2C bandwidth at 100 kHz. */
+#define BENCH_IMU_ODR LSM6DSM_FIFO_416Hz
+#define BENCH_IMU_PERIOD_NS (1000000000ULL / 416)
+
+/**
+ * Sleep time between two drains of the LSM6DSM FIFO. Reading the FIFO takes about half as long as it took to fill it,
+ * so a drain collects about 23 sample pairs: well within #LSM6DSM_RING_SIZE samples.
+ */
+#define BENCH_IMU_DRAIN_NS 30000000ULL
+
+/** Number of blocking I2C transfers measured by the profiling benchmark. */
+#define BENCH_PROFILE_TRANSFERS 50
+
+/** Number of 3-axis samples traced. */
+#define BENCH_TRACE_SAMPLES 1200
+
+/** Sample period of the traced accelerometer: 400 Hz. */
+#define BENCH_TRACE_PERIOD_NS 2500000ULL
+
+/** Interval at which the simulated debug probe empties the trace channel. */
+#define BENCH_TRACE_POLL_NS 50000000ULL
+
+/** Period of the sampling job of the run loop benchmark, in ms: 10 Hz. */
+#define BENCH_RUNLOOP_PERIOD_MS 100
+
+/** Number of samples taken, both with busy waits and with the run loop. */
+#define BENCH_RUNLOOP_SAMPLES 100
+
+/** Period of the reporting job of the run loop benchmark, in ms: long enough for Deep Sleep mode. */
+#define BENCH_RUNLOOP_REPORT_MS 3000
+
+/** Number of reports made by the reporting job alone. */
+#define BENCH_RUNLOOP_REPORTS 5
+
+/** Number of samples in the block conditioned by the DSP benchmark: 10 s at 100 Hz. */
+#define BENCH_DSP_SAMPLES 1000
+
+/** Number of times the DSP benchmark conditions the block, fixed-point and float alike, to time it on the host. */
+#define BENCH_DSP_ROUNDS 100
+
+/** Number of taps of the FIR filter of the DSP benchmark. */
+#define BENCH_DSP_TAPS 16
+
+/** Number of accelerometer samples handed over by the ring buffer benchmark. */
+#define BENCH_RINGBUF_SAMPLES 400
+
+/** Capacity of the ring in the ring buffer benchmark, in samples. */
+#define BENCH_RINGBUF_CAPACITY 16
+
+/** Time the main loop spends on each batch of samples in the ring buffer benchmark, in us. */
+#define BENCH_RINGBUF_WORK_US 2000
+
+/** Number of accelerometer samples drained by the scheduler benchmark. */
+#define BENCH_SCHED_SAMPLES 800
+
+/** Number of accelerometer sample periods between two commands of the tag reader in the scheduler benchmark. */
+#define BENCH_SCHED_COMMAND_TICKS 10
+
+/** Period of the report job in the scheduler benchmark, in ms. */
+#define BENCH_SCHED_REPORT_MS 1000
+
+/** Event priorities in the scheduler benchmark. */
+#define BENCH_SCHED_PRIORITY_SENSOR 0
+#define BENCH_SCHED_PRIORITY_NFC 1
+#define BENCH_SCHED_PRIORITY_REPORT 2
+
+/** MIME type used for the command and response NDEF records. */
+#define BENCH_MIME "n/p"
+
+/** NFC page where the NDEF TLV starts: behind the lock control and proprietary TLVs written by #NDEFT2T_Init. */
+#define BENCH_NDEF_PAGE 6
+
+/* ------------------------------------------------------------------------- */
+
+typedef struct BENCH_S {
+    const char * name;
+    void (*run)(void);
+} BENCH_T;
+
+/** Aborts the executable when @c expr is false, regardless of @c DEBUG. */
+#define BENCH_CHECK(expr) do { if (expr) {} else { Sim_AssertFailed(__FILE__, __LINE__); } } while (0)
+
+/* ------------------------------------------------------------------------- */
+
+int Bench_CompressCb(int eepromByteOffset, int bitCount, void * pOut);
+int Bench_DecompressCb(const uint8_t * pData, int bitCount, void * pOut);
+void Bench_FieldStatusCb(bool isPresent);
+void Bench_MsgAvailableCb(void);
+void Bench_I2cDoneCb(I2C_XFER_T * pXfer);
+extern uint8_t Bench_ResponseBuffer[MSG_RESPONSE_BUFFER_SIZE];
+
+static void Storage(void);
+static void EepromCache(void);
+static void Events(void);
+static void NdefMsg(void);
+static void NdefRefresh(void);
+static void MsgResponse(void);
+static void MsgCoalesce(void);
+static void CompressBlocks(void);
+static void I2c(void);
+static void I2cQueue(void);
+static void AccelFifo(void);
+static void ImuFifo(void);
+static void ProfileScopes(void);
+static void TraceAccel(void);
+static void RunLoop(void);
+static void Scheduler(void);
+static void RingBuffer(void);
+static void DspKernels(void);
+static uint64_t HostNs(void);
+
+static const BENCH_T sBenches[] = {
+    {"storage", Storage},
+    {"eeprom_cache", EepromCache},
+    {"event", Events},
+    {"ndef_msg", NdefMsg},
+    {"ndef_refresh", NdefRefresh},
+    {"msg_response", MsgResponse},
+    {"msg_coalesce", MsgCoalesce},
+    {"compress", CompressBlocks},
+    {"i2c", I2c},
+    {"i2c_queue", I2cQueue},
+    {"adxl_fifo", AccelFifo},
+    {"lsm6dsm_fifo", ImuFifo},
+    {"profile", ProfileScopes},
+    {"trace", TraceAccel},
+    {"runloop", RunLoop},
+    {"sched", Scheduler},
+    {"ringbuf", RingBuffer},
+    {"dsp", DspKernels}
+};
+
+static volatile bool sMsgAvailable;
+static bool sSchedPosting; /**< Whether interrupts and callbacks post their work to the scheduler */
+static uint8_t sNdefInstance[NDEFT2T_INSTANCE_SIZE] __attribute__((aligned (4)));
+static uint8_t sNdefBuffer[NFC_SHARED_MEM_BYTE_SIZE] __attribute__((aligned (4)));
+static int sResponseCount;
+static bool sAcceptResponses = true;
+
+/** #MSG_RESPONSE_BUFFER is assigned to this array in app_sel.h */
+uint8_t Bench_ResponseBuffer[MSG_RESPONSE_BUFFER_SIZE];
+
+/* ------------------------------------------------------------------------- */
+
+int Bench_CompressCb(int eepromByteOffset, int bitCount, void * pOut)
+{
+    ASSERT(bitCount == STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS);
+    (void)bitCount; /* suppress [-Wunused-parameter]: its value is known to be STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS. */
+    uint8_t data[STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES];
+    Chip_EEPROM_Read(NSS_EEPROM, eepromByteOffset, data, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+    int length = Compress_Encode(data, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES, pOut, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+    return length * 8;
+}
+
+int Bench_DecompressCb(const uint8_t * pData, int bitCount, void * pOut)
+{
+    int length = Compress_Decode(pData, STORAGE_IDIVUP(bitCount, 8), pOut, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+    return (length == STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES) ? STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS : 0;
+}
+
+void Bench_FieldStatusCb(bool isPresent)
+{
+    (void)isPresent;
+}
+
+static void Sched_Commands(void * pArg);
+
+void Bench_MsgAvailableCb(void)
+{
+    if (sSchedPosting) {
+        BENCH_CHECK(Sched_Post(Sched_Commands, NULL, BENCH_SCHED_PRIORITY_NFC));
+    }
+    else {
+        sMsgAvailable = true;
+    }
+}
+
+/** A slowly varying temperature-like signal around freezing, in tenths of a degree. */
+static int16_t Sample(int n)
+{
+    return (int16_t)(-20 + ((n / 7) % 40) - ((n / 97) % 15));
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void Storage(void)
+{
+    STORAGE_TYPE samples[BENCH_STORAGE_CHUNK];
+
+    Chip_EEPROM_Init(NSS_EEPROM);
+    Storage_Init();
+    Storage_Reset(false);
+    for (int n = 0; n < BENCH_STORAGE_SAMPLES; n += BENCH_STORAGE_CHUNK) {
+        for (int i = 0; i < BENCH_STORAGE_CHUNK; i++) {
+            samples[i] = Sample(n + i);
+        }
+        BENCH_CHECK(Storage_Write(samples, BENCH_STORAGE_CHUNK) == BENCH_STORAGE_CHUNK);
+    }
+    BENCH_CHECK(Storage_GetCount() == BENCH_STORAGE_SAMPLES);
+
+    BENCH_CHECK(Storage_Seek(0));
+    for (int n = 0; n < BENCH_STORAGE_SAMPLES; n += BENCH_STORAGE_CHUNK) {
+        BENCH_CHECK(Storage_Read(samples, BENCH_STORAGE_CHUNK) == BENCH_STORAGE_CHUNK);
+        for (int i = 0; i < BENCH_STORAGE_CHUNK; i++) {
+            BENCH_CHECK(samples[i] == Sample(n + i));
+        }
+    }
+
+    /* Paged readout, last page first, as an NFC reader does when fetching the most recent samples first. */
+    for (int n = BENCH_STORAGE_SAMPLES - BENCH_STORAGE_CHUNK; n >= 0; n -= BENCH_STORAGE_CHUNK) {
+        BENCH_CHECK(Storage_Seek(n));
+        BENCH_CHECK(Storage_Read(samples, BENCH_STORAGE_CHUNK) == BENCH_STORAGE_CHUNK);
+        for (int i = 0; i < BENCH_STORAGE_CHUNK; i++) {
+            BENCH_CHECK(samples[i] == Sample(n + i));
+        }
+    }
+    Storage_DeInit();
+
+    /* The directory is rebuilt after initializing again. Reading on while the samples read from are moved to FLASH. */
+    Storage_Init();
+    int count = Storage_GetCount();
+    BENCH_CHECK(count == BENCH_STORAGE_SAMPLES);
+    BENCH_CHECK(Storage_Seek(count - 1));
+    for (int n = count; n < count + STORAGE_BLOCK_SIZE_IN_SAMPLES; n++) {
+        samples[0] = Sample(n);
+        BENCH_CHECK(Storage_Write(samples, 1) == 1);
+    }
+    for (int n = count - 1; n < count - 1 + BENCH_STORAGE_CHUNK; n++) {
+        BENCH_CHECK((Storage_Read(samples, 1) == 1) && (samples[0] == Sample(n)));
+    }
+    Storage_DeInit();
+}
+
+/** Called under interrupt: completes the EEPROM flushes started in the background. */
+void EEPROM_IRQHandler(void)
+{
+    (void)Chip_EEPROM_Poll(NSS_EEPROM);
+}
+
+/**
+ * Writes a series of rows in small chunks, with other work in between, and checks that each write is visible to reads
+ * right away. Flushes run in the background: the writes may wait for a free cache slot, but never for a whole flush.
+ */
+static void EepromCache(void)
+{
+    static uint8_t expected[BENCH_EEPROM_ROWS * EEPROM_ROW_SIZE];
+    static uint8_t data[BENCH_EEPROM_ROWS * EEPROM_ROW_SIZE];
+    int first = BENCH_EEPROM_FIRST_ROW * EEPROM_ROW_SIZE;
+    uint64_t stall = 0;
+
+    for (int i = 0; i < (int)sizeof(expected); i++) {
+        expected[i] = (uint8_t)(i * 7 + 3);
+    }
+    Chip_EEPROM_Init(NSS_EEPROM);
+    NVIC_EnableIRQ(EEPROM_IRQn);
+    for (int offset = 0; offset < (int)sizeof(expected); offset += BENCH_EEPROM_CHUNK) {
+        uint64_t start = Sim_GetTime();
+        Chip_EEPROM_Write(NSS_EEPROM, first + offset, expected + offset, BENCH_EEPROM_CHUNK);
+        stall += Sim_GetTime() - start;
+        Sim_Delay(BENCH_EEPROM_WORK_NS);
+        Chip_EEPROM_Read(NSS_EEPROM, first, data, offset + BENCH_EEPROM_CHUNK);
+        BENCH_CHECK(memcmp(data, expected, (size_t)(offset + BENCH_EEPROM_CHUNK)) == 0);
+    }
+    BENCH_CHECK(stall < SIM_EEPROM_PROGRAM_TIME_US * 1000ULL);
+
+    Chip_EEPROM_Flush(NSS_EEPROM, false);
+    while (Chip_EEPROM_Poll(NSS_EEPROM)) {
+        Sim_Delay(BENCH_EEPROM_WORK_NS);
+    }
+    for (int row = 0; row < BENCH_EEPROM_ROWS; row++) {
+        BENCH_CHECK(Sim_Eeprom_GetProgramCount(BENCH_EEPROM_FIRST_ROW + row) == 1);
+    }
+    BENCH_CHECK(memcmp((uint8_t *)EEPROM_START + first, expected, sizeof(expected)) == 0);
+    NVIC_DisableIRQ(EEPROM_IRQn);
+    Chip_EEPROM_DeInit(NSS_EEPROM);
+}
+
+/** The range of indices #Events_Cb accepts. */
+static unsigned int sEventFirst;
+static unsigned int sEventLast;
+
+/** Checks a reported event against the pattern stored by #Events. @c context holds the timestamp of event 0. */
+static bool Events_Cb(uint8_t tag, int offset, uint8_t len, unsigned int index, uint32_t timestamp, uint32_t context)
+{
+    BENCH_CHECK((sEventFirst <= index) && (index <= sEventLast));
+    BENCH_CHECK(tag == index % 4);
+    BENCH_CHECK(len == ((index % 3) ? sizeof(uint32_t) : 0));
+    if (len) {
+        uint32_t data;
+        Chip_EEPROM_Read(NSS_EEPROM, offset, &data, sizeof(data));
+        BENCH_CHECK(data == index);
+    }
+    else {
+        BENCH_CHECK(offset == -1);
+    }
+    BENCH_CHECK(timestamp == context + index);
+    return true;
+}
+
+/** Retrieves the @c stored events stored by #Events in all possible ways. */
+static void Events_Check(unsigned int stored)
+{
+    uint32_t start;
+    unsigned int index;
+    unsigned int count = 0;
+
+    BENCH_CHECK(Event_GetFirstByTag(0, NULL, NULL, &index, &start) && (index == 0));
+    (void)Event_SetCb(Events_Cb);
+    sEventFirst = 0;
+    sEventLast = stored - 1;
+    for (uint8_t tag = 0; tag < 4; tag++) {
+        count += Event_GetByTag(tag, start);
+        BENCH_CHECK(Event_GetFirstByTag(tag, NULL, NULL, &index, NULL) && (index == tag));
+        BENCH_CHECK(Event_GetLastByTag(tag, NULL, NULL, &index, NULL) && (index == sEventLast - (sEventLast - tag) % 4));
+    }
+    BENCH_CHECK(count == stored);
+    BENCH_CHECK(!Event_GetFirstByTag(4, NULL, NULL, NULL, NULL));
+
+    sEventFirst = stored / 3;
+    sEventLast = 2 * stored / 3;
+    BENCH_CHECK(Event_GetByTime(start + sEventFirst, start + sEventLast, start) == sEventLast - sEventFirst + 1);
+    BENCH_CHECK(Event_GetByIndex(sEventFirst, sEventLast, start) == sEventLast - sEventFirst + 1);
+    (void)Event_SetCb(NULL);
+}
+
+static void Events(void)
+{
+    Chip_EEPROM_Init(NSS_EEPROM);
+    Chip_RTC_Init(NSS_RTC);
+    Chip_Clock_System_BusyWait_ms(1000); /* A base timestamp of 0 is taken for an uninitialized EEPROM region. */
+    Event_Init(true);
+    BENCH_CHECK(!Event_GetLastByTag(0, NULL, NULL, NULL, NULL)); /* Builds the index: it is extended while logging. */
+
+    /* Log until full, one event per second. */
+    unsigned int stored = 0;
+    uint32_t data = 0;
+    while (Event_Set((uint8_t)(stored % 4), &data, (stored % 3) ? sizeof(data) : 0)) {
+        stored++;
+        data++;
+        Chip_Clock_System_BusyWait_ms(1000);
+    }
+    BENCH_CHECK(stored >= BENCH_EVENT_MIN_COUNT);
+    Events_Check(stored);
+    Event_DeInit();
+
+    /* Next session: the index is rebuilt from EEPROM. */
+    Event_Init(false);
+    Events_Check(stored);
+    Event_DeInit();
+}
+
+/* ------------------------------------------------------------------------- */
+
+/** Generates the response NDEF message, as an application does. */
+static bool ResponseCb(int responseLength, const uint8_t * pResponseData)
+{
+    NDEFT2T_CREATE_RECORD_INFO_T recordInfo = {.pString = (uint8_t *)BENCH_MIME, .shortRecord = true, .uriCode = 0};
+    if (!sAcceptResponses) {
+        return false;
+    }
+    NDEFT2T_CreateMessageDirect(sNdefInstance);
+    BENCH_CHECK(NDEFT2T_CreateMimeRecord(sNdefInstance, &recordInfo));
+    BENCH_CHECK(NDEFT2T_WriteRecordPayload(sNdefInstance, pResponseData, responseLength));
+    NDEFT2T_CommitRecord(sNdefInstance);
+    BENCH_CHECK(NDEFT2T_CommitMessage(sNdefInstance));
+    sResponseCount++;
+    return true;
+}
+
+/** Plays the role of the tag reader: writes a command following the Type 2 Tag NDEF write procedure. */
+static void ReaderWriteCommand(const uint8_t * pCmd, int cmdLength)
+{
+    uint8_t tlv[64] = {0};
+    int recordLength = 3 + (int)sizeof(BENCH_MIME) - 1 + cmdLength;
+    int n = 0;
+
+    tlv[n++] = 0x03; /* NDEF message TLV */
+    tlv[n++] = (uint8_t)recordLength;
+    tlv[n++] = 0xD2; /* MB, ME, SR, TNF: media type */
+    tlv[n++] = sizeof(BENCH_MIME) - 1;
+    tlv[n++] = (uint8_t)cmdLength;
+    memcpy(tlv + n, BENCH_MIME, sizeof(BENCH_MIME) - 1);
+    n += (int)sizeof(BENCH_MIME) - 1;
+    memcpy(tlv + n, pCmd, (size_t)cmdLength);
+    n += cmdLength;
+    tlv[n++] = 0xFE; /* Terminator TLV */
+
+    /* First page with a zero length, then the remainder, then the first page with the correct length. */
+    uint8_t first[4] = {tlv[0], 0, tlv[2], tlv[3]};
+    BENCH_CHECK(Sim_Nfc_ReaderWrite(BENCH_NDEF_PAGE, first));
+    for (int page = 1; page * 4 < n; page++) {
+        BENCH_CHECK(Sim_Nfc_ReaderWrite(BENCH_NDEF_PAGE + page, tlv + page * 4));
+    }
+    BENCH_CHECK(Sim_Nfc_ReaderWrite(BENCH_NDEF_PAGE, tlv));
+}
+
+/**
+ * Plays the role of the tag reader: reads the NDEF message and returns the payload of its single MIME record.
+ * NULL TLVs in front of the NDEF message TLV are skipped.
+ * @return The payload length.
+ */
+static int ReaderReadResponse(uint8_t * pPayload)
+{
+    uint8_t data[256];
+    int start = 0;
+    BENCH_CHECK(Sim_Nfc_ReaderRead(BENCH_NDEF_PAGE, data));
+    while ((start < 4) && (data[start] == 0x00)) { /* NULL TLV */
+        start++;
+    }
+    BENCH_CHECK(data[start] == 0x03);
+    int length = start + 2 + data[start + 1];
+    for (int read = 16; read < length; read += 16) {
+        BENCH_CHECK(read + 16 <= (int)sizeof(data));
+        BENCH_CHECK(Sim_Nfc_ReaderRead(BENCH_NDEF_PAGE + read / 4, data + read));
+    }
+    BENCH_CHECK((data[start + 2] & 0x17) == 0x12); /* SR, TNF: media type */
+    int typeLength = data[start + 3];
+    int payloadLength = data[start + 4];
+    memcpy(pPayload, data + start + 5 + typeLength, (size_t)payloadLength);
+    return payloadLength;
+}
+
+/** Passes all records of the NDEF message written by the tag reader to the msg module. */
+static void HandleCommands(void)
+{
+    NDEFT2T_PARSE_RECORD_INFO_T recordInfo;
+    BENCH_CHECK(NDEFT2T_GetMessage(sNdefInstance, sNdefBuffer, NFC_SHARED_MEM_BYTE_SIZE));
+    while (NDEFT2T_GetNextRecord(sNdefInstance, &recordInfo)) {
+        int length;
+        const uint8_t * pPayload = NDEFT2T_GetRecordPayload(sNdefInstance, &length);
+        Msg_HandleCommand(length, pPayload);
+    }
+}
+
+static void NdefMsg(void)
+{
+    static const uint8_t cmd[2] = {MSG_ID_GETVERSION, 0};
+    uint8_t response[32];
+
+    Chip_NFC_Init(NSS_NFC);
+    NDEFT2T_Init();
+    Msg_Init();
+    Msg_SetResponseCb(ResponseCb);
+    sMsgAvailable = false;
+    sResponseCount = 0;
+
+    Sim_Nfc_SetField(true);
+    for (int n = 0; n < BENCH_NDEF_ROUNDTRIPS; n++) {
+        ReaderWriteCommand(cmd, sizeof(cmd));
+        BENCH_CHECK(sMsgAvailable);
+        sMsgAvailable = false;
+        HandleCommands();
+        BENCH_CHECK(sResponseCount == n + 1);
+
+        BENCH_CHECK(ReaderReadResponse(response) > 2);
+        BENCH_CHECK(response[0] == MSG_ID_GETVERSION);
+    }
+    Sim_Nfc_SetField(false);
+    NDEFT2T_DeInit();
+}
+
+/** Refreshes a status message with a changing reading, as a status tag does while a phone is held against it. */
+static void NdefRefresh(void)
+{
+    NDEFT2T_CREATE_RECORD_INFO_T recordInfo = {.pString = (uint8_t *)BENCH_MIME, .shortRecord = true, .uriCode = 0};
+    uint8_t status[BENCH_NDEF_STATUS_SIZE];
+    uint8_t payload[BENCH_NDEF_STATUS_SIZE];
+
+    Chip_NFC_Init(NSS_NFC);
+    NDEFT2T_Init();
+    for (int i = 0; i < BENCH_NDEF_STATUS_SIZE; i++) {
+        status[i] = (uint8_t)i;
+    }
+
+    Sim_Nfc_SetField(true);
+    for (uint32_t n = 0; n < BENCH_NDEF_REFRESHES; n++) {
+        memcpy(status, &n, sizeof(n));
+        NDEFT2T_CreateMessage(sNdefInstance, sNdefBuffer, NFC_SHARED_MEM_BYTE_SIZE, true);
+        BENCH_CHECK(NDEFT2T_CreateMimeRecord(sNdefInstance, &recordInfo));
+        BENCH_CHECK(NDEFT2T_WriteRecordPayload(sNdefInstance, status, sizeof(status)));
+        NDEFT2T_CommitRecord(sNdefInstance);
+        BENCH_CHECK(NDEFT2T_CommitMessage(sNdefInstance));
+
+        BENCH_CHECK(ReaderReadResponse(payload) == BENCH_NDEF_STATUS_SIZE);
+        BENCH_CHECK(memcmp(payload, status, sizeof(status)) == 0);
+    }
+    Sim_Nfc_SetField(false);
+    NDEFT2T_DeInit();
+}
+
+/**
+ * Builds large responses in place in the response buffer while the upper layer refuses them, as happens while no tag
+ * reader is present, then lets the tag reader fetch each of them with a #MSG_ID_GETRESPONSE command.
+ */
+static void MsgResponse(void)
+{
+    static const uint8_t cmd[2] = {MSG_ID_GETRESPONSE, 0};
+    uint8_t response[MSG_RESPONSE_BUFFER_SIZE];
+
+    Chip_NFC_Init(NSS_NFC);
+    NDEFT2T_Init();
+    Msg_Init();
+    Msg_SetResponseCb(ResponseCb);
+    sMsgAvailable = false;
+    sResponseCount = 0;
+
+    Sim_Nfc_SetField(true);
+    for (int n = 0; n < BENCH_MSG_RESPONSES; n++) {
+        sAcceptResponses = false;
+        uint8_t * pPayload = Msg_ReserveResponse(BENCH_MSG_RESPONSE_ID, BENCH_MSG_RESPONSE_SIZE);
+        BENCH_CHECK(pPayload != NULL);
+        BENCH_CHECK(pPayload - 2 >= Bench_ResponseBuffer); /* In place, behind the header. */
+        for (int i = 0; i < BENCH_MSG_RESPONSE_SIZE; i++) {
+            pPayload[i] = (uint8_t)(n + i);
+        }
+        Msg_CommitResponse(BENCH_MSG_RESPONSE_SIZE);
+        sAcceptResponses = true;
+
+        ReaderWriteCommand(cmd, sizeof(cmd));
+        BENCH_CHECK(sMsgAvailable);
+        sMsgAvailable = false;
+        HandleCommands();
+        BENCH_CHECK(sResponseCount == n + 1);
+
+        BENCH_CHECK(ReaderReadResponse(response) == 2 + BENCH_MSG_RESPONSE_SIZE);
+        BENCH_CHECK(response[0] == BENCH_MSG_RESPONSE_ID);
+        for (int i = 0; i < BENCH_MSG_RESPONSE_SIZE; i++) {
+            BENCH_CHECK(response[2 + i] == (uint8_t)(n + i));
+        }
+    }
+    Sim_Nfc_SetField(false);
+    NDEFT2T_DeInit();
+}
+
+/**
+ * Queues a few small responses while the upper layer refuses them, then lets the tag reader fetch all of them in one
+ * round trip with a #MSG_ID_GETRESPONSES command. A first such command is refused as well: that may not lose them.
+ */
+static void MsgCoalesce(void)
+{
+    static const uint8_t cmd[2] = {MSG_ID_GETRESPONSES, 0};
+    uint8_t response[MSG_RESPONSE_BUFFER_SIZE];
+    uint8_t payload[6];
+
+    Chip_NFC_Init(NSS_NFC);
+    NDEFT2T_Init();
+    Msg_Init();
+    Msg_SetResponseCb(ResponseCb);
+    sMsgAvailable = false;
+    sResponseCount = 0;
+
+    Sim_Nfc_SetField(true);
+    for (int n = 0; n < BENCH_MSG_BATCHES; n++) {
+        sAcceptResponses = false;
+        for (int r = 0; r < BENCH_MSG_BATCH_SIZE; r++) {
+            memset(payload, n + r, sizeof(payload));
+            Msg_AddResponse((uint8_t)(BENCH_MSG_RESPONSE_ID + r), sizeof(payload), payload);
+        }
+        ReaderWriteCommand(cmd, sizeof(cmd));
+        BENCH_CHECK(sMsgAvailable);
+        sMsgAvailable = false;
+        HandleCommands();
+        BENCH_CHECK(sResponseCount == n);
+        sAcceptResponses = true;
+
+        ReaderWriteCommand(cmd, sizeof(cmd));
+        BENCH_CHECK(sMsgAvailable);
+        sMsgAvailable = false;
+        HandleCommands();
+        BENCH_CHECK(sResponseCount == n + 1);
+
+        int length = ReaderReadResponse(response);
+        const MSG_RESPONSE_GETRESPONSES_T * pHeader = (const MSG_RESPONSE_GETRESPONSES_T *)(response + 2);
+        BENCH_CHECK(response[0] == MSG_ID_GETRESPONSES);
+        BENCH_CHECK((pHeader->result == MSG_OK) && (pHeader->count == BENCH_MSG_BATCH_SIZE));
+        const uint8_t * pFrame = response + 2 + sizeof(MSG_RESPONSE_GETRESPONSES_T);
+        for (int r = 0; r < BENCH_MSG_BATCH_SIZE; r++) {
+            BENCH_CHECK(pFrame[0] == 2 + sizeof(payload));
+            BENCH_CHECK(pFrame[1] == BENCH_MSG_RESPONSE_ID + r);
+            BENCH_CHECK((pFrame[3] == (uint8_t)(n + r)) && (pFrame[2 + sizeof(payload)] == (uint8_t)(n + r)));
+            pFrame += 1 + pFrame[0];
+        }
+        BENCH_CHECK(pFrame == response + length);
+    }
+    Sim_Nfc_SetField(false);
+    NDEFT2T_DeInit();
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void CompressBlocks(void)
+{
+    static uint8_t raw[BENCH_COMPRESS_SIZE];
+    static uint8_t encoded[BENCH_COMPRESS_SIZE];
+    static uint8_t decoded[BENCH_COMPRESS_SIZE];
+
+    /* Packed as the storage module does: STORAGE_BITSIZE bits per sample, LSBit first. */
+    memset(raw, 0, sizeof(raw));
+    for (int bit = 0; bit + STORAGE_BITSIZE <= BENCH_COMPRESS_SIZE * 8; bit += STORAGE_BITSIZE) {
+        uint32_t sample = (uint32_t)Sample(bit / STORAGE_BITSIZE) & ((1U << STORAGE_BITSIZE) - 1);
+        for (int i = 0; i < STORAGE_BITSIZE; i++) {
+            raw[(bit + i) / 8] |= (uint8_t)(((sample >> i) & 1) << ((bit + i) % 8));
+        }
+    }
+    for (int round = 0; round < BENCH_COMPRESS_ROUNDS; round++) {
+        int encodedLength = Compress_Encode(raw, BENCH_COMPRESS_SIZE, encoded, BENCH_COMPRESS_SIZE);
+        BENCH_CHECK((encodedLength > 0) && (encodedLength < BENCH_COMPRESS_SIZE));
+        BENCH_CHECK(Compress_Decode(encoded, encodedLength, decoded, BENCH_COMPRESS_SIZE) == BENCH_COMPRESS_SIZE);
+        BENCH_CHECK(memcmp(raw, decoded, BENCH_COMPRESS_SIZE) == 0);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+/** Called under interrupt. */
+void I2C0_IRQHandler(void)
+{
+    if (Chip_I2C_IsMasterActive(I2C0)) {
+        Chip_I2C_MasterStateHandler(I2C0);
+    }
+    else {
+        Chip_I2C_SlaveStateHandler(I2C0);
+    }
+}
+
+/** Lets the data registers of the simulated accelerometer change with every read. */
+static void Adxl343_OnRead(SIM_I2C_REGDEVICE_T * pRegDevice, uint8_t reg)
+{
+    if (reg == ADXL3XX_REG_DATAX0) {
+        for (int i = 0; i < 6; i++) {
+            pRegDevice->regs[ADXL3XX_REG_DATAX0 + i]++;
+        }
+    }
+}
+
+/** Initializes the I2C master with the i2cq module. */
+static void I2c_InitMaster(void)
+{
+    Chip_Clock_System_SetClockFreq(SYSTEMCLOCK);
+    Chip_SysCon_Peripheral_DeassertReset(SYSCON_PERIPHERAL_RESET_I2C0);
+    Chip_I2C_Init(I2C0);
+    Chip_I2C_SetClockRate(I2C0, I2C_BITRATE);
+    I2CQ_Init();
+}
+
+/** Adds the simulated accelerometer to the bus and initializes the I2C master with the i2cq module. */
+static void I2c_Init(SIM_I2C_REGDEVICE_T * pAdxl343)
+{
+    memset(pAdxl343, 0, sizeof(*pAdxl343));
+    pAdxl343->regs[ADXL3XX_REG_DEVID] = 0xE5;
+    pAdxl343->onRead = Adxl343_OnRead;
+    Sim_I2c_AddRegDevice(pAdxl343, ADXL343_ADDRESS);
+    I2c_InitMaster();
+}
+
+static void I2c(void)
+{
+    static SIM_I2C_REGDEVICE_T adxl343;
+    int16_t x;
+    int16_t y;
+    int16_t z;
+
+    I2c_Init(&adxl343);
+    BENCH_CHECK(adxl343_begin());
+    BENCH_CHECK(adxl343.regs[ADXL3XX_REG_POWER_CTL] == 0x08);
+    for (int n = 0; n < BENCH_I2C_SAMPLES; n++) {
+        BENCH_CHECK(adxl343_getXYZ(&x, &y, &z));
+        BENCH_CHECK((uint8_t)x == (uint8_t)(n + 1));
+    }
+    NVIC_DisableIRQ(I2C0_IRQn);
+    Chip_I2C_DeInit(I2C0);
+}
+
+/** Reads the accelerometer samples with a full queue of transfers: each next transfer is started under interrupt. */
+static void I2cQueue(void)
+{
+    static SIM_I2C_REGDEVICE_T adxl343;
+    static uint8_t data[BENCH_I2C_SAMPLES][6];
+    static I2C_XFER_T xfers[BENCH_I2C_SAMPLES];
+    uint8_t reg = ADXL3XX_REG_DATAX0;
+    int submitted = 0;
+
+    I2c_Init(&adxl343);
+    for (int n = 0; n < BENCH_I2C_SAMPLES; n++) {
+        xfers[n] = (I2C_XFER_T){.slaveAddr = ADXL343_ADDRESS, .txBuff = &reg, .txSz = 1, .rxBuff = data[n], .rxSz = 6};
+    }
+    for (int n = 0; n < BENCH_I2C_SAMPLES; n++) {
+        while ((submitted < BENCH_I2C_SAMPLES) && I2CQ_Submit(&xfers[submitted])) {
+            submitted++;
+        }
+        BENCH_CHECK(I2CQ_Wait(&xfers[n]) == I2C_STATUS_DONE);
+        BENCH_CHECK(data[n][0] == (uint8_t)(n + 1));
+    }
+    BENCH_CHECK(I2CQ_GetCount() == 0);
+    NVIC_DisableIRQ(I2C0_IRQn);
+    Chip_I2C_DeInit(I2C0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * The simulated accelerometer in FIFO stream mode: sample @c n, counting from 1, is taken at @c n periods after the
+ * start and holds @c n, @c -n and @c 2n on its axes. Samples are produced lazily, whenever the FIFO is looked at.
+ */
+static struct {
+    SIM_I2C_REGDEVICE_T regDevice;
+    uint64_t start; /**< Virtual time at which the sensor started sampling */
+    int produced; /**< Number of samples taken */
+    int consumed; /**< Number of samples popped from the FIFO, or dropped on overflow */
+    int overflows; /**< Number of samples dropped because the FIFO was full */
+    volatile bool watermark; /**< Set by #PIO0_IRQHandler */
+    uint64_t watermarkTime; /**< Virtual time of the last watermark interrupt */
+} sAccel;
+
+static void Sched_Drain(void * pArg);
+
+/** Called under interrupt. */
+void PIO0_IRQHandler(void)
+{
+    uint32_t ints = Chip_GPIO_GetMaskedInts(NSS_GPIO, 0);
+
+    if (ints & (1 << ACCEL_INT_PIN)) {
+        Chip_GPIO_DisableInt(NSS_GPIO, 0, 1 << ACCEL_INT_PIN);
+        sAccel.watermarkTime = Sim_GetTime();
+        if (sSchedPosting) {
+            BENCH_CHECK(Sched_Post(Sched_Drain, NULL, BENCH_SCHED_PRIORITY_SENSOR));
+        }
+        else {
+            sAccel.watermark = true;
+        }
+    }
+    Chip_GPIO_ClearInts(NSS_GPIO, 0, ints);
+}
+
+/** Takes the samples that are due at the current virtual time. In stream mode, the oldest samples are dropped. */
+static int AccelFifo_Produce(void)
+{
+    sAccel.produced = (int)((Sim_GetTime() - sAccel.start) / BENCH_FIFO_PERIOD_NS);
+    if (sAccel.produced - sAccel.consumed > ADXL343_FIFO_SIZE) {
+        sAccel.overflows += sAccel.produced - sAccel.consumed - ADXL343_FIFO_SIZE;
+        sAccel.consumed = sAccel.produced - ADXL343_FIFO_SIZE;
+    }
+    return sAccel.produced - sAccel.consumed;
+}
+
+static void AccelFifo_OnRead(SIM_I2C_REGDEVICE_T * pRegDevice, uint8_t reg)
+{
+    int entries = AccelFifo_Produce();
+
+    if (reg == ADXL3XX_REG_FIFO_STATUS) {
+        pRegDevice->regs[reg] = (uint8_t)entries;
+    }
+    else if ((reg == ADXL3XX_REG_DATAX0) && (entries > 0)) {
+        sAccel.consumed++;
+        int16_t axes[3] = {(int16_t)sAccel.consumed, (int16_t)-sAccel.consumed, (int16_t)(2 * sAccel.consumed)};
+        memcpy(&pRegDevice->regs[ADXL3XX_REG_DATAX0], axes, sizeof(axes));
+    }
+}
+
+/**
+ * Drives the interrupt pin according to the FIFO level. Model callbacks cannot drive other models, so the host applies
+ * the level whenever the firmware has looked at the FIFO.
+ */
+static void AccelFifo_UpdatePin(void)
+{
+    Sim_Gpio_SetInput(ACCEL_INT_PIN, AccelFifo_Produce() >= BENCH_FIFO_WATERMARK);
+}
+
+/** The firmware sleeps: let time pass until the sensor reaches its watermark. */
+static void AccelFifo_Idle(void)
+{
+    uint64_t due = sAccel.start + (uint64_t)(sAccel.consumed + BENCH_FIFO_WATERMARK) * BENCH_FIFO_PERIOD_NS;
+
+    if (due > Sim_GetTime()) {
+        Sim_Delay(due - Sim_GetTime());
+    }
+    AccelFifo_UpdatePin();
+}
+
+/**
+ * Drains the accelerometer FIFO each time its watermark interrupt fires, as the application does. Compare the I2C
+ * transfers and the interrupts with the @c i2c benchmark, which polls one sample per read.
+ */
+static void AccelFifo(void)
+{
+    static adxl343_sample_t samples[ADXL343_FIFO_SIZE];
+    int count = 0;
+
+    memset(&sAccel, 0, sizeof(sAccel));
+    I2c_Init(&sAccel.regDevice);
+    sAccel.regDevice.onRead = AccelFifo_OnRead;
+
+    BENCH_CHECK(adxl343_begin());
+    BENCH_CHECK(adxl343_setDataRate(ADXL343_DATARATE_100_HZ));
+    BENCH_CHECK(adxl343_enableFifo(BENCH_FIFO_WATERMARK, ADXL343_INT1));
+    BENCH_CHECK(sAccel.regDevice.regs[ADXL3XX_REG_FIFO_CTL] == ((ADXL343_FIFO_STREAM << 6) | BENCH_FIFO_WATERMARK));
+    BENCH_CHECK(sAccel.regDevice.regs[ADXL3XX_REG_INT_ENABLE] == ADXL343_INT_WATERMARK);
+    sAccel.start = Sim_GetTime();
+    Sim_SetIdleCb(AccelFifo_Idle);
+
+    Chip_GPIO_SetPinDIRInput(NSS_GPIO, 0, ACCEL_INT_PIN);
+    Chip_GPIO_SetupPinInt(NSS_GPIO, 0, ACCEL_INT_PIN, GPIO_INT_ACTIVE_HIGH_LEVEL);
+    Chip_GPIO_EnableInt(NSS_GPIO, 0, 1 << ACCEL_INT_PIN);
+    NVIC_EnableIRQ(PIO0_IRQn);
+    while (count < BENCH_FIFO_SAMPLES) {
+        __disable_irq();
+        while (!sAccel.watermark) {
+            __WFI();
+            __enable_irq();
+            __disable_irq();
+        }
+        sAccel.watermark = false;
+        __enable_irq();
+
+        int n = adxl343_readFifo(samples, ADXL343_FIFO_SIZE);
+        AccelFifo_UpdatePin();
+        Chip_GPIO_EnableInt(NSS_GPIO, 0, 1 << ACCEL_INT_PIN);
+        BENCH_CHECK(n >= BENCH_FIFO_WATERMARK);
+        for (int i = 0; i < n; i++) {
+            count++;
+            BENCH_CHECK((samples[i].x == count) && (samples[i].y == -count) && (samples[i].z == 2 * count));
+        }
+    }
+    BENCH_CHECK(sAccel.overflows == 0);
+
+    Sim_SetIdleCb(NULL);
+    NVIC_DisableIRQ(PIO0_IRQn);
+    NVIC_DisableIRQ(I2C0_IRQn);
+    Chip_I2C_DeInit(I2C0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * The simulated LSM6DSM, batching gyroscope and accelerometer in its FIFO: word @c n, counting from 0, holds @c n.
+ * Pattern position @c n % 6 tells the sensor and the axis. Words are produced lazily, whenever the FIFO is looked at.
+ */
+static struct {
+    SIM_I2C_REGDEVICE_T regDevice;
+    uint64_t start; /**< Virtual time at which the sensor started batching */
+    int produced; /**< Number of words batched */
+    int consumed; /**< Number of words read from the FIFO */
+} sImu;
+
+static int ImuFifo_Produce(void)
+{
+    /* 4 kB FIFO: the bench drains it long before it would overrun. */
+    sImu.produced = (int)((Sim_GetTime() - sImu.start) / BENCH_IMU_PERIOD_NS) * LSM6DSM_FIFO_PATTERN_WORDS;
+    BENCH_CHECK(sImu.produced - sImu.consumed <= 2048);
+    return sImu.produced - sImu.consumed;
+}
+
+static void ImuFifo_OnRead(SIM_I2C_REGDEVICE_T * pRegDevice, uint8_t reg)
+{
+    int words = ImuFifo_Produce();
+
+    if (reg == LSM6DSM_FIFO_STATUS1) {
+        int pattern = sImu.consumed % LSM6DSM_FIFO_PATTERN_WORDS;
+        pRegDevice->regs[LSM6DSM_FIFO_STATUS1] = (uint8_t)words;
+        pRegDevice->regs[LSM6DSM_FIFO_STATUS2] = (uint8_t)(((words >> 8) & 0x07) | ((words == 0) ? 0x10 : 0));
+        pRegDevice->regs[LSM6DSM_FIFO_STATUS3] = (uint8_t)pattern;
+        pRegDevice->regs[LSM6DSM_FIFO_STATUS4] = 0;
+    }
+    else if ((reg == LSM6DSM_FIFO_DATA_OUT_L) && (words > 0)) {
+        pRegDevice->regs[LSM6DSM_FIFO_DATA_OUT_L] = (uint8_t)sImu.consumed;
+        pRegDevice->regs[LSM6DSM_FIFO_DATA_OUT_H] = (uint8_t)(sImu.consumed >> 8);
+        sImu.consumed++;
+    }
+    else if (reg == LSM6DSM_FIFO_DATA_OUT_H) {
+        pRegDevice->pointer = LSM6DSM_FIFO_DATA_OUT_L; /* Rolls back for the next word */
+    }
+}
+
+static void ImuFifo_OnWrite(SIM_I2C_REGDEVICE_T * pRegDevice, uint8_t reg)
+{
+    if (reg == LSM6DSM_CTRL3_C) {
+        pRegDevice->regs[reg] &= (uint8_t)~0x01; /* SW_RESET clears itself */
+    }
+}
+
+/** Drains the LSM6DSM FIFO periodically into the ring buffer of tagged samples, and checks each sample popped. */
+static void ImuFifo(void)
+{
+    lsm6dsm_sample_t sample;
+    int popped = 0;
+
+    memset(&sImu, 0, sizeof(sImu));
+    sImu.regDevice.regs[LSM6DSM_WHO_AM_I] = LSM6DSM_ID;
+    sImu.regDevice.onRead = ImuFifo_OnRead;
+    sImu.regDevice.onWrite = ImuFifo_OnWrite;
+    Sim_I2c_AddRegDevice(&sImu.regDevice, LSM6DSM_ADDRESS);
+    I2c_InitMaster();
+
+    BENCH_CHECK(lsm6dsm_beginFifo(BENCH_IMU_ODR, 0));
+    BENCH_CHECK((sImu.regDevice.regs[LSM6DSM_FIFO_CTRL5] & 0x07) == LSM6DSM_STREAM_MODE);
+    BENCH_CHECK((sImu.regDevice.regs[LSM6DSM_FIFO_CTRL5] >> 3) == BENCH_IMU_ODR);
+    BENCH_CHECK(sImu.regDevice.regs[LSM6DSM_FIFO_CTRL3] == ((LSM6DSM_FIFO_GY_NO_DEC << 3) | LSM6DSM_FIFO_XL_NO_DEC));
+    sImu.start = Sim_GetTime();
+
+    while (popped < 2 * BENCH_IMU_PAIRS) {
+        Sim_Delay(BENCH_IMU_DRAIN_NS);
+        BENCH_CHECK(lsm6dsm_drainFifo() >= 0);
+        while (lsm6dsm_popSample(&sample)) {
+            int word = popped / 2 * LSM6DSM_FIFO_PATTERN_WORDS + (popped % 2) * 3;
+            BENCH_CHECK(sample.tag == ((popped % 2) ? LSM6DSM_TAG_ACCEL : LSM6DSM_TAG_GYRO));
+            BENCH_CHECK((sample.x == word) && (sample.y == word + 1) && (sample.z == word + 2));
+            popped++;
+        }
+    }
+    BENCH_CHECK(lsm6dsm_getDropCount() == 0);
+
+    NVIC_DisableIRQ(I2C0_IRQn);
+    Chip_I2C_DeInit(I2C0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Measures blocking I2C transfers in the #PROFILE_ID_I2C_TRANSFER scope, then lets the tag reader fetch that scope
+ * with a #MSG_ID_GETPROFILE command and checks it against the virtual time.
+ */
+static void ProfileScopes(void)
+{
+    static SIM_I2C_REGDEVICE_T adxl343;
+    uint8_t cmd[2 + sizeof(MSG_CMD_GETPROFILE_T)] = {MSG_ID_GETPROFILE, 0, PROFILE_ID_I2C_TRANSFER};
+    uint8_t response[MSG_RESPONSE_BUFFER_SIZE];
+    uint8_t reg = ADXL3XX_REG_DATAX0;
+    uint8_t data[6];
+
+    I2c_Init(&adxl343);
+    Profile_Init();
+    uint64_t start = Sim_GetCycles();
+    for (int n = 0; n < BENCH_PROFILE_TRANSFERS; n++) {
+        I2C_XFER_T xfer = {.slaveAddr = ADXL343_ADDRESS, .txBuff = &reg, .txSz = 1, .rxBuff = data, .rxSz = 6};
+        BENCH_CHECK(Chip_I2C_MasterTransfer(I2C0, &xfer) == I2C_STATUS_DONE);
+    }
+    uint64_t elapsed = Sim_GetCycles() - start;
+    NVIC_DisableIRQ(I2C0_IRQn);
+    Chip_I2C_DeInit(I2C0);
+
+    Chip_NFC_Init(NSS_NFC);
+    NDEFT2T_Init();
+    Msg_Init();
+    Msg_SetResponseCb(ResponseCb);
+    Sim_Nfc_SetField(true);
+    /* The measured scope, then one beyond the table. */
+    static const int scopes[2] = {PROFILE_ID_I2C_TRANSFER, PROFILE_SCOPE_COUNT};
+    for (int i = 0; i < 2; i++) {
+        int scope = scopes[i];
+        cmd[2] = (uint8_t)scope;
+        sMsgAvailable = false;
+        ReaderWriteCommand(cmd, sizeof(cmd));
+        BENCH_CHECK(sMsgAvailable);
+        HandleCommands();
+        int length = ReaderReadResponse(response);
+        const MSG_RESPONSE_GETPROFILE_T * pHeader = (const MSG_RESPONSE_GETPROFILE_T *)(response + 2);
+        BENCH_CHECK((response[0] == MSG_ID_GETPROFILE) && (pHeader->scope == scope));
+        BENCH_CHECK(pHeader->scopeCount == PROFILE_SCOPE_COUNT);
+        if (scope == PROFILE_SCOPE_COUNT) {
+            BENCH_CHECK((pHeader->result == MSG_ERR_INVALID_PARAMETER) && (pHeader->binCount == 0));
+            BENCH_CHECK(length == 2 + (int)sizeof(MSG_RESPONSE_GETPROFILE_T));
+            continue;
+        }
+        BENCH_CHECK((pHeader->result == MSG_OK) && (pHeader->binCount == PROFILE_HISTOGRAM_BINS));
+        BENCH_CHECK(length == 2 + (int)sizeof(MSG_RESPONSE_GETPROFILE_T) + PROFILE_HISTOGRAM_BINS * 2);
+        BENCH_CHECK(pHeader->count == BENCH_PROFILE_TRANSFERS);
+        BENCH_CHECK((pHeader->min > 0) && (pHeader->min <= pHeader->max) && (pHeader->totalHigh == 0));
+        BENCH_CHECK((pHeader->totalLow >= BENCH_PROFILE_TRANSFERS * pHeader->min) && (pHeader->totalLow <= elapsed));
+        int calls = 0;
+        for (int bin = 0; bin < PROFILE_HISTOGRAM_BINS; bin++) {
+            const uint8_t * pBin = response + 2 + sizeof(MSG_RESPONSE_GETPROFILE_T) + 2 * bin;
+            calls += pBin[0] | (pBin[1] << 8);
+        }
+        BENCH_CHECK(calls == BENCH_PROFILE_TRANSFERS);
+    }
+    Sim_Nfc_SetField(false);
+    NDEFT2T_DeInit();
+}
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Plays the debug probe: moves everything written to the trace channel to @c pCapture.
+ * @return The number of bytes moved.
+ */
+static int Trace_Read(uint8_t * pCapture)
+{
+    SEGGER_RTT_BUFFER_UP * pRing = &_SEGGER_RTT.aUp[TRACE_RTT_CHANNEL];
+    int n = 0;
+
+    while (pRing->RdOff != pRing->WrOff) {
+        pCapture[n++] = (uint8_t)pRing->pBuffer[pRing->RdOff];
+        pRing->RdOff = (pRing->RdOff + 1) % pRing->SizeOfBuffer;
+    }
+    return n;
+}
+
+/**
+ * Traces 3-axis samples at 400 Hz while the debug probe polls the trace channel, then decodes the capture and checks
+ * every record: a binary record is 11 bytes where the equivalent text line takes 30. Ends with a #LOG record.
+ */
+static void TraceAccel(void)
+{
+    static uint8_t capture[BENCH_TRACE_SAMPLES * (TRACE_HEADER_SIZE + 6) + TRACE_HEADER_SIZE];
+    int size = 0;
+
+    Chip_Clock_System_SetClockFreq(SYSTEMCLOCK);
+    Trace_Init();
+    Trace_Event(TRACE_EVENT_START);
+    for (int n = 1; n <= BENCH_TRACE_SAMPLES; n++) {
+        Sim_Delay(BENCH_TRACE_PERIOD_NS);
+        Trace_Event16x3(TRACE_EVENT_ACCEL, (uint16_t)n, (uint16_t)-n, (uint16_t)(2 * n));
+        if ((n * BENCH_TRACE_PERIOD_NS) % BENCH_TRACE_POLL_NS == 0) {
+            size += Trace_Read(capture + size);
+        }
+    }
+    size += Trace_Read(capture + size);
+    BENCH_CHECK(Trace_GetDropCount() == 0);
+    BENCH_CHECK(size == (int)sizeof(capture));
+
+    uint32_t previous = 0;
+    for (int offset = 0, n = 0; offset < size; n++) {
+        const uint8_t * pRecord = capture + offset;
+        uint32_t timestamp = (uint32_t)(pRecord[1] | (pRecord[2] << 8) | (pRecord[3] << 16) | ((uint32_t)pRecord[4] << 24));
+        BENCH_CHECK(timestamp >= previous);
+        BENCH_CHECK(timestamp - (uint32_t)(n * BENCH_TRACE_PERIOD_NS / 1000) <= 1);
+        previous = timestamp;
+        offset += TRACE_HEADER_SIZE;
+        if (n == 0) {
+            BENCH_CHECK(pRecord[0] == TRACE_EVENT_START);
+        }
+        else {
+            int16_t x = (int16_t)(pRecord[5] | (pRecord[6] << 8));
+            int16_t y = (int16_t)(pRecord[7] | (pRecord[8] << 8));
+            int16_t z = (int16_t)(pRecord[9] | (pRecord[10] << 8));
+            BENCH_CHECK(pRecord[0] == TRACE_EVENT_ACCEL);
+            BENCH_CHECK((x == n) && (y == -n) && (z == 2 * n));
+            offset += 6;
+        }
+    }
+
+    /* A LOG record only holds the offset of its format string, and the arguments. */
+    LOG("Traced %d samples, %u dropped", BENCH_TRACE_SAMPLES, -1);
+    BENCH_CHECK(Trace_Read(capture) == TRACE_HEADER_SIZE + 2 + 2 * 4);
+    BENCH_CHECK(capture[0] == TRACE_EVENT_LOG);
+    BENCH_CHECK(strcmp(__start_logstr + (capture[5] | (capture[6] << 8)), "Traced %d samples, %u dropped") == 0);
+    BENCH_CHECK((capture[7] | (capture[8] << 8)) == BENCH_TRACE_SAMPLES);
+    BENCH_CHECK((capture[11] & capture[12] & capture[13] & capture[14]) == 0xFF);
+    Chip_TIMER_DeInit(NSS_TIMER32_0, CLOCK_PERIPHERAL_32TIMER0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/** The times at which the run loop jobs ran, in ms. */
+static struct {
+    uint32_t samples[BENCH_RUNLOOP_SAMPLES];
+    int sampleCount;
+    uint32_t reports[BENCH_RUNLOOP_REPORTS];
+    int reportCount;
+} sRunLoop;
+
+/** Run loop job: reads one accelerometer sample. */
+static void RunLoop_Sample(void * pArg)
+{
+    int16_t x;
+    int16_t y;
+    int16_t z;
+
+    (void)pArg;
+    BENCH_CHECK(adxl343_getXYZ(&x, &y, &z));
+    BENCH_CHECK(sRunLoop.sampleCount < BENCH_RUNLOOP_SAMPLES);
+    sRunLoop.samples[sRunLoop.sampleCount++] = RunLoop_GetTime();
+}
+
+/** Run loop job: stands in for a periodic report. */
+static void RunLoop_Report(void * pArg)
+{
+    (void)pArg;
+    BENCH_CHECK(sRunLoop.reportCount < BENCH_RUNLOOP_REPORTS);
+    sRunLoop.reports[sRunLoop.reportCount++] = RunLoop_GetTime();
+}
+
+/** Run loop job: may never run. */
+static void RunLoop_Cancelled(void * pArg)
+{
+    (void)pArg;
+    BENCH_CHECK(false);
+}
+
+/**
+ * Samples the accelerometer at 10 Hz, first paced with busy waits, then by a periodic job of the run loop: the core
+ * must be active at least 10 times less. Then leaves a periodic job with a period of a few seconds alone, which must
+ * be met from Deep Sleep mode.
+ */
+static void RunLoop(void)
+{
+    static SIM_I2C_REGDEVICE_T adxl343;
+    int16_t x;
+    int16_t y;
+    int16_t z;
+
+    I2c_Init(&adxl343);
+    memset(&sRunLoop, 0, sizeof(sRunLoop));
+
+    uint64_t active = Sim_GetPower()->activeNs;
+    for (int n = 0; n < BENCH_RUNLOOP_SAMPLES; n++) {
+        BENCH_CHECK(adxl343_getXYZ(&x, &y, &z));
+        Chip_Clock_System_BusyWait_ms(BENCH_RUNLOOP_PERIOD_MS);
+    }
+    uint64_t busyWaitActive = Sim_GetPower()->activeNs - active;
+
+    RunLoop_Init();
+    active = Sim_GetPower()->activeNs;
+    BENCH_CHECK(RunLoop_AddPeriodicJob(RunLoop_Sample, NULL, BENCH_RUNLOOP_PERIOD_MS) >= 0);
+    RunLoop_CancelJob(RunLoop_AddOneShotJob(RunLoop_Cancelled, NULL, BENCH_RUNLOOP_PERIOD_MS / 2));
+    while (sRunLoop.sampleCount < BENCH_RUNLOOP_SAMPLES) {
+        RunLoop_Step();
+    }
+    uint64_t runLoopActive = Sim_GetPower()->activeNs - active;
+    for (int n = 0; n < BENCH_RUNLOOP_SAMPLES; n++) {
+        BENCH_CHECK(sRunLoop.samples[n] == (uint32_t)((n + 1) * BENCH_RUNLOOP_PERIOD_MS));
+    }
+    BENCH_CHECK(runLoopActive * 10 <= busyWaitActive);
+    BENCH_CHECK(Sim_GetPower()->deepSleepNs == 0);
+
+    /* The sampling job is removed by starting over. */
+    RunLoop_Init();
+    BENCH_CHECK(RunLoop_AddPeriodicJob(RunLoop_Report, NULL, BENCH_RUNLOOP_REPORT_MS) >= 0);
+    while (sRunLoop.reportCount < BENCH_RUNLOOP_REPORTS) {
+        RunLoop_Step();
+    }
+    for (int n = 0; n < BENCH_RUNLOOP_REPORTS; n++) {
+        BENCH_CHECK(sRunLoop.reports[n] == (uint32_t)((n + 1) * BENCH_RUNLOOP_REPORT_MS));
+    }
+    BENCH_CHECK(Sim_GetPower()->deepSleepNs > 0);
+    RunLoop_DeInit();
+    NVIC_DisableIRQ(I2C0_IRQn);
+    Chip_I2C_DeInit(I2C0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/** The progress of the scheduler benchmark. */
+static struct {
+    int ticks; /**< Number of accelerometer sample periods passed */
+    int count; /**< Number of accelerometer samples drained */
+    int commands; /**< Number of commands written by the tag reader */
+    int overtakes; /**< Number of sensor events dispatched before an NFC event that was posted earlier */
+    int reports;
+    uint64_t maxLatency; /**< Longest time from a watermark interrupt to its drain, in ns */
+} sSched;
+
+/** Event handler: drains the accelerometer FIFO. */
+static void Sched_Drain(void * pArg)
+{
+    static adxl343_sample_t samples[ADXL343_FIFO_SIZE];
+
+    (void)pArg;
+    if (Sim_GetTime() - sAccel.watermarkTime > sSched.maxLatency) {
+        sSched.maxLatency = Sim_GetTime() - sAccel.watermarkTime;
+    }
+    if (Sched_GetCount(BENCH_SCHED_PRIORITY_NFC) > 0) {
+        sSched.overtakes++;
+    }
+    int n = adxl343_readFifo(samples, ADXL343_FIFO_SIZE);
+    AccelFifo_UpdatePin();
+    Chip_GPIO_EnableInt(NSS_GPIO, 0, 1 << ACCEL_INT_PIN);
+    BENCH_CHECK(n >= BENCH_FIFO_WATERMARK);
+    for (int i = 0; i < n; i++) {
+        sSched.count++;
+        BENCH_CHECK((samples[i].x == sSched.count) && (samples[i].y == -sSched.count)
+                    && (samples[i].z == 2 * sSched.count));
+    }
+}
+
+/** Event handler: answers the commands written by the tag reader. */
+static void Sched_Commands(void * pArg)
+{
+    (void)pArg;
+    BENCH_CHECK(Sched_GetCount(BENCH_SCHED_PRIORITY_SENSOR) == 0);
+    HandleCommands();
+}
+
+/** Event handler: stands in for a periodic report, which has the lowest priority. */
+static void Sched_Report(void * pArg)
+{
+    (void)pArg;
+    BENCH_CHECK(Sched_GetCount(-1) == 0);
+    sSched.reports++;
+}
+
+/** Run loop job: hands the report over to the scheduler. */
+static void Sched_ReportJob(void * pArg)
+{
+    BENCH_CHECK(Sched_Post(Sched_Report, pArg, BENCH_SCHED_PRIORITY_REPORT));
+}
+
+/**
+ * The outside world, once per accelerometer sample period: every few periods, the tag reader checks the response to
+ * its previous command and writes the next one. The command is written first, so that when the watermark is reached
+ * in the same period, the sensor event is posted after the NFC event.
+ */
+static void Sched_World(void)
+{
+    uint8_t response[32];
+
+    sSched.ticks++;
+    if ((sSched.ticks % BENCH_SCHED_COMMAND_TICKS == 0)
+        && (sSched.commands * BENCH_SCHED_COMMAND_TICKS < BENCH_SCHED_SAMPLES)) {
+        static const uint8_t cmd[2] = {MSG_ID_GETVERSION, 0};
+        if (sSched.commands > 0) {
+            BENCH_CHECK(sResponseCount == sSched.commands);
+            BENCH_CHECK(ReaderReadResponse(response) > 2);
+            BENCH_CHECK(response[0] == MSG_ID_GETVERSION);
+        }
+        ReaderWriteCommand(cmd, sizeof(cmd));
+        sSched.commands++;
+    }
+    AccelFifo_UpdatePin();
+    Sim_SetTimedCb(sAccel.start + (uint64_t)(sSched.ticks + 1) * BENCH_FIFO_PERIOD_NS, Sched_World);
+}
+
+/**
+ * Combines the @c adxl_fifo and @c ndef_msg benchmarks and a periodic job: the interrupt handler and the NFC callback
+ * only post events, which are dispatched by priority from the main loop. The sensor events may never wait for a lower
+ * priority event, and the FIFO may not overflow.
+ */
+static void Scheduler(void)
+{
+    memset(&sAccel, 0, sizeof(sAccel));
+    memset(&sSched, 0, sizeof(sSched));
+    I2c_Init(&sAccel.regDevice);
+    sAccel.regDevice.onRead = AccelFifo_OnRead;
+    BENCH_CHECK(adxl343_begin());
+    BENCH_CHECK(adxl343_setDataRate(ADXL343_DATARATE_100_HZ));
+    BENCH_CHECK(adxl343_enableFifo(BENCH_FIFO_WATERMARK, ADXL343_INT1));
+
+    Chip_NFC_Init(NSS_NFC);
+    NDEFT2T_Init();
+    Msg_Init();
+    Msg_SetResponseCb(ResponseCb);
+    sResponseCount = 0;
+    Sim_Nfc_SetField(true);
+
+    RunLoop_Init();
+    Sched_Init();
+    sSchedPosting = true;
+    BENCH_CHECK(RunLoop_AddPeriodicJob(Sched_ReportJob, NULL, BENCH_SCHED_REPORT_MS) >= 0);
+    sAccel.start = Sim_GetTime();
+    Sim_SetTimedCb(sAccel.start + BENCH_FIFO_PERIOD_NS, Sched_World);
+
+    Chip_GPIO_SetPinDIRInput(NSS_GPIO, 0, ACCEL_INT_PIN);
+    Chip_GPIO_SetupPinInt(NSS_GPIO, 0, ACCEL_INT_PIN, GPIO_INT_ACTIVE_HIGH_LEVEL);
+    Chip_GPIO_EnableInt(NSS_GPIO, 0, 1 << ACCEL_INT_PIN);
+    NVIC_EnableIRQ(PIO0_IRQn);
+    while ((sSched.count < BENCH_SCHED_SAMPLES) || (sResponseCount < sSched.commands)) {
+        Sched_Step();
+    }
+    BENCH_CHECK(sAccel.overflows == 0);
+    BENCH_CHECK(sSched.maxLatency < (uint64_t)(ADXL343_FIFO_SIZE - BENCH_FIFO_WATERMARK) * BENCH_FIFO_PERIOD_NS);
+    BENCH_CHECK(sSched.overtakes > 0);
+    BENCH_CHECK(sSched.reports >= (int)(BENCH_SCHED_SAMPLES * BENCH_FIFO_PERIOD_NS / 1000000) / BENCH_SCHED_REPORT_MS - 1);
+    BENCH_CHECK(Sched_GetOverflowCount() == 0);
+    BENCH_CHECK(Sim_GetPower()->sleepNs > Sim_GetPower()->activeNs);
+
+    sSchedPosting = false;
+    Sim_SetTimedCb(0, NULL);
+    NVIC_DisableIRQ(PIO0_IRQn);
+    RunLoop_DeInit();
+    Sim_Nfc_SetField(false);
+    NDEFT2T_DeInit();
+    NVIC_DisableIRQ(I2C0_IRQn);
+    Chip_I2C_DeInit(I2C0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/** The accelerometer samples handed over from the I2C interrupt to the main loop. */
+static struct {
+    RINGBUF_T ring;
+    adxl343_sample_t data[BENCH_RINGBUF_CAPACITY];
+    I2C_XFER_T xfer;
+    uint8_t reg;
+    uint8_t raw[6];
+    int read; /**< Number of samples read under interrupt */
+} sRingBuf;
+
+/** Queues the read of the next sample. */
+static void RingBuf_Submit(void)
+{
+    sRingBuf.reg = ADXL3XX_REG_DATAX0;
+    sRingBuf.xfer = (I2C_XFER_T){.slaveAddr = ADXL343_ADDRESS, .txBuff = &sRingBuf.reg, .txSz = 1,
+                                 .rxBuff = sRingBuf.raw, .rxSz = sizeof(sRingBuf.raw)};
+    BENCH_CHECK(I2CQ_Submit(&sRingBuf.xfer));
+}
+
+/** Called under interrupt: the producer of the ring. Pushes the sample just read and reads the next one. */
+void Bench_I2cDoneCb(I2C_XFER_T * pXfer)
+{
+    if (pXfer == &sRingBuf.xfer) {
+        adxl343_sample_t sample;
+        BENCH_CHECK(pXfer->status == I2C_STATUS_DONE);
+        memcpy(&sample, sRingBuf.raw, sizeof(sample));
+        RingBuf_Push(&sRingBuf.ring, &sample, 1);
+        if (++sRingBuf.read < BENCH_RINGBUF_SAMPLES) {
+            RingBuf_Submit();
+        }
+    }
+}
+
+/**
+ * Reads the accelerometer back-to-back under interrupt, and processes the samples in batches in the main loop: each
+ * batch takes longer than a read, so several samples queue up meanwhile. Neither side disables interrupts to hand the
+ * samples over. Then checks the bulk operations around the wrap-around of the ring.
+ */
+static void RingBuffer(void)
+{
+    static SIM_I2C_REGDEVICE_T adxl343;
+    adxl343_sample_t batch[BENCH_RINGBUF_CAPACITY + 1];
+    int consumed = 0;
+    int batches = 0;
+    int maxBatch = 0;
+
+    memset(&sRingBuf, 0, sizeof(sRingBuf));
+    I2c_Init(&adxl343);
+    RingBuf_Init(&sRingBuf.ring, sRingBuf.data, sizeof(sRingBuf.data[0]), BENCH_RINGBUF_CAPACITY);
+    RingBuf_Submit();
+    while (consumed < BENCH_RINGBUF_SAMPLES) {
+        __disable_irq();
+        while (RingBuf_GetCount(&sRingBuf.ring) == 0) {
+            __WFI();
+            __enable_irq();
+            __disable_irq();
+        }
+        __enable_irq();
+
+        int n = RingBuf_Pop(&sRingBuf.ring, batch, BENCH_RINGBUF_CAPACITY);
+        batches++;
+        maxBatch = (n > maxBatch) ? n : maxBatch;
+        for (int i = 0; i < n; i++) {
+            consumed++;
+            BENCH_CHECK(((uint8_t)batch[i].x == (uint8_t)consumed) && (batch[i].y == batch[i].x)
+                        && (batch[i].z == batch[i].x));
+        }
+        Chip_Clock_System_BusyWait_us(BENCH_RINGBUF_WORK_US);
+    }
+    BENCH_CHECK(RingBuf_GetDropped(&sRingBuf.ring) == 0);
+    BENCH_CHECK((maxBatch > 1) && (batches * 2 < BENCH_RINGBUF_SAMPLES));
+    BENCH_CHECK(I2CQ_GetCount() == 0);
+
+    /* The producer is idle: fill the ring beyond its capacity, then let the elements wrap around. */
+    for (int i = 0; i <= BENCH_RINGBUF_CAPACITY; i++) {
+        batch[i] = (adxl343_sample_t){.x = (int16_t)i, .y = 0, .z = 0};
+    }
+    BENCH_CHECK(RingBuf_Push(&sRingBuf.ring, batch, BENCH_RINGBUF_CAPACITY + 1) == BENCH_RINGBUF_CAPACITY);
+    BENCH_CHECK(RingBuf_GetDropped(&sRingBuf.ring) == 1);
+    BENCH_CHECK((RingBuf_Pop(&sRingBuf.ring, batch, 3) == 3) && (batch[2].x == 2));
+    BENCH_CHECK(RingBuf_Push(&sRingBuf.ring, batch, 3) == 3);
+    BENCH_CHECK(RingBuf_Pop(&sRingBuf.ring, batch, BENCH_RINGBUF_CAPACITY + 1) == BENCH_RINGBUF_CAPACITY);
+    BENCH_CHECK((batch[0].x == 3) && (batch[BENCH_RINGBUF_CAPACITY - 4].x == BENCH_RINGBUF_CAPACITY - 1));
+    BENCH_CHECK((batch[BENCH_RINGBUF_CAPACITY - 3].x == 0) && (batch[BENCH_RINGBUF_CAPACITY - 1].x == 2));
+    BENCH_CHECK(RingBuf_GetCount(&sRingBuf.ring) == 0);
+
+    NVIC_DisableIRQ(I2C0_IRQn);
+    Chip_I2C_DeInit(I2C0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/** The kernels of the DSP benchmark. */
+typedef enum BENCH_DSP_E {
+    BENCH_DSP_MOVAVG,
+    BENCH_DSP_CIC,
+    BENCH_DSP_BIQUAD,
+    BENCH_DSP_FIR,
+    BENCH_DSP_SCALE,
+    BENCH_DSP_COUNT
+} BENCH_DSP_T;
+
+static const char * const sDspNames[BENCH_DSP_COUNT] = {"movavg", "cic", "biquad", "fir", "scale"};
+
+/** A second order Butterworth low-pass filter at 10 Hz for 100 Hz samples. */
+static const DSP_BIQUAD_COEFFS_T sDspLowPass[1] = {
+    {DSP_Q14(0.0675), DSP_Q14(0.1349), DSP_Q14(0.0675), DSP_Q14(-1.1430), DSP_Q14(0.4128)}
+};
+
+/** A low-pass filter with a triangular impulse response: the taps sum up to 1.0. */
+static const int16_t sDspTaps[BENCH_DSP_TAPS] = {
+    DSP_Q15(1 / 72.0), DSP_Q15(2 / 72.0), DSP_Q15(3 / 72.0), DSP_Q15(4 / 72.0), DSP_Q15(5 / 72.0),
+    DSP_Q15(6 / 72.0), DSP_Q15(7 / 72.0), DSP_Q15(8 / 72.0), DSP_Q15(8 / 72.0), DSP_Q15(7 / 72.0),
+    DSP_Q15(6 / 72.0), DSP_Q15(5 / 72.0), DSP_Q15(4 / 72.0), DSP_Q15(3 / 72.0), DSP_Q15(2 / 72.0),
+    DSP_Q15(1 / 72.0)
+};
+
+/**
+ * The float counterpart of each kernel, straight from the textbook, as the application would write it with
+ * lsm6dsm_from_fs2g_to_mg. The coefficients are the quantized ones of the fixed-point kernels: the comparison then
+ * only shows the error of the integer arithmetic.
+ * @return The number of output samples.
+ */
+static int DspFloat(BENCH_DSP_T kernel, const int16_t * pIn, float * pOut, int count)
+{
+    int outCount = count;
+
+    switch (kernel) {
+        case BENCH_DSP_MOVAVG: {
+            for (int n = 0; n < count; n++) {
+                float sum = 0;
+                for (int k = 0; (k < 16) && (k <= n); k++) {
+                    sum += pIn[n - k];
+                }
+                pOut[n] = sum / 16;
+            }
+            break;
+        }
+        case BENCH_DSP_CIC: {
+            /* Order 2, decimation by 4: twice a moving sum over 4 samples, then every 4th sample. */
+            static float sums[BENCH_DSP_SAMPLES];
+            for (int n = 0; n < count; n++) {
+                sums[n] = 0;
+                for (int k = 0; (k < 4) && (k <= n); k++) {
+                    sums[n] += pIn[n - k];
+                }
+            }
+            outCount = 0;
+            for (int n = 3; n < count; n += 4) {
+                float sum = 0;
+                for (int k = 0; (k < 4) && (k <= n); k++) {
+                    sum += sums[n - k];
+                }
+                pOut[outCount++] = sum / 16;
+            }
+            break;
+        }
+        case BENCH_DSP_BIQUAD: {
+            const DSP_BIQUAD_COEFFS_T * pC = &sDspLowPass[0];
+            float x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+            for (int n = 0; n < count; n++) {
+                float y0 = (pC->b0 * (float)pIn[n] + pC->b1 * x1 + pC->b2 * x2 - pC->a1 * y1 - pC->a2 * y2) / 16384;
+                x2 = x1;
+                x1 = pIn[n];
+                y2 = y1;
+                y1 = y0;
+                pOut[n] = y0;
+            }
+            break;
+        }
+        case BENCH_DSP_FIR: {
+            for (int n = 0; n < count; n++) {
+                float sum = 0;
+                for (int k = 0; (k < BENCH_DSP_TAPS) && (k <= n); k++) {
+                    sum += sDspTaps[k] / 32768.0f * pIn[n - k];
+                }
+                pOut[n] = sum;
+            }
+            break;
+        }
+        default:
+            for (int n = 0; n < count; n++) {
+                pOut[n] = lsm6dsm_from_fs2g_to_mg(pIn[n]);
+            }
+            break;
+    }
+    return outCount;
+}
+
+/** Runs one fixed-point kernel from its initial state. @return The number of output samples. */
+static int DspFixed(BENCH_DSP_T kernel, const int16_t * pIn, int32_t * pOut, int count)
+{
+    static int16_t out[BENCH_DSP_SAMPLES];
+    static int16_t history[BENCH_DSP_TAPS];
+    int outCount = count;
+
+    switch (kernel) {
+        case BENCH_DSP_MOVAVG: {
+            DSP_MOVAVG_T movAvg;
+            Dsp_MovAvg_Init(&movAvg, history, 4);
+            Dsp_MovAvg(&movAvg, pIn, out, count);
+            break;
+        }
+        case BENCH_DSP_CIC: {
+            DSP_CIC_T cic;
+            Dsp_Cic_Init(&cic, 2, 2);
+            outCount = Dsp_Cic(&cic, pIn, count, out);
+            break;
+        }
+        case BENCH_DSP_BIQUAD: {
+            DSP_BIQUAD_STATE_T state[1];
+            Dsp_Biquad_Init(state, 1);
+            Dsp_Biquad(sDspLowPass, state, 1, pIn, out, count);
+            break;
+        }
+        case BENCH_DSP_FIR: {
+            DSP_FIR_T fir;
+            Dsp_Fir_Init(&fir, sDspTaps, history, BENCH_DSP_TAPS);
+            Dsp_Fir(&fir, pIn, out, count);
+            break;
+        }
+        default:
+            for (int n = 0; n < count; n++) {
+                pOut[n] = Dsp_Scale(pIn[n], DSP_Q16(0.061));
+            }
+            return count;
+    }
+    for (int n = 0; n < outCount; n++) {
+        pOut[n] = out[n];
+    }
+    return outCount;
+}
+
+/**
+ * Conditions a block of accelerometer samples with each fixed-point kernel and with its float counterpart. Each
+ * fixed-point result must lie within 1 LSB of the float result, also for the recursive biquad. Prints per kernel:
+ *  @code
+ *      bench=dsp kernel=fir samples=... fixed_host_ns=... float_host_ns=... max_error=...
+ *  @endcode
+ * The host has an FPU: only the errors carry over to the target, where the float code runs in soft-float.
+ * Then checks the square root and the unit conversions over their whole input range.
+ */
+static void DspKernels(void)
+{
+    static int16_t samples[BENCH_DSP_SAMPLES];
+    static int32_t fixed[BENCH_DSP_SAMPLES];
+    static float reference[BENCH_DSP_SAMPLES];
+    uint32_t random = 1;
+
+    /* Gravity, a 1 Hz movement, a 20 Hz vibration and noise, at 100 Hz and 0.061 mg/LSB. */
+    for (int n = 0; n < BENCH_DSP_SAMPLES; n++) {
+        random = random * 1103515245 + 12345;
+        int slow = abs(n % 100 - 50) * 400 - 10000;
+        int fast = (n % 5 < 3) ? 1500 : -2250;
+        samples[n] = (int16_t)(16393 + slow + fast + (int)((random >> 16) % 201) - 100);
+    }
+
+    for (int kernel = 0; kernel < BENCH_DSP_COUNT; kernel++) {
+        int count = 0;
+        int referenceCount = 0;
+        uint64_t start = HostNs();
+        for (int round = 0; round < BENCH_DSP_ROUNDS; round++) {
+            count = DspFixed((BENCH_DSP_T)kernel, samples, fixed, BENCH_DSP_SAMPLES);
+        }
+        uint64_t fixedNs = HostNs() - start;
+        start = HostNs();
+        for (int round = 0; round < BENCH_DSP_ROUNDS; round++) {
+            referenceCount = DspFloat((BENCH_DSP_T)kernel, samples, reference, BENCH_DSP_SAMPLES);
+        }
+        uint64_t floatNs = HostNs() - start;
+
+        BENCH_CHECK(count == referenceCount);
+        float maxError = 0;
+        for (int n = 0; n < count; n++) {
+            float error = fabsf((float)fixed[n] - reference[n]);
+            maxError = (error > maxError) ? error : maxError;
+        }
+        printf("bench=dsp kernel=%s samples=%d fixed_host_ns=%llu float_host_ns=%llu max_error=%.2f\n",
+               sDspNames[kernel], BENCH_DSP_SAMPLES * BENCH_DSP_ROUNDS, (unsigned long long)fixedNs,
+               (unsigned long long)floatNs, (double)maxError);
+        BENCH_CHECK(maxError <= 1.0f);
+    }
+
+    /* The decimator keeps a constant input, as it compensates its gain. */
+    DSP_CIC_T cic;
+    int16_t constant[16];
+    for (int n = 0; n < 16; n++) {
+        constant[n] = INT16_MIN;
+    }
+    Dsp_Cic_Init(&cic, 2, 3);
+    BENCH_CHECK((Dsp_Cic(&cic, constant, 16, constant) == 2) && (constant[1] == INT16_MIN));
+
+    for (uint32_t value = 0; value < 0xFFFF0000; value += 65521) {
+        uint64_t root = Dsp_Sqrt(value);
+        BENCH_CHECK((root * root <= value) && ((root + 1) * (root + 1) > value));
+    }
+    BENCH_CHECK(Dsp_Sqrt(0xFFFFFFFF) == 0xFFFF);
+    BENCH_CHECK(Dsp_Magnitude(INT16_MIN, INT16_MIN, INT16_MIN) == 56755);
+    BENCH_CHECK(Dsp_Magnitude(0, 181, 181) == 255);
+
+    for (int32_t lsb = INT16_MIN; lsb <= INT16_MAX; lsb++) {
+        int16_t value = (int16_t)lsb;
+        BENCH_CHECK(fabsf((float)Dsp_Scale(value, DSP_Q16(0.488)) - lsm6dsm_from_fs16g_to_mg(value)) <= 1.0f);
+        BENCH_CHECK(fabsf((float)Dsp_Scale(value, DSP_Q16(70.0)) - lsm6dsm_from_fs2000dps_to_mdps(value)) <= 1.0f);
+        BENCH_CHECK(fabsf((float)(Dsp_Scale(value, DSP_Q16(1000 / 256.0)) + 25000)
+                          - 1000 * lsm6dsm_from_lsb_to_celsius(value)) <= 1.0f);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+/** Names of the profiling scopes in the output, indexed by #PROFILE_ID_T. */
+static const char * const sProfileNames[PROFILE_SCOPE_COUNT] = {
+    [PROFILE_ID_STORAGE_FLUSH] = "storage_flush",
+    [PROFILE_ID_STORAGE_MOVE] = "storage_move",
+    [PROFILE_ID_COMPRESS_ENCODE] = "compress_encode",
+    [PROFILE_ID_NDEFT2T_COMMIT] = "ndeft2t_commit",
+    [PROFILE_ID_I2C_TRANSFER] = "i2c_transfer"
+};
+
+/** Writes one line per profiling scope that was entered. */
+static void PrintProfile(FILE * stream, const char * prefix)
+{
+    for (int id = 0; id < PROFILE_SCOPE_COUNT; id++) {
+        const PROFILE_SCOPE_T * pScope = Profile_GetScope(id);
+        if (pScope->count > 0) {
+            fprintf(stream, "%s scope=%s count=%lu min_cycles=%lu max_cycles=%lu total_cycles=%llu\n", prefix,
+                    sProfileNames[id], (unsigned long)pScope->count, (unsigned long)pScope->min,
+                    (unsigned long)pScope->max, (unsigned long long)pScope->total);
+        }
+    }
+}
+
+/** @return The processor time used by the host, in ns */
+static uint64_t HostNs(void)
+{
+    return (uint64_t)clock() * 1000000000ULL / CLOCKS_PER_SEC;
+}
+
+static void Run(const BENCH_T * pBench)
+{
+    char prefix[128];
+
+    Sim_Init();
+    Profile_Init();
+    uint64_t hostStart = HostNs();
+    pBench->run();
+    uint64_t hostNs = HostNs() - hostStart;
+
+    snprintf(prefix, sizeof(prefix), "bench=%s time_ns=%llu host_ns=%llu", pBench->name,
+             (unsigned long long)Sim_GetTime(), (unsigned long long)hostNs);
+    Sim_PrintStats(stdout, prefix);
+    PrintProfile(stdout, prefix);
+    fflush(stdout);
+}
+
+int main(int argc, char * argv[])
+{
+    int run = 0;
+
+    for (size_t i = 0; i < sizeof(sBenches) / sizeof(sBenches[0]); i++) {
+        bool selected = (argc <= 1);
+        for (int arg = 1; arg < argc; arg++) {
+            selected |= (strcmp(argv[arg], sBenches[i].name) == 0);
+        }
+        if (selected) {
+            Run(&sBenches[i]);
+            run++;
+        }
+    }
+    if (run == 0) {
+        fprintf(stderr, "bench: no benchmark matches\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/** @} */
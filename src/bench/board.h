@@ -0,0 +1,20 @@
+#ifndef __BOARD_H_
+#define __BOARD_H_
+
+/**
+ * @defgroup BENCH_BOARD bench: board and diversity settings of the host-native benchmarks
+ * @ingroup SIM
+ * Plays the role of the board library for the benchmark executable, which only exists in the @ref SIM "simulation
+ * build". The EEPROM and FLASH layout in @c app_sel.h mirrors the one of the temperature logger demo application, so
+ * that the measured numbers translate to a real application.
+ * @{
+ */
+
+#define SYSTEMCLOCK 1000000
+#define I2C_BITRATE 100000
+#define ACCEL_INT_PIN 2 /* As in the application board: ADXL343 INT1 */
+
+#include "chip.h"
+
+/** @} */
+#endif
@@ -0,0 +1,17 @@
+#ifndef __APP_SEL_H_
+#define __APP_SEL_H_
+
+/**
+ * @addtogroup BENCH_COMPRESS_BOARD
+ * The compress diversity settings are deliberately absent: each benchmark executable gets them as compiler flags, see
+ * meson.build. The storage settings determine the block size, and match those in @c src/bench/app_sel.h.
+ * @{
+ */
+
+/* Diversities tweaking the storage module. */
+#define STORAGE_TYPE int16_t
+#define STORAGE_BITSIZE 11
+#define STORAGE_SIGNED 1
+
+/** @} */
+#endif
@@ -0,0 +1,312 @@
+#define _GNU_SOURCE /* ucontext */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+#include "board.h"
+#include "compress/compress.h"
+#include "storage/storage_dft.h"
+#if COMPRESS_CODEC == COMPRESS_CODEC_HEATSHRINK
+    #include "compress/heatshrink/heatshrink_encoder.h"
+    #include "compress/heatshrink/heatshrink_decoder.h"
+#endif
+
+/**
+ * @defgroup BENCH_COMPRESS bench_compress: Host-native benchmark of the compress mod over sensor traces
+ * @ingroup SIM
+ * The compress diversity settings are fixed at compile time, so there is one executable per configuration: see
+ * @c meson.build for the list. Each one compresses and decompresses a corpus of traces, cut in blocks of
+ * #STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES as the storage module hands them over, and prints one line per trace:
+ *  @code
+ *      bench=compress config=... trace=... blocks=... raw_bytes=... compressed_bytes=... ratio=... ...
+ *  @endcode
+ * - @c ratio: compressed size divided by raw size. Blocks that do not compress count at their raw size, as the
+ *  storage module then stores them uncompressed; @c uncompressed_blocks counts them.
+ * - @c encode_bytes_per_s, @c decode_bytes_per_s: raw bytes processed per second of host processor time. All blocks
+ *  are encoded, as the storage module tries to compress each block; only the blocks that compressed are decoded.
+ * - @c encode_stack, @c decode_stack: peak stack use of #Compress_Encode and #Compress_Decode in bytes, measured by
+ *  running them on a painted stack of their own. These are host numbers: compare them between configurations.
+ * - The decode fields read @c n/a when no block of the trace compressed.
+ * - @c encode_workarea, @c decode_workarea: the part of that stack taken by the codec state, including its buffers.
+ * A failed round trip aborts the executable with a non-zero exit code.
+ *
+ * The built-in corpus holds synthetic traces mimicking the temperature logger and an ADXL343 at rest and in motion.
+ * Recorded traces can be added: @c bench_compress_<config> [file...] - each file holds 16-bit little endian samples,
+ * truncated to #STORAGE_BITSIZE bits.
+ * @{
+ */
+
+/* ------------------------------------------------------------------------- */
+
+/** Set by meson.build: the name of the configuration, as printed. */
+#ifndef BENCH_COMPRESS_CONFIG
+    #define BENCH_COMPRESS_CONFIG "default"
+#endif
+
+/** Number of blocks in each built-in trace. */
+#define BENCH_BLOCKS 16
+
+/** Maximum number of blocks taken from a recorded trace. */
+#define BENCH_MAX_BLOCKS 256
+
+/** Number of times each block is compressed and decompressed, to get a measurable processor time. */
+#define BENCH_ROUNDS 20
+
+/** Size of the stack the codec runs on while measuring its stack use. */
+#define BENCH_STACK_SIZE (64 * 1024)
+
+/** The value the stack is painted with. */
+#define BENCH_STACK_PAINT 0xA5
+
+/** The value of a sample of one trace, given its index. */
+typedef int16_t (*pTraceSample_t)(int n);
+
+/* ------------------------------------------------------------------------- */
+
+static void Encode(void);
+static void Decode(void);
+
+static uint8_t sRaw[BENCH_MAX_BLOCKS][STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES];
+static uint8_t sEncoded[STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES];
+static uint8_t sDecoded[STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES];
+static int sBlock; /**< The block in @c sRaw given to #Encode */
+static int sEncodedLength; /**< Output of #Encode, input of #Decode */
+static int sDecodedLength; /**< Output of #Decode */
+
+static uint8_t sStack[BENCH_STACK_SIZE] __attribute__((aligned (16)));
+static ucontext_t sMainContext;
+static ucontext_t sCodecContext;
+
+/* ------------------------------------------------------------------------- */
+
+/** A pseudo random number in the range [-range, range], reproducible over runs and hosts. */
+static int Noise(int n, int range)
+{
+    uint32_t x = (uint32_t)n * 2654435761U;
+    x ^= x >> 15;
+    x *= 2246822519U;
+    x ^= x >> 13;
+    return (int)(x % (uint32_t)(2 * range + 1)) - range;
+}
+
+/** A triangle wave between -amplitude and amplitude. */
+static int Triangle(int n, int period, int amplitude)
+{
+    int phase = n % period;
+    int half = period / 2;
+    int rising = (phase < half) ? phase : period - phase;
+    return (4 * amplitude * rising) / period - amplitude;
+}
+
+/**
+ * The temperature logger: a sample each 10 minutes, in tenths of a degree. A day/night cycle of 6 degrees around 4
+ * degrees, noise of 0.1 degree, and now and then a door opened for an hour.
+ */
+static int16_t Temperature(int n)
+{
+    int door = ((n % 500) < 6) ? 25 : 0;
+    return (int16_t)(40 + Triangle(n, 144, 30) + Noise(n, 1) + door);
+}
+
+/**
+ * An ADXL343 at rest, full resolution at +-2 g: 256 LSB per g. X, Y and Z interleaved, as a 3-axis log stores them.
+ * Only noise of a few LSB on top of gravity.
+ */
+static int16_t AccelRest(int n)
+{
+    static const int16_t gravity[3] = {4, -9, 256};
+    return (int16_t)(gravity[n % 3] + Noise(n, 3));
+}
+
+/** An ADXL343 on a machine running half of the time: a vibration of about 0.2 g on all axes, X, Y and Z interleaved. */
+static int16_t AccelMotion(int n)
+{
+    static const int16_t gravity[3] = {4, -9, 256};
+    int sample = n / 3;
+    int running = ((sample / 200) % 2) ? 1 : 0;
+    int vibration = running * Triangle(sample + 3 * (n % 3), 10, 50 - 10 * (n % 3));
+    return (int16_t)(gravity[n % 3] + vibration + Noise(n, 3 + running * 5));
+}
+
+/* ------------------------------------------------------------------------- */
+
+/** Packs a sample in a block as the storage module does: #STORAGE_BITSIZE bits, LSBit first, without padding. */
+static void PackSample(uint8_t * pBlock, int index, int16_t sample)
+{
+    uint32_t value = (uint32_t)sample & ((1U << STORAGE_BITSIZE) - 1);
+    int bit = index * STORAGE_BITSIZE;
+
+    for (int i = 0; i < STORAGE_BITSIZE; i++) {
+        pBlock[(bit + i) / 8] |= (uint8_t)(((value >> i) & 1) << ((bit + i) % 8));
+    }
+}
+
+/** Fills @c sRaw with @c blocks blocks of generated samples. */
+static void Generate(pTraceSample_t sample, int blocks)
+{
+    memset(sRaw, 0, sizeof(sRaw));
+    for (int b = 0; b < blocks; b++) {
+        for (int i = 0; i < STORAGE_BLOCK_SIZE_IN_SAMPLES; i++) {
+            PackSample(sRaw[b], i, sample(b * STORAGE_BLOCK_SIZE_IN_SAMPLES + i));
+        }
+    }
+}
+
+/** Fills @c sRaw with the samples of a recorded trace. @return The number of complete blocks, or -1 on error. */
+static int Load(const char * path)
+{
+    FILE * pFile = fopen(path, "rb");
+    uint8_t bytes[2];
+    int count = 0;
+
+    if (pFile == NULL) {
+        return -1;
+    }
+    memset(sRaw, 0, sizeof(sRaw));
+    while ((count < BENCH_MAX_BLOCKS * STORAGE_BLOCK_SIZE_IN_SAMPLES) && (fread(bytes, 1, 2, pFile) == 2)) {
+        int16_t sample = (int16_t)(bytes[0] | (bytes[1] << 8));
+        PackSample(sRaw[count / STORAGE_BLOCK_SIZE_IN_SAMPLES], count % STORAGE_BLOCK_SIZE_IN_SAMPLES, sample);
+        count++;
+    }
+    fclose(pFile);
+    return count / STORAGE_BLOCK_SIZE_IN_SAMPLES;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void Encode(void)
+{
+    sEncodedLength = Compress_Encode(sRaw[sBlock], STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES, sEncoded,
+                                     STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+}
+
+static void Decode(void)
+{
+    sDecodedLength = Compress_Decode(sEncoded, sEncodedLength, sDecoded, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+}
+
+/** Runs @c fn on a painted stack of its own. @return The number of bytes of that stack that were touched. */
+static int MeasureStack(void (*fn)(void))
+{
+    int untouched = 0;
+
+    fn(); /* Once on the normal stack: the dynamic linker resolving library functions must not be measured. */
+    memset(sStack, BENCH_STACK_PAINT, sizeof(sStack));
+    getcontext(&sCodecContext);
+    sCodecContext.uc_stack.ss_sp = sStack;
+    sCodecContext.uc_stack.ss_size = sizeof(sStack);
+    sCodecContext.uc_link = &sMainContext;
+    makecontext(&sCodecContext, fn, 0);
+    swapcontext(&sMainContext, &sCodecContext);
+
+    /* The stack grows down: the bytes at the lowest addresses are touched last. */
+    while ((untouched < BENCH_STACK_SIZE) && (sStack[untouched] == BENCH_STACK_PAINT)) {
+        untouched++;
+    }
+    return BENCH_STACK_SIZE - untouched;
+}
+
+static uint64_t HostNs(void)
+{
+    return (uint64_t)clock() * 1000000000ULL / CLOCKS_PER_SEC;
+}
+
+/** Compresses and decompresses @c blocks blocks in @c sRaw, verifies the round trip and prints the results. */
+static bool Run(const char * name, int blocks)
+{
+    int compressed = 0;
+    int uncompressedBlocks = 0;
+    int encodeStack = 0;
+    int decodeStack = 0;
+    uint64_t encodeNs = 0;
+    uint64_t decodeNs = 0;
+    int raw = blocks * STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES;
+    char decodeSpeed[24] = "n/a";
+    char decodeStackText[16] = "n/a";
+
+    for (sBlock = 0; sBlock < blocks; sBlock++) {
+        /* Encoding runs for each block, also when its output is not used: time it for each block. */
+        int stack = MeasureStack(Encode);
+        encodeStack = (stack > encodeStack) ? stack : encodeStack;
+        uint64_t start = HostNs();
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            Encode();
+        }
+        encodeNs += HostNs() - start;
+        if (sEncodedLength == 0) {
+            compressed += STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES;
+            uncompressedBlocks++;
+            continue;
+        }
+        compressed += sEncodedLength;
+
+        stack = MeasureStack(Decode);
+        decodeStack = (stack > decodeStack) ? stack : decodeStack;
+        if ((sDecodedLength != STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES)
+                || (memcmp(sDecoded, sRaw[sBlock], STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES) != 0)) {
+            fprintf(stderr, "bench_compress: %s: block %d does not survive the round trip\n", name, sBlock);
+            return false;
+        }
+
+        start = HostNs();
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            Decode();
+        }
+        decodeNs += HostNs() - start;
+    }
+
+    /* Only the blocks that compressed are decoded: without any, there is nothing to report on decoding. */
+    int encoded = blocks * STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES * BENCH_ROUNDS;
+    int decoded = (blocks - uncompressedBlocks) * STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES * BENCH_ROUNDS;
+    if (decoded > 0) {
+        snprintf(decodeSpeed, sizeof(decodeSpeed), "%llu",
+                 decodeNs ? (unsigned long long)(decoded * 1000000000ULL / decodeNs) : 0ULL);
+        snprintf(decodeStackText, sizeof(decodeStackText), "%d", decodeStack);
+    }
+#if COMPRESS_CODEC == COMPRESS_CODEC_HEATSHRINK
+    int encodeWorkarea = (int)sizeof(heatshrink_encoder);
+    int decodeWorkarea = (int)sizeof(heatshrink_decoder);
+#else
+    int encodeWorkarea = 0;
+    int decodeWorkarea = 0;
+#endif
+    printf("bench=compress config=%s trace=%s blocks=%d raw_bytes=%d compressed_bytes=%d ratio=%.3f"
+           " uncompressed_blocks=%d encode_bytes_per_s=%llu decode_bytes_per_s=%s encode_stack=%d decode_stack=%s"
+           " encode_workarea=%d decode_workarea=%d\n",
+           BENCH_COMPRESS_CONFIG, name, blocks, raw, compressed, (double)compressed / raw, uncompressedBlocks,
+           encodeNs ? (unsigned long long)(encoded * 1000000000ULL / encodeNs) : 0ULL, decodeSpeed,
+           encodeStack, decodeStackText, encodeWorkarea, decodeWorkarea);
+    return true;
+}
+
+int main(int argc, char * argv[])
+{
+    static const struct {
+        const char * name;
+        pTraceSample_t sample;
+    } traces[] = {
+        {"temperature", Temperature},
+        {"adxl343_rest", AccelRest},
+        {"adxl343_motion", AccelMotion}
+    };
+    bool success = true;
+
+    for (size_t i = 0; i < sizeof(traces) / sizeof(traces[0]); i++) {
+        Generate(traces[i].sample, BENCH_BLOCKS);
+        success &= Run(traces[i].name, BENCH_BLOCKS);
+    }
+    for (int arg = 1; arg < argc; arg++) {
+        int blocks = Load(argv[arg]);
+        if (blocks <= 0) {
+            fprintf(stderr, "bench_compress: %s: cannot read a full block of samples\n", argv[arg]);
+            success = false;
+        }
+        else {
+            success &= Run(argv[arg], blocks);
+        }
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/** @} */
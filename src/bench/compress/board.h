@@ -0,0 +1,17 @@
+#ifndef __BOARD_H_
+#define __BOARD_H_
+
+/**
+ * @defgroup BENCH_COMPRESS_BOARD bench_compress: board and diversity settings of the compression benchmark
+ * @ingroup SIM
+ * Plays the role of the board library for the compression benchmark executables. Only the compress mod is linked in:
+ * no peripheral is simulated.
+ * @{
+ */
+
+#define SYSTEMCLOCK 1000000
+
+#include "chip.h"
+
+/** @} */
+#endif
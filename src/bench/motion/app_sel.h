@@ -0,0 +1,29 @@
+#ifndef __APP_SEL_H_
+#define __APP_SEL_H_
+
+/**
+ * @addtogroup BENCH_MOTION_BOARD
+ * The event and storage modules are set up as in @c src/application/board.h: the storage module stores one
+ * #motion_record_t per window. The FLASH region matches the one in @c src/bench/app_sel.h.
+ * @{
+ */
+
+#include "motion_record.h"
+
+/* Diversities tweaking the event module. */
+#define EVENT_EEPROM_FIRST_ROW 2
+#define EVENT_EEPROM_LAST_ROW 20
+
+/* Diversities tweaking the storage module. */
+#define STORAGE_TYPE motion_record_t
+#define STORAGE_FIELD_COUNT MOTION_RECORD_FIELD_COUNT
+#define STORAGE_FIELD_TYPE int16_t
+#define STORAGE_FIELD_BITSIZES MOTION_RECORD_BITSIZES
+#define STORAGE_BITSIZE MOTION_RECORD_BITSIZE
+#define STORAGE_SIGNED 1
+#define STORAGE_EEPROM_FIRST_ROW 21
+#define STORAGE_EEPROM_LAST_ROW (EEPROM_NR_OF_RW_ROWS - 1)
+#define STORAGE_FLASH_FIRST_PAGE 128 /**< There is no linker script: the first 8 kB are assumed to hold the program. */
+
+/** @} */
+#endif
@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "board.h"
+#include "sim.h"
+#include "event/event.h"
+#include "storage/storage.h"
+#include "motion.h"
+
+/**
+ * @defgroup BENCH_MOTION bench_motion: Host-native benchmark of the motion feature engine
+ * @ingroup SIM
+ * Feeds phases of rest, vibration, shake, shock and tilt to the feature engine of the application, with the storage
+ * module set up as in the application: one #motion_record_t per window. Prints one line:
+ *  @code
+ *      bench=motion windows=... samples=... sample_bits=... scalar_bits=... record_bits=... reduction=...
+ *  @endcode
+ * - @c sample_bits: the size of the accelerometer samples, at 10 bits per axis.
+ * - @c scalar_bits: the size of the features when each is stored as a separate 11-bit sample.
+ * - @c record_bits: the size of the features as stored: a bit size per field of the record.
+ * - @c reduction: @c sample_bits divided by @c record_bits.
+ * Each condition must raise its event exactly once, and each window must be stored as one record that reads back as
+ * computed. Otherwise, or when the reduction is less than #BENCH_MIN_REDUCTION, the executable aborts with a non-zero
+ * exit code.
+ * @{
+ */
+
+/* ------------------------------------------------------------------------- */
+
+/** Number of windows of each phase of movement. */
+#define BENCH_MOTION_WINDOWS 4
+
+/** Bits of one accelerometer sample: three axes of 10 bits in the +/-2 g range. */
+#define BENCH_SAMPLE_BITSIZE (3 * 10)
+
+/** The bit size of a feature when stored as a separate sample, as a scalar configuration of the storage module. */
+#define BENCH_SCALAR_BITSIZE 11
+
+/** The least reduction of the stored size, compared to storing the samples. */
+#define BENCH_MIN_REDUCTION 10
+
+/** Aborts the executable when @c expr is false, regardless of @c DEBUG. */
+#define BENCH_CHECK(expr) do { if (expr) {} else { Sim_AssertFailed(__FILE__, __LINE__); } } while (0)
+
+/* ------------------------------------------------------------------------- */
+
+/** The phases of movement, in order. */
+typedef enum BENCH_MOTION_E {
+    BENCH_MOTION_REST,
+    BENCH_MOTION_VIBRATION,
+    BENCH_MOTION_REST_AGAIN,
+    BENCH_MOTION_SHAKE,
+    BENCH_MOTION_SHOCK,
+    BENCH_MOTION_TILT,
+    BENCH_MOTION_COUNT
+} BENCH_MOTION_T;
+
+/** Counts the events stored per tag. */
+static int sMotionEvents[MOTION_EVENT_TILT + 1];
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Sample @c n of a phase, in LSB at 256 LSB/g. At rest, gravity lies along Z with a little noise; a vibration adds
+ * +/-20 LSB at 25 Hz, a shake 400 LSB peak-to-peak at 1.6 Hz along X, a shock a single 2 g spike, and a tilt turns
+ * gravity by 45 degrees towards Y.
+ */
+static adxl343_sample_t MotionSample(BENCH_MOTION_T phase, int n)
+{
+    adxl343_sample_t sample = {.x = (int16_t)(n % 3 - 1), .y = (int16_t)(n % 5 / 4), .z = 256};
+
+    switch (phase) {
+        case BENCH_MOTION_VIBRATION:
+            sample.z = (int16_t)(sample.z + ((n / 2) % 2 ? 20 : -20));
+            break;
+        case BENCH_MOTION_SHAKE:
+            sample.x = (int16_t)((n % 64 < 32) ? -200 + 25 * (n % 32) / 2 : 200 - 25 * (n % 32) / 2);
+            break;
+        case BENCH_MOTION_SHOCK:
+            sample.x = (int16_t)((n == MOTION_WINDOW_SIZE + 10) ? 512 : sample.x);
+            break;
+        case BENCH_MOTION_TILT:
+            sample.y = 181;
+            sample.z = 181;
+            break;
+        default:
+            break;
+    }
+    return sample;
+}
+
+static bool Motion_EventCb(uint8_t tag, int offset, uint8_t len, unsigned int index, uint32_t timestamp, uint32_t context)
+{
+    (void)offset;
+    (void)index;
+    (void)timestamp;
+    (void)context;
+    BENCH_CHECK((tag >= MOTION_EVENT_SHOCK) && (tag <= MOTION_EVENT_TILT) && (len == sizeof(uint16_t)));
+    sMotionEvents[tag]++;
+    return true;
+}
+
+/** Whether a record read back holds the features of a window, as far as they fit their fields. */
+static bool Equal(const motion_record_t * pRecord, const motion_features_t * pFeatures)
+{
+    bool equal = (pRecord->shocks == pFeatures->shocks);
+    for (int axis = 0; axis < 3; axis++) {
+        equal = equal && (pRecord->mean[axis] == pFeatures->mean[axis]) && (pRecord->rms[axis] == pFeatures->rms[axis])
+                && (pRecord->peakToPeak[axis] == pFeatures->peakToPeak[axis])
+                && (pRecord->crossings[axis] == pFeatures->crossings[axis]);
+    }
+    return equal;
+}
+
+/* ------------------------------------------------------------------------- */
+
+int main(void)
+{
+    static motion_features_t features[BENCH_MOTION_COUNT * BENCH_MOTION_WINDOWS];
+    adxl343_sample_t samples[ADXL343_FIFO_SIZE];
+    motion_record_t record;
+    int windows = 0;
+
+    Sim_Init();
+    Chip_EEPROM_Init(NSS_EEPROM);
+    Event_Init(true);
+    Event_SetCb(Motion_EventCb);
+    Storage_Init();
+    Storage_Reset(false);
+    Motion_Init();
+
+    for (int phase = 0; phase < BENCH_MOTION_COUNT; phase++) {
+        /* The samples arrive as FIFO drains do: in chunks that do not line up with the windows. */
+        for (int n = 0; n < BENCH_MOTION_WINDOWS * MOTION_WINDOW_SIZE; n += ADXL343_FIFO_SIZE) {
+            for (int i = 0; i < ADXL343_FIFO_SIZE; i++) {
+                samples[i] = MotionSample((BENCH_MOTION_T)phase, n + i);
+            }
+            int count = BENCH_MOTION_WINDOWS * MOTION_WINDOW_SIZE - n;
+            count = (count < ADXL343_FIFO_SIZE) ? count : ADXL343_FIFO_SIZE;
+            int completed = Motion_AddSamples(samples, count);
+            BENCH_CHECK(completed <= 1); /* The chunks are smaller than a window: only the last one can be kept. */
+            if (completed > 0) {
+                features[windows++] = *Motion_GetFeatures();
+            }
+        }
+        const motion_features_t * pFeatures = Motion_GetFeatures();
+        switch (phase) {
+            case BENCH_MOTION_REST:
+            case BENCH_MOTION_REST_AGAIN:
+                BENCH_CHECK((pFeatures->detected == 0) && (pFeatures->mean[2] == 256) && (pFeatures->rms[2] == 0));
+                break;
+            case BENCH_MOTION_VIBRATION:
+                BENCH_CHECK(pFeatures->detected == MOTION_DETECTED(MOTION_EVENT_VIBRATION));
+                BENCH_CHECK((pFeatures->rms[2] == 20) && (pFeatures->peakToPeak[2] == 40));
+                BENCH_CHECK(pFeatures->crossings[2] >= MOTION_VIBRATION_CROSSINGS);
+                break;
+            case BENCH_MOTION_SHAKE:
+                BENCH_CHECK(pFeatures->detected == MOTION_DETECTED(MOTION_EVENT_SHAKE));
+                BENCH_CHECK((pFeatures->peakToPeak[0] >= 390) && (pFeatures->crossings[0] <= 2));
+                break;
+            case BENCH_MOTION_TILT:
+                BENCH_CHECK(pFeatures->detected == MOTION_DETECTED(MOTION_EVENT_TILT));
+                BENCH_CHECK((pFeatures->mean[1] == 181) && (pFeatures->mean[2] == 181));
+                break;
+            default:
+                break;
+        }
+    }
+    BENCH_CHECK(windows == BENCH_MOTION_COUNT * BENCH_MOTION_WINDOWS);
+    BENCH_CHECK(Motion_GetWindowCount() == windows);
+
+    for (int tag = MOTION_EVENT_SHOCK; tag <= MOTION_EVENT_TILT; tag++) {
+        BENCH_CHECK(Event_GetByTag((uint8_t)tag, 0) == 1);
+        BENCH_CHECK(sMotionEvents[tag] == 1);
+    }
+
+    /* One record per window, read back as computed: the bench stays within the range of each field. */
+    BENCH_CHECK(Storage_GetCount() == windows);
+    BENCH_CHECK(Storage_Seek(0));
+    for (int w = 0; w < windows; w++) {
+        BENCH_CHECK(Storage_Read(&record, 1) == 1);
+        BENCH_CHECK(Equal(&record, &features[w]));
+    }
+    BENCH_CHECK((record.mean[2] == 181) && (record.shocks == 0));
+    BENCH_CHECK(features[0].peakToPeak[0] == 2); /* The noise on X: -1 .. 1 */
+
+    Storage_DeInit();
+    Event_DeInit();
+
+    long sampleBits = (long)windows * MOTION_WINDOW_SIZE * BENCH_SAMPLE_BITSIZE;
+    long scalarBits = (long)windows * MOTION_RECORD_FIELD_COUNT * BENCH_SCALAR_BITSIZE;
+    long recordBits = (long)windows * STORAGE_BITSIZE;
+    double reduction = (double)sampleBits / recordBits;
+    printf("bench=motion windows=%d samples=%d sample_bits=%ld scalar_bits=%ld record_bits=%ld reduction=%.1f\n",
+           windows, windows * MOTION_WINDOW_SIZE, sampleBits, scalarBits, recordBits, reduction);
+    return (reduction >= BENCH_MIN_REDUCTION) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/** @} */
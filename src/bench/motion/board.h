@@ -0,0 +1,17 @@
+#ifndef __BOARD_H_
+#define __BOARD_H_
+
+/**
+ * @defgroup BENCH_MOTION_BOARD bench_motion: board and diversity settings of the motion feature benchmark
+ * @ingroup SIM
+ * Plays the role of the board library for the motion feature benchmark executable. The storage module stores the
+ * records of the application, so the simulation is compiled again for this executable.
+ * @{
+ */
+
+#define SYSTEMCLOCK 1000000
+
+#include "chip.h"
+
+/** @} */
+#endif
@@ -0,0 +1,39 @@
+#ifndef __APP_SEL_H_
+#define __APP_SEL_H_
+
+/**
+ * @addtogroup BENCH_RECORDS_BOARD
+ * The storage module stores records of three accelerometer axes. The EEPROM and FLASH regions match those in
+ * @c src/bench/app_sel.h.
+ * @{
+ */
+
+#include <stdint.h>
+
+/** One sample of an accelerometer: 11 bits per axis suffice for an ADXL343 at +-2 g, full resolution. */
+typedef struct BENCH_ACCEL_S {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} BENCH_ACCEL_T;
+
+/* Diversities tweaking the storage module. */
+#define STORAGE_TYPE BENCH_ACCEL_T
+#define STORAGE_FIELD_COUNT 3
+#define STORAGE_FIELD_TYPE int16_t
+#define STORAGE_FIELD_BITSIZES 11, 11, 11
+#define STORAGE_BITSIZE 33
+#define STORAGE_SIGNED 1
+#define STORAGE_EEPROM_FIRST_ROW 21
+#define STORAGE_EEPROM_LAST_ROW (EEPROM_NR_OF_RW_ROWS - 1)
+#define STORAGE_FLASH_FIRST_PAGE 128 /**< There is no linker script: the first 8 kB are assumed to hold the program. */
+#define STORAGE_FIRST_ALON_REGISTER 3
+#define STORAGE_COMPRESS_CB Records_CompressCb
+#define STORAGE_DECOMPRESS_CB Records_DecompressCb
+
+/* Diversities tweaking the compress module: each plane holds the samples of one axis. */
+#define COMPRESS_CODEC COMPRESS_CODEC_DELTA
+#define COMPRESS_DELTA_BITSIZE 11
+
+/** @} */
+#endif
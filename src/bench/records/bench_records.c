@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "board.h"
+#include "sim.h"
+#include "compress/compress.h"
+#include "storage/storage.h"
+
+/**
+ * @defgroup BENCH_RECORDS bench_records: Host-native benchmark of the storage module storing records
+ * @ingroup SIM
+ * Stores a synthetic 3-axis accelerometer trace as records of three 11-bit fields until the storage module is full,
+ * reads all records back, and compares the compressed size of each block moved to FLASH - compressed per axis, as
+ * the storage module hands over the planes - with the size of the same block compressed with its axes interleaved,
+ * as when each axis is stored as a separate sample. Prints one line:
+ *  @code
+ *      bench=records records=... blocks=... raw_bytes=... planes_bytes=... interleaved_bytes=... gain=...
+ *  @endcode
+ * - @c raw_bytes: the size of the blocks moved to FLASH, uncompressed.
+ * - @c planes_bytes, @c interleaved_bytes: their compressed size, compressed per axis, or interleaved. Blocks that do
+ *  not compress count at their raw size, as the storage module then stores them uncompressed.
+ * - @c gain: @c interleaved_bytes divided by @c planes_bytes.
+ * A record that is not read back as written, or a gain below #BENCH_MIN_GAIN, aborts the executable with a non-zero
+ * exit code.
+ * @{
+ */
+
+/* ------------------------------------------------------------------------- */
+
+/** Number of records handed over in one call to #Storage_Write and #Storage_Read. */
+#define BENCH_CHUNK 50
+
+/** The least compression gain of storing the axes as planes, instead of interleaved. */
+#define BENCH_MIN_GAIN 1.5
+
+/** Aborts the executable when @c expr is false, regardless of @c DEBUG. */
+#define BENCH_CHECK(expr) do { if (expr) {} else { Sim_AssertFailed(__FILE__, __LINE__); } } while (0)
+
+/* ------------------------------------------------------------------------- */
+
+int Records_CompressCb(const uint8_t * pPlanes, int bitCount, void * pOut);
+int Records_DecompressCb(const uint8_t * pData, int bitCount, void * pOut);
+
+static int sBlocks; /**< The number of blocks given to #Records_CompressCb */
+static int sPlanesBytes; /**< The compressed size of those blocks, per axis */
+static int sInterleavedBytes; /**< The compressed size of those blocks, with the axes interleaved */
+
+/* ------------------------------------------------------------------------- */
+
+/** A pseudo random number in the range [-range, range], reproducible over runs and hosts. */
+static int Noise(int n, int range)
+{
+    uint32_t x = (uint32_t)n * 2654435761U;
+    x ^= x >> 15;
+    x *= 2246822519U;
+    x ^= x >> 13;
+    return (int)(x % (uint32_t)(2 * range + 1)) - range;
+}
+
+/** A triangle wave between -amplitude and amplitude. */
+static int Triangle(int n, int period, int amplitude)
+{
+    int phase = n % period;
+    int half = period / 2;
+    int rising = (phase < half) ? phase : period - phase;
+    return (4 * amplitude * rising) / period - amplitude;
+}
+
+/**
+ * An ADXL343 on a machine running half of the time, full resolution: 256 LSB per g. Gravity on Z, a vibration of
+ * about 0.2 g on all axes while running, and noise of a few LSB.
+ */
+static BENCH_ACCEL_T Accel(int n)
+{
+    int running = ((n / 200) % 2) ? 1 : 0;
+    BENCH_ACCEL_T accel;
+
+    accel.x = (int16_t)(4 + running * Triangle(n, 10, 50) + Noise(3 * n, 3 + running * 5));
+    accel.y = (int16_t)(-9 + running * Triangle(n + 3, 10, 40) + Noise(3 * n + 1, 3 + running * 5));
+    accel.z = (int16_t)(256 + running * Triangle(n + 6, 10, 30) + Noise(3 * n + 2, 3 + running * 5));
+    return accel;
+}
+
+static bool Equal(const BENCH_ACCEL_T * pA, const BENCH_ACCEL_T * pB)
+{
+    return (pA->x == pB->x) && (pA->y == pB->y) && (pA->z == pB->z);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/** Compresses the planes. Compresses the records in EEPROM as well, only to compare the sizes. */
+int Records_CompressCb(const uint8_t * pPlanes, int bitCount, void * pOut)
+{
+    uint8_t interleaved[STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES];
+    uint8_t encoded[STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES];
+
+    BENCH_CHECK(bitCount == STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS);
+    int length = Compress_Encode(pPlanes, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES, pOut,
+                                 STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+
+    Chip_EEPROM_Read(NSS_EEPROM, STORAGE_EEPROM_FIRST_ROW * EEPROM_ROW_SIZE, interleaved,
+                     STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+    int interleavedLength = Compress_Encode(interleaved, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES, encoded,
+                                            STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+
+    sBlocks++;
+    sPlanesBytes += length ? length : STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES;
+    sInterleavedBytes += interleavedLength ? interleavedLength : STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES;
+    return length * 8;
+}
+
+int Records_DecompressCb(const uint8_t * pData, int bitCount, void * pOut)
+{
+    int length = Compress_Decode(pData, STORAGE_IDIVUP(bitCount, 8), pOut, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+    return (length == STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES) ? STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS : 0;
+}
+
+/* ------------------------------------------------------------------------- */
+
+int main(void)
+{
+    BENCH_ACCEL_T records[BENCH_CHUNK];
+    int count = 0;
+    int written;
+
+    Sim_Init();
+    Chip_EEPROM_Init(NSS_EEPROM);
+    Storage_Init();
+    Storage_Reset(false);
+
+    /* Fill the storage module: the last call stores only part of the records, or none. */
+    do {
+        for (int i = 0; i < BENCH_CHUNK; i++) {
+            records[i] = Accel(count + i);
+        }
+        written = Storage_Write(records, BENCH_CHUNK);
+        count += written;
+    } while (written == BENCH_CHUNK);
+    BENCH_CHECK(Storage_GetCount() == count);
+    BENCH_CHECK(sBlocks > 0);
+
+    BENCH_CHECK(Storage_Seek(0));
+    for (int n = 0; n < count; n += BENCH_CHUNK) {
+        int expected = ((count - n) < BENCH_CHUNK) ? (count - n) : BENCH_CHUNK;
+        BENCH_CHECK(Storage_Read(records, BENCH_CHUNK) == expected);
+        for (int i = 0; i < expected; i++) {
+            BENCH_ACCEL_T accel = Accel(n + i);
+            BENCH_CHECK(Equal(&records[i], &accel));
+        }
+    }
+    Storage_DeInit();
+
+    /* The records survive initializing again. Read across the boundary of the first two blocks in FLASH. */
+    Storage_Init();
+    BENCH_CHECK(Storage_GetCount() == count);
+    int first = STORAGE_BLOCK_SIZE_IN_SAMPLES - BENCH_CHUNK / 2;
+    BENCH_CHECK(Storage_Seek(first));
+    BENCH_CHECK(Storage_Read(records, BENCH_CHUNK) == BENCH_CHUNK);
+    for (int i = 0; i < BENCH_CHUNK; i++) {
+        BENCH_ACCEL_T accel = Accel(first + i);
+        BENCH_CHECK(Equal(&records[i], &accel));
+    }
+    Storage_DeInit();
+
+    int raw = sBlocks * STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES;
+    double gain = (double)sInterleavedBytes / sPlanesBytes;
+    printf("bench=records records=%d blocks=%d raw_bytes=%d planes_bytes=%d interleaved_bytes=%d gain=%.3f\n", count,
+           sBlocks, raw, sPlanesBytes, sInterleavedBytes, gain);
+    return (gain >= BENCH_MIN_GAIN) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/** @} */
@@ -0,0 +1,17 @@
+#ifndef __BOARD_H_
+#define __BOARD_H_
+
+/**
+ * @defgroup BENCH_RECORDS_BOARD bench_records: board and diversity settings of the record storage benchmark
+ * @ingroup SIM
+ * Plays the role of the board library for the record storage benchmark executable. The storage diversity settings
+ * differ from those of the other benchmarks, so the simulation is compiled again for this executable.
+ * @{
+ */
+
+#define SYSTEMCLOCK 1000000
+
+#include "chip.h"
+
+/** @} */
+#endif
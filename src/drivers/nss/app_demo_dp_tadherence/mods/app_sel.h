@@ -20,7 +20,7 @@
 
 /* Diversities tweaking msg module for application-specific usage. */
 
-#define MSG_APP_HANDLERS_COUNT 7
+#define MSG_APP_HANDLERS_COUNT 30 /* Indexed by message id, up to MSG_ID_GETPILLREMOVALS */
 #define MSG_APP_HANDLERS MsgHandler_CmdHandlers
 #define MSG_ENABLE_RESET 1
 #define MSG_ENABLE_PREPAREDEBUG 1
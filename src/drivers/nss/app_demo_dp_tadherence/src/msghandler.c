@@ -41,21 +41,19 @@ static uint8_t sNdefInstanceTx[NDEFT2T_INSTANCE_SIZE];
 __attribute__ ((section(".noinit"))) __attribute__((aligned (4)))
 static uint8_t sNdefInstanceRx[NDEFT2T_INSTANCE_SIZE];
 
-/** Buffer for outgoing data (response) (NFC/NDEF)  */
-__attribute__ ((section(".noinit"), aligned (4)))
-static uint8_t sTxData[NFC_SHARED_MEM_BYTE_SIZE];
-
 /** Buffer for incoming data (command) (NFC/NDEF)  */
 __attribute__ ((section(".noinit"), aligned (4)))
 static uint8_t sRxData[NFC_SHARED_MEM_BYTE_SIZE];
 
 
-MSG_CMD_HANDLER_T MsgHandler_CmdHandlers[MSG_APP_HANDLERS_COUNT] = {{MSG_ID_SETPRISTINE, SetPristineHandler},
-                                                                    {MSG_ID_SETRHYTHM, SetRhythmHandler},
-                                                                    {MSG_ID_GETRHYTHM, GetRhythmHandler},
-                                                                    {MSG_ID_START, StartHandler},
-                                                                    {MSG_ID_GETSTART, GetStartHandler},
-                                                                    {MSG_ID_GETPILLREMOVALS, GetRemovalsHandler}};
+#define MSGHANDLER_CMD_HANDLERS(X) \
+    X(MSG_ID_SETPRISTINE, SetPristineHandler) \
+    X(MSG_ID_SETRHYTHM, SetRhythmHandler) \
+    X(MSG_ID_GETRHYTHM, GetRhythmHandler) \
+    X(MSG_ID_START, StartHandler) \
+    X(MSG_ID_GETSTART, GetStartHandler) \
+    X(MSG_ID_GETPILLREMOVALS, GetRemovalsHandler)
+MSG_APP_HANDLER_TABLE(MsgHandler_CmdHandlers, MSGHANDLER_CMD_HANDLERS);
 
 /**
  * Called under interrupt.
@@ -121,7 +119,7 @@ void MsgHandler_Init(void)
     Msg_Init();
     Msg_SetResponseCb(ResponseCb);
 
-    NDEFT2T_CreateMessage(sNdefInstanceTx, sTxData, sizeof(sTxData), true);
+    NDEFT2T_CreateMessageDirect(sNdefInstanceTx);
     AddMimeRecord(0, NULL);
     AddTextRecords();
     NDEFT2T_CommitMessage(sNdefInstanceTx);
@@ -253,7 +251,7 @@ static uint32_t GetRemovalsHandler(uint8_t msgId, int payloadLen, const uint8_t*
 
 static bool ResponseCb(int responseLength, const uint8_t* responseData)
 {
-    NDEFT2T_CreateMessage(sNdefInstanceTx, sTxData, sizeof(sTxData), true);
+    NDEFT2T_CreateMessageDirect(sNdefInstanceTx);
     AddMimeRecord(responseLength, responseData);
     NDEFT2T_CommitMessage(sNdefInstanceTx);
     return true;
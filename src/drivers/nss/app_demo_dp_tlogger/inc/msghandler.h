@@ -50,4 +50,14 @@ void AppMsgInit(bool reuseKeys);
  */
 void AppMsgHandleCommand(int cmdLength, const uint8_t* cmdData);
 
+/**
+ * Continues a transfer started with a #APP_MSG_ID_STREAMMEASUREMENTS command: places the next chunk - already
+ * prepared - in the NFC shared memory.
+ * To be called when the tag reader has read the previous chunk, i.e. after #NDEFT2T_MSG_READ_CB has been called.
+ * When the last chunk has been read, that chunk is left in the NFC shared memory and read detection is disabled.
+ * @return @c false when no transfer is running: the read concerns another message. @c true when the read concerns a
+ *  chunk of the transfer - including the last one.
+ */
+bool AppMsgStreamNext(void);
+
 #endif /** @} */
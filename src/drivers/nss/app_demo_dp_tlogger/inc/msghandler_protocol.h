@@ -31,6 +31,14 @@
  */
 #define APP_MSG_ERR_TSEN 0x1000E
 
+/**
+ * The optional features of the message handler module supported by this application, as reported in
+ * #MSG_RESPONSE_GETVERSION_T.capabilities. That response is sent along with each #APP_MSG_ID_GETCONFIG response.
+ * - #MSG_CAPABILITY_GETRESPONSES: all stored #APP_MSG_RESPONSE_MEASURETEMPERATURE_T responses can be fetched in one
+ *  round trip with #MSG_ID_GETRESPONSES.
+ */
+#define APP_MSG_CAPABILITIES MSG_CAPABILITY_GETRESPONSES
+
 /**
  * The maximum temperature the application can handle. This is a result of the limitations of the IC (-40:+85C), the
  * limitations of the battery (say, -30:+50C), and the requirements of the use case.
@@ -65,6 +73,7 @@
  * The maximum number of temperature measurement values that can be retrieved in one response.
  * @see APP_MSG_ID_GETMEASUREMENTS
  * @see APP_MSG_ID_GETPERIODICDATA
+ * @see APP_MSG_ID_STREAMMEASUREMENTS
  */
 #define APP_MSG_MAX_TEMPERATURE_VALUES_IN_RESPONSE 232
 #if APP_MSG_MAX_TEMPERATURE_VALUES_IN_RESPONSE > 255
@@ -135,7 +144,8 @@ typedef enum APP_MSG_ID {
      * @param APP_MSG_CMD_MEASURETEMPERATURE_T
      * @return #MSG_RESPONSE_RESULTONLY_T immediately; @n
      *  If @c result was equal to #MSG_OK, #APP_MSG_RESPONSE_MEASURETEMPERATURE_T thereafter. This may take up to
-     *  100 ms. This second response must be fetched by issuing a command with #MSG_ID_GETRESPONSE.
+     *  100 ms. This second response must be fetched by issuing a command with #MSG_ID_GETRESPONSE - or, together with
+     *  the other stored responses, with #MSG_ID_GETRESPONSES.
      * @note asynchronous command
      */
     APP_MSG_ID_MEASURETEMPERATURE = 0x50,
@@ -171,8 +181,26 @@ typedef enum APP_MSG_ID {
      */
     APP_MSG_ID_GETPERIODICDATA = 0x5E,
 
+    /**
+     * @c 0x5F @n
+     * Retrieves all stored measurements from a given offset onwards, without further commands: a first chunk is given
+     * as response, and each time the tag reader has read the complete NDEF message, the next chunk is placed in the
+     * NFC shared memory. The tag reader only needs to keep reading.
+     * The next chunk is already prepared while the tag reader reads the current one.
+     * - The transfer ends after the chunk with #APP_MSG_RESPONSE_STREAMMEASUREMENTS_T.more equal to @c 0, or when the
+     *  tag reader writes a new command.
+     * - The chunks are numbered. When the tag reader sees a gap in the sequence numbers, or when the NFC field was lost,
+     *  the transfer can be resumed by issuing this command again with the offset of the first missing measurement.
+     * @param APP_MSG_CMD_STREAMMEASUREMENTS_T
+     * @return #MSG_RESPONSE_RESULTONLY_T if the command could not be handled;
+     *  #APP_MSG_RESPONSE_STREAMMEASUREMENTS_T otherwise, one for each chunk.
+     * @note asynchronous command
+     * @note Requires a tag reader that does not write in the NFC shared memory while reading, see #NDEFT2T_MSG_READ_CB.
+     */
+    APP_MSG_ID_STREAMMEASUREMENTS = 0x5F,
+
     /** Number of application specific message IDs. Not to be used as a possible ID. Use this in for loops or to define array sizes. */
-    APP_MSG_ID_COUNT = 7
+    APP_MSG_ID_COUNT = 8
 } APP_MSG_ID_T;
 
 /**
@@ -549,6 +577,22 @@ typedef struct APP_MSG_CMD_GETPERIODICDATA_S {
     uint16_t offset;
 } APP_MSG_CMD_GETPERIODICDATA_T;
 
+/** @see APP_MSG_ID_STREAMMEASUREMENTS */
+typedef struct APP_MSG_CMD_STREAMMEASUREMENTS_S {
+    /**
+     * Unit: number of samples.
+     * - A value of 0 starts with the oldest samples.
+     * - Any other value denotes the number of old samples to skip. Use this to resume an interrupted transfer.
+     */
+    uint16_t offset;
+
+    /**
+     * The sequence number to give to the first chunk. Each next chunk is numbered one higher.
+     * Use this to continue the numbering when resuming an interrupted transfer.
+     */
+    uint16_t sequence;
+} APP_MSG_CMD_STREAMMEASUREMENTS_T;
+
 /* ------------------------------------------------------------------------- */
 
 /**
@@ -642,6 +686,44 @@ typedef struct APP_MSG_RESPONSE_GETMEASUREMENTS_S {
     //int16_t data[count];
 } APP_MSG_RESPONSE_GETMEASUREMENTS_T;
 
+/**
+ * @see APP_MSG_ID_STREAMMEASUREMENTS
+ *
+ * Each chunk is a response with this structure, followed by @c count temperature values - each in deci-Celsius,
+ * 2 bytes - in the same format as for #APP_MSG_RESPONSE_GETMEASUREMENTS_T.
+ */
+typedef struct APP_MSG_RESPONSE_STREAMMEASUREMENTS_S {
+    /**
+     * The command result.
+     * Only when @c result equals #MSG_OK, the other fields in this response are valid.
+     */
+    uint32_t result;
+
+    /** The sequence number of this chunk. */
+    uint16_t sequence;
+
+    /**
+     * Unit: number of samples.
+     * Defines the sequence number of the first data value that follows.
+     */
+    uint16_t offset;
+
+    /**
+     * The number of values that follow this structure. This number can be @c 0.
+     * The total size of the response thus equals
+     * @code sizeof(APP_MSG_RESPONSE_STREAMMEASUREMENTS_T) + sizeof(int16_t) * count @endcode
+     */
+    uint8_t count;
+
+    /**
+     * - @c 1 when a next chunk will follow after this one is read.
+     * - @c 0 when this is the last chunk of the transfer.
+     */
+    uint8_t more;
+
+    //int16_t data[count];
+} APP_MSG_RESPONSE_STREAMMEASUREMENTS_T;
+
 /** @see APP_MSG_ID_GETCONFIG */
 typedef struct APP_MSG_RESPONSE_GETCONFIG_S {
     /**
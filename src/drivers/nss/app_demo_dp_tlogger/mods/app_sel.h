@@ -32,9 +32,15 @@
 
 /* Diversities tweaking msg module for application-specific usage. */
 #define MSG_APP_HANDLERS App_CmdHandler
-#define MSG_APP_HANDLERS_COUNT 7U
-#define MSG_RESPONSE_BUFFER_SIZE 20 /**< A value large enough to store #APP_MSG_RESPONSE_MEASURETEMPERATURE_T - nothing else is buffered. */
+#define MSG_APP_HANDLERS_COUNT 32U /**< #App_CmdHandler is indexed by message id, up to #APP_MSG_ID_STREAMMEASUREMENTS. */
+/**
+ * A value large enough to store four #APP_MSG_RESPONSE_MEASURETEMPERATURE_T next to the largest response that can be
+ * stored: 254 bytes. #APP_MSG_ID_GETMEASUREMENTS and #APP_MSG_ID_GETPERIODICDATA responses up to that size - 121
+ * values - are built in place. Larger ones do not fit the size byte of a stored response, and are copied.
+ */
+#define MSG_RESPONSE_BUFFER_SIZE (256 + 4 * (1 + 2 + 6))
 #define MSG_RESPONSE_BUFFER App_ResponseBuffer
+#define MSG_ENABLE_GETRESPONSES 1
 #ifdef DEBUG
     #define MSG_ENABLE_RESET 1
     #define MSG_ENABLE_READREGISTER 1
@@ -680,8 +680,13 @@ static bool Execute(PMU_DPD_WAKEUPREASON_T wakeupReason)
         if (sMessageRead) {
             sMessageRead = false;
             messageRxTx = true;
-            NDEFT2T_ResetNfcMemory();
-            GenerateNextAutomaticCommand();
+            /* Reads of a transfer started with APP_MSG_ID_STREAMMEASUREMENTS - its last chunk included - are not
+             * answered with automatically generated commands.
+             */
+            if (!AppMsgStreamNext()) {
+                NDEFT2T_ResetNfcMemory();
+                GenerateNextAutomaticCommand();
+            }
         }
 
         if (Timer_CheckMeasurementTimeout()) {
@@ -34,6 +34,9 @@ static uint32_t MeasureTemperatureHandler(uint8_t msgId, int len, const uint8_t*
 static uint32_t StartHandler(uint8_t msgId, int len, const uint8_t* pPayload);
 static uint32_t GetEventsHandler(uint8_t msgId, int len, const uint8_t* pPayload);
 static uint32_t GetPeriodicDataHandler(uint8_t msgId, int len, const uint8_t* pPayload);
+static uint32_t StreamMeasurementsHandler(uint8_t msgId, int len, const uint8_t* pPayload);
+static void StreamPrepare(void);
+static void StreamSend(void);
 static bool ResponseCb(int responseLength, const uint8_t* responseData);
 bool CommandAcceptCb(uint8_t msgId, int payloadLen, const uint8_t * pPayload);
 
@@ -55,8 +58,8 @@ static unsigned char sMime[18] = MIME;
 
 /**
  * The size of the array #sBuffer, in bytes.
- * It must be big enough to contain the largest possible NDEF record payload, and big enough for use as
- * workspace in #ExtractFullPeriodicData.
+ * It must be big enough to contain the largest possible NDEF record payload, and big enough for the largest response
+ * holding measurements: those that do not fit in #App_ResponseBuffer are built here.
  */
 #define BUFFER_SIZE MAX(MAX_RECORD_PAYLOAD_SIZE, \
                         MAX(sizeof(APP_MSG_RESPONSE_GETMEASUREMENTS_T), \
@@ -71,6 +74,23 @@ static unsigned char sMime[18] = MIME;
 __attribute__ ((section(".noinit"))) __attribute__((aligned (4)))
 static uint8_t sBuffer[BUFFER_SIZE];
 
+/**
+ * Holds the next chunk of an #APP_MSG_ID_STREAMMEASUREMENTS transfer. It is filled in by #StreamPrepare right after
+ * the previous chunk is handed off, while the tag reader is still reading that one.
+ */
+__attribute__ ((section(".noinit"))) __attribute__((aligned (4)))
+static uint8_t sStreamBuffer[sizeof(APP_MSG_RESPONSE_STREAMMEASUREMENTS_T)
+                             + (sizeof(STORAGE_TYPE) * APP_MSG_MAX_TEMPERATURE_VALUES_IN_RESPONSE)];
+
+/** Keeps track of the transfer started with #APP_MSG_ID_STREAMMEASUREMENTS. */
+static struct {
+    bool active; /**< @c true while #sStreamBuffer holds a chunk that is still to be given. */
+    bool running; /**< @c true from the command until the tag reader has read the last chunk. */
+    uint16_t sequence; /**< The sequence number of the next chunk to prepare. */
+    int offset; /**< The offset of the first measurement of the next chunk to prepare. */
+    int end; /**< The number of measurements stored when the transfer started. */
+} sStream;
+
 /**
  * Used to block multiple responses on one command. Communication must occur strictly according
  * to a command - response sequence. Multiple responses generated by one command are to be fetched
@@ -82,22 +102,28 @@ static bool sAcceptResponse = false;
 __attribute__ ((section(".noinit")))
 uint8_t App_ResponseBuffer[MSG_RESPONSE_BUFFER_SIZE];
 
-MSG_CMD_HANDLER_T App_CmdHandler[APP_MSG_ID_COUNT] = {{APP_MSG_ID_GETMEASUREMENTS, GetMeasurementsHandler},
-                                                      {APP_MSG_ID_GETCONFIG, GetConfigHandler},
-                                                      {APP_MSG_ID_SETCONFIG, SetConfigHandler},
-                                                      {APP_MSG_ID_MEASURETEMPERATURE, MeasureTemperatureHandler},
-                                                      {APP_MSG_ID_START, StartHandler},
-                                                      {APP_MSG_ID_GETEVENTS, GetEventsHandler},
-                                                      {APP_MSG_ID_GETPERIODICDATA, GetPeriodicDataHandler}};
+#define APP_CMD_HANDLERS(X) \
+    X(APP_MSG_ID_GETMEASUREMENTS, GetMeasurementsHandler) \
+    X(APP_MSG_ID_GETCONFIG, GetConfigHandler) \
+    X(APP_MSG_ID_SETCONFIG, SetConfigHandler) \
+    X(APP_MSG_ID_MEASURETEMPERATURE, MeasureTemperatureHandler) \
+    X(APP_MSG_ID_START, StartHandler) \
+    X(APP_MSG_ID_GETEVENTS, GetEventsHandler) \
+    X(APP_MSG_ID_GETPERIODICDATA, GetPeriodicDataHandler) \
+    X(APP_MSG_ID_STREAMMEASUREMENTS, StreamMeasurementsHandler)
+MSG_APP_HANDLER_TABLE(App_CmdHandler, APP_CMD_HANDLERS);
 
 /**
- * Dummy variable to test whether the diversity setting #MSG_APP_HANDLERS_COUNT matches APP_MSG_ID_COUNT.
+ * Dummy variable to test whether all APP_MSG_ID_COUNT commands have a handler in #App_CmdHandler.
  * If not equal, the dummy variable will have a negative array size and the compiler will raise an error
  * similar to:
  *   ../src/msghandler.c:71:13: error: size of array 'sTestValuesOf.' is negative
  * @{
  */
-static char sTestValuesOfMsgAppHandlerCount[((int)MSG_APP_HANDLERS_COUNT == APP_MSG_ID_COUNT) - 1] __attribute__((unused));
+static char sTestValuesOfMsgAppHandlerCount[((int)App_CmdHandler_COUNT == APP_MSG_ID_COUNT) - 1] __attribute__((unused));
+
+/** Dummy variable to test whether #APP_MSG_CAPABILITIES matches the capabilities enabled in app_sel.h. */
+static char sTestValuesOfCapabilities[(APP_MSG_CAPABILITIES == (MSG_ENABLE_GETRESPONSES ? MSG_CAPABILITY_GETRESPONSES : 0)) - 1] __attribute__((unused));
 
 /* ------------------------------------------------------------------------- */
 
@@ -216,7 +242,8 @@ static bool EventCb_GetEventsResponse(uint8_t tag, int offset, uint8_t len, unsi
  * @param offset The number of pairs to skip before fetching the periodically taken measurements.
  * @param count The number of samples requested, of each selected type of periodic data.
  * @param pData Used as both workspace and as container for the requested data. May not be @c NULL. The size of the
- *  buffer must be at least @code sizeof(STORAGE_TYPE) * count @endcode bytes.
+ *  buffer must be at least @code sizeof(STORAGE_TYPE) * count @endcode bytes. It need not be aligned: the byte before
+ *  @c pData is then used as workspace as well.
  * @return The number of bytes occupied in pBuffer.
  */
 static int ExtractFullPeriodicData(uint8_t which, unsigned int offset, int count, uint8_t * pData)
@@ -224,15 +251,62 @@ static int ExtractFullPeriodicData(uint8_t which, unsigned int offset, int count
     ASSERT(which == APP_MSG_PERIODICDATA_TYPE_TEMPERATURE);
     (void)which; /* suppress [-Wunused-parameter]: which is assumed to be APP_MSG_PERIODICDATA_TYPE_TEMPERATURE, checked in the assert above. */
     int size = 0;
-    STORAGE_TYPE * samples = (STORAGE_TYPE *)pData;
+    /* The response buffer of the msg module gives no alignment guarantee: read in place, one byte lower if need be. */
+    uint8_t * pAligned = pData - ((uintptr_t)pData % sizeof(STORAGE_TYPE));
+    STORAGE_TYPE * samples = (STORAGE_TYPE *)pAligned;
     if (Storage_Seek((int)offset)) {
         count = Storage_Read(samples, count);
         /* samples is now filled with count values of type STORAGE_TYPE. */
         size = count * (int)sizeof(int16_t);
+        if (pAligned != pData) {
+            memmove(pData, pAligned, (size_t)size);
+        }
     }
     return size;
 }
 
+/**
+ * @param offset The sequence number of the first measurement to give.
+ * @return The number of measurements to give in one response, starting at @c offset.
+ */
+static int CountMeasurements(unsigned int offset)
+{
+    int count = Storage_GetCount() - (int)offset;
+    if (count > APP_MSG_MAX_TEMPERATURE_VALUES_IN_RESPONSE) {
+        count = APP_MSG_MAX_TEMPERATURE_VALUES_IN_RESPONSE;
+    }
+    return (count > 0) ? count : 0;
+}
+
+/**
+ * Reserves room for a response holding measurements, to be filled in place by the caller.
+ * @param msgId The id of the response.
+ * @param payloadLen The size of the response in bytes.
+ * @return Where to write the payload: in the response buffer of the msg module, avoiding a copy; or in #sBuffer when
+ *  the response is too large to be stored there.
+ */
+static uint8_t * ReserveResponse(uint8_t msgId, int payloadLen)
+{
+    uint8_t * pPayload = Msg_ReserveResponse(msgId, payloadLen);
+    return (pPayload == NULL) ? sBuffer : pPayload;
+}
+
+/**
+ * Gives the response written in place.
+ * @param msgId The id of the response.
+ * @param payloadLen The size of the response in bytes: at most the size given to #ReserveResponse.
+ * @param pPayload As returned by #ReserveResponse.
+ */
+static void CommitResponse(uint8_t msgId, int payloadLen, const uint8_t * pPayload)
+{
+    if (pPayload == sBuffer) {
+        Msg_AddResponse(msgId, payloadLen, sBuffer);
+    }
+    else {
+        Msg_CommitResponse(payloadLen);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 
 /**
@@ -243,6 +317,7 @@ static int ExtractFullPeriodicData(uint8_t which, unsigned int offset, int count
  * #APP_MSG_MAX_TEMPERATURE_VALUES_IN_RESPONSE is too large.
  */
 static char sTestGetMeasurementsDefine[(sizeof(APP_MSG_RESPONSE_GETMEASUREMENTS_T) + (2*APP_MSG_MAX_TEMPERATURE_VALUES_IN_RESPONSE) > MAX_RECORD_PAYLOAD_SIZE) ? -1 : 1] __attribute__((unused));
+static char sTestStreamMeasurementsDefine[(sizeof(sStreamBuffer) > MAX_RECORD_PAYLOAD_SIZE) ? -1 : 1] __attribute__((unused));
 
 /**
  * Dummy variables to test whether the enum #APP_MSG_TSEN_RESOLUTION_T is in sync with #TSEN_RESOLUTION_T.
@@ -266,16 +341,18 @@ static uint32_t GetMeasurementsHandler(uint8_t msgId, int len, const uint8_t * p
     uint32_t errorCode;
     if (len == sizeof(APP_MSG_CMD_GETMEASUREMENTS_T)) {
         const APP_MSG_CMD_GETMEASUREMENTS_T * command = (const APP_MSG_CMD_GETMEASUREMENTS_T *)pPayload;
-        APP_MSG_RESPONSE_GETMEASUREMENTS_T * response = (APP_MSG_RESPONSE_GETMEASUREMENTS_T *)sBuffer;
-        response->result = MSG_OK;
-        response->offset = command->offset;
-        memset(response->zero, 0, sizeof(response->zero));
+        APP_MSG_RESPONSE_GETMEASUREMENTS_T response;
+        response.result = MSG_OK;
+        response.offset = command->offset;
+        memset(response.zero, 0, sizeof(response.zero));
         /* Append as many measured values as possible. */
-        uint8_t * pData = &sBuffer[sizeof(APP_MSG_RESPONSE_GETMEASUREMENTS_T)];
-        int size = ExtractFullPeriodicData(APP_MSG_PERIODICDATA_TYPE_TEMPERATURE, command->offset,
-                                           APP_MSG_MAX_TEMPERATURE_VALUES_IN_RESPONSE, pData);
-        response->count = (uint8_t)(size / (int)sizeof(int16_t));
-        Msg_AddResponse(msgId, (int)sizeof(APP_MSG_RESPONSE_GETMEASUREMENTS_T) + size, (uint8_t *)response);
+        int count = CountMeasurements(command->offset);
+        uint8_t * pResponse = ReserveResponse(msgId, (int)(sizeof(response) + sizeof(int16_t) * (unsigned int)count));
+        int size = ExtractFullPeriodicData(APP_MSG_PERIODICDATA_TYPE_TEMPERATURE, command->offset, count,
+                                           pResponse + sizeof(response));
+        response.count = (uint8_t)(size / (int)sizeof(int16_t));
+        memcpy(pResponse, &response, sizeof(response)); /* Not word aligned in the response buffer. */
+        CommitResponse(msgId, (int)sizeof(response) + size, pResponse);
     }
     else {
         errorCode = MSG_ERR_INVALID_COMMAND_SIZE;
@@ -441,16 +518,18 @@ static uint32_t GetPeriodicDataHandler(uint8_t msgId, int len, const uint8_t* pP
             errorCode = MSG_ERR_INVALID_NYI;
         }
         else {
-            APP_MSG_RESPONSE_GETPERIODICDATA_T * response = (APP_MSG_RESPONSE_GETPERIODICDATA_T *)sBuffer;
-            response->result = MSG_OK;
-            response->which = command->which;
-            response->format = command->format;
-            response->offset = command->offset;
+            APP_MSG_RESPONSE_GETPERIODICDATA_T response;
+            response.result = MSG_OK;
+            response.which = command->which;
+            response.format = command->format;
+            response.offset = command->offset;
             /* Append as many measured values as possible. */
-            uint8_t * pData = &sBuffer[sizeof(APP_MSG_RESPONSE_GETPERIODICDATA_T)];
-            int size = ExtractFullPeriodicData(command->which, command->offset,
-                                               APP_MSG_MAX_TEMPERATURE_VALUES_IN_RESPONSE, pData);
-            Msg_AddResponse(msgId, (int)sizeof(APP_MSG_RESPONSE_GETPERIODICDATA_T) + size, sBuffer);
+            int count = CountMeasurements(command->offset);
+            uint8_t * pResponse = ReserveResponse(msgId,
+                                                  (int)(sizeof(response) + sizeof(int16_t) * (unsigned int)count));
+            int size = ExtractFullPeriodicData(command->which, command->offset, count, pResponse + sizeof(response));
+            memcpy(pResponse, &response, sizeof(response)); /* Not word aligned in the response buffer. */
+            CommitResponse(msgId, (int)sizeof(response) + size, pResponse);
             errorCode = MSG_OK;
         }
     }
@@ -460,6 +539,75 @@ static uint32_t GetPeriodicDataHandler(uint8_t msgId, int len, const uint8_t* pP
     return errorCode;
 }
 
+static uint32_t StreamMeasurementsHandler(uint8_t msgId, int len, const uint8_t* pPayload)
+{
+    (void)msgId; /* suppress [-Wunused-parameter]: each chunk is sent with APP_MSG_ID_STREAMMEASUREMENTS. */
+    uint32_t errorCode;
+    if (len == sizeof(APP_MSG_CMD_STREAMMEASUREMENTS_T)) {
+        const APP_MSG_CMD_STREAMMEASUREMENTS_T * command = (const APP_MSG_CMD_STREAMMEASUREMENTS_T *)pPayload;
+        sStream.sequence = command->sequence;
+        sStream.offset = command->offset;
+        sStream.end = Storage_GetCount();
+        sStream.running = true;
+        /* Each subsequent chunk is given when the previous one is read: NDEFT2T_MSG_READ_CB must be called. */
+        NDEFT2T_EnableAutomaticMode();
+        StreamPrepare();
+        StreamSend();
+        errorCode = MSG_OK;
+    }
+    else {
+        errorCode = MSG_ERR_INVALID_COMMAND_SIZE;
+    }
+    return errorCode;
+}
+
+/**
+ * Fills #sStreamBuffer with the next chunk of the transfer started by #StreamMeasurementsHandler.
+ * This includes reading - and decompressing - the measurements from the storage module, which is the time consuming
+ * part.
+ */
+static void StreamPrepare(void)
+{
+    APP_MSG_RESPONSE_STREAMMEASUREMENTS_T * response = (APP_MSG_RESPONSE_STREAMMEASUREMENTS_T *)sStreamBuffer;
+    int count = sStream.end - sStream.offset;
+    int size = 0;
+    if (count > APP_MSG_MAX_TEMPERATURE_VALUES_IN_RESPONSE) {
+        count = APP_MSG_MAX_TEMPERATURE_VALUES_IN_RESPONSE;
+    }
+    if (count > 0) {
+        size = ExtractFullPeriodicData(APP_MSG_PERIODICDATA_TYPE_TEMPERATURE, (unsigned int)sStream.offset, count,
+                                       &sStreamBuffer[sizeof(APP_MSG_RESPONSE_STREAMMEASUREMENTS_T)]);
+    }
+    response->result = MSG_OK;
+    response->sequence = sStream.sequence++;
+    response->offset = (uint16_t)sStream.offset;
+    response->count = (uint8_t)(size / (int)sizeof(int16_t));
+    sStream.offset += response->count;
+    /* A failure to read the measurements also ends the transfer. */
+    response->more = (response->count > 0) && (sStream.offset < sStream.end);
+    sStream.active = true;
+}
+
+/**
+ * Gives the chunk prepared in #sStreamBuffer as response, then already prepares the next chunk, if any.
+ * @pre #StreamPrepare must have been called.
+ */
+static void StreamSend(void)
+{
+    const APP_MSG_RESPONSE_STREAMMEASUREMENTS_T * response = (const APP_MSG_RESPONSE_STREAMMEASUREMENTS_T *)sStreamBuffer;
+    bool more = response->more;
+
+    sAcceptResponse = true;
+    Msg_AddResponse(APP_MSG_ID_STREAMMEASUREMENTS,
+                    (int)(sizeof(APP_MSG_RESPONSE_STREAMMEASUREMENTS_T) + sizeof(int16_t) * response->count),
+                    sStreamBuffer);
+    /* The response is in the NFC shared memory now: sStreamBuffer can be reused. */
+    sStream.active = false;
+    if (more) {
+        StreamPrepare();
+    }
+}
+
 /* -------------------------------------------------------------------------------- */
 
 bool CommandAcceptCb(uint8_t msgId, int payloadLen, const uint8_t * pPayload)
@@ -495,9 +643,6 @@ static bool ResponseCb(int responseLength, const uint8_t* responseData)
     __attribute__ ((section(".noinit"))) __attribute__((aligned (4)))
     static uint8_t sNdefInstance[NDEFT2T_INSTANCE_SIZE];
 
-    __attribute__ ((section(".noinit"))) __attribute__((aligned (4)))
-    static uint8_t sData[NFC_SHARED_MEM_BYTE_SIZE];
-
     NDEFT2T_CREATE_RECORD_INFO_T recordInfo;
     bool success = sAcceptResponse;
     const char * pData;
@@ -524,7 +669,7 @@ static bool ResponseCb(int responseLength, const uint8_t* responseData)
 
     if (sAcceptResponse) {
         sAcceptResponse = false;
-        NDEFT2T_CreateMessage(sNdefInstance, sData, sizeof(sData), false);
+        NDEFT2T_CreateMessageDirect(sNdefInstance);
 
         if ((APP_MSG_ID_T)responseData[0] == APP_MSG_ID_GETCONFIG) {
             /* Append a mime record with the stored version info. */
@@ -609,10 +754,29 @@ void AppMsgInit(bool reuseKeys)
 
 void AppMsgHandleCommand(int cmdLength, const uint8_t* cmdData)
 {
+    /* Any new command ends a running transfer. Writing it already ended the read detection. */
+    sStream.active = false;
+    sStream.running = false;
     sAcceptResponse = true;
     Msg_HandleCommand(cmdLength, cmdData);
 }
 
+bool AppMsgStreamNext(void)
+{
+    bool running = sStream.running;
+    if (sStream.active) {
+        StreamSend();
+    }
+    else if (running) {
+        /* The last chunk has been read. Leave it in place, and stop detecting reads: the writing of the command had
+         * stopped that as well, before the transfer started.
+         */
+        sStream.running = false;
+        NDEFT2T_DisableMessageReadDetection();
+    }
+    return running;
+}
+
 void AppMsgHandlerSendMeasureTemperatureResponse(bool success, int16_t temperature)
 {
     APP_MSG_RESPONSE_MEASURETEMPERATURE_T response;
@@ -20,9 +20,10 @@
 
 //! [msg_mod_cmd_handler]
 static uint32_t Handler77(uint8_t msgId, int payloadLen, const uint8_t* pPayload);
-MSG_CMD_HANDLER_T appCmdHandler[MSG_APP_HANDLERS_COUNT] = { {0x77, Handler77},
-                                                            /* Additional commands can be added here. */
-                                                          };
+#define APP_CMD_HANDLERS(X) \
+    X(0x77, Handler77) \
+    /* Additional commands can be added here. */
+MSG_APP_HANDLER_TABLE(appCmdHandler, APP_CMD_HANDLERS); /* MSG_APP_HANDLERS_COUNT is 0x77 - MSG_ID_LASTRESERVED */
 //! [msg_mod_cmd_handler]
 
 static uint32_t Handler77(uint8_t msgId, int payloadLen, const uint8_t* pPayload)
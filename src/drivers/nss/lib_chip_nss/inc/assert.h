@@ -23,8 +23,12 @@
  * @note If the macro @c DEBUG is not defined, the #ASSERT macro generates no code.
  * @note If the expression @c expr has side-effects, the program behaves differently depending on whether @c DEBUG is
  *  defined.
+ * @note In the host-native simulation build (@c NSS_SIM), a failing expression aborts the process instead.
  */
-#ifdef DEBUG
+#if defined(NSS_SIM)
+    void Sim_AssertFailed(const char * file, int line);
+    #define ASSERT(expr) do { if (expr) {} else { Sim_AssertFailed(__FILE__, __LINE__); } } while (0)
+#elif defined(DEBUG)
     #define ASSERT(expr) do { if (expr) {} else { __asm__("BKPT"); } } while (0)
 #else
     #define ASSERT(expr) /* Prevent a compiler warning for unused variables */
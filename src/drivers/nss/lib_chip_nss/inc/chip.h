@@ -124,6 +124,11 @@ typedef struct NFC_UID_S {
 #define Chip_TIMER32_0_Init() Chip_TIMER_Init(NSS_TIMER32_0, CLOCK_PERIPHERAL_32TIMER0) /**< Helper function for Timer32_0 Init */
 #define Chip_TIMER32_0_DeInit() Chip_TIMER_DeInit(NSS_TIMER32_0, CLOCK_PERIPHERAL_32TIMER0) /**< Helper function for Timer32_0 DeInit */
 
+#if defined(NSS_SIM)
+/* Memories and register blocks are backed by host objects: see @ref SIM */
+#include "sim.h"
+#endif
+
 /**
  * Macro to annotate a function as "weak".
  * @note A weak function is linked-in, unless a function with the exact same name
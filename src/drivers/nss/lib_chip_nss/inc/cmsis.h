@@ -103,11 +103,16 @@ typedef enum {
 
 } IRQn_Type;
 
+#if defined(NSS_SIM)
+/* The core peripherals and intrinsics are simulated: see @ref SIM */
+#include "sim_core.h"
+#else
 /* Ignoring -Wsign-conversion in CMSIS (ARM) files */
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wsign-conversion"
 #include "core_cm0plus.h"
 #pragma GCC diagnostic pop
+#endif
 
 /**
  * @}
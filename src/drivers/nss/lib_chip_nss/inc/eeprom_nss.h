@@ -43,6 +43,15 @@
  *      Data is only guaranteed to be committed in non-volatile memory after a call to #Chip_EEPROM_Flush or
  *      #Chip_EEPROM_DeInit.
  *
+ * @par Write-back cache
+ *  Writes are collected in a RAM cache of #EEPROM_CACHE_ROWS rows. A row is only flushed - erased and programmed, which
+ *  takes about 2.5 ms - when its cache slot is needed for another row, or when #Chip_EEPROM_Flush is called. When all
+ *  slots are in use after a write, the oldest row is flushed in the background. Only one row can be flushed at a time.
+ *  A flush in the background is completed in #Chip_EEPROM_Poll. To have this done under interrupt, call
+ *  #Chip_EEPROM_Poll from @c EEPROM_IRQHandler and enable @c EEPROM_IRQn; otherwise the next call to any of the
+ *  functions of this driver completes it. #Chip_EEPROM_Read waits for a flush in progress, then returns the cached
+ *  data where it overlaps.
+ *
  * @warning EEPROM requires a system clock of 500 kHz or higher. This is not checked for.
  *  For a full list of clock restrictions in effect, see @ref NSS_CLOCK_RESTRICTIONS.
  *
@@ -54,6 +63,19 @@
 
 #include "chip.h"
 
+/**
+ * The number of EEPROM rows the driver caches in RAM. Each row costs #EEPROM_ROW_SIZE bytes of RAM.
+ * More rows means fewer flushes when writes alternate between rows, e.g. data and meta data; and less waiting when
+ * writing a series of rows.
+ * To override, define it in the application's @c app_sel.h or on the compiler command line.
+ */
+#if !defined(EEPROM_CACHE_ROWS)
+    #define EEPROM_CACHE_ROWS 4
+#endif
+#if (EEPROM_CACHE_ROWS < 1) || (EEPROM_CACHE_ROWS > EEPROM_NR_OF_RW_ROWS)
+    #error EEPROM_CACHE_ROWS must be in the range [1, EEPROM_NR_OF_RW_ROWS]
+#endif
+
 /** NSS EEPROM register block structure */
 typedef struct NSS_EEPROM_S {
     __IO uint32_t CMD; /*!< EEPROM command register */
@@ -124,10 +146,10 @@ void Chip_EEPROM_Read(NSS_EEPROM_T *pEEPROM, int offset, void *pBuf, int size);
  * @param pBuf : Pointer to the data to be copied into EEPROM. There are no alignment requirements.
  * @param size : Number of bytes to copy
  * @c offset + @c size must not exceed #EEPROM_ROW_SIZE * #EEPROM_NR_OF_RW_ROWS
- * @note This function's timing is non deterministic. Possibly, a pending flush must be executed before data is written;
- *  and when the data to write is spread over multiple EEPROM rows, intermediate flushes are also required.
- * @note The portion written in the last row is not committed an flushed to EEPROM. To be sure written data is
- *  effectively retained in the EEPROM memory, user needs to call #Chip_EEPROM_Flush or #Chip_EEPROM_DeInit
+ * @note This function's timing is non deterministic. When the written rows are not cached yet and no cache slot is free,
+ *  a flush must be completed first; the oldest row is flushed in the background when all slots are in use afterwards.
+ * @note The written data is not flushed to EEPROM. To be sure written data is effectively retained in the EEPROM
+ *  memory, user needs to call #Chip_EEPROM_Flush or #Chip_EEPROM_DeInit
  * @pre @c offset an @c size denote a memory region. The caller must ensure this whole region lies inside the
  *  EEPROM memory. This is not checked for.
  */
@@ -143,20 +165,30 @@ void Chip_EEPROM_Write(NSS_EEPROM_T *pEEPROM, int offset, const void *pBuf, int
  * @note The @c offset an @c size denote a memory region. If any part of this region lies outside the EEPROM memory,
  *  nothing is written, and the function call is a void operation.
  *  @c offset + @c size must not exceed #EEPROM_ROW_SIZE * #EEPROM_NR_OF_RW_ROWS
- * @note This function's timing is non deterministic. Possibly, a pending flush must be executed before data is written;
- *  and when the data to write is spread over multiple EEPROM rows, intermediate flushes are also required.
- * @note The portion written in the last row is not committed an flushed to EEPROM. To be sure written data is
- *  effectively retained in the EEPROM memory, user needs to call #Chip_EEPROM_Flush or #Chip_EEPROM_DeInit
+ * @note This function's timing is non deterministic. When the written rows are not cached yet and no cache slot is free,
+ *  a flush must be completed first; the oldest row is flushed in the background when all slots are in use afterwards.
+ * @note The written data is not flushed to EEPROM. To be sure written data is effectively retained in the EEPROM
+ *  memory, user needs to call #Chip_EEPROM_Flush or #Chip_EEPROM_DeInit
  */
 void Chip_EEPROM_Memset(NSS_EEPROM_T *pEEPROM, int offset, uint8_t pattern, int size);
 
 /**
- * If needed, this function flushes pending data into the EEPROM. When this function returns, the flush operation has
- * been completed. To be used only if the user wants to make sure written data is retained, for example before going to
- * sleep.
+ * If needed, this function flushes all cached rows into the EEPROM, one after the other. To be used only if the user
+ * wants to make sure written data is retained, for example before going to sleep.
  * @param pEEPROM : ignored. Argument no longer used but kept for compatibility.
- * @param wait : ignored. Argument no longer used but kept for compatibility.
+ * @param wait : If @c true, returns when all flush operations have been completed. If @c false, returns after starting
+ *  the first flush operation: the others are started by #Chip_EEPROM_Poll, until it returns @c false.
  */
 void Chip_EEPROM_Flush(NSS_EEPROM_T *pEEPROM, bool wait);
 
+/**
+ * Completes a flush that was started in the background, and starts the next one when #Chip_EEPROM_Flush was called
+ * without waiting. Returns immediately.
+ * @param pEEPROM : ignored. Argument kept for consistency with the other functions.
+ * @return @c true while a flush is in progress.
+ * @note May be called under interrupt, typically from @c EEPROM_IRQHandler: the EEPROM interrupt is raised when a
+ *  flush completes.
+ */
+bool Chip_EEPROM_Poll(NSS_EEPROM_T *pEEPROM);
+
 #endif /** @} */
@@ -43,6 +43,11 @@
  *   -# Polling based handling makes use of #Chip_I2C_EventHandlerPolling handler.
  *  The user can also implement an own handler using #Chip_I2C_SetMasterEventHandler to perform specific actions for
  *   specific events (#I2C_EVENT_T).
+ * @par Asynchronous I2C Master transfers:
+ *  #Chip_I2C_MasterTransferStart starts a transfer and returns immediately. Completion is reported by the
+ *  #I2C_EVENT_DONE event, under interrupt, and can also be polled in #I2C_XFER_T.status. This frees the CPU for the
+ *  duration of the transfer, e.g. to enter a low power mode. For a queue of transfers on top of this, see the i2cq
+ *  module.
  *
  * @par To use this driver:
  *  <b> I2C Driver is initialized as follows: </b>
@@ -237,6 +242,22 @@ uint32_t Chip_I2C_GetClockRate(I2C_ID_T id);
  */
 I2C_STATUS_T Chip_I2C_MasterTransfer(I2C_ID_T id, I2C_XFER_T *xfer);
 
+/**
+ * Start a transmit and receive in master mode, without waiting for its completion.
+ * @param id : I2C peripheral selected (#I2C0)
+ * @param xfer : Pointer to a #I2C_XFER_T structure, see #Chip_I2C_MasterTransfer.
+ * @pre Interrupt based event handling is used: #Chip_I2C_MasterStateHandler is called from the interrupt handler and
+ *  the I2C interrupt is enabled in NVIC.
+ * @pre No other master transfer is in progress.
+ * @post #I2C_XFER_T.status is #I2C_STATUS_BUSY until the transfer completes, after which it holds the final status
+ *  as returned by #Chip_I2C_MasterTransfer.
+ * @note The event handler is called with #I2C_EVENT_LOCK before the transfer starts. When the transfer completes, it
+ *  is called under interrupt with #I2C_EVENT_UNLOCK and then with #I2C_EVENT_DONE. At that time the driver is ready
+ *  for the next transfer: it can be started from within the event handler.
+ * @note During the transfer, program execution must not change the content of the memory pointed to by @a xfer.
+ */
+void Chip_I2C_MasterTransferStart(I2C_ID_T id, I2C_XFER_T *xfer);
+
 /**
  * Transmit data to I2C slave using I2C Master mode
  * @param id : I2C peripheral ID (#I2C0)
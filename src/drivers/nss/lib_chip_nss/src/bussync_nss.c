@@ -34,6 +34,9 @@ static void Chip_BusSync_WaitSync(volatile const uint32_t *pACCSTAT)
     while ((0 == ((*pACCSTAT) & 0x1)) /* Test if register access is now possible */ &&
             (tickswaited < MAX_WAITTIME_SYSCLOCKTICKS) /* Timeout to prevent infinite loop */) {
         tickswaited += 6; /* 6 is the estimated worst-case (lowest) instruction/cycle count per while-loop */
+#if defined(NSS_SIM)
+        Sim_Sync();
+#endif
     };
 
     /* Check if timeout occurred while waiting for register access to complete
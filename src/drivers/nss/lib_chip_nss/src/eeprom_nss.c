@@ -34,61 +34,181 @@
 #define EEPROM_OFFSET_TO_ROW(x) ((x) / EEPROM_ROW_SIZE)
 
 /**
- * The offset in the EEPROM starting from where the contents are cashed, with @c 0 pointing to the start of the EEPROM
- * memory.
+ * Per cache slot, the offset in the EEPROM of the cached row, with @c 0 pointing to the start of the EEPROM memory;
+ * or @c -1 when the slot is free.
  * Must always point to the first byte of a row.
  */
 __attribute__((section(".noinit")))
-static int sCachedOffset;
+static int sCachedOffset[EEPROM_CACHE_ROWS];
 
 /**
- * Buffer to hold the cached data.
+ * Buffers to hold the cached data, one row per slot. A cached row always holds data that is not yet flushed.
  */
 __attribute__ ((section(".noinit"))) __attribute__((aligned (2)))
-static uint8_t sCachedData[EEPROM_ROW_SIZE];
+static uint8_t sCachedData[EEPROM_CACHE_ROWS][EEPROM_ROW_SIZE];
+
+/** Per cache slot, the value of #sUseCount at the last write: the slot with the lowest value is evicted first. */
+__attribute__((section(".noinit")))
+static uint32_t sLastUse[EEPROM_CACHE_ROWS];
+
+/** Incremented with each write to the cache. */
+__attribute__((section(".noinit")))
+static uint32_t sUseCount;
+
+/**
+ * The slot whose row is being erased and programmed, or @c -1. Only one row can be flushed at a time: the EEPROM
+ * controller latches the row written last.
+ */
+__attribute__((section(".noinit")))
+static volatile int sFlushing;
+
+/** @c true while all cached rows are being flushed, one after the other: see #Chip_EEPROM_Flush */
+__attribute__((section(".noinit")))
+static volatile bool sFlushAll;
 
 /* ------------------------------------------------------------------------- */
 
 /**
- * Copies the cached data - if any - from #sCachedData to EEPROM, then starts an erase & program operation a.k.a flush.
- * Returns when this is completed.
- * When called redundantly, this function is a void operation.
+ * Copies the cached data of one slot to EEPROM, then starts an erase & program operation a.k.a flush.
+ * Returns immediately: see #Progress.
+ * @param slot A slot holding a row.
+ * @pre No flush is in progress, and interrupts are disabled.
  */
-static void CommitAndFlush(void)
+static void CommitAndStartFlush(int slot)
+{
+    /* Assumptions of code below */
+    ASSERT(sFlushing < 0); /* The EEPROM controller must be idle. */
+    ASSERT(((int)sCachedData[slot] & 1) == 0); /* The buffer must be 16-bit aligned. */
+    ASSERT(sCachedOffset[slot] % EEPROM_ROW_SIZE == 0); /* Exactly 1 EEPROM row must have been cached. */
+
+    /* Commit */
+    uint16_t * src = (uint16_t *)sCachedData[slot];
+    uint16_t * dst = (uint16_t *)EEPROM_START + sCachedOffset[slot] / 2;
+    for (int i = 0; i < EEPROM_ROW_SIZE; i += 2) {
+        *dst = *src;
+        dst++;
+        src++;
+    }
+
+    /* Flush: the completion is also signaled on EEPROM_IRQn, for the application to call Chip_EEPROM_Poll. */
+    NSS_EEPROM->INT_CLR_STATUS = EEPROM_PROG_DONE_STATUS_BIT;
+    NSS_EEPROM->INT_SET_ENABLE = EEPROM_PROG_DONE_STATUS_BIT;
+    NSS_EEPROM->CMD = EEPROM_START_ERASE_PROGRAM;
+    sFlushing = slot;
+#if defined(NSS_SIM)
+    Sim_Sync(); /* Applies the status clear before it is checked in Progress. */
+#endif
+}
+
+/** @return The cached slot that was written to longest ago, excluding the one being flushed; or @c -1. */
+static int FindOldest(void)
 {
-    if (sCachedOffset >= 0) {
-        /* Assumptions of code below */
-        ASSERT(EEPROM_ROW_SIZE == sizeof(sCachedData)); /* The buffer size must be 1 EEPROM row. */
-        ASSERT(((int)sCachedData & 1) == 0); /* The buffer must be 16-bit aligned. */
-        ASSERT(sCachedOffset % EEPROM_ROW_SIZE == 0); /* Exactly 1 EEPROM row must have been cached. */
-
-        /* Commit */
-        uint16_t * src = (uint16_t *)sCachedData;
-        uint16_t * dst = (uint16_t *)EEPROM_START + sCachedOffset / 2;
-        for (int i = 0; i < EEPROM_ROW_SIZE; i += 2) {
-            *dst = *src;
-            dst++;
-            src++;
+    int oldest = -1;
+    for (int slot = 0; slot < EEPROM_CACHE_ROWS; slot++) {
+        if ((sCachedOffset[slot] >= 0) && (slot != sFlushing)
+            && ((oldest < 0) || (sLastUse[slot] < sLastUse[oldest]))) {
+            oldest = slot;
         }
+    }
+    return oldest;
+}
 
-        /* Flush */
+/**
+ * Completes the flush in progress - if any - when the EEPROM reports it is done, and frees its slot. When all rows are
+ * to be flushed, the next flush is started.
+ * @pre Interrupts are disabled.
+ */
+static void Progress(void)
+{
+    if ((sFlushing >= 0) && (NSS_EEPROM->INT_STATUS & EEPROM_PROG_DONE_STATUS_BIT)) {
+        NSS_EEPROM->INT_CLR_ENABLE = EEPROM_PROG_DONE_STATUS_BIT;
         NSS_EEPROM->INT_CLR_STATUS = EEPROM_PROG_DONE_STATUS_BIT;
-        NSS_EEPROM->CMD = EEPROM_START_ERASE_PROGRAM;
-        while ((NSS_EEPROM->INT_STATUS & EEPROM_PROG_DONE_STATUS_BIT) == 0) {
-            ; /* wait */
+#if defined(NSS_SIM)
+        Sim_Sync(); /* Lowers the interrupt line. */
+#endif
+        sCachedOffset[sFlushing] = -1;
+        sFlushing = -1;
+        if (sFlushAll) {
+            int slot = FindOldest();
+            if (slot >= 0) {
+                CommitAndStartFlush(slot);
+            }
+            else {
+                sFlushAll = false;
+            }
         }
+    }
+}
 
-        sCachedOffset = -1;
+/**
+ * Waits until no flush is in progress. Interrupts are enabled while waiting, as far as the caller had them enabled.
+ * @param primask The interrupt mask of the caller, before it disabled the interrupts.
+ * @param all If @c true, also waits until all rows requested by #Chip_EEPROM_Flush are flushed.
+ * @pre Interrupts are disabled.
+ * @post Interrupts are disabled.
+ */
+static void WaitIdle(uint32_t primask, bool all)
+{
+    Progress();
+    while ((sFlushing >= 0) || (all && sFlushAll)) {
+        __set_PRIMASK(primask);
+#if defined(NSS_SIM)
+        Sim_Poll();
+#endif
+        __disable_irq();
+        Progress();
     }
 }
 
+/**
+ * Finds the slot caching the row at the given offset, or loads the row in a free slot. When no slot is free, the
+ * oldest slot is flushed first.
+ * @param primask See #WaitIdle
+ * @param rowOffset The offset of the first byte of a row.
+ * @return The slot, not being flushed.
+ * @pre Interrupts are disabled.
+ */
+static int Acquire(uint32_t primask, int rowOffset)
+{
+    int slot;
+
+    for (slot = 0; slot < EEPROM_CACHE_ROWS; slot++) {
+        if (sCachedOffset[slot] == rowOffset) {
+            break;
+        }
+    }
+    if (slot == sFlushing) {
+        /* The data is latched already: wait until it is programmed, then cache the row anew. */
+        WaitIdle(primask, false);
+        slot = EEPROM_CACHE_ROWS;
+    }
+    if (slot == EEPROM_CACHE_ROWS) {
+        for (;;) {
+            for (slot = 0; (slot < EEPROM_CACHE_ROWS) && (sCachedOffset[slot] >= 0); slot++) {
+                ; /* find a free slot */
+            }
+            if (slot < EEPROM_CACHE_ROWS) {
+                break;
+            }
+            if (sFlushing < 0) {
+                CommitAndStartFlush(FindOldest());
+            }
+            WaitIdle(primask, false);
+        }
+        WaitIdle(primask, false); /* Do not read the EEPROM memory while it is being programmed. */
+        sCachedOffset[slot] = rowOffset;
+        memcpy(sCachedData[slot], (uint8_t *)(EEPROM_START + rowOffset), (uint32_t)EEPROM_ROW_SIZE);
+    }
+    return slot;
+}
+
 /**
  * Loops over these actions:
- * - Initialize #sCachedData if necessary
- * - Find the portion of @c pBuf that can be copied to #sCachedData
- * - Copies that portion to #sCachedData
- * - If not all data is copied, commits and flushed #sCachedData to EEPROM memory
+ * - Find or initialize the slot in #sCachedData for the row holding @c offset
+ * - Copies the portion of @c pBuf that falls in that row to the slot
  * - repeat until all data is copied
+ * The cached rows are only flushed when their slot is needed for another row. When all slots are in use afterwards,
+ * the oldest row is flushed in the background: this makes a free slot available by the time the next row is needed.
  * @param offset See #Chip_EEPROM_Write and #Chip_EEPROM_Memset
  * @param pBuf See #Chip_EEPROM_Write and #Chip_EEPROM_Memset
  * @param size See #Chip_EEPROM_Write and #Chip_EEPROM_Memset
@@ -107,35 +227,23 @@ static void Write(int offset, const void * pBuf, int size, bool singleValue)
     ASSERT(offset >= 0);
     ASSERT(offset + size < EEPROM_ROW_SIZE * (EEPROM_NR_OF_RW_ROWS + 1));
 
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
     while (size > 0) {
-        if (sCachedOffset < 0) { /* If nothing is cached */
-            sCachedOffset = (offset / EEPROM_ROW_SIZE) * EEPROM_ROW_SIZE;
-            memcpy(sCachedData, (uint8_t *)(EEPROM_START + sCachedOffset), (uint32_t)sizeof(sCachedData));
+        int rowOffset = (offset / EEPROM_ROW_SIZE) * EEPROM_ROW_SIZE;
+        int slot = Acquire(primask, rowOffset);
+        int relativeOffset = offset - rowOffset;
+        int partialSize = EEPROM_ROW_SIZE - relativeOffset; /* the maximum value that can be copied */
+        if (size <= partialSize) {
+            partialSize = size;
         }
-        int relativeOffset = offset - sCachedOffset;
-
-        /* Find the overlap with what's already cached.
-         *   EEPROM: eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee
-         *   cached:               cccccccc
-         * to write:                              wwwww     --> relativeOffset > sizeof(sCachedData)
-         *      OR:                      wwwww
-         *      OR:                  wwwww
-         *      OR:              wwwww                                        --> relativeOffset < 0
-         *      OR:     wwwww                                                 --> relativeOffset < 0
-         */
-        int partialSize = 0;
-        if ((0 <= relativeOffset) && (relativeOffset < (int)sizeof(sCachedData))) {
-            partialSize = (int)sizeof(sCachedData) - relativeOffset; /* the maximum value that can be copied */
-            if (size <= partialSize) {
-                partialSize = size;
-            }
-            if (singleValue) {
-                memset(sCachedData + relativeOffset, *(uint8_t *)pBuf, (uint32_t)partialSize);
-            }
-            else {
-                memcpy(sCachedData + relativeOffset, pBuf, (uint32_t)partialSize);
-            }
+        if (singleValue) {
+            memset(sCachedData[slot] + relativeOffset, *(uint8_t *)pBuf, (uint32_t)partialSize);
         }
+        else {
+            memcpy(sCachedData[slot] + relativeOffset, pBuf, (uint32_t)partialSize);
+        }
+        sLastUse[slot] = ++sUseCount;
 
         /* Prepare the next iteration. */
         offset += partialSize;
@@ -143,11 +251,19 @@ static void Write(int offset, const void * pBuf, int size, bool singleValue)
             pBuf = (uint8_t *)pBuf + partialSize;
         }
         size -= partialSize;
-        /* commit and flush only if necessary */
-        if (size > 0) {
-            CommitAndFlush();
+    }
+
+    Progress();
+    if ((sFlushing < 0) && (FindOldest() >= 0)) {
+        int slot;
+        for (slot = 0; (slot < EEPROM_CACHE_ROWS) && (sCachedOffset[slot] >= 0); slot++) {
+            ; /* find a free slot */
+        }
+        if (slot == EEPROM_CACHE_ROWS) {
+            CommitAndStartFlush(FindOldest());
         }
     }
+    __set_PRIMASK(primask);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -174,13 +290,19 @@ void Chip_EEPROM_Init(NSS_EEPROM_T *pEEPROM)
     }
     NSS_EEPROM->CLKDIV = (uint32_t)div;
 
-    sCachedOffset = -1;
+    for (int slot = 0; slot < EEPROM_CACHE_ROWS; slot++) {
+        sCachedOffset[slot] = -1;
+        sLastUse[slot] = 0;
+    }
+    sUseCount = 0;
+    sFlushing = -1;
+    sFlushAll = false;
 }
 
 void Chip_EEPROM_DeInit(NSS_EEPROM_T *pEEPROM)
 {
     (void)pEEPROM; /* suppress [-Wunused-parameter]: argument no longer used but kept for compatibility. */
-    CommitAndFlush();
+    Chip_EEPROM_Flush(NSS_EEPROM, true);
     Chip_SysCon_Peripheral_AssertReset(SYSCON_PERIPHERAL_RESET_EEPROM);
     Chip_SysCon_Peripheral_DisablePower(SYSCON_PERIPHERAL_POWER_EEPROM);
     Chip_Clock_Peripheral_DisableClock(CLOCK_PERIPHERAL_EEPROM);
@@ -189,8 +311,36 @@ void Chip_EEPROM_DeInit(NSS_EEPROM_T *pEEPROM)
 void Chip_EEPROM_Flush(NSS_EEPROM_T *pEEPROM, bool wait)
 {
     (void)pEEPROM; /* suppress [-Wunused-parameter]: argument no longer used but kept for compatibility. */
-    (void)wait; /* suppress [-Wunused-parameter]: argument no longer used but kept for compatibility. */
-    CommitAndFlush();
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    Progress();
+    sFlushAll = true;
+    if (sFlushing < 0) {
+        int slot = FindOldest();
+        if (slot >= 0) {
+            CommitAndStartFlush(slot);
+        }
+        else {
+            sFlushAll = false;
+        }
+    }
+    if (wait) {
+        WaitIdle(primask, true);
+    }
+    __set_PRIMASK(primask);
+}
+
+bool Chip_EEPROM_Poll(NSS_EEPROM_T *pEEPROM)
+{
+    (void)pEEPROM; /* suppress [-Wunused-parameter]: argument kept for consistency with the other functions. */
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    Progress();
+    bool busy = (sFlushing >= 0);
+    __set_PRIMASK(primask);
+    return busy;
 }
 
 void Chip_EEPROM_Read(NSS_EEPROM_T *pEEPROM, int offset, void * pBuf, int size)
@@ -202,20 +352,28 @@ void Chip_EEPROM_Read(NSS_EEPROM_T *pEEPROM, int offset, void * pBuf, int size)
     ASSERT(size > 0);
     ASSERT(offset + size <= EEPROM_ROW_SIZE * EEPROM_NR_OF_R_ROWS);
 
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    WaitIdle(primask, false); /* Do not read the EEPROM memory while it is being programmed. */
     memcpy(pBuf, (uint8_t *)(EEPROM_START + offset), (uint32_t)size);
 
-    if (sCachedOffset >= 0) {
+    for (int slot = 0; slot < EEPROM_CACHE_ROWS; slot++) {
+        if (sCachedOffset[slot] < 0) {
+            continue;
+        }
+        const uint8_t * cachedData = sCachedData[slot];
+        int cachedOffset = sCachedOffset[slot];
         /* Check if address ranges overlap */
-        uint8_t * src;
+        const uint8_t * src;
         uint8_t * dst;
-        if (sCachedOffset < offset) {
+        if (cachedOffset < offset) {
             /*  EEPROM: eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee
              * to read:                              rrrrr
              *  cached:               cccccccc
              *      OR:                        cccccccc
              *      OR:                             cccccccc
              */
-            src = sCachedData + (offset - sCachedOffset); /* S below */
+            src = cachedData + (offset - cachedOffset); /* S below */
             dst = pBuf; /* D below */
             /*  EEPROM: eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee
              * to read:                              Drrrr
@@ -231,8 +389,8 @@ void Chip_EEPROM_Read(NSS_EEPROM_T *pEEPROM, int offset, void * pBuf, int size)
              *      OR:                                cccccccc
              *      OR:                                            cccccccc
              */
-            src = sCachedData; /* S below */
-            dst = (uint8_t *)pBuf + (sCachedOffset - offset); /* D below */
+            src = cachedData; /* S below */
+            dst = (uint8_t *)pBuf + (cachedOffset - offset); /* D below */
             /*  EEPROM: eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee
              * to read:                              Drrrr
              *  cached:                              Sccccccc
@@ -242,14 +400,15 @@ void Chip_EEPROM_Read(NSS_EEPROM_T *pEEPROM, int offset, void * pBuf, int size)
              *  cached:                                            Sccccccc
              */
         }
-        if ((src < sCachedData + sizeof(sCachedData)) && (dst < (uint8_t *)pBuf + size)) { /* Excluding out of bounds */
+        if ((src < cachedData + EEPROM_ROW_SIZE) && (dst < (uint8_t *)pBuf + size)) { /* Excluding out of bounds */
             int partialSize = (uint8_t *)pBuf + size - dst; /* Limit the size so it fits in the destination */
-            if (partialSize > (int)sizeof(sCachedData)) {
-                partialSize = (int)sizeof(sCachedData); /* Limit the size so it fits in the source */
+            if (partialSize > cachedData + EEPROM_ROW_SIZE - src) {
+                partialSize = cachedData + EEPROM_ROW_SIZE - src; /* Limit the size so it fits in the source */
             }
             memcpy(dst, src, (uint32_t)partialSize); /* Overwrite with cached data */
         }
     }
+    __set_PRIMASK(primask);
 }
 
 void Chip_EEPROM_Write(NSS_EEPROM_T *pEEPROM, int offset, const void * pBuf, int size)
@@ -10,6 +10,7 @@
  */
 
 #include "chip.h"
+#include "profile/profile.h"
 
 /* ------------------------------------------------------------------------- */
 
@@ -179,6 +180,7 @@
 #define I2C_CON_FLAGS (I2C_CON_AA | I2C_CON_SI | I2C_CON_STO | I2C_CON_STA)
 #define NSS_I2Cx(id)      ((i2c[id].ip))
 #define SLAVE_ACTIVE(iic) (((iic)->flags & 0xFF00) != 0)
+#define MASTER_ASYNC_FLAG (1u << 0) /* The active master transfer was started by Chip_I2C_MasterTransferStart */
 
 /* I2C common interface structure */
 struct i2c_interface {
@@ -484,6 +486,9 @@ void Chip_I2C_EventHandler(I2C_ID_T id, I2C_EVENT_T event)
     int counter = 100000; /* A safety counter to avoid possible infinite loops. Does its precise value matter that much? */
     do {
         counter--; /* wait */
+#if defined(NSS_SIM)
+        Sim_Poll();
+#endif
     } while ((*stat == I2C_STATUS_BUSY) && counter);
 //    while (*stat == I2C_STATUS_BUSY) {
 //    }
@@ -506,6 +511,9 @@ void Chip_I2C_EventHandlerPolling(I2C_ID_T id, I2C_EVENT_T event)
 //    while (*stat == I2C_STATUS_BUSY) {
     while ((*stat == I2C_STATUS_BUSY) && counter) {
         counter--; /* wait */
+#if defined(NSS_SIM)
+        Sim_Poll();
+#endif
         if (Chip_I2C_IsStateChanged(id)) {
             Chip_I2C_MasterStateHandler(id);
         }
@@ -572,6 +580,7 @@ I2C_EVENTHANDLER_T Chip_I2C_GetMasterEventHandler(I2C_ID_T id)
 I2C_STATUS_T Chip_I2C_MasterTransfer(I2C_ID_T id, I2C_XFER_T *xfer)
 {
     struct i2c_interface *iic = &i2c[id];
+    PROFILE_BEGIN(PROFILE_ID_I2C_TRANSFER);
 
     iic->mEvent(id, I2C_EVENT_LOCK);
     xfer->status = I2C_STATUS_BUSY;
@@ -586,6 +595,9 @@ I2C_STATUS_T Chip_I2C_MasterTransfer(I2C_ID_T id, I2C_XFER_T *xfer)
 
     /* Wait for stop condition to appear on bus */
     while (!isI2CBusFree(iic->ip)) {
+#if defined(NSS_SIM)
+        Sim_Poll();
+#endif
     }
 
     /* Start slave if one is active */
@@ -594,9 +606,26 @@ I2C_STATUS_T Chip_I2C_MasterTransfer(I2C_ID_T id, I2C_XFER_T *xfer)
     }
 
     iic->mEvent(id, I2C_EVENT_UNLOCK);
+    PROFILE_END(PROFILE_ID_I2C_TRANSFER);
     return xfer->status;
 }
 
+/* Start a master transfer without waiting for its completion */
+void Chip_I2C_MasterTransferStart(I2C_ID_T id, I2C_XFER_T *xfer)
+{
+    struct i2c_interface *iic = &i2c[id];
+
+    iic->mEvent(id, I2C_EVENT_LOCK);
+    xfer->status = I2C_STATUS_BUSY;
+    iic->flags |= MASTER_ASYNC_FLAG;
+    iic->mXfer = xfer;
+
+    /* If slave xfer not in progress */
+    if (!iic->sXfer) {
+        startMasterXfer(iic->ip);
+    }
+}
+
 /* Master tx only */
 int Chip_I2C_MasterSend(I2C_ID_T id, uint8_t slaveAddr, const uint8_t *buff, int len)
 {
@@ -646,8 +675,28 @@ int Chip_I2C_IsMasterActive(I2C_ID_T id)
 /* State change handler for master transfer */
 void Chip_I2C_MasterStateHandler(I2C_ID_T id)
 {
-    if (!handleMasterXferState(i2c[id].ip, i2c[id].mXfer)) {
-        i2c[id].mEvent(id, I2C_EVENT_DONE);
+    struct i2c_interface *iic = &i2c[id];
+
+    if (!handleMasterXferState(iic->ip, iic->mXfer)) {
+        if (iic->flags & MASTER_ASYNC_FLAG) {
+            /* Finish what Chip_I2C_MasterTransfer does after the wait, so the event handler can start a next transfer. */
+            iic->flags &= ~MASTER_ASYNC_FLAG;
+            iic->mXfer = NULL;
+
+            /* Wait for stop condition to appear on bus: this takes at most one bit time. */
+            while (!isI2CBusFree(iic->ip)) {
+#if defined(NSS_SIM)
+                Sim_Poll();
+#endif
+            }
+
+            /* Start slave if one is active */
+            if (SLAVE_ACTIVE(iic)) {
+                startSlaverXfer(iic->ip);
+            }
+            iic->mEvent(id, I2C_EVENT_UNLOCK);
+        }
+        iic->mEvent(id, I2C_EVENT_DONE);
     }
 }
 
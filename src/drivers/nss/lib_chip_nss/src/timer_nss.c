@@ -44,6 +44,9 @@ void Chip_TIMER_Reset(NSS_TIMER_T *pTMR)
 
     while (pTMR->TC != 0) {
         /* Wait for terminal count to clear */
+#if defined(NSS_SIM)
+        Sim_Sync();
+#endif
     }
 
     /* Restore timer state */
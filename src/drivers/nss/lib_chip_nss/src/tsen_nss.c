@@ -65,6 +65,9 @@ TSEN_RESOLUTION_T Chip_TSen_GetResolution(NSS_TSEN_T *pTSen)
 void Chip_TSen_Start(NSS_TSEN_T *pTSen)
 {
     pTSen->CR |= 0x1 << 0;
+#if defined(NSS_SIM)
+    Sim_Sync(); /* Clears the RDY flag of the previous measurement, as reading DR does on the real hardware. */
+#endif
 }
 
 TSEN_STATUS_T Chip_TSen_ReadStatus(NSS_TSEN_T *pTSen, TSEN_RESOLUTION_T *pResolution)
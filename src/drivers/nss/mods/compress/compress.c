@@ -11,6 +11,10 @@
 
 #include "board.h"
 #include "compress/compress.h"
+#include "profile/profile.h"
+
+#if COMPRESS_CODEC == COMPRESS_CODEC_HEATSHRINK
+
 #include "heatshrink/heatshrink_encoder.h"
 #include "heatshrink/heatshrink_decoder.h"
 
@@ -19,30 +23,32 @@ int Compress_Encode(const uint8_t * input, int inputLength, uint8_t * output, in
     heatshrink_encoder encoder;
     bool success = true;
     int compressedSize = 0;
+    PROFILE_BEGIN(PROFILE_ID_COMPRESS_ENCODE);
 
     heatshrink_encoder_reset(&encoder);
     while (success && (inputLength > 0)) {
         /* Add uncompressed data */
-        int sunk = 0;
-        success &= heatshrink_encoder_sink(&encoder, input, (size_t)inputLength, (size_t *)&sunk) == HSER_SINK_OK;
+        size_t sunk = 0; /* size_t, not int: the pointer is written through as a size_t. */
+        success &= heatshrink_encoder_sink(&encoder, input, (size_t)inputLength, &sunk) == HSER_SINK_OK;
         input += sunk;
-        inputLength -= sunk;
+        inputLength -= (int)sunk;
         if (inputLength == 0) {
             success &= heatshrink_encoder_finish(&encoder) == HSER_FINISH_MORE;
         }
         /* Retrieve compressed data */
         HSE_poll_res pollResult;
-        int polled;
+        size_t polled;
         do {
             polled = 0;
-            pollResult = heatshrink_encoder_poll(&encoder, output, (size_t)outputLength, (size_t *)&polled);
+            pollResult = heatshrink_encoder_poll(&encoder, output, (size_t)outputLength, &polled);
             output += polled;
-            outputLength -= polled;
-            compressedSize += polled;
+            outputLength -= (int)polled;
+            compressedSize += (int)polled;
         } while ((pollResult == HSER_POLL_MORE) && (polled > 0));
         success &= pollResult == HSER_POLL_EMPTY;
     }
     success &= heatshrink_encoder_finish(&encoder) == HSER_FINISH_DONE;
+    PROFILE_END(PROFILE_ID_COMPRESS_ENCODE);
     return success ? compressedSize : 0;
 }
 
@@ -55,22 +61,22 @@ int Compress_Decode(const uint8_t * input, int inputLength, uint8_t * output, in
     heatshrink_decoder_reset(&decoder);
     while (success && (inputLength > 0)) {
         /* Add compressed data */
-        int sunk = 0;
-        success &= heatshrink_decoder_sink(&decoder, input, (size_t)inputLength, (size_t *)&sunk) == HSDR_SINK_OK;
+        size_t sunk = 0; /* size_t, not int: the pointer is written through as a size_t. */
+        success &= heatshrink_decoder_sink(&decoder, input, (size_t)inputLength, &sunk) == HSDR_SINK_OK;
         input += sunk;
-        inputLength -= sunk;
+        inputLength -= (int)sunk;
         if (inputLength == 0) {
             success &= heatshrink_decoder_finish(&decoder) == HSDR_FINISH_MORE;
         }
         /* Retrieve uncompressed data */
         HSD_poll_res pollResult;
-        int polled;
+        size_t polled;
         do {
             polled = 0;
-            pollResult = heatshrink_decoder_poll(&decoder, output, (size_t)outputLength, (size_t *)&polled);
+            pollResult = heatshrink_decoder_poll(&decoder, output, (size_t)outputLength, &polled);
             output += polled;
-            outputLength -= polled;
-            uncompressedSize += polled;
+            outputLength -= (int)polled;
+            uncompressedSize += (int)polled;
         } while ((pollResult == HSDR_POLL_MORE) && (polled > 0));
         /* If the decoding fully fills the available buffer, polled equaled outputLength when heatshrink_decoder_poll
          * returned the last but one time; and both polled and outputLength are now 0 after heatshrink_decoder_poll a
@@ -83,3 +89,201 @@ int Compress_Decode(const uint8_t * input, int inputLength, uint8_t * output, in
 
     return success ? uncompressedSize : 0;
 }
+
+#else /* COMPRESS_CODEC == COMPRESS_CODEC_DELTA */
+
+/* ------------------------------------------------------------------------- */
+
+/** The number of bits used to store the length in bytes of the uncompressed data. */
+#define LENGTH_BITS 16
+
+/** The number of bits used to store a bit width, ranging from 0 up to and including #COMPRESS_DELTA_BITSIZE. */
+#define WIDTH_BITS 5
+
+/** A mask selecting the bits of one sample. */
+#define SAMPLE_MASK ((1U << COMPRESS_DELTA_BITSIZE) - 1)
+
+/** Maps a signed value to an unsigned one, interleaving positive and negative values: 0, -1, 1, -2, 2, ... */
+#define ZIGZAG(x) ((uint32_t)(((x) << 1) ^ ((x) >> 31)))
+
+/** The inverse of #ZIGZAG */
+#define UNZIGZAG(x) ((int32_t)((x) >> 1) ^ -(int32_t)((x) & 1))
+
+/**
+ * Reads or writes a stream of bits, LSBit first. Up to 7 bits are buffered in @c bits; the bytes are read or written
+ * one at a time.
+ */
+typedef struct BITSTREAM_S {
+    uint8_t * pData; /**< The next byte to read or write. */
+    int remaining; /**< The number of bytes that can still be read or written. */
+    uint32_t bits; /**< The bits read but not yet returned, or given but not yet written. */
+    int bitCount; /**< The number of valid bits in @c bits. */
+    bool overflow; /**< @c true when more bytes were needed than @c remaining allowed. */
+} BITSTREAM_T;
+
+/* ------------------------------------------------------------------------- */
+
+static void Put(BITSTREAM_T * pStream, uint32_t value, int width)
+{
+    pStream->bits |= value << pStream->bitCount;
+    pStream->bitCount += width;
+    while (pStream->bitCount >= 8) {
+        if (pStream->remaining > 0) {
+            *pStream->pData++ = (uint8_t)pStream->bits;
+            pStream->remaining--;
+        }
+        else {
+            pStream->overflow = true;
+        }
+        pStream->bits >>= 8;
+        pStream->bitCount -= 8;
+    }
+}
+
+/** Writes out the last, incomplete byte. The unused bits in it are 0. */
+static void Flush(BITSTREAM_T * pStream)
+{
+    if (pStream->bitCount > 0) {
+        Put(pStream, 0, 8 - pStream->bitCount);
+    }
+}
+
+static uint32_t Get(BITSTREAM_T * pStream, int width)
+{
+    uint32_t value;
+
+    while (pStream->bitCount < width) {
+        if (pStream->remaining > 0) {
+            pStream->bits |= (uint32_t)*pStream->pData++ << pStream->bitCount;
+            pStream->remaining--;
+        }
+        else {
+            pStream->overflow = true;
+        }
+        pStream->bitCount += 8;
+    }
+    value = pStream->bits & ((1U << width) - 1);
+    pStream->bits >>= width;
+    pStream->bitCount -= width;
+    return value;
+}
+
+/** @return The number of bits required to store @c value. */
+static int Width(uint32_t value)
+{
+    int width = 0;
+    while (value) {
+        value >>= 1;
+        width++;
+    }
+    return width;
+}
+
+/** @return The signed difference between two consecutive samples, taking wrap-around into account. */
+static int32_t Delta(uint32_t sample, uint32_t previous)
+{
+    uint32_t delta = (sample - previous) & SAMPLE_MASK;
+    return (int32_t)(delta << (32 - COMPRESS_DELTA_BITSIZE)) >> (32 - COMPRESS_DELTA_BITSIZE);
+}
+
+/* ------------------------------------------------------------------------- */
+
+int Compress_Encode(const uint8_t * input, int inputLength, uint8_t * output, int outputLength)
+{
+    BITSTREAM_T in = {.pData = (uint8_t *)input, .remaining = inputLength};
+    BITSTREAM_T out = {.pData = output, .remaining = outputLength};
+    int32_t deltas[COMPRESS_DELTA_FRAME_SIZE];
+
+    if ((inputLength <= 0) || (inputLength >= (1 << LENGTH_BITS))) {
+        return 0;
+    }
+    PROFILE_BEGIN(PROFILE_ID_COMPRESS_ENCODE);
+    int count = inputLength * 8 / COMPRESS_DELTA_BITSIZE;
+    int tailBits = inputLength * 8 - count * COMPRESS_DELTA_BITSIZE;
+
+    Put(&out, (uint32_t)inputLength, LENGTH_BITS);
+    if (count > 0) {
+        uint32_t previous = Get(&in, COMPRESS_DELTA_BITSIZE);
+        Put(&out, previous, COMPRESS_DELTA_BITSIZE);
+        count--;
+
+        while ((count > 0) && !out.overflow) {
+            int n = (count < COMPRESS_DELTA_FRAME_SIZE) ? count : COMPRESS_DELTA_FRAME_SIZE;
+            int32_t min = INT32_MAX;
+            uint32_t range = 0;
+
+            for (int i = 0; i < n; i++) {
+                uint32_t sample = Get(&in, COMPRESS_DELTA_BITSIZE);
+                deltas[i] = Delta(sample, previous);
+                previous = sample;
+                if (deltas[i] < min) {
+                    min = deltas[i];
+                }
+            }
+            for (int i = 0; i < n; i++) {
+                range |= (uint32_t)(deltas[i] - min);
+            }
+
+            uint32_t zigzag = ZIGZAG(min);
+            int minWidth = Width(zigzag);
+            int width = Width(range);
+            Put(&out, (uint32_t)minWidth, WIDTH_BITS);
+            Put(&out, zigzag, minWidth);
+            Put(&out, (uint32_t)width, WIDTH_BITS);
+            for (int i = 0; i < n; i++) {
+                Put(&out, (uint32_t)(deltas[i] - min), width);
+            }
+            count -= n;
+        }
+    }
+    Put(&out, Get(&in, tailBits), tailBits);
+    Flush(&out);
+
+    PROFILE_END(PROFILE_ID_COMPRESS_ENCODE);
+    return out.overflow ? 0 : outputLength - out.remaining;
+}
+
+int Compress_Decode(const uint8_t * input, int inputLength, uint8_t * output, int outputLength)
+{
+    BITSTREAM_T in = {.pData = (uint8_t *)input, .remaining = inputLength};
+    BITSTREAM_T out = {.pData = output, .remaining = outputLength};
+
+    int length = (int)Get(&in, LENGTH_BITS);
+    if ((length == 0) || (length > outputLength)) {
+        return 0;
+    }
+    int count = length * 8 / COMPRESS_DELTA_BITSIZE;
+    int tailBits = length * 8 - count * COMPRESS_DELTA_BITSIZE;
+
+    if (count > 0) {
+        uint32_t previous = Get(&in, COMPRESS_DELTA_BITSIZE);
+        Put(&out, previous, COMPRESS_DELTA_BITSIZE);
+        count--;
+
+        while ((count > 0) && !in.overflow) {
+            int n = (count < COMPRESS_DELTA_FRAME_SIZE) ? count : COMPRESS_DELTA_FRAME_SIZE;
+
+            int minWidth = (int)Get(&in, WIDTH_BITS);
+            if (minWidth > COMPRESS_DELTA_BITSIZE) {
+                return 0; /* Corrupt data */
+            }
+            uint32_t zigzag = Get(&in, minWidth);
+            int32_t min = UNZIGZAG(zigzag);
+            int width = (int)Get(&in, WIDTH_BITS);
+            if (width > COMPRESS_DELTA_BITSIZE) {
+                return 0; /* Corrupt data */
+            }
+            for (int i = 0; i < n; i++) {
+                previous = (previous + (uint32_t)((int32_t)Get(&in, width) + min)) & SAMPLE_MASK;
+                Put(&out, previous, COMPRESS_DELTA_BITSIZE);
+            }
+            count -= n;
+        }
+    }
+    Put(&out, Get(&in, tailBits), tailBits);
+    Flush(&out);
+
+    return (in.overflow || out.overflow) ? 0 : length;
+}
+
+#endif
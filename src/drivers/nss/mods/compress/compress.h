@@ -36,7 +36,26 @@
  *  Check @ref MODS_NSS_COMPRESS_DFT for all diversity parameters.
  *
  * @par Memory Requirements
- *  The memory requirements are defined by the diversity settings. Check #COMPRESS_WINDOW_BITS and #COMPRESS_USE_INDEX.
+ *  The memory requirements are defined by the diversity settings. Check #COMPRESS_CODEC, #COMPRESS_WINDOW_BITS and
+ *  #COMPRESS_USE_INDEX.
+ *
+ * @par Use with the storage module
+ *  Both codecs can compress the blocks of samples the storage module moves from EEPROM to FLASH. For
+ *  #COMPRESS_CODEC_DELTA, also define #COMPRESS_DELTA_BITSIZE equal to @c STORAGE_BITSIZE. The callbacks are then:
+ *  @code
+ *      int CompressCb(int eepromByteOffset, int bitCount, void * pOut)
+ *      {
+ *          uint8_t data[STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES];
+ *          Chip_EEPROM_Read(NSS_EEPROM, eepromByteOffset, data, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+ *          return 8 * Compress_Encode(data, STORAGE_IDIVUP(bitCount, 8), pOut, STORAGE_IDIVUP(bitCount, 8));
+ *      }
+ *      int DecompressCb(const uint8_t * pData, int bitCount, void * pOut)
+ *      {
+ *          int length = Compress_Decode(pData, STORAGE_IDIVUP(bitCount, 8), pOut,
+ *                                       STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+ *          return (length == STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES) ? STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS : 0;
+ *      }
+ *  @endcode
  *
  * @par How to use the module
  *  -# To compress, simply call Compress_Encode. No preparation or initialization is necessary.
@@ -20,10 +20,64 @@
  * the defines with their desired values in the application app_sel.h header file: the compiler will pick up your
  * defines before parsing this file.
  *
+ * Two codecs are available, selected with #COMPRESS_CODEC:
+ * - #COMPRESS_CODEC_HEATSHRINK: a general purpose LZSS codec, finding repeated byte patterns. It can be tweaked with
+ *  #COMPRESS_WINDOW_BITS, #COMPRESS_LOOKAHEAD_BITS and #COMPRESS_USE_INDEX.
+ * - #COMPRESS_CODEC_DELTA: a codec for series of equisized samples of which neighbors differ only a little, such as
+ *  temperature or acceleration samples. It can be tweaked with #COMPRESS_DELTA_BITSIZE and
+ *  #COMPRESS_DELTA_FRAME_SIZE.
+ *
  * @{
  */
 
+/** When assigned to #COMPRESS_CODEC, the heatshrink LZSS codec is used. */
+#define COMPRESS_CODEC_HEATSHRINK 1
+
+/**
+ * When assigned to #COMPRESS_CODEC, the delta codec is used. The input is regarded as a series of samples of
+ * #COMPRESS_DELTA_BITSIZE bits each, packed without padding bits, LSBit first - as the storage module stores them.
+ * - Only the first sample is stored as is. For all other samples, the difference with the previous sample is taken.
+ * - The differences are grouped in frames of #COMPRESS_DELTA_FRAME_SIZE samples. Per frame, the smallest difference is
+ *  stored - zigzag mapped, so that small negative values need few bits as well - and all differences are stored
+ *  relative to it, using the minimum number of bits required for that frame.
+ * A slowly rising or falling series thus needs about 10 bits per frame; noise of a few LSB adds 2 to 3 bits per sample.
+ * No memory is allocated besides the stack: about 64 + 4 * #COMPRESS_DELTA_FRAME_SIZE bytes for compression, and less
+ * for decompression.
+ */
+#define COMPRESS_CODEC_DELTA 2
+
+/** Selects the codec used by #Compress_Encode and #Compress_Decode. */
+#ifndef COMPRESS_CODEC
+    #define COMPRESS_CODEC COMPRESS_CODEC_HEATSHRINK
+#endif
+#if (COMPRESS_CODEC != COMPRESS_CODEC_HEATSHRINK) && (COMPRESS_CODEC != COMPRESS_CODEC_DELTA)
+    #error COMPRESS_CODEC must be COMPRESS_CODEC_HEATSHRINK or COMPRESS_CODEC_DELTA
+#endif
+
+/**
+ * Only used by #COMPRESS_CODEC_DELTA. The size in bits of one sample in the data to compress. When used to compress
+ * the data of the storage module, set this equal to @c STORAGE_BITSIZE.
+ */
+#ifndef COMPRESS_DELTA_BITSIZE
+    #define COMPRESS_DELTA_BITSIZE 8
+#endif
+#if (COMPRESS_DELTA_BITSIZE < 2) || (COMPRESS_DELTA_BITSIZE > 24)
+    #error COMPRESS_DELTA_BITSIZE must be in the range [2, 24]
+#endif
+
+/**
+ * Only used by #COMPRESS_CODEC_DELTA. The number of samples sharing the same number of bits per difference. Smaller
+ * frames adapt faster to a changing signal, but add more overhead: 10 bits or more per frame.
+ */
+#ifndef COMPRESS_DELTA_FRAME_SIZE
+    #define COMPRESS_DELTA_FRAME_SIZE 16
+#endif
+#if (COMPRESS_DELTA_FRAME_SIZE < 1) || (COMPRESS_DELTA_FRAME_SIZE > 64)
+    #error COMPRESS_DELTA_FRAME_SIZE must be in the range [1, 64]
+#endif
+
 /**
+ * Only used by #COMPRESS_CODEC_HEATSHRINK.
  * The window size determines how far back in the input can be searched for repeated patterns. A value of 8 will only
  * use 2^8 == 256 bytes, while a value of 10 will use 2^10 == 1024 bytes. The latter uses more memory, but may also
  * compress more effectively by detecting more repetition.
@@ -40,6 +94,7 @@
 #endif
 
 /**
+ * Only used by #COMPRESS_CODEC_HEATSHRINK.
  * The lookahead size determines the maximum length for repeated patterns that are found.
  * If equal to 4, a 50-byte run of 'a' characters will be represented as several repeated 2^4 == 16-byte patterns,
  * whereas a larger value may be able to represent it all at once.
@@ -54,6 +109,7 @@
 #endif
 
 /**
+ * Only used by #COMPRESS_CODEC_HEATSHRINK.
  * Enables indexing. Indexing greatly reduces the compression time - possibly up to a factor of 5 (!). It is not used
  * for decompression. Enabling it roughly doubles the required stack size for compression, plus requires temporarily
  * an extra 512 bytes while the index being built up.
@@ -0,0 +1,227 @@
+#include "dsp.h"
+
+/* -------------------------------------------------------------------------
+ * Private function prototypes
+ * ------------------------------------------------------------------------- */
+
+static int16_t Saturate(int32_t value);
+
+/* -------------------------------------------------------------------------
+ * Private functions
+ * ------------------------------------------------------------------------- */
+
+/** @return @c value, clipped to the range of a 16-bit sample */
+static int16_t Saturate(int32_t value)
+{
+    if (value > INT16_MAX) {
+        value = INT16_MAX;
+    }
+    else if (value < INT16_MIN) {
+        value = INT16_MIN;
+    }
+    return (int16_t)value;
+}
+
+/* -------------------------------------------------------------------------
+ * Exported functions
+ * ------------------------------------------------------------------------- */
+
+void Dsp_MovAvg_Init(DSP_MOVAVG_T * pState, int16_t * pHistory, int lengthShift)
+{
+    ASSERT((pState != NULL) && (pHistory != NULL) && (lengthShift >= 0) && (lengthShift <= 15));
+    for (int n = 0; n < (1 << lengthShift); n++) {
+        pHistory[n] = 0;
+    }
+    pState->pHistory = pHistory;
+    pState->sum = 0;
+    pState->index = 0;
+    pState->lengthShift = (uint8_t)lengthShift;
+}
+
+void Dsp_MovAvg(DSP_MOVAVG_T * pState, const int16_t * pIn, int16_t * pOut, int count)
+{
+    int16_t * pHistory = pState->pHistory;
+    int32_t sum = pState->sum;
+    uint32_t index = pState->index;
+    const int shift = pState->lengthShift;
+    const uint32_t mask = (1U << shift) - 1;
+    const int32_t half = (1 << shift) >> 1;
+
+    ASSERT(count > 0);
+    for (int n = 0; n < count; n++) {
+        int16_t x = pIn[n];
+        sum += x - pHistory[index];
+        pHistory[index] = x;
+        index = (index + 1) & mask;
+        pOut[n] = (int16_t)((sum + half) >> shift);
+    }
+    pState->sum = sum;
+    pState->index = (uint16_t)index;
+}
+
+void Dsp_Cic_Init(DSP_CIC_T * pState, int order, int decimationShift)
+{
+    ASSERT((pState != NULL) && (order >= 1) && (order <= DSP_CIC_MAX_ORDER));
+    ASSERT((decimationShift >= 1) && (decimationShift <= 7) && (order * decimationShift <= 16));
+    for (int stage = 0; stage < DSP_CIC_MAX_ORDER; stage++) {
+        pState->integrator[stage] = 0;
+        pState->delay[stage] = 0;
+    }
+    pState->order = (uint8_t)order;
+    pState->decimationShift = (uint8_t)decimationShift;
+    pState->phase = 0;
+}
+
+int Dsp_Cic(DSP_CIC_T * pState, const int16_t * pIn, int count, int16_t * pOut)
+{
+    const int order = pState->order;
+    const int gainShift = order * pState->decimationShift;
+    const uint32_t decimation = 1U << pState->decimationShift;
+    uint32_t phase = pState->phase;
+    int outCount = 0;
+
+    ASSERT(count > 0);
+    for (int n = 0; n < count; n++) {
+        /* Unsigned arithmetic: the integrators may wrap around. */
+        uint32_t value = (uint32_t)(int32_t)pIn[n];
+        for (int stage = 0; stage < order; stage++) {
+            value += pState->integrator[stage];
+            pState->integrator[stage] = value;
+        }
+        if (++phase == decimation) {
+            phase = 0;
+            for (int stage = 0; stage < order; stage++) {
+                uint32_t previous = pState->delay[stage];
+                pState->delay[stage] = value;
+                value -= previous;
+            }
+            /* The gain is 2^gainShift: compensate, rounding to the nearest. The result always fits in 16 bits. */
+            pOut[outCount++] = (int16_t)(((int32_t)value + ((1 << gainShift) >> 1)) >> gainShift);
+        }
+    }
+    pState->phase = (uint8_t)phase;
+    return outCount;
+}
+
+void Dsp_Biquad_Init(DSP_BIQUAD_STATE_T * pState, int stages)
+{
+    ASSERT((pState != NULL) && (stages > 0));
+    for (int stage = 0; stage < stages; stage++) {
+        pState[stage] = (DSP_BIQUAD_STATE_T){0, 0, 0, 0, 0};
+    }
+}
+
+void Dsp_Biquad(const DSP_BIQUAD_COEFFS_T * pCoeffs, DSP_BIQUAD_STATE_T * pState, int stages, const int16_t * pIn,
+                int16_t * pOut, int count)
+{
+    ASSERT((pCoeffs != NULL) && (pState != NULL) && (stages > 0) && (count > 0));
+    for (int stage = 0; stage < stages; stage++) {
+        /* Keep the coefficients and the state in registers for the whole block. */
+        const int32_t b0 = pCoeffs[stage].b0;
+        const int32_t b1 = pCoeffs[stage].b1;
+        const int32_t b2 = pCoeffs[stage].b2;
+        const int32_t a1 = pCoeffs[stage].a1;
+        const int32_t a2 = pCoeffs[stage].a2;
+        int32_t x1 = pState[stage].x1;
+        int32_t x2 = pState[stage].x2;
+        int32_t y1 = pState[stage].y1;
+        int32_t y2 = pState[stage].y2;
+        int32_t error = pState[stage].error;
+
+        for (int n = 0; n < count; n++) {
+            int32_t x0 = pIn[n];
+            int32_t acc = b0 * x0 + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2 + error;
+            int32_t y0 = acc >> 14;
+            error = acc & 0x3FFF;
+            if ((y0 > INT16_MAX) || (y0 < INT16_MIN)) {
+                y0 = Saturate(y0);
+                error = 0;
+            }
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+            pOut[n] = (int16_t)y0;
+        }
+        pState[stage] = (DSP_BIQUAD_STATE_T){(int16_t)x1, (int16_t)x2, (int16_t)y1, (int16_t)y2, (int16_t)error};
+        pIn = pOut; /* The next stage filters in place. */
+    }
+}
+
+void Dsp_Fir_Init(DSP_FIR_T * pState, const int16_t * pTaps, int16_t * pHistory, int tapCount)
+{
+    ASSERT((pState != NULL) && (pTaps != NULL) && (pHistory != NULL) && (tapCount >= 1) && (tapCount <= 0xFFFF));
+    for (int n = 0; n < tapCount; n++) {
+        pHistory[n] = 0;
+    }
+    pState->pTaps = pTaps;
+    pState->pHistory = pHistory;
+    pState->tapCount = (uint16_t)tapCount;
+    pState->index = 0;
+}
+
+void Dsp_Fir(DSP_FIR_T * pState, const int16_t * pIn, int16_t * pOut, int count)
+{
+    const int16_t * pTaps = pState->pTaps;
+    int16_t * pHistory = pState->pHistory;
+    const int tapCount = pState->tapCount;
+    int index = pState->index;
+
+    ASSERT(count > 0);
+    for (int n = 0; n < count; n++) {
+        index = (index + 1 == tapCount) ? 0 : index + 1;
+        pHistory[index] = pIn[n];
+
+        /* Walk the ring backwards from the newest sample in two runs, instead of wrapping the index at each tap. */
+        const int16_t * pTap = pTaps;
+        const int16_t * pX = &pHistory[index];
+        int32_t acc = 0x4000; /* Rounds to the nearest. */
+        for (int k = index; k >= 0; k--) {
+            acc += *pTap++ * *pX--;
+        }
+        pX = &pHistory[tapCount - 1];
+        for (int k = tapCount - 1; k > index; k--) {
+            acc += *pTap++ * *pX--;
+        }
+        pOut[n] = Saturate(acc >> 15);
+    }
+    pState->index = (uint16_t)index;
+}
+
+uint16_t Dsp_Sqrt(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)root;
+}
+
+uint16_t Dsp_Magnitude(int16_t x, int16_t y, int16_t z)
+{
+    /* Each square is at most 2^30: their sum fits in 32 bits. */
+    uint32_t squared = (uint32_t)(x * x) + (uint32_t)(y * y) + (uint32_t)(z * z);
+    return Dsp_Sqrt(squared);
+}
+
+int32_t Dsp_Scale(int16_t value, uint32_t factor)
+{
+    /* Split the factor so that neither product exceeds 32 bits: value * factor = value * high * 2^16 + value * low */
+    int32_t high = (int32_t)(factor >> 16);
+    int32_t low = (int32_t)(factor & 0xFFFF);
+
+    ASSERT(high <= INT16_MAX);
+    return value * high + ((value * low + 0x8000) >> 16);
+}
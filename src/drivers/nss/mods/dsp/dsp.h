@@ -0,0 +1,242 @@
+#ifndef __DSP_H_
+#define __DSP_H_
+
+/** @defgroup MODS_NSS_DSP dsp: Fixed-point signal conditioning kernels
+ * @ingroup MODS_NSS
+ * The dsp module filters and converts 16-bit sensor samples with integer arithmetic only: moving average, decimating
+ * CIC filter, biquad IIR filter, FIR filter, integer square root and scaled unit conversion.
+ *
+ * @par Diversity
+ *  This module supports diversity, like the highest order of a CIC decimator.
+ *  Check @ref MODS_NSS_DSP_DFT for all diversity parameters.
+ *
+ * @par Cortex-M0+
+ *  The core has no FPU and no divide instruction: a single float multiplication costs a call into the soft-float
+ *  library, a division a call into the division routine. Its only multiply instruction takes two 32-bit operands and
+ *  keeps the lower 32 bits of the product. All kernels are therefore written such that:
+ *  - each multiplication takes two 16-bit operands, or one 16-bit and one 17-bit operand, and the product is
+ *      accumulated in 32 bits: one @c MULS, no 64-bit arithmetic;
+ *  - each division is a shift: window lengths and decimation factors are powers of two, and scale factors are
+ *      fractions of 2^16;
+ *  - the history of a filter is a ring that is walked in at most two runs, without a modulo per sample.
+ *  The cost per sample is then dominated by the number of multiplications: none for the moving average and the CIC
+ *  decimator, 5 per biquad stage, 1 per FIR tap, and 2 per unit conversion.
+ *
+ * @par Number formats
+ *  Samples are signed 16-bit integers. The taps of an FIR filter are Q15 values: @c 0x7FFF is just below 1.0.
+ *  The coefficients of a biquad stage are Q14 values, to cover the range [-2.0, 2.0[ that the feedback coefficients
+ *  need: use #DSP_Q14. Scale factors are Q16 values: use #DSP_Q16. These macros convert at compile time when given a
+ *  constant: no floating point code is linked in.
+ *  Results are rounded to the nearest integer, and saturated to the 16-bit range where they can exceed it.
+ *
+ * @par Timing on the target
+ *  Mark the conditioning of a block of samples with a @ref MODS_NSS_PROFILE "profiling scope" to obtain its cost in
+ *  system clock cycles. At a system clock of 1 MHz, a block of 32 samples gathered at 100 Hz leaves a budget of
+ *  320000 cycles, of which the kernels of this module should take only a small fraction.
+ *
+ * @par Example: low-pass filter, decimate and convert accelerometer samples to mg
+ *  @code
+ *      static const DSP_BIQUAD_COEFFS_T sLowPass[1] = {{DSP_Q14(0.0675), DSP_Q14(0.1349), DSP_Q14(0.0675),
+ *                                                         DSP_Q14(-1.1430), DSP_Q14(0.4128)}};
+ *      static DSP_BIQUAD_STATE_T sLowPassState[1];
+ *      static DSP_CIC_T sDecimator;
+ *
+ *      Dsp_Biquad_Init(sLowPassState, 1);
+ *      Dsp_Cic_Init(&sDecimator, 2, 2);
+ *      ...
+ *      Dsp_Biquad(sLowPass, sLowPassState, 1, samples, samples, count);
+ *      count = Dsp_Cic(&sDecimator, samples, count, samples);
+ *      for (int n = 0; n < count; n++) {
+ *          mg[n] = Dsp_Scale(samples[n], DSP_Q16(0.061)); // LSM6DSM at +/-2 g
+ *      }
+ *  @endcode
+ *
+ * @{
+ */
+
+/* -------------------------------------------------------------------------
+ * Include files
+ * ------------------------------------------------------------------------- */
+
+#include "chip.h"
+#include "dsp_dft.h"
+
+/* -------------------------------------------------------------------------
+ * Types and defines
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Converts a constant to a Q14 biquad coefficient.
+ * @param c : Must be in the range [-2.0, 2.0[.
+ */
+#define DSP_Q14(c) ((int16_t)((c) * 16384.0 + (((c) >= 0) ? 0.5 : -0.5)))
+
+/**
+ * Converts a constant to a Q15 FIR tap.
+ * @param c : Must be in the range [-1.0, 1.0[.
+ */
+#define DSP_Q15(c) ((int16_t)((c) * 32768.0 + (((c) >= 0) ? 0.5 : -0.5)))
+
+/**
+ * Converts a constant to a Q16 scale factor for #Dsp_Scale.
+ * @param c : Must be in the range [0, 32768[.
+ */
+#define DSP_Q16(c) ((uint32_t)((c) * 65536.0 + 0.5))
+
+/** A moving average over a window of a power of two samples. To be accessed via the functions of this module only. */
+typedef struct DSP_MOVAVG_S {
+    int16_t * pHistory; /**< The last 2^lengthShift input samples */
+    int32_t sum; /**< The sum of the samples in @c pHistory */
+    uint16_t index; /**< Where the next input sample goes in @c pHistory */
+    uint8_t lengthShift;
+} DSP_MOVAVG_T;
+
+/**
+ * A cascaded integrator-comb decimator. To be accessed via the functions of this module only.
+ * The integrators wrap around on purpose: the combs undo the wrap, as long as the output fits in 32 bits.
+ */
+typedef struct DSP_CIC_S {
+    uint32_t integrator[DSP_CIC_MAX_ORDER];
+    uint32_t delay[DSP_CIC_MAX_ORDER]; /**< The previous input of each comb */
+    uint8_t order;
+    uint8_t decimationShift;
+    uint8_t phase; /**< Input samples taken since the last output sample */
+} DSP_CIC_T;
+
+/**
+ * The coefficients of one biquad stage, in Q14. The stage computes
+ *  @c y[n] = @c b0 x[n] + @c b1 x[n-1] + @c b2 x[n-2] - @c a1 y[n-1] - @c a2 y[n-2]
+ * The sum of the absolute values of all five coefficients must stay below 4.0.
+ */
+typedef struct DSP_BIQUAD_COEFFS_S {
+    int16_t b0;
+    int16_t b1;
+    int16_t b2;
+    int16_t a1;
+    int16_t a2;
+} DSP_BIQUAD_COEFFS_T;
+
+/** The state of one biquad stage. To be accessed via the functions of this module only. */
+typedef struct DSP_BIQUAD_STATE_S {
+    int16_t x1;
+    int16_t x2;
+    int16_t y1;
+    int16_t y2;
+    int16_t error; /**< The fraction dropped from the previous output: fed back to shape the rounding noise. */
+} DSP_BIQUAD_STATE_T;
+
+/**
+ * An FIR filter. To be accessed via the functions of this module only.
+ * The sum of the absolute values of the taps must stay below 2.0.
+ */
+typedef struct DSP_FIR_S {
+    const int16_t * pTaps; /**< Q15. @c pTaps[0] weighs the newest sample. */
+    int16_t * pHistory; /**< The last @c tapCount input samples */
+    uint16_t tapCount;
+    uint16_t index; /**< Where the newest input sample is in @c pHistory */
+} DSP_FIR_T;
+
+/* -------------------------------------------------------------------------
+ * Exported function prototypes
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Initializes a moving average, as if only zeroes were seen so far.
+ * @param pState : May not be @c NULL.
+ * @param pHistory : May not be @c NULL. Room for 2^lengthShift samples, to be used by the moving average only.
+ * @param lengthShift : Must be in the range [0, 15]. The window holds 2^lengthShift samples.
+ */
+void Dsp_MovAvg_Init(DSP_MOVAVG_T * pState, int16_t * pHistory, int lengthShift);
+
+/**
+ * Replaces each sample by the average of the window ending at that sample. Costs no multiplication.
+ * @param pState : May not be @c NULL.
+ * @param pIn : May not be @c NULL. The input samples, oldest first.
+ * @param pOut : May not be @c NULL. Room for @c count samples. May equal @c pIn.
+ * @param count : Must be positive. The number of samples at @c pIn.
+ */
+void Dsp_MovAvg(DSP_MOVAVG_T * pState, const int16_t * pIn, int16_t * pOut, int count);
+
+/**
+ * Initializes a CIC decimator. Its gain is compensated: a constant input gives the same constant output.
+ * @param pState : May not be @c NULL.
+ * @param order : Must be in the range [1, #DSP_CIC_MAX_ORDER]. The number of integrator and comb stages.
+ * @param decimationShift : Must be in the range [1, 7]. One output sample is given for every 2^decimationShift
+ *  input samples.
+ * @pre @c order * @c decimationShift <= 16: the bit growth of the filter fits in 32 bits.
+ */
+void Dsp_Cic_Init(DSP_CIC_T * pState, int order, int decimationShift);
+
+/**
+ * Filters and decimates samples. Costs no multiplication: @c order additions per input sample, and @c order
+ * subtractions per output sample.
+ * @param pState : May not be @c NULL.
+ * @param pIn : May not be @c NULL. The input samples, oldest first.
+ * @param count : Must be positive. The number of samples at @c pIn.
+ * @param pOut : May not be @c NULL. Room for the output samples: at most @c count >> @c decimationShift, plus 1.
+ *  May equal @c pIn.
+ * @return The number of samples written to @c pOut.
+ */
+int Dsp_Cic(DSP_CIC_T * pState, const int16_t * pIn, int count, int16_t * pOut);
+
+/**
+ * Initializes the state of a cascade of biquad stages, as if only zeroes were seen so far.
+ * @param pState : May not be @c NULL. Room for @c stages states.
+ * @param stages : Must be positive.
+ */
+void Dsp_Biquad_Init(DSP_BIQUAD_STATE_T * pState, int stages);
+
+/**
+ * Filters samples through a cascade of biquad stages, in direct form I. Costs 5 multiplications per sample per stage.
+ * The rounding error of each output is fed back into the next one, which keeps the rounding noise out of the pass band
+ * of a low-pass filter.
+ * @param pCoeffs : May not be @c NULL. The coefficients of the @c stages stages, the first stage first.
+ * @param pState : May not be @c NULL. The states of the @c stages stages, as initialized by #Dsp_Biquad_Init.
+ * @param stages : Must be positive.
+ * @param pIn : May not be @c NULL. The input samples, oldest first.
+ * @param pOut : May not be @c NULL. Room for @c count samples. May equal @c pIn.
+ * @param count : Must be positive. The number of samples at @c pIn.
+ */
+void Dsp_Biquad(const DSP_BIQUAD_COEFFS_T * pCoeffs, DSP_BIQUAD_STATE_T * pState, int stages, const int16_t * pIn,
+                int16_t * pOut, int count);
+
+/**
+ * Initializes an FIR filter, as if only zeroes were seen so far.
+ * @param pState : May not be @c NULL.
+ * @param pTaps : May not be @c NULL. The @c tapCount taps in Q15, used by the filter from now on.
+ * @param pHistory : May not be @c NULL. Room for @c tapCount samples, to be used by the filter only.
+ * @param tapCount : Must be in the range [1, 0xFFFF].
+ */
+void Dsp_Fir_Init(DSP_FIR_T * pState, const int16_t * pTaps, int16_t * pHistory, int tapCount);
+
+/**
+ * Filters samples. Costs 1 multiplication per sample per tap.
+ * @param pState : May not be @c NULL.
+ * @param pIn : May not be @c NULL. The input samples, oldest first.
+ * @param pOut : May not be @c NULL. Room for @c count samples. May equal @c pIn.
+ * @param count : Must be positive. The number of samples at @c pIn.
+ */
+void Dsp_Fir(DSP_FIR_T * pState, const int16_t * pIn, int16_t * pOut, int count);
+
+/**
+ * Calculates an integer square root with shifts, additions and comparisons only.
+ * @param value : The radicand.
+ * @return The largest integer whose square does not exceed @c value.
+ */
+uint16_t Dsp_Sqrt(uint32_t value);
+
+/**
+ * Calculates the length of a 3D vector, e.g. the magnitude of an acceleration. Costs 3 multiplications.
+ * @return The length, rounded down.
+ */
+uint16_t Dsp_Magnitude(int16_t x, int16_t y, int16_t z);
+
+/**
+ * Converts a sample to another unit, e.g. from LSB to mg. Costs 2 multiplications.
+ * @param value : The sample.
+ * @param factor : The factor to multiply with, in Q16: use #DSP_Q16.
+ * @return @c value * @c factor, rounded to the nearest integer.
+ */
+int32_t Dsp_Scale(int16_t value, uint32_t factor);
+
+#endif /** @} */
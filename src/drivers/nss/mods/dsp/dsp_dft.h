@@ -0,0 +1,22 @@
+/** @defgroup MODS_NSS_DSP_DFT Diversity Settings
+ *  @ingroup MODS_NSS_DSP
+ * These 'defines' capture the diversity settings of the module. The displayed values refer to the default settings.
+ * To override the default settings, place the defines with their desired values in the application app_sel.h header
+ * file: the compiler will pick up your defines before parsing this file.
+ * @{
+ */
+#ifndef __DSP_DFT_H_
+#define __DSP_DFT_H_
+
+/**
+ * The highest order a CIC decimator can be initialized with. Each order costs 8 bytes of RAM per decimator.
+ * The bit growth of the filter must fit in 32 bits: see #Dsp_Cic_Init.
+ */
+#if !defined(DSP_CIC_MAX_ORDER)
+    #define DSP_CIC_MAX_ORDER 3
+#endif
+#if (DSP_CIC_MAX_ORDER < 1) || (DSP_CIC_MAX_ORDER > 8)
+    #error DSP_CIC_MAX_ORDER must be in the range [1, 8]
+#endif
+
+#endif /** @} */
@@ -27,6 +27,17 @@
  *      Events can only be searched by traversing them in sequence, from the oldest event to the newest event.
  *      The size of one event equals the size of the structure #EVENT_T plus #EVENT_T.len. Searching stops when the
  *      iterator reaches the value of #sMeta.nextFreeOffset.
+ *
+ *  @par Index
+ *      To avoid traversing all events for each search, an index is kept in SRAM: see #sIndex. It is built with one
+ *      traversal the first time it is needed after #Event_Init, and updated by #Event_Set from then on. It holds:
+ *      - for the first #EVENT_INDEX_TAG_COUNT different tag values: where the first and the last event with that tag
+ *          are stored. Only tag values that did not fit still require a traversal.
+ *      - a checkpoint every so many events: where the event is stored, and the full timestamp of the event before.
+ *          A traversal can start at any checkpoint instead of at the oldest event. When all
+ *          #EVENT_INDEX_CHECKPOINT_COUNT checkpoints are used, every other one is dropped and the distance between two
+ *          checkpoints is doubled.
+ *      The index is not stored in EEPROM: all assigned EEPROM is kept for events.
  */
 
 /**
@@ -109,6 +120,32 @@ typedef struct EVENT_S { /* ANY change must be reflected in EVENT_OVERHEAD. */
 
 #pragma pack(pop)
 
+/** The position of an event, allowing a traversal to start at that event. */
+typedef struct CHECKPOINT_S {
+    uint16_t offset; /**< The absolute offset to where the #EVENT_T structure of the event is stored. */
+    uint16_t index; /**< The sequential number of the event. */
+    /**
+     * Time in seconds. The full timestamp of the event before, or #META_T.baseTimestamp for the very first event.
+     * Adding the delta time of the event itself gives its timestamp.
+     */
+    uint32_t timestamp;
+} CHECKPOINT_T;
+
+/** All information reported about an event, without having to read it. */
+typedef struct INDEXED_EVENT_S {
+    uint32_t timestamp; /**< Time in seconds. The full timestamp of the event. */
+    uint16_t offset; /**< The absolute offset to where the #EVENT_T structure of the event is stored. */
+    uint16_t index; /**< The sequential number of the event. */
+    uint8_t len; /**< Copy of #EVENT_T.len */
+} INDEXED_EVENT_T;
+
+/** The first and the last event stored for one tag value. */
+typedef struct TAG_INDEX_S {
+    INDEXED_EVENT_T first;
+    INDEXED_EVENT_T last;
+    uint8_t tag;
+} TAG_INDEX_T;
+
 /**
  * Dummy variable to test the value of #MEMORY_FIRSTUNUSEDEEPROMOFFSET.
  * If the macro is not correct, the dummy variable will have a negative array size and the compiler will raise an error
@@ -125,8 +162,36 @@ static META_T sMeta;
 extern bool EVENT_CB(uint8_t tag, int offset, uint8_t len, unsigned int index, uint32_t timestamp, uint32_t context);
 static pEvent_Cb_t sEventCb = EVENT_CB;
 
+/**
+ * Index of the events stored, to speed up searching. Built in #BuildIndex, updated in #IndexEvent.
+ * @note All fields except @c valid are only meaningful when @c valid equals @c true.
+ */
+static struct {
+    bool valid; /**< @c false after #Event_Init, until the index is first needed. */
+    /**
+     * @c true when no event has a timestamp smaller than the event stored before it. Only then are timestamps sorted,
+     * and can the checkpoints be used to search by time.
+     */
+    bool monotonic;
+    bool tagOverflow; /**< @c true when events are stored with a tag value not present in @c tags. */
+    uint16_t count; /**< The number of events stored. */
+    uint32_t lastTimestamp; /**< Time in seconds. The full timestamp of the last event, or the base timestamp. */
+    int tagCount; /**< The number of valid elements in @c tags. */
+    TAG_INDEX_T tags[EVENT_INDEX_TAG_COUNT];
+    int checkpointCount; /**< The number of valid elements in @c checkpoints. */
+    unsigned int checkpointInterval; /**< The difference in index between two consecutive checkpoints. */
+    CHECKPOINT_T checkpoints[EVENT_INDEX_CHECKPOINT_COUNT]; /**< The first one, if present, is at index @c 0. */
+} sIndex;
+
+static void IndexEvent(int eepromOffset, const EVENT_T * pEvent);
+static void BuildIndex(void);
+static const TAG_INDEX_T * FindTag(uint8_t tag);
+static CHECKPOINT_T FindCheckpointByIndex(unsigned int index);
+static CHECKPOINT_T FindCheckpointByTime(uint32_t timestamp);
 static bool GetFirstOrLastByTag(bool first, uint8_t tag, int * pOffset, uint8_t * pLen, unsigned int * pIndex,
                                 uint32_t * pTimestamp);
+static bool GetIndexedByTag(bool first, uint8_t tag, int * pOffset, uint8_t * pLen, unsigned int * pIndex,
+                            uint32_t * pTimestamp);
 
 #if EVENT_CB_SELF_DEFINED == 1
 #pragma GCC diagnostic push
@@ -150,6 +215,154 @@ bool DummyEventCb(uint8_t tag, int offset, uint8_t len, unsigned int index, uint
 #pragma GCC diagnostic pop
 #endif
 
+/**
+ * Adds the event that was just stored, or read while building the index, to the index.
+ * @param eepromOffset The absolute offset to where the #EVENT_T structure of the event is stored.
+ * @param pEvent The event information as stored in EEPROM.
+ */
+static void IndexEvent(int eepromOffset, const EVENT_T * pEvent)
+{
+    uint16_t index = sIndex.count;
+    uint32_t timestamp = sIndex.lastTimestamp + RESTORE_TIMESTAMP(pEvent->deltaTimestamp);
+
+    if ((index % sIndex.checkpointInterval) == 0) {
+        if (sIndex.checkpointCount == EVENT_INDEX_CHECKPOINT_COUNT) {
+            /* Keep the even checkpoints only. The new checkpoint is then at a multiple of the doubled interval. */
+            for (int n = 1; n < EVENT_INDEX_CHECKPOINT_COUNT / 2; n++) {
+                sIndex.checkpoints[n] = sIndex.checkpoints[2 * n];
+            }
+            sIndex.checkpointCount = EVENT_INDEX_CHECKPOINT_COUNT / 2;
+            sIndex.checkpointInterval *= 2;
+        }
+        sIndex.checkpoints[sIndex.checkpointCount].offset = (uint16_t)eepromOffset;
+        sIndex.checkpoints[sIndex.checkpointCount].index = index;
+        sIndex.checkpoints[sIndex.checkpointCount].timestamp = sIndex.lastTimestamp;
+        sIndex.checkpointCount++;
+    }
+
+    INDEXED_EVENT_T indexed = {.timestamp = timestamp, .offset = (uint16_t)eepromOffset, .index = index,
+                               .len = (uint8_t)pEvent->len};
+    TAG_INDEX_T * pTag = (TAG_INDEX_T *)FindTag((uint8_t)pEvent->tag);
+    if (pTag) {
+        pTag->last = indexed;
+    }
+    else if (sIndex.tagCount < EVENT_INDEX_TAG_COUNT) {
+        pTag = &sIndex.tags[sIndex.tagCount];
+        pTag->tag = (uint8_t)pEvent->tag;
+        pTag->first = indexed;
+        pTag->last = indexed;
+        sIndex.tagCount++;
+    }
+    else {
+        sIndex.tagOverflow = true;
+    }
+
+    if (timestamp < sIndex.lastTimestamp) {
+        sIndex.monotonic = false;
+    }
+    sIndex.lastTimestamp = timestamp;
+    sIndex.count++;
+}
+
+/** Traverses all events once to build the index from scratch. */
+static void BuildIndex(void)
+{
+    int eepromOffset = EEPROM_ABSOLUTE_FIRST_BYTE_OFFSET;
+    EVENT_T event;
+
+    sIndex.monotonic = true;
+    sIndex.tagOverflow = false;
+    sIndex.count = 0;
+    sIndex.lastTimestamp = sMeta.baseTimestamp;
+    sIndex.tagCount = 0;
+    sIndex.checkpointCount = 0;
+    sIndex.checkpointInterval = EVENT_INDEX_CHECKPOINT_INTERVAL;
+    while (eepromOffset < sMeta.nextFreeOffset) {
+        Chip_EEPROM_Read(NSS_EEPROM, eepromOffset, &event, EVENT_OVERHEAD);
+        IndexEvent(eepromOffset, &event);
+        eepromOffset += EVENT_OVERHEAD + event.len;
+    }
+    sIndex.valid = true;
+}
+
+/**
+ * Looks up a tag value in the index.
+ * @param tag The tag value to look for.
+ * @return The index information of the tag value, or @c NULL when not present: then either no event with this tag
+ *  value is stored, or - only if #sIndex.tagOverflow is set - it did not fit in the index.
+ * @pre The index is valid.
+ */
+static const TAG_INDEX_T * FindTag(uint8_t tag)
+{
+    for (int n = 0; n < sIndex.tagCount; n++) {
+        if (sIndex.tags[n].tag == tag) {
+            return &sIndex.tags[n];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Determines where to start a traversal to reach an event with a given index as fast as possible.
+ * @param index The sequential number of the event to reach.
+ * @return The closest checkpoint at or before @c index.
+ */
+static CHECKPOINT_T FindCheckpointByIndex(unsigned int index)
+{
+    CHECKPOINT_T checkpoint = {.offset = EEPROM_ABSOLUTE_FIRST_BYTE_OFFSET, .index = 0,
+                               .timestamp = sMeta.baseTimestamp};
+
+    if (!sIndex.valid) {
+        BuildIndex();
+    }
+    if (sIndex.checkpointCount > 0) {
+        unsigned int n = index / sIndex.checkpointInterval;
+        if (n >= (unsigned int)sIndex.checkpointCount) {
+            n = (unsigned int)sIndex.checkpointCount - 1;
+        }
+        checkpoint = sIndex.checkpoints[n];
+    }
+    return checkpoint;
+}
+
+/**
+ * Determines where to start a traversal to reach the first event with a timestamp at or after a given timestamp.
+ * @param timestamp Time in seconds.
+ * @return The last checkpoint of which all events before have a smaller timestamp. When the timestamps are not
+ *  sorted, the very first event.
+ */
+static CHECKPOINT_T FindCheckpointByTime(uint32_t timestamp)
+{
+    CHECKPOINT_T checkpoint = {.offset = EEPROM_ABSOLUTE_FIRST_BYTE_OFFSET, .index = 0,
+                               .timestamp = sMeta.baseTimestamp};
+
+    if (!sIndex.valid) {
+        BuildIndex();
+    }
+    if (sIndex.monotonic) {
+        /* Binary search: count the checkpoints of which the event before has a smaller timestamp. */
+        int low = 0;
+        int high = sIndex.checkpointCount;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (sIndex.checkpoints[mid].timestamp < timestamp) {
+                low = mid + 1;
+            }
+            else {
+                high = mid;
+            }
+        }
+        if (low > 0) {
+            checkpoint = sIndex.checkpoints[low - 1];
+        }
+    }
+    return checkpoint;
+}
+
+/**
+ * Fallback for #Event_GetFirstByTag and #Event_GetLastByTag when the tag value did not fit in the index.
+ * @see Event_GetFirstByTag
+ */
 static bool GetFirstOrLastByTag(bool first, uint8_t tag, int * pOffset, uint8_t * pLen, unsigned int * pIndex,
                                 uint32_t * pTimestamp)
 {
@@ -186,6 +399,37 @@ static bool GetFirstOrLastByTag(bool first, uint8_t tag, int * pOffset, uint8_t
     return found;
 }
 
+/**
+ * Common implementation for #Event_GetFirstByTag and #Event_GetLastByTag. Answers from the index, only traverses the
+ * events when the tag value did not fit in the index.
+ * @see Event_GetFirstByTag
+ */
+static bool GetIndexedByTag(bool first, uint8_t tag, int * pOffset, uint8_t * pLen, unsigned int * pIndex,
+                            uint32_t * pTimestamp)
+{
+    if (!sIndex.valid) {
+        BuildIndex();
+    }
+    const TAG_INDEX_T * pTag = FindTag(tag);
+    if (!pTag) {
+        return sIndex.tagOverflow && GetFirstOrLastByTag(first, tag, pOffset, pLen, pIndex, pTimestamp);
+    }
+    const INDEXED_EVENT_T * pEvent = first ? &pTag->first : &pTag->last;
+    if (pOffset) {
+        *pOffset = pEvent->len ? (pEvent->offset + EVENT_OVERHEAD) : -1;
+    }
+    if (pLen) {
+        *pLen = pEvent->len;
+    }
+    if (pIndex) {
+        *pIndex = pEvent->index;
+    }
+    if (pTimestamp) {
+        *pTimestamp = pEvent->timestamp;
+    }
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 
 void Event_Init(bool reset)
@@ -205,6 +449,7 @@ void Event_Init(bool reset)
     if ((sMeta.nextFreeOffset < EEPROM_ABSOLUTE_FIRST_BYTE_OFFSET) || (sMeta.nextFreeOffset >= EEPROM_META_OFFSET)) {
         sMeta.nextFreeOffset = EEPROM_ABSOLUTE_FIRST_BYTE_OFFSET;
     }
+    sIndex.valid = false;
 }
 
 void Event_DeInit(void)
@@ -254,6 +499,9 @@ bool Event_Set(uint8_t tag, void * data, uint8_t len)
         if (len) {
             Chip_EEPROM_Write(NSS_EEPROM, sMeta.nextFreeOffset + EVENT_OVERHEAD, data, len);
         }
+        if (sIndex.valid) {
+            IndexEvent(sMeta.nextFreeOffset, &event);
+        }
         sMeta.nextFreeOffset = (uint16_t)(sMeta.nextFreeOffset + EVENT_OVERHEAD + len);
         sMeta.lastTimestamp = now;
     }
@@ -266,16 +514,17 @@ unsigned int Event_GetByIndex(unsigned int first, unsigned int last, uint32_t co
 #if EVENT_CB_OPENING_CALL
     searching = sEventCb(0, -1, 0, EVENT_CB_OPENING_INDEX, 0, context);
 #endif
-    int eepromOffset = EEPROM_ABSOLUTE_FIRST_BYTE_OFFSET;
-    uint32_t timestamp = sMeta.baseTimestamp;
-    unsigned int index = 0;
+    CHECKPOINT_T checkpoint = FindCheckpointByIndex(first);
+    int eepromOffset = checkpoint.offset;
+    uint32_t timestamp = checkpoint.timestamp;
+    unsigned int index = checkpoint.index;
     unsigned int count = 0;
     EVENT_T event;
 
-    while (searching && (eepromOffset < sMeta.nextFreeOffset)) {
+    while (searching && (eepromOffset < sMeta.nextFreeOffset) && (index <= last)) {
         Chip_EEPROM_Read(NSS_EEPROM, eepromOffset, &event, EVENT_OVERHEAD);
         timestamp += RESTORE_TIMESTAMP(event.deltaTimestamp);
-        if ((first <= index) && (index <= last)) {
+        if (first <= index) {
         searching = sEventCb(event.tag,
                              event.len ? eepromOffset + EVENT_OVERHEAD : -1,
                              event.len,
@@ -299,19 +548,22 @@ unsigned int Event_GetByTime(unsigned int begin, unsigned int end, uint32_t cont
 #if EVENT_CB_OPENING_CALL
     searching = sEventCb(0, -1, 0, EVENT_CB_OPENING_INDEX, 0, context);
 #endif
-    int eepromOffset = EEPROM_ABSOLUTE_FIRST_BYTE_OFFSET;
-    uint32_t timestamp = sMeta.baseTimestamp;
-    unsigned int index = 0;
+    CHECKPOINT_T checkpoint = FindCheckpointByTime(begin);
+    int eepromOffset = checkpoint.offset;
+    uint32_t timestamp = checkpoint.timestamp;
+    unsigned int index = checkpoint.index;
     unsigned int count = 0;
     EVENT_T event;
 
-    begin = REDUCE_TIMESTAMP(begin);
-    end = REDUCE_TIMESTAMP(end);
     while (searching && (eepromOffset < sMeta.nextFreeOffset)) {
         Chip_EEPROM_Read(NSS_EEPROM, eepromOffset, &event, EVENT_OVERHEAD);
         timestamp += RESTORE_TIMESTAMP(event.deltaTimestamp);
-        if ((begin <= event.deltaTimestamp) && (event.deltaTimestamp <= end)) {
-            searching = sEventCb(event.tag, eepromOffset, event.len, index, timestamp, context);
+        if (sIndex.monotonic && (timestamp > end)) {
+            break; /* All remaining events are even later. */
+        }
+        if ((begin <= timestamp) && (timestamp <= end)) {
+            int offset = event.len ? (eepromOffset + EVENT_OVERHEAD) : -1;
+            searching = sEventCb(event.tag, offset, event.len, index, timestamp, context);
             count++;
         }
         eepromOffset += EVENT_OVERHEAD + event.len;
@@ -330,14 +582,33 @@ unsigned int Event_GetByTag(uint8_t tag, uint32_t context)
     searching = sEventCb(0, -1, 0, EVENT_CB_OPENING_INDEX, 0, context);
 #endif
     int eepromOffset = EEPROM_ABSOLUTE_FIRST_BYTE_OFFSET;
+    int endOffset = sMeta.nextFreeOffset;
     uint32_t timestamp = sMeta.baseTimestamp;
     unsigned int index = 0;
     unsigned int count = 0;
     EVENT_T event;
 
-    while (searching && (eepromOffset < sMeta.nextFreeOffset)) {
+    if (!sIndex.valid) {
+        BuildIndex();
+    }
+    const TAG_INDEX_T * pTag = FindTag(tag);
+    if (pTag) {
+        /* Only traverse the events from the first up to and including the last event with this tag value. */
+        eepromOffset = pTag->first.offset;
+        endOffset = pTag->last.offset + 1;
+        index = pTag->first.index;
+    }
+    else if (!sIndex.tagOverflow) {
+        endOffset = eepromOffset; /* No event has this tag value. */
+    }
+    while (searching && (eepromOffset < endOffset)) {
         Chip_EEPROM_Read(NSS_EEPROM, eepromOffset, &event, EVENT_OVERHEAD);
-        timestamp += RESTORE_TIMESTAMP(event.deltaTimestamp);
+        if (pTag && (index == pTag->first.index)) {
+            timestamp = pTag->first.timestamp;
+        }
+        else {
+            timestamp += RESTORE_TIMESTAMP(event.deltaTimestamp);
+        }
         if (tag == event.tag) {
             int offset = event.len ? (eepromOffset + EVENT_OVERHEAD) : -1;
             searching = sEventCb(event.tag, offset, event.len, index, timestamp, context);
@@ -354,10 +625,10 @@ unsigned int Event_GetByTag(uint8_t tag, uint32_t context)
 
 bool Event_GetFirstByTag(uint8_t tag, int * pOffset, uint8_t * pLen, unsigned int * pIndex, uint32_t * pTimestamp)
 {
-    return GetFirstOrLastByTag(true, tag, pOffset, pLen, pIndex, pTimestamp);
+    return GetIndexedByTag(true, tag, pOffset, pLen, pIndex, pTimestamp);
 }
 
 bool Event_GetLastByTag(uint8_t tag, int * pOffset, uint8_t * pLen, unsigned int * pIndex, uint32_t * pTimestamp)
 {
-    return GetFirstOrLastByTag(false, tag, pOffset, pLen, pIndex, pTimestamp);
+    return GetIndexedByTag(false, tag, pOffset, pLen, pIndex, pTimestamp);
 }
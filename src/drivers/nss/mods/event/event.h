@@ -194,8 +194,9 @@ unsigned int Event_GetByIndex(unsigned int first, unsigned int last, uint32_t co
  * @param context May be any number. Is not stored or looked at, only passed on as last argument in every call to
  *  #EVENT_CB. Use for your own housekeeping, as a means to provide contextual information to the callback.
  * @note Since the RTC value is used as timestamp, it is possible that events that are stored at a later time have a
- *  timestamp that is smaller than an earlier event. This function will scan @b all events and report @b all those that
- *  have a timestamp between (and including) @c begin and @c end.
+ *  timestamp that is smaller than an earlier event. This function will then scan @b all events and report @b all those
+ *  that have a timestamp between (and including) @c begin and @c end. As long as this has not happened, only the events
+ *  close to and between @c begin and @c end are read.
  * @return The number of events reported, not including the possible opening and closing calls.
  * @see pEvent_Cb_t
  */
@@ -31,6 +31,9 @@
  * - #EVENT_CB_OPENING_CALL
  * - #EVENT_CB_CLOSING_CALL
  * - #EVENT_OVERHEAD_CHOICE
+ * - #EVENT_INDEX_TAG_COUNT
+ * - #EVENT_INDEX_CHECKPOINT_COUNT
+ * - #EVENT_INDEX_CHECKPOINT_INTERVAL
  *
  * These defines are fixed or derived from the above flags and may not be defined or redefined in an application:
  * - #EVENT_EEPROM_ROW_COUNT
@@ -214,4 +217,45 @@
     #define EVENT_OVERHEAD 6
 #endif
 
+/* ------------------------------------------------------------------------- */
+
+#ifndef EVENT_INDEX_TAG_COUNT
+    /**
+     * The number of different tag values for which the first and the last event are kept in an index in SRAM. For
+     * these tag values, #Event_GetFirstByTag and #Event_GetLastByTag do not need to read EEPROM, and #Event_GetByTag
+     * only reads the events in between. Other tag values are searched for by reading all events.
+     * @note Each tag value takes 28 bytes of SRAM.
+     */
+    #define EVENT_INDEX_TAG_COUNT 4
+#endif
+#if !(EVENT_INDEX_TAG_COUNT >= 1)
+    #error Invalid value for EVENT_INDEX_TAG_COUNT
+#endif
+
+#ifndef EVENT_INDEX_CHECKPOINT_COUNT
+    /**
+     * The maximum number of checkpoints kept in an index in SRAM. A checkpoint allows to start reading events from the
+     * middle of the assigned EEPROM region: #Event_GetByIndex jumps to the closest checkpoint, #Event_GetByTime
+     * searches the closest checkpoint using a binary search.
+     * When all checkpoints are in use, every other one is dropped and #EVENT_INDEX_CHECKPOINT_INTERVAL is doubled.
+     * @note Each checkpoint takes 8 bytes of SRAM.
+     * @note Must be an even number.
+     */
+    #define EVENT_INDEX_CHECKPOINT_COUNT 16
+#endif
+#if !(EVENT_INDEX_CHECKPOINT_COUNT >= 2) || ((EVENT_INDEX_CHECKPOINT_COUNT % 2) != 0)
+    #error Invalid value for EVENT_INDEX_CHECKPOINT_COUNT
+#endif
+
+#ifndef EVENT_INDEX_CHECKPOINT_INTERVAL
+    /**
+     * The initial number of events between two checkpoints. At most this many events - or a power of two multiple of it,
+     * see #EVENT_INDEX_CHECKPOINT_COUNT - are read in excess when retrieving events by index or by time.
+     */
+    #define EVENT_INDEX_CHECKPOINT_INTERVAL 8
+#endif
+#if !(EVENT_INDEX_CHECKPOINT_INTERVAL >= 1)
+    #error Invalid value for EVENT_INDEX_CHECKPOINT_INTERVAL
+#endif
+
 #endif /** @} */
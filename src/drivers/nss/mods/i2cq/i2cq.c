@@ -0,0 +1,131 @@
+#include "i2cq.h"
+
+/* -------------------------------------------------------------------------
+ * Private function prototypes
+ * ------------------------------------------------------------------------- */
+
+static void EventHandler(I2C_ID_T id, I2C_EVENT_T event);
+static void Complete(void);
+
+/* -------------------------------------------------------------------------
+ * Private variables
+ * ------------------------------------------------------------------------- */
+
+/** Ring buffer of the submitted transfers. The transfer at #sHead is in progress. */
+static I2C_XFER_T * sQueue[I2CQ_QUEUE_SIZE];
+static volatile int sHead;
+static volatile int sCount;
+
+/* -------------------------------------------------------------------------
+ * Private functions
+ * ------------------------------------------------------------------------- */
+
+/** The master event handler, installed by #I2CQ_Init. */
+static void EventHandler(I2C_ID_T id, I2C_EVENT_T event)
+{
+    switch (event) {
+        case I2C_EVENT_WAIT:
+            /* A blocking transfer using Chip_I2C_MasterTransfer: wait as the default handler does. */
+            Chip_I2C_EventHandler(id, event);
+            break;
+        case I2C_EVENT_DONE:
+            /* Also raised at the end of a blocking transfer, which is only allowed when nothing is queued. */
+            if (sCount > 0) {
+                Complete();
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Called under interrupt when the transfer at the head of the queue is completed.
+ * The next transfer is started before the application is notified, to keep the bus idle time as short as possible.
+ */
+static void Complete(void)
+{
+    I2C_XFER_T * pXfer = sQueue[sHead];
+
+    sHead = (sHead + 1) % I2CQ_QUEUE_SIZE;
+    sCount--;
+    if (sCount > 0) {
+        Chip_I2C_MasterTransferStart(I2C0, sQueue[sHead]);
+    }
+#if defined(I2CQ_DONE_CB)
+    {
+        extern void I2CQ_DONE_CB(I2C_XFER_T * pXfer);
+        I2CQ_DONE_CB(pXfer);
+    }
+#else
+    (void)pXfer;
+#endif
+}
+
+/* -------------------------------------------------------------------------
+ * Exported functions
+ * ------------------------------------------------------------------------- */
+
+void I2CQ_Init(void)
+{
+    sHead = 0;
+    sCount = 0;
+    Chip_I2C_SetMasterEventHandler(I2C0, EventHandler);
+    NVIC_EnableIRQ(I2C0_IRQn);
+}
+
+bool I2CQ_Submit(I2C_XFER_T * pXfer)
+{
+    bool accepted = false;
+    uint32_t primask = __get_PRIMASK();
+
+    ASSERT(pXfer != NULL);
+    __disable_irq();
+    if (sCount < I2CQ_QUEUE_SIZE) {
+        pXfer->status = I2C_STATUS_BUSY;
+        sQueue[(sHead + sCount) % I2CQ_QUEUE_SIZE] = pXfer;
+        sCount++;
+        if (sCount == 1) {
+            Chip_I2C_MasterTransferStart(I2C0, pXfer);
+        }
+        accepted = true;
+    }
+    __set_PRIMASK(primask);
+    return accepted;
+}
+
+I2C_STATUS_T I2CQ_Wait(I2C_XFER_T * pXfer)
+{
+    volatile I2C_STATUS_T * pStatus = &pXfer->status;
+
+    ASSERT(pXfer != NULL);
+    /* The check and the sleep must be atomic: otherwise the last interrupt may be handled in between, and never wake
+     * up the CPU. A pending interrupt ends __WFI even while masked; it is handled as soon as it is unmasked.
+     */
+    __disable_irq();
+    while (*pStatus == I2C_STATUS_BUSY) {
+        __WFI();
+        __enable_irq();
+        __disable_irq();
+    }
+    __enable_irq();
+    return *pStatus;
+}
+
+I2C_STATUS_T I2CQ_Transfer(I2C_XFER_T * pXfer)
+{
+    __disable_irq();
+    while (sCount == I2CQ_QUEUE_SIZE) {
+        __WFI();
+        __enable_irq();
+        __disable_irq();
+    }
+    (void)I2CQ_Submit(pXfer); /* Cannot fail: interrupts are disabled, so nothing was added meanwhile. */
+    __enable_irq();
+    return I2CQ_Wait(pXfer);
+}
+
+int I2CQ_GetCount(void)
+{
+    return sCount;
+}
@@ -0,0 +1,111 @@
+#ifndef __I2CQ_H_
+#define __I2CQ_H_
+
+/** @defgroup MODS_NSS_I2CQ i2cq: Asynchronous I2C master transfer queue
+ * @ingroup MODS_NSS
+ * The I2C queue module lets the application submit I2C master transfers without waiting for them. Submitted transfers
+ * are executed one after the other, in order: the next transfer is started under interrupt as soon as the previous one
+ * completes. Meanwhile, the CPU is free to do other work or to sleep. At 100 kHz, a transfer of 10 bytes takes about
+ * 1 ms.
+ *
+ * @par Diversity
+ *  This module supports diversity, like the size of the queue and a completion callback.
+ *  Check @ref MODS_NSS_I2CQ_DFT for all diversity parameters.
+ *
+ * @par Completion
+ *  The @c status field of a submitted #I2C_XFER_T stays #I2C_STATUS_BUSY until the transfer is completed. After that,
+ *  it holds the final status, as #Chip_I2C_MasterTransfer would have returned. The application can:
+ *  - poll the @c status field;
+ *  - call #I2CQ_Wait, which sleeps until the given transfer is completed;
+ *  - define @c I2CQ_DONE_CB, which is called under interrupt for each completed transfer.
+ *
+ * @note This mod installs its own master event handler using #Chip_I2C_SetMasterEventHandler. Blocking transfers with
+ *  #Chip_I2C_MasterTransfer remain possible, but only when the queue is empty.
+ * @note The application must still provide the interrupt handler #I2C0_IRQHandler, calling
+ *  #Chip_I2C_MasterStateHandler for master transfers. This allows to combine it with the slave functionality.
+ * @note Arbitration loss is reported as is: the transfer is not retried. The pointers and sizes in the transfer
+ *  structure have been changed by then.
+ *
+ * @par Example: read a sensor register while doing other work
+ *  @code
+ *      uint8_t reg = 0x32;
+ *      uint8_t data[6];
+ *      I2C_XFER_T xfer = {.slaveAddr = 0x53, .txBuff = &reg, .txSz = 1, .rxBuff = data, .rxSz = 6};
+ *      I2CQ_Init();
+ *      if (I2CQ_Submit(&xfer)) {
+ *          DoOtherWork();
+ *          if (I2CQ_Wait(&xfer) == I2C_STATUS_DONE) {
+ *              ...
+ *          }
+ *      }
+ *  @endcode
+ *
+ * @{
+ */
+
+/* -------------------------------------------------------------------------
+ * Include files
+ * ------------------------------------------------------------------------- */
+
+#include "chip.h"
+#include "i2cq_dft.h"
+
+/* -------------------------------------------------------------------------
+ * Types and defines
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Callback function type to report the completion of a transfer.
+ * @param pXfer : The completed transfer, as given to #I2CQ_Submit. The @c status field holds the final status.
+ * @note Called under interrupt. It is allowed to submit a new transfer from within the callback.
+ */
+typedef void (*pI2cq_Done_Cb_t)(I2C_XFER_T * pXfer);
+
+/* -------------------------------------------------------------------------
+ * Exported function prototypes
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Initializes the module and empties the queue.
+ * @pre The I2C driver is initialized (#Chip_I2C_Init) and its clock rate is set.
+ * @post The module's master event handler is installed, and the I2C interrupt is enabled in NVIC.
+ */
+void I2CQ_Init(void);
+
+/**
+ * Appends a transfer to the queue. When the queue was empty, the transfer is started immediately.
+ * This function returns without waiting for the transfer to complete.
+ * @param pXfer : May not be @c NULL. The transfer to execute. See #Chip_I2C_MasterTransfer for the meaning of the
+ *  fields. The memory pointed to - including the buffers - must remain valid and untouched until the transfer has
+ *  completed.
+ * @return @c false when the queue is full: the transfer is not queued and @c pXfer is not touched.
+ *  @c true otherwise: @c pXfer->status is set to #I2C_STATUS_BUSY.
+ * @note May be called under interrupt.
+ */
+bool I2CQ_Submit(I2C_XFER_T * pXfer);
+
+/**
+ * Sleeps until the given transfer has completed.
+ * @param pXfer : May not be @c NULL. A transfer that was accepted by #I2CQ_Submit.
+ * @return The final status of the transfer.
+ * @note Must not be called under interrupt.
+ */
+I2C_STATUS_T I2CQ_Wait(I2C_XFER_T * pXfer);
+
+/**
+ * Submits a transfer and waits for its completion: the blocking equivalent of #I2CQ_Submit. Unlike
+ * #Chip_I2C_MasterTransfer, the CPU sleeps while the bus is busy, and earlier submitted transfers are honored.
+ * @param pXfer : May not be @c NULL. See #I2CQ_Submit.
+ * @return The final status of the transfer.
+ * @note Waits for a free slot in the queue first when needed.
+ * @note Must not be called under interrupt.
+ */
+I2C_STATUS_T I2CQ_Transfer(I2C_XFER_T * pXfer);
+
+/**
+ * @return The number of transfers that are queued, including the one in progress.
+ * @note May be called under interrupt.
+ */
+int I2CQ_GetCount(void);
+
+#endif /** @} */
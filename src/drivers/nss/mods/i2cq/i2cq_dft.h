@@ -0,0 +1,39 @@
+/** @defgroup MODS_NSS_I2CQ_DFT Diversity Settings
+ *  @ingroup MODS_NSS_I2CQ
+ * These 'defines' capture the diversity settings of the module. The displayed values refer to the default settings.
+ * To override the default settings, place the defines with their desired values in the application app_sel.h header
+ * file: the compiler will pick up your defines before parsing this file.
+ * @{
+ */
+#ifndef __I2CQ_DFT_H_
+#define __I2CQ_DFT_H_
+
+/**
+ * The maximum number of transfers that can be queued, including the one in progress.
+ * Only pointers to the transfers are queued: each queued transfer costs 4 bytes of RAM.
+ */
+#if !defined(I2CQ_QUEUE_SIZE)
+    #define I2CQ_QUEUE_SIZE 4
+#endif
+#if (I2CQ_QUEUE_SIZE < 1) || (I2CQ_QUEUE_SIZE > 255)
+    #error I2CQ_QUEUE_SIZE must be in the range [1, 255]
+#endif
+
+/* Diversity flags below are undefined by default. They are wrapped in a DOXYGEN precompilation flag to enable
+ * documenting them properly. To define them and use the corresponding functionality of the module, make the correct
+ * defines in app_sel.h or board_sel.h.
+ */
+#ifdef __DOXYGEN__
+#error This block of code may not be parsed using gcc.
+
+/**
+ * By default, the completion of a transfer can only be polled, by checking its @c status field or by calling
+ * #I2CQ_Wait. To be notified under interrupt instead, define the callback function here.
+ * Set this define to the function to be called.
+ * @note The value set @b must have the same signature as @ref pI2cq_Done_Cb_t
+ * @note This must be set to the name of a function, not a pointer to a function: no dereference will be made!
+ */
+#define I2CQ_DONE_CB application function of type pI2cq_Done_Cb_t
+#endif
+
+#endif /** @} */
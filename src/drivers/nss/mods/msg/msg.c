@@ -15,6 +15,12 @@
 #if MSG_ENABLE_CHECKBATTERY
 	#include "batimp/batimp.h"
 #endif
+#if MSG_ENABLE_GETPROFILE
+	#include "profile/profile.h"
+	#if !PROFILE_ENABLED
+		#error MSG_ENABLE_GETPROFILE requires PROFILE_ENABLED to be set.
+	#endif
+#endif
 
 /* ------------------------------------------------------------------------- */
 
@@ -38,6 +44,12 @@ static uint32_t GetResponseHandler(uint8_t msgId, int payloadLen, const uint8_t*
 #if MSG_ENABLE_GETVERSION
 static uint32_t GetVersionHandler(uint8_t msgId, int payloadLen, const uint8_t* pPayload);
 #endif
+#if MSG_ENABLE_GETRESPONSES
+static uint32_t GetResponsesHandler(uint8_t msgId, int payloadLen, const uint8_t* pPayload);
+#endif
+#if MSG_ENABLE_GETPROFILE
+static uint32_t GetProfileHandler(uint8_t msgId, int payloadLen, const uint8_t* pPayload);
+#endif
 #if MSG_ENABLE_RESET
 static uint32_t ResetHandler(uint8_t msgId, int payloadLen, const uint8_t* pPayload);
 #endif
@@ -69,8 +81,18 @@ static uint32_t CheckBatteryHandler(uint8_t msgId, int payloadLen, const uint8_t
 static uint32_t GetCalibrationTimestampHandler(uint8_t msgId, int payloadLen, const uint8_t* pPayload);
 #endif
 
-static uint32_t DispatchCommand(uint8_t msgId, int payloadLen, const uint8_t* pPayload,
-                                const MSG_CMD_HANDLER_T * handler, int handlerCount);
+static uint32_t DispatchCommand(uint8_t msgId, int index, int payloadLen, const uint8_t* pPayload,
+                                const pMsg_CmdHandler_t * handler, int handlerCount);
+static void SendResponse(int responseLength, const uint8_t* pResponseData);
+#if MSG_RESPONSE_BUFFER_SIZE
+static uint8_t * OldestResponse(void);
+static uint8_t * NextResponse(uint8_t * pResponse);
+static void DiscardOldestResponse(void);
+static uint8_t * FindFreeSlot(int responseLength);
+static uint8_t * MakeRoom(int responseLength);
+static void StoreResponse(uint8_t * pSlot, int responseLength);
+static uint8_t * Reserve(uint8_t msgId, int payloadLen, bool discard);
+#endif
 
 /* ------------------------------------------------------------------------- */
 
@@ -78,43 +100,50 @@ static pMsg_ResponseCb_t sResponseCb;
 
 /**
  * All command handlers must return #MSG_OK and must call #Msg_AddResponse themselves.
+ * Indexed by message id: a command is dispatched with a single lookup, disabled commands are left @c NULL.
  */
-static MSG_CMD_HANDLER_T sCmdHandler[] = {
+static const pMsg_CmdHandler_t sCmdHandler[MSG_ID_LASTRESERVED + 1] = {
 #if MSG_ENABLE_GETRESPONSE
-    {MSG_ID_GETRESPONSE, GetResponseHandler},
+    [MSG_ID_GETRESPONSE] = GetResponseHandler,
 #endif
 #if MSG_ENABLE_GETVERSION
-    {MSG_ID_GETVERSION, GetVersionHandler},
+    [MSG_ID_GETVERSION] = GetVersionHandler,
 #endif
 #if MSG_ENABLE_RESET
-    {MSG_ID_RESET, ResetHandler},
+    [MSG_ID_RESET] = ResetHandler,
 #endif
 #if MSG_ENABLE_READREGISTER
-    {MSG_ID_READREGISTER, ReadRegisterHandler},
+    [MSG_ID_READREGISTER] = ReadRegisterHandler,
 #endif
 #if MSG_ENABLE_WRITEREGISTER
-    {MSG_ID_WRITEREGISTER, WriteRegisterHandler},
+    [MSG_ID_WRITEREGISTER] = WriteRegisterHandler,
 #endif
 #if MSG_ENABLE_READMEMORY
-    {MSG_ID_READMEMORY, ReadMemoryHandler},
+    [MSG_ID_READMEMORY] = ReadMemoryHandler,
 #endif
 #if MSG_ENABLE_WRITEMEMORY
-    {MSG_ID_WRITEMEMORY, WriteMemoryHandler},
+    [MSG_ID_WRITEMEMORY] = WriteMemoryHandler,
 #endif
 #if MSG_ENABLE_PREPAREDEBUG
-    {MSG_ID_PREPAREDEBUG, PrepareDebugHandler},
+    [MSG_ID_PREPAREDEBUG] = PrepareDebugHandler,
 #endif
 #if MSG_ENABLE_GETUID
-    {MSG_ID_GETUID, GetUidHandler},
+    [MSG_ID_GETUID] = GetUidHandler,
 #endif
 #if MSG_ENABLE_GETNFCUID
-    {MSG_ID_GETNFCUID, GetNfcUidHandler},
+    [MSG_ID_GETNFCUID] = GetNfcUidHandler,
 #endif
 #if MSG_ENABLE_CHECKBATTERY
-    {MSG_ID_CHECKBATTERY, CheckBatteryHandler},
+    [MSG_ID_CHECKBATTERY] = CheckBatteryHandler,
 #endif
 #if MSG_ENABLE_GETCALIBRATIONTIMESTAMP
-    {MSG_ID_GETCALIBRATIONTIMESTAMP, GetCalibrationTimestampHandler},
+    [MSG_ID_GETCALIBRATIONTIMESTAMP] = GetCalibrationTimestampHandler,
+#endif
+#if MSG_ENABLE_GETRESPONSES
+    [MSG_ID_GETRESPONSES] = GetResponsesHandler,
+#endif
+#if MSG_ENABLE_GETPROFILE
+    [MSG_ID_GETPROFILE] = GetProfileHandler,
 #endif
 };
 
@@ -136,6 +165,15 @@ static uint8_t * spResponseBuffer;
 static uint8_t * spOldestResponse;
 static uint8_t * spNextResponse;
 /** @} */
+
+/**
+ * Points to the size byte of the response reserved by #Msg_ReserveResponse, or is @c NULL when no reservation is
+ * pending. The size byte remains 0 until the response is stored in #Msg_CommitResponse.
+ */
+static uint8_t * spReservedResponse;
+
+/** The size of the reserved response, including the header. Only valid when @c spReservedResponse is not @c NULL. */
+static int sReservedLength;
 #endif
 
 /* ------------------------------------------------------------------------- */
@@ -148,25 +186,106 @@ static uint32_t GetResponseHandler(uint8_t msgId, int payloadLen, const uint8_t*
     (void)payloadLen; /* suppress [-Wunused-parameter]: no argument is expected, but if present redundantly, just ignore. */
     (void)pPayload; /* suppress [-Wunused-parameter]: no argument is expected, but if present redundantly, just ignore. */
 
-    if (*spOldestResponse == RESPONSE_SIZE_SKIP_TO_END) {
-        spOldestResponse = spResponseBuffer;
-    }
-    if (*spOldestResponse == 0) {
+    uint8_t * pStored = OldestResponse();
+    if (pStored == NULL) {
         MSG_RESPONSE_RESULTONLY_T response;
         response.result = MSG_ERR_NO_RESPONSE;
         Msg_AddResponse(msgId, sizeof(response), (uint8_t*)&response);
     }
     else {
-        uint8_t msgIdStored = *(spOldestResponse + 1);
-        int payloadLenStored = *spOldestResponse - MSG_HEADER_SIZE;
-        uint8_t* pPayloadStored = spOldestResponse + 1 + MSG_HEADER_SIZE;
+        uint8_t msgIdStored = *(pStored + 1);
+        int payloadLenStored = *pStored - MSG_HEADER_SIZE;
+        uint8_t* pPayloadStored = pStored + 1 + MSG_HEADER_SIZE;
         Msg_AddResponse(msgIdStored, payloadLenStored, pPayloadStored);
-        spOldestResponse += 1 + *spOldestResponse;
-        if (spOldestResponse >= spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE) {
-            ASSERT(spOldestResponse == spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE); /* A failure indicates a buffer overflow. */
-            spOldestResponse = spResponseBuffer;
+        DiscardOldestResponse();
+    }
+    return MSG_OK;
+}
+#endif
+
+#if MSG_ENABLE_GETRESPONSES
+/** @see MSG_ID_GETRESPONSES */
+static uint32_t GetResponsesHandler(uint8_t msgId, int payloadLen, const uint8_t* pPayload)
+{
+    uint8_t response[MSG_GETRESPONSES_MAX_LENGTH];
+    MSG_RESPONSE_GETRESPONSES_T header;
+    int length = MSG_HEADER_SIZE + sizeof(MSG_RESPONSE_GETRESPONSES_T);
+    uint8_t * pStored = OldestResponse();
+
+    ASSERT(msgId == MSG_ID_GETRESPONSES);
+    (void)payloadLen; /* suppress [-Wunused-parameter]: no argument is expected, but if present redundantly, just ignore. */
+    (void)pPayload; /* suppress [-Wunused-parameter]: no argument is expected, but if present redundantly, just ignore. */
+
+    if (pStored == NULL) {
+        header.result = MSG_ERR_NO_RESPONSE;
+        header.count = 0;
+        Msg_AddResponse(msgId, sizeof(header), (uint8_t*)&header);
+    }
+    else if (length + 1 + *pStored > MSG_GETRESPONSES_MAX_LENGTH) {
+        /* The oldest response does not fit in a frame: hand it over as is, as with MSG_ID_GETRESPONSE. */
+        if ((sResponseCb != NULL) && sResponseCb(*pStored, pStored + 1)) {
+            DiscardOldestResponse();
         }
     }
+    else {
+        /* The stored responses are copied including their size byte: each forms a frame in the response. They are
+         * left in the response buffer until the upper layer has accepted the combined response.
+         */
+        header.result = MSG_OK;
+        header.count = 0;
+        while ((pStored != NULL) && (length + 1 + *pStored <= MSG_GETRESPONSES_MAX_LENGTH)
+                && (header.count < UINT8_MAX)) {
+            memcpy(response + length, pStored, (size_t)(1 + *pStored));
+            length += 1 + *pStored;
+            header.count++;
+            pStored = NextResponse(pStored);
+        }
+        response[0] = msgId;
+        response[1] = MSG_DIRECTION_OUTGOING;
+        memcpy(response + MSG_HEADER_SIZE, &header, sizeof(header)); /* Not word aligned in the response. */
+        if ((sResponseCb != NULL) && sResponseCb(length, response)) {
+            for (int n = 0; n < header.count; n++) {
+                DiscardOldestResponse();
+            }
+        }
+    }
+    return MSG_OK;
+}
+#endif
+
+#if MSG_ENABLE_GETPROFILE
+/** @see MSG_ID_GETPROFILE */
+static uint32_t GetProfileHandler(uint8_t msgId, int payloadLen, const uint8_t* pPayload)
+{
+    const MSG_CMD_GETPROFILE_T * command = (const MSG_CMD_GETPROFILE_T *)pPayload;
+    uint8_t response[sizeof(MSG_RESPONSE_GETPROFILE_T) + PROFILE_HISTOGRAM_BINS * sizeof(uint16_t)];
+    MSG_RESPONSE_GETPROFILE_T * pHeader = (MSG_RESPONSE_GETPROFILE_T *)response;
+    const PROFILE_SCOPE_T * pScope = NULL;
+
+    ASSERT(msgId == MSG_ID_GETPROFILE);
+    memset(response, 0, sizeof(response));
+    pHeader->scopeCount = PROFILE_SCOPE_COUNT;
+    if (payloadLen == sizeof(MSG_CMD_GETPROFILE_T)) {
+        pHeader->scope = command->scope;
+        pScope = Profile_GetScope(command->scope);
+        pHeader->result = (pScope == NULL) ? MSG_ERR_INVALID_PARAMETER : MSG_OK;
+    }
+    else {
+        pHeader->result = MSG_ERR_INVALID_COMMAND_SIZE;
+    }
+
+    int length = sizeof(MSG_RESPONSE_GETPROFILE_T);
+    if (pScope != NULL) {
+        pHeader->binCount = PROFILE_HISTOGRAM_BINS;
+        pHeader->count = pScope->count;
+        pHeader->min = pScope->min;
+        pHeader->max = pScope->max;
+        pHeader->totalLow = (uint32_t)pScope->total;
+        pHeader->totalHigh = (uint32_t)(pScope->total >> 32);
+        memcpy(response + length, pScope->histogram, sizeof(pScope->histogram));
+        length += (int)sizeof(pScope->histogram);
+    }
+    Msg_AddResponse(msgId, length, response);
     return MSG_OK;
 }
 #endif
@@ -179,7 +298,8 @@ static uint32_t GetVersionHandler(uint8_t msgId, int payloadLen, const uint8_t*
     (void)payloadLen; /* suppress [-Wunused-parameter]: no argument is expected, but if present redundantly, just ignore. */
     (void)pPayload; /* suppress [-Wunused-parameter]: no argument is expected, but if present redundantly, just ignore. */
 
-    MSG_RESPONSE_GETVERSION_T response = {reserved2: 0,
+    MSG_RESPONSE_GETVERSION_T response = {capabilities: (MSG_ENABLE_GETRESPONSES ? MSG_CAPABILITY_GETRESPONSES : 0)
+                                                        | (MSG_ENABLE_GETPROFILE ? MSG_CAPABILITY_GETPROFILE : 0),
                                           swMajorVersion: SW_MAJOR_VERSION,
                                           swMinorVersion: SW_MINOR_VERSION,
                                           apiMajorVersion: MSG_API_MAJOR_VERSION,
@@ -412,21 +532,236 @@ static uint32_t GetCalibrationTimestampHandler(uint8_t msgId, int payloadLen, co
 
 /* ------------------------------------------------------------------------- */
 
-static uint32_t DispatchCommand(uint8_t msgId, int payloadLen, const uint8_t* pPayload,
-                                const MSG_CMD_HANDLER_T * handler, int handlerCount)
+/**
+ * Calls the handler stored at @c index in a table indexed by message id.
+ * @param msgId The id of the command
+ * @param index The position of @c msgId in @c handler
+ * @param payloadLen Forwarded to the handler
+ * @param pPayload Forwarded to the handler
+ * @param handler The table of handlers. Unused ids hold @c NULL.
+ * @param handlerCount The number of elements in @c handler
+ * @return The result of the handler, or #MSG_ERR_UNKNOWN_COMMAND when no handler is present for @c msgId
+ */
+static uint32_t DispatchCommand(uint8_t msgId, int index, int payloadLen, const uint8_t* pPayload,
+                                const pMsg_CmdHandler_t * handler, int handlerCount)
 {
     uint32_t result = MSG_ERR_UNKNOWN_COMMAND;
-    uint8_t n;
     ASSERT((handlerCount == 0) || (handler != NULL));
-    for (n = 0; n < handlerCount; n++) {
-        if ((handler[n].id == msgId) && (handler[n].handler != NULL)) {
-            result = handler[n].handler(msgId, payloadLen, pPayload);
-            break;
-        }
+    if ((index >= 0) && (index < handlerCount) && (handler[index] != NULL)) {
+        result = handler[index](msgId, payloadLen, pPayload);
     }
     return result;
 }
 
+/**
+ * Hands a formatted response to the upper layer. If refused, the response is stored in the response buffer, or
+ * discarded when there is none or when it does not fit.
+ * @param responseLength The size of the response in bytes, including the header.
+ * @param pResponseData The header followed by the payload.
+ */
+static void SendResponse(int responseLength, const uint8_t* pResponseData)
+{
+    if ((sResponseCb != NULL) && sResponseCb(responseLength, pResponseData)) {
+        /* Response has been accepted. Nothing to be stored. */
+    }
+#if MSG_RESPONSE_BUFFER_SIZE
+    else if ((responseLength > MSG_RESPONSE_BUFFER_SIZE) || (responseLength >= RESPONSE_SIZE_SKIP_TO_END)) {
+        /* Response has not been accepted but it is too big to be stored. */
+    #if defined(MSG_RESPONSE_DISCARDED_CB)
+        /* Send out this new response _now_, then discard it unconditionally. */
+        extern bool MSG_RESPONSE_DISCARDED_CB(int responseLength, const uint8_t* pResponseData);
+        (void)MSG_RESPONSE_DISCARDED_CB(responseLength, pResponseData);
+    #endif
+    }
+    else { /* Response must be stored so it can be fetched later. */
+        uint8_t * pSlot = MakeRoom(responseLength);
+        memcpy(pSlot + 1, pResponseData, (size_t)responseLength);
+        StoreResponse(pSlot, responseLength);
+    }
+#elif defined(MSG_RESPONSE_DISCARDED_CB)
+    else { /* Send out this new response _now_, then discard it unconditionally. */
+        extern bool MSG_RESPONSE_DISCARDED_CB(int responseLength, const uint8_t* pResponseData);
+        (void)MSG_RESPONSE_DISCARDED_CB(responseLength, pResponseData);
+    }
+#endif
+}
+
+#if MSG_RESPONSE_BUFFER_SIZE
+/**
+ * Retrieves the oldest stored response, skipping the dummy response at the end of the buffer if present.
+ * @return Points to the size byte of the oldest stored response, or @c NULL when no responses are stored.
+ */
+static uint8_t * OldestResponse(void)
+{
+    if (*spOldestResponse == RESPONSE_SIZE_SKIP_TO_END) {
+        spOldestResponse = spResponseBuffer;
+    }
+    return (*spOldestResponse == 0) ? NULL : spOldestResponse;
+}
+
+/**
+ * Retrieves the stored response following the given one, without discarding anything.
+ * @param pResponse Points to the size byte of a stored response.
+ * @return Points to the size byte of the next stored response, or @c NULL when @c pResponse is the newest one.
+ */
+static uint8_t * NextResponse(uint8_t * pResponse)
+{
+    pResponse += 1 + *pResponse;
+    if ((pResponse >= spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE) || (*pResponse == RESPONSE_SIZE_SKIP_TO_END)) {
+        ASSERT(pResponse <= spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE); /* A failure indicates a buffer overflow. */
+        pResponse = spResponseBuffer;
+    }
+    return (pResponse == spNextResponse) ? NULL : pResponse;
+}
+
+/**
+ * Removes the oldest stored response from the response buffer.
+ * @pre #OldestResponse did not return @c NULL.
+ */
+static void DiscardOldestResponse(void)
+{
+    spOldestResponse += 1 + *spOldestResponse;
+    if (spOldestResponse >= spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE) {
+        ASSERT(spOldestResponse == spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE); /* A failure indicates a buffer overflow. */
+        spOldestResponse = spResponseBuffer;
+    }
+}
+
+/**
+ * Looks for room in the response buffer without discarding stored responses.
+ * @param responseLength The size of the response in bytes, including the header.
+ * @return Where the size byte of the response is to be placed, or @c NULL when there is not enough room. When this
+ *  differs from @c spNextResponse, the response does not fit in the remainder of the buffer and is placed at its start.
+ */
+static uint8_t * FindFreeSlot(int responseLength)
+{
+    uint8_t * pSlot;
+    uint8_t * pLimit;
+
+    if (spOldestResponse == spNextResponse) {
+        /* Empty: start over at the beginning to have the whole buffer available. */
+        spOldestResponse = spResponseBuffer;
+        spNextResponse = spResponseBuffer;
+        *spNextResponse = 0;
+    }
+
+    /* Determine the first byte that may not be overwritten, as if the buffer was linear. */
+    pSlot = spNextResponse;
+    pLimit = spOldestResponse;
+    if (spOldestResponse <= spNextResponse) {
+        pLimit += MSG_RESPONSE_BUFFER_SIZE;
+    }
+    if (pSlot + 1 + responseLength > spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE) {
+        pSlot = spResponseBuffer;
+        pLimit = (spOldestResponse <= spNextResponse) ? spOldestResponse : spResponseBuffer;
+    }
+
+    /* The byte following the response must remain available to hold the terminating 0. */
+    return (pSlot + 1 + responseLength < pLimit) ? pSlot : NULL;
+}
+
+/**
+ * Makes room in the response buffer, discarding the oldest response(s) as required.
+ * @param responseLength The size of the response in bytes, including the header.
+ * @return Where the size byte of the response is to be placed: always equal to @c spNextResponse.
+ */
+static uint8_t * MakeRoom(int responseLength)
+{
+    int rolloverCount;
+
+    /* Check if the response can be stored in the buffer without splitting.
+     * If not, we skip the remainder of the buffer, thereby increasing the required space.
+     */
+    if (spNextResponse + 1 + responseLength > spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE) {
+        *spNextResponse = RESPONSE_SIZE_SKIP_TO_END;
+        spNextResponse = spResponseBuffer;
+    }
+
+    /* Determine what to add to spOldestResponse to have comparisons as if the buffer was linear. */
+    rolloverCount = 0;
+    if (spOldestResponse <= spNextResponse) {
+        rolloverCount = MSG_RESPONSE_BUFFER_SIZE;
+    }
+
+    /* Check if one or more oldest responses must be discarded. */
+    while (spNextResponse + 1 + responseLength >= spOldestResponse + rolloverCount) {
+        if (*spOldestResponse == RESPONSE_SIZE_SKIP_TO_END) {
+            /* Discard a dummy response that was added because the next response didn't fit in the remaining space
+             * in the buffer. No need to inform anyone.
+             */
+            spOldestResponse = spResponseBuffer;
+            rolloverCount = MSG_RESPONSE_BUFFER_SIZE;
+        }
+        else {
+    #if defined(MSG_RESPONSE_DISCARDED_CB)
+            /* Send out the oldest response _now_, then discard it unconditionally. */
+            int length = *spOldestResponse;
+            uint8_t* data = spOldestResponse + 1;
+            extern bool MSG_RESPONSE_DISCARDED_CB(int responseLength, const uint8_t* pResponseData);
+            (void)MSG_RESPONSE_DISCARDED_CB(length, data);
+    #endif
+            spOldestResponse += 1 + *spOldestResponse;
+            if (spOldestResponse >= spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE) {
+                ASSERT(spOldestResponse == spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE); /* A failure indicates a buffer overflow. */
+                spOldestResponse = spResponseBuffer;
+                rolloverCount = MSG_RESPONSE_BUFFER_SIZE;
+            }
+        }
+    }
+    return spNextResponse;
+}
+
+/**
+ * Adds a response to the response buffer.
+ * @param pSlot As returned by #FindFreeSlot or #MakeRoom. The response is already copied to @c pSlot + 1.
+ * @param responseLength The size of the response in bytes, including the header.
+ */
+static void StoreResponse(uint8_t * pSlot, int responseLength)
+{
+    if (pSlot != spNextResponse) {
+        *spNextResponse = RESPONSE_SIZE_SKIP_TO_END;
+    }
+    *pSlot = (uint8_t)responseLength; /* Guaranteed to fit in one byte. */
+    spNextResponse = pSlot + 1 + responseLength;
+    if (spNextResponse >= spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE) {
+        ASSERT(spNextResponse == spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE); /* A failure indicates a buffer overflow. */
+        spNextResponse = spResponseBuffer;
+    }
+    *spNextResponse = 0;
+}
+
+/**
+ * Reserves room in the response buffer and writes the response header.
+ * @param msgId The id of the response.
+ * @param payloadLen The size of the payload in bytes.
+ * @param discard Whether the oldest stored response(s) may be discarded to make room.
+ * @return Where the payload is to be written, or @c NULL when no room could be reserved.
+ */
+static uint8_t * Reserve(uint8_t msgId, int payloadLen, bool discard)
+{
+    uint8_t * pSlot = NULL;
+    int responseLength = payloadLen + MSG_HEADER_SIZE;
+
+    /* The size byte and the terminating 0 must fit as well. */
+    if ((spReservedResponse == NULL) && (responseLength < MSG_RESPONSE_BUFFER_SIZE - 1)
+            && (responseLength < RESPONSE_SIZE_SKIP_TO_END)) {
+        pSlot = FindFreeSlot(responseLength);
+        if ((pSlot == NULL) && discard) {
+            pSlot = MakeRoom(responseLength);
+        }
+    }
+    if (pSlot != NULL) {
+        *pSlot = 0; /* Until committed, the response is not part of the buffer. */
+        pSlot[1] = msgId;
+        pSlot[2] = MSG_DIRECTION_OUTGOING;
+        spReservedResponse = pSlot;
+        sReservedLength = responseLength;
+        pSlot += 1 + MSG_HEADER_SIZE;
+    }
+    return pSlot;
+}
+#endif
+
 /* -------------------------------------------------------------------------
  * Exported functions
  * ------------------------------------------------------------------------- */
@@ -439,6 +774,7 @@ void Msg_Init(void)
     spOldestResponse = MSG_RESPONSE_BUFFER;
     spNextResponse = MSG_RESPONSE_BUFFER;
     *spNextResponse = 0;
+    spReservedResponse = NULL;
 #endif
 }
 
@@ -452,83 +788,59 @@ void Msg_AddResponse(uint8_t msgId, int payloadLen, const uint8_t* pPayload)
     ASSERT(payloadLen > 0);
     ASSERT(pPayload != NULL);
 
-    /* Formatted message formation. */
-    uint8_t formattedMsg[payloadLen + MSG_HEADER_SIZE];
-    memcpy(formattedMsg + MSG_HEADER_SIZE, pPayload, (size_t)payloadLen);
-    formattedMsg[0] = msgId;
-    formattedMsg[1] = MSG_DIRECTION_OUTGOING;
-    int responseLength = payloadLen + MSG_HEADER_SIZE; /* Update response length for header. */
+    uint8_t * pReserved = NULL;
+#if MSG_RESPONSE_BUFFER_SIZE
+    /* Storing a refused response would make room at spNextResponse: that is where the pending reservation lives. */
+    ASSERT(spReservedResponse == NULL);
 
-    if ((sResponseCb != NULL) && sResponseCb(responseLength, formattedMsg)) {
-        /* Response has been accepted. Nothing to be stored. */
+    /* Prefer free room in the response buffer over a copy on the stack. Stored responses are not discarded for this:
+     * that only happens when the upper layer refuses the response.
+     */
+    pReserved = Reserve(msgId, payloadLen, false);
+#endif
+    if (pReserved != NULL) {
+        memcpy(pReserved, pPayload, (size_t)payloadLen);
+        Msg_CommitResponse(payloadLen);
     }
-#if MSG_RESPONSE_BUFFER_SIZE
-    else if ((responseLength > MSG_RESPONSE_BUFFER_SIZE) || (responseLength >= RESPONSE_SIZE_SKIP_TO_END)) {
-        /* Response has not been accepted but it is too big to be stored. */
-    #if defined(MSG_RESPONSE_DISCARDED_CB)
-        /* Send out this new response _now_, then discard it unconditionally. */
-        extern bool MSG_RESPONSE_DISCARDED_CB(int responseLength, const uint8_t* pResponseData);
-        (void)MSG_RESPONSE_DISCARDED_CB(responseLength, formattedMsg);
-    #endif
+    else {
+        /* Formatted message formation. */
+        uint8_t formattedMsg[payloadLen + MSG_HEADER_SIZE];
+        memcpy(formattedMsg + MSG_HEADER_SIZE, pPayload, (size_t)payloadLen);
+        formattedMsg[0] = msgId;
+        formattedMsg[1] = MSG_DIRECTION_OUTGOING;
+        SendResponse(payloadLen + MSG_HEADER_SIZE, formattedMsg); /* Update response length for header. */
     }
-    else { /* Response must be stored so it can be fetched later. */
-        int rolloverCount;
-
-        /* Check if the response can be stored in the buffer without splitting.
-         * If not, we skip the remainder of the buffer, thereby increasing the required space.
-         */
-        if (spNextResponse + 1 + responseLength > spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE) {
-            *spNextResponse = RESPONSE_SIZE_SKIP_TO_END;
-            spNextResponse = spResponseBuffer;
-        }
-
-        /* Determine what to add to spOldestResponse to have comparisons as if the buffer was linear. */
-        rolloverCount = 0;
-        if (spOldestResponse <= spNextResponse) {
-            rolloverCount = MSG_RESPONSE_BUFFER_SIZE;
-        }
+}
 
-        /* Check if one or more oldest responses must be discarded. */
-        while (spNextResponse + 1 + responseLength >= spOldestResponse + rolloverCount) {
-            if (*spOldestResponse == RESPONSE_SIZE_SKIP_TO_END) {
-                /* Discard a dummy response that was added because the next response didn't fit in the remaining space
-                 * in the buffer. No need to inform anyone.
-                 */
-                spOldestResponse = spResponseBuffer;
-                rolloverCount = MSG_RESPONSE_BUFFER_SIZE;
-            }
-            else {
-    #if defined(MSG_RESPONSE_DISCARDED_CB)
-                /* Send out the oldest response _now_, then discard it unconditionally. */
-                int length = *spOldestResponse;
-                uint8_t* data = spOldestResponse + 1;
-                extern bool MSG_RESPONSE_DISCARDED_CB(int responseLength, const uint8_t* pResponseData);
-                (void)MSG_RESPONSE_DISCARDED_CB(length, data);
-    #endif
-                spOldestResponse += 1 + *spOldestResponse;
-                if (spOldestResponse >= spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE) {
-                    ASSERT(spOldestResponse == spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE); /* A failure indicates a buffer overflow. */
-                    spOldestResponse = spResponseBuffer;
-                    rolloverCount = MSG_RESPONSE_BUFFER_SIZE;
-                }
-            }
-        }
+uint8_t * Msg_ReserveResponse(uint8_t msgId, int payloadLen)
+{
+    uint8_t * pReserved = NULL;
+    ASSERT(payloadLen > 0);
+#if MSG_RESPONSE_BUFFER_SIZE
+    pReserved = Reserve(msgId, payloadLen, true);
+#else
+    (void)msgId; /* suppress [-Wunused-parameter]: without a response buffer, nothing can be reserved. */
+#endif
+    return pReserved;
+}
 
-        /* Store the new response. */
-        *spNextResponse = (uint8_t)responseLength; /* Guaranteed to fit in one byte. */
-        memcpy(spNextResponse + 1, formattedMsg, (size_t)responseLength);
-        spNextResponse += 1 + responseLength;
-        if (spNextResponse >= spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE) {
-            ASSERT(spNextResponse == spResponseBuffer + MSG_RESPONSE_BUFFER_SIZE); /* A failure indicates a buffer overflow. */
-            spNextResponse = spResponseBuffer;
-        }
-        *spNextResponse = 0;
+void Msg_CommitResponse(int payloadLen)
+{
+#if MSG_RESPONSE_BUFFER_SIZE
+    uint8_t * pSlot = spReservedResponse;
+    ASSERT(pSlot != NULL);
+    ASSERT((payloadLen > 0) && (payloadLen + MSG_HEADER_SIZE <= sReservedLength));
+    spReservedResponse = NULL;
+    sReservedLength = payloadLen + MSG_HEADER_SIZE;
+    if ((sResponseCb != NULL) && sResponseCb(sReservedLength, pSlot + 1)) {
+        /* Response has been accepted. The reserved room is free again. */
     }
-#elif defined(MSG_RESPONSE_DISCARDED_CB)
-    else { /* Send out this new response _now_, then discard it unconditionally. */
-        extern bool MSG_RESPONSE_DISCARDED_CB(int responseLength, const uint8_t* pResponseData);
-        (void)MSG_RESPONSE_DISCARDED_CB(responseLength, formattedMsg);
+    else {
+        StoreResponse(pSlot, sReservedLength);
     }
+#else
+    (void)payloadLen; /* suppress [-Wunused-parameter]: without a response buffer, nothing can have been reserved. */
+    ASSERT(false); /* Msg_ReserveResponse always returns NULL without a response buffer. */
 #endif
 }
 
@@ -555,14 +867,14 @@ void Msg_HandleCommand(int cmdLength, const uint8_t* pCmdData)
 #endif
 
         if (msgId <= MSG_ID_LASTRESERVED) {
-            result = DispatchCommand(msgId, cmdLength - MSG_HEADER_SIZE, pCmdData + MSG_HEADER_SIZE,
+            result = DispatchCommand(msgId, msgId, cmdLength - MSG_HEADER_SIZE, pCmdData + MSG_HEADER_SIZE,
                                      sCmdHandler, sizeof(sCmdHandler) / sizeof(sCmdHandler[0]));
         }
 #if (MSG_APP_HANDLERS_COUNT)
         else {
-            extern MSG_CMD_HANDLER_T MSG_APP_HANDLERS[MSG_APP_HANDLERS_COUNT];
-            result = DispatchCommand(msgId, cmdLength - MSG_HEADER_SIZE, pCmdData + MSG_HEADER_SIZE,
-                                     MSG_APP_HANDLERS, MSG_APP_HANDLERS_COUNT);
+            extern const pMsg_CmdHandler_t MSG_APP_HANDLERS[MSG_APP_HANDLERS_COUNT];
+            result = DispatchCommand(msgId, msgId - MSG_APP_ID_FIRST, cmdLength - MSG_HEADER_SIZE,
+                                     pCmdData + MSG_HEADER_SIZE, MSG_APP_HANDLERS, MSG_APP_HANDLERS_COUNT);
         }
 #endif
 #if defined(MSG_CATCHALL_HANDLER)
@@ -579,6 +891,9 @@ void Msg_HandleCommand(int cmdLength, const uint8_t* pCmdData)
         }
 #endif
     }
+#if MSG_RESPONSE_BUFFER_SIZE
+    ASSERT(spReservedResponse == NULL); /* A failure indicates a handler did not commit its reserved response. */
+#endif
 
     if (result != MSG_OK) {
         MSG_RESPONSE_RESULTONLY_T response;
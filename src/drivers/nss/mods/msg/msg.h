@@ -470,11 +470,13 @@
  * @par How to use the module
  *  Most likely there will be at least a few application specific commands and responses. A first step would then be to
  *  create a list of message id's and functions that act as the command handlers / response generators for these message
- *  id's and to store them in an array of type #MSG_CMD_HANDLER_T.
+ *  id's and to store them in a table defined with #MSG_APP_HANDLER_TABLE. The table is indexed by message id, which
+ *  keeps the time to dispatch a command constant, regardless of the number of commands.
  *
  *  Each such function is to use #Msg_AddResponse reply to a received command. It is recommended also create a (packed)
  *  command structure and response structure for each message id, as this aids in explicitly describing the message
- *  specific parameters.
+ *  specific parameters. For large responses, #Msg_ReserveResponse and #Msg_CommitResponse allow to build the response
+ *  in place in the response buffer.
  *
  *  Also check the other diversity flags and enable the required functionality. Possibly you'll have to implement a few
  *  callback functions if you want to make use of all the functionality. Couple your 'extensions' using the diversity
@@ -707,6 +709,45 @@ typedef enum MSG_ID {
      */
     MSG_ID_GETCALIBRATIONTIMESTAMP = 0x0c,
 
+    /**
+     * @c 0x0d @n
+     * Retrieves as many stored responses as fit in a single response, oldest first. Compared to #MSG_ID_GETRESPONSE,
+     * this saves one round trip for each additional stored response.
+     * @param Header : Sequence of bytes as per the @ref msg_anchor_protocol "Protocol".
+     * @param Payload : @b No payload.
+     * @return #MSG_RESPONSE_GETRESPONSES_T, followed by the stored responses.
+     *  When the oldest stored response on its own is too large to be combined, it is returned as is instead, as with
+     *  #MSG_ID_GETRESPONSE.
+     * @note synchronous command
+     * @note The stored responses are only removed once the upper layer accepted the response. When it is refused,
+     *  it is not stored: the host can send this command again to retrieve the same responses.
+     * @ifnot MSG_PROTOCOL_DOC
+     * @note The size of the response is limited to #MSG_GETRESPONSES_MAX_LENGTH bytes. Send this command again
+     *  until #MSG_ERR_NO_RESPONSE is returned to retrieve all stored responses.
+     * @endif
+     * @note Available when #MSG_CAPABILITY_GETRESPONSES is set in #MSG_RESPONSE_GETVERSION_T.capabilities.
+     * @ifnot MSG_PROTOCOL_DOC
+     * @note Disabled by default. To enable this command, define #MSG_ENABLE_GETRESPONSES.
+     * @endif
+     */
+    MSG_ID_GETRESPONSES = 0x0d,
+
+    /**
+     * @c 0x0e @n
+     * Retrieves the measurements of one profiling scope: the number of calls, the shortest, longest and total
+     * duration, and a log2 histogram of the durations, all in system clock cycles.
+     * @param Header : Sequence of bytes as per the @ref msg_anchor_protocol "Protocol".
+     * @param Payload : #MSG_CMD_GETPROFILE_T
+     * @return #MSG_RESPONSE_GETPROFILE_T, followed by the histogram.
+     * @note synchronous command
+     * @note Available when #MSG_CAPABILITY_GETPROFILE is set in #MSG_RESPONSE_GETVERSION_T.capabilities.
+     * @ifnot MSG_PROTOCOL_DOC
+     * @note Disabled by default. To enable this command, define #MSG_ENABLE_GETPROFILE.
+     * @see MODS_NSS_PROFILE
+     * @endif
+     */
+    MSG_ID_GETPROFILE = 0x0e,
+
     /** Obsolete. Do not use. */
     MSG_ID_OBSOLETE_3E = 0x3E,
 
@@ -753,9 +794,44 @@ void Msg_SetResponseCb(pMsg_ResponseCb_t cb);
  * @param msgId : Holds the id of the message
  * @param payloadLen : Size in bytes of the response
  * @param pPayload : May not be @c NULL. Points to @c payloadLen number of bytes, which forms the complete response.
+ * @note When the response buffer has enough free room, the response is formatted there. Otherwise, a copy of the
+ *  response is made on the stack. To avoid both the copy of the payload and the stack usage, use
+ *  #Msg_ReserveResponse and #Msg_CommitResponse instead.
+ * @pre No reservation made with #Msg_ReserveResponse may be pending: storing this response could overwrite it.
  */
 void Msg_AddResponse(uint8_t msgId, int payloadLen, const uint8_t* pPayload);
 
+/**
+ * Reserves room for a response in the response buffer, to be filled in by the caller. This avoids building the
+ * response in a separate buffer first, which then needs to be copied by #Msg_AddResponse.
+ * The response is given to the upper layer - or stored - when #Msg_CommitResponse is called.
+ * @param msgId : Holds the id of the message
+ * @param payloadLen : Size in bytes of the response
+ * @return Where the @c payloadLen bytes of the response payload are to be written, or @c NULL when no room could be
+ *  reserved: when no buffer has been made available via the diversities #MSG_RESPONSE_BUFFER and
+ *  #MSG_RESPONSE_BUFFER_SIZE, when the response does not fit in the buffer, or when a reservation is already pending.
+ *  Except for the latter case, use #Msg_AddResponse instead.
+ * @note To make room, the oldest stored response(s) may be discarded - even when the upper layer accepts the response
+ *  afterwards. If a function has been assigned to #MSG_RESPONSE_DISCARDED_CB, that callback will have been called for
+ *  each of them before this function exits.
+ * @post #Msg_CommitResponse must be called before calling this function or #Msg_AddResponse again, and before
+ *  returning from a command handler.
+ * @post The header of the response is already written: the message id and the directionality byte directly precede
+ *  the returned pointer.
+ */
+uint8_t * Msg_ReserveResponse(uint8_t msgId, int payloadLen);
+
+/**
+ * Finishes the response reserved with #Msg_ReserveResponse. The response is given to the upper layer directly from the
+ * response buffer. If this fails, it is kept in the response buffer so it can be given to the upper layer at a later
+ * time; otherwise the reserved room is freed.
+ * @param payloadLen : Size in bytes of the response. May be less than reserved, when less data turned out to be
+ *  available: the remainder of the reserved room is freed.
+ *  @pre 0 < @c payloadLen <= the size given to #Msg_ReserveResponse
+ * @pre #Msg_ReserveResponse returned a non-@c NULL pointer, and the first @c payloadLen payload bytes have been written.
+ */
+void Msg_CommitResponse(int payloadLen);
+
 /**
  * To be called each time a command has been received via any communication channel.
  * @param cmdLength : The size in bytes in @c pCmdData
@@ -53,6 +53,11 @@ typedef struct MSG_CMD_WRITEMEMORY_S {
     uint8_t data[32]; /**< A container for the data to write. */
 } MSG_CMD_WRITEMEMORY_T;
 
+/** @see MSG_ID_GETPROFILE */
+typedef struct MSG_CMD_GETPROFILE_S {
+    uint8_t scope; /**< The scope to retrieve, starting from 0. */
+} MSG_CMD_GETPROFILE_T;
+
 #pragma pack(pop)
 
 /* ------------------------------------------------------------------------- */
@@ -95,19 +100,35 @@ typedef uint32_t (*pMsg_CmdHandler_t)(uint8_t msgId, int payloadLen, const uint8
  */
 typedef bool (*pMsg_AcceptCommandCb_t)(uint8_t msgId, int payloadLen, const uint8_t* pPayload);
 
+/** The lowest message id available for application specific commands. */
+#define MSG_APP_ID_FIRST (MSG_ID_LASTRESERVED + 1)
+
 /**
- * Structure to be used to add the application specific command handlers.
+ * Defines the table with the application specific command handlers, indexed by message id.
+ * The table is to be used as #MSG_APP_HANDLERS: each command is then dispatched with a single lookup, independent of
+ * the number of handlers.
+ * @param name The name of the table, which must equal #MSG_APP_HANDLERS.
+ * @param list An X-macro taking a macro argument @c X, and calling @c X(id, handler) once for each command.
+ *  @c id is the message id, @c handler a function of type #pMsg_CmdHandler_t.
+ * @note The table has #MSG_APP_HANDLERS_COUNT elements, which must equal the highest id in @c list minus
+ *  #MSG_ID_LASTRESERVED. Ids without a handler are @c NULL and are answered with #MSG_ERR_UNKNOWN_COMMAND.
+ * @note The build fails when an id is used twice, or lies outside the range covered by the table.
+ * @note An enum value @c name_COUNT is defined as well, holding the number of handlers in @c list.
  * @see MSG_APP_HANDLERS_COUNT
  */
-typedef struct MSG_CMD_HANDLER_S {
-    /** The id of the command this handler takes care of. */
-    uint8_t id;
-
-    /**
-     * The function that handles a command with #id as message id.
-     */
-    pMsg_CmdHandler_t handler;
-} MSG_CMD_HANDLER_T;
+#define MSG_APP_HANDLER_TABLE(name, list) \
+    enum { name##_COUNT = 0 list(MSG_APP_HANDLER_TABLE_COUNT_) }; \
+    static inline void name##_CheckUnique(uint8_t msgId) \
+    { \
+        switch (msgId) { list(MSG_APP_HANDLER_TABLE_CASE_) default: break; } \
+    } \
+    const pMsg_CmdHandler_t name[MSG_APP_HANDLERS_COUNT] = { list(MSG_APP_HANDLER_TABLE_ENTRY_) }
+
+/** @cond */
+#define MSG_APP_HANDLER_TABLE_COUNT_(id, handler) + 1
+#define MSG_APP_HANDLER_TABLE_CASE_(id, handler) case (id):
+#define MSG_APP_HANDLER_TABLE_ENTRY_(id, handler) [(id) - MSG_APP_ID_FIRST] = (handler),
+/** @endcond */
 
 /** @endcond */
 
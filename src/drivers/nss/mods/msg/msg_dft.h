@@ -52,6 +52,8 @@
  *      - #MSG_ENABLE_PREPAREDEBUG
  *      - #MSG_ENABLE_GETUID
  *      - #MSG_ENABLE_CHECKBATTERY
+ *      - #MSG_ENABLE_GETRESPONSES
+ *      - #MSG_ENABLE_GETPROFILE
  *
  * @par Example
  *  To override each and every diversity flag that the message handler module offers, create defines that are known to
@@ -59,7 +61,7 @@
  *  The recommended way to do this is to add the code below to @c app_sel.h
  *  @code
  *      #define MSG_APP_HANDLERS_COUNT 15
- *      #define MSG_APP_HANDLERS <name of MSG_CMD_HANDLER_T array>
+ *      #define MSG_APP_HANDLERS <name of the table defined with MSG_APP_HANDLER_TABLE>
  *      #define MSG_CATCHALL_HANDLER <name of pMsg_CmdHandler_t function>
  *      #define SW_MAJOR_VERSION 4
  *      #define SW_MINOR_VERSION 2
@@ -76,6 +78,9 @@
  *      #define MSG_ENABLE_GETUID 1
  *      #define MSG_ENABLE_CHECKBATTERY 1
  *      #define MSG_ENABLE_GETCALIBRATIONTIMESTAMP 1
+ *      #define MSG_ENABLE_GETRESPONSES 1
+ *      #define MSG_GETRESPONSES_MAX_LENGTH 64
+ *      #define MSG_ENABLE_GETPROFILE 1
  *  @endcode
  *
  * @{
@@ -87,7 +92,8 @@
     /**
      * @pre To define custom command handlers, both #MSG_APP_HANDLERS_COUNT and #MSG_APP_HANDLERS must be defined.
      * @pre #MSG_APP_HANDLERS_COUNT must be a strict positive number indicating the size of the array
-     *  #MSG_APP_HANDLERS
+     *  #MSG_APP_HANDLERS. The array is indexed by message id, starting at #MSG_APP_ID_FIRST: its size is the highest
+     *  application specific message id minus #MSG_ID_LASTRESERVED.
      */
     #define MSG_APP_HANDLERS_COUNT 0
 #endif
@@ -156,6 +162,44 @@
  */
 #define MSG_ENABLE_GETRESPONSE (MSG_RESPONSE_BUFFER_SIZE > 0)
 
+/**
+ * Assign a non-zero value to enable the handling of the command #MSG_ID_GETRESPONSES: all stored responses are then
+ * retrievable in one go, saving the host a round trip per additional response.
+ * @pre #MSG_RESPONSE_BUFFER_SIZE must be set.
+ * @note The handler uses a local array of #MSG_GETRESPONSES_MAX_LENGTH bytes.
+ * @see MSG_CAPABILITY_GETRESPONSES
+ */
+#ifndef MSG_ENABLE_GETRESPONSES
+    #define MSG_ENABLE_GETRESPONSES 0
+#endif
+#if MSG_ENABLE_GETRESPONSES && !MSG_ENABLE_GETRESPONSE
+    #error MSG_ENABLE_GETRESPONSES requires MSG_RESPONSE_BUFFER and MSG_RESPONSE_BUFFER_SIZE to be defined.
+#endif
+
+/**
+ * The size in bytes, including the header, of the largest response to #MSG_ID_GETRESPONSES. Stored responses are
+ * combined up to this size; the remainder is left for a next #MSG_ID_GETRESPONSES command.
+ * Choose a value the upper layer is able to transmit in one go.
+ * @note Only used when #MSG_ENABLE_GETRESPONSES is set.
+ */
+#ifndef MSG_GETRESPONSES_MAX_LENGTH
+    #define MSG_GETRESPONSES_MAX_LENGTH 64
+#endif
+#if MSG_ENABLE_GETRESPONSES && (MSG_GETRESPONSES_MAX_LENGTH < 14)
+    #error MSG_GETRESPONSES_MAX_LENGTH must hold the header, MSG_RESPONSE_GETRESPONSES_T and at least one frame.
+#endif
+
+/**
+ * Assign a non-zero value to enable the handling of the command #MSG_ID_GETPROFILE: the measurements of the
+ * profiling scopes are then retrievable by a tag reader.
+ * @pre #PROFILE_ENABLED must be set, and the application must call #Profile_Init.
+ * @note The response takes <tt>27 + 2 * #PROFILE_HISTOGRAM_BINS</tt> bytes, including the header.
+ * @see MSG_CAPABILITY_GETPROFILE
+ */
+#ifndef MSG_ENABLE_GETPROFILE
+    #define MSG_ENABLE_GETPROFILE 0
+#endif
+
 /* ------------------------------------------------------------------------- */
 
 /**
@@ -249,9 +293,10 @@
 /**
  *  To define custom command handlers, both #MSG_APP_HANDLERS_COUNT and #MSG_APP_HANDLERS
  *  must be defined.
- *  @pre #MSG_APP_HANDLERS must be an array with elements of type #MSG_CMD_HANDLER_T
+ *  @pre #MSG_APP_HANDLERS must be an array with elements of type #pMsg_CmdHandler_t, defined using
+ *   #MSG_APP_HANDLER_TABLE.
  */
-#define MSG_APP_HANDLERS application defined array with MSG_APP_HANDLERS_COUNT elements of type #MSG_CMD_HANDLER_T
+#define MSG_APP_HANDLERS application defined array with MSG_APP_HANDLERS_COUNT elements of type #pMsg_CmdHandler_t
 
 /**
  *  Responses that do not get treated immediately can be stored in an internal buffer. To define a buffer to be used
@@ -80,6 +80,18 @@ typedef enum MSG_ERR {
     MSG_ERR_LASTRESERVED = 0x1003F
 } MSG_ERR_T;
 
+/**
+ * Lists the optional features a host can rely on, as reported in #MSG_RESPONSE_GETVERSION_T.capabilities.
+ * Hosts must ignore bits they do not know.
+ */
+typedef enum MSG_CAPABILITY {
+    /** @c 0x0001 @n The command #MSG_ID_GETRESPONSES is available. */
+    MSG_CAPABILITY_GETRESPONSES = 1 << 0,
+
+    /** @c 0x0002 @n The command #MSG_ID_GETPROFILE is available. */
+    MSG_CAPABILITY_GETPROFILE = 1 << 1
+} MSG_CAPABILITY_T;
+
 /* ------------------------------------------------------------------------- */
 
 #pragma pack(push, 1)
@@ -108,7 +120,11 @@ typedef struct MSG_RESPONSE_RESULTONLY_S {
 
 /** @see MSG_ID_GETVERSION */
 typedef struct MSG_RESPONSE_GETVERSION_S {
-    uint16_t reserved2; /**< Reserved for future use. Must be 0. Does not bear any significance. */
+    /**
+     * A bitmask of OR'd values of type #MSG_CAPABILITY_T.
+     * @note Older firmware reports @c 0 here: this field used to be reserved.
+     */
+    uint16_t capabilities;
     uint16_t swMajorVersion; /**< The software major version */
     uint16_t swMinorVersion; /**< The software minor version */
     uint16_t apiMajorVersion; /**< Equal to #MSG_API_MAJOR_VERSION */
@@ -121,6 +137,44 @@ typedef struct MSG_RESPONSE_GETVERSION_S {
     uint32_t deviceId;
 } MSG_RESPONSE_GETVERSION_T;
 
+/**
+ * @see MSG_ID_GETRESPONSES
+ * @note This structure is followed by @c count frames, each holding one stored response: a single byte with the size
+ *  of the response in bytes, followed by the response itself - starting with its message id and directionality byte,
+ *  as if it was retrieved with #MSG_ID_GETRESPONSE. The oldest response comes first.
+ */
+typedef struct MSG_RESPONSE_GETRESPONSES_S {
+    /**
+     * The command result.
+     * #MSG_OK if at least one stored response follows, #MSG_ERR_NO_RESPONSE otherwise.
+     */
+    uint32_t result;
+
+    uint8_t count; /**< The number of frames following this structure. */
+} MSG_RESPONSE_GETRESPONSES_T;
+
+/**
+ * @see MSG_ID_GETPROFILE
+ * @note This structure is followed by @c binCount 16-bit values: the number of calls per duration bin. Bin 0 counts
+ *  the durations of 0 cycles, bin @c n the durations in the range [2^(n-1), 2^n[, the last bin also all longer ones.
+ */
+typedef struct MSG_RESPONSE_GETPROFILE_S {
+    /**
+     * The command result.
+     * #MSG_OK, or #MSG_ERR_INVALID_PARAMETER when @c scope is not below @c scopeCount.
+     */
+    uint32_t result;
+
+    uint8_t scope; /**< The requested scope. */
+    uint8_t scopeCount; /**< The number of scopes. */
+    uint8_t binCount; /**< The number of histogram bins following this structure. 0 on error. */
+    uint32_t count; /**< The number of completed calls. */
+    uint32_t min; /**< The shortest duration in cycles, @c 0xFFFFFFFF when @c count is 0. */
+    uint32_t max; /**< The longest duration in cycles. */
+    uint32_t totalLow; /**< The lower 32 bits of the sum of all durations in cycles. */
+    uint32_t totalHigh; /**< The upper 32 bits of the sum of all durations in cycles. */
+} MSG_RESPONSE_GETPROFILE_T;
+
 /** @see MSG_ID_READREGISTER */
 typedef struct MSG_RESPONSE_READREGISTER_S {
     /**
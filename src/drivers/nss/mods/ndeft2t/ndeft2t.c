@@ -12,6 +12,7 @@
 #include <string.h>
 #include "chip.h"
 #include "ndeft2t/ndeft2t.h"
+#include "profile/profile.h"
 
 /* -------------------------------------------------------------------------
  * Private types and enumerations
@@ -60,6 +61,8 @@
 
 #define NDEFT2T_TERM_TLV_INIT_VAL 0xFFFFFFFFUL /**< Initialiser value for terminator TLV offset. */
 
+#define NDEFT2T_DIRECT_CHUNK_WORDS 8 /**< Words copied at once to the shared memory when creating a message directly. */
+
 /**
  * Helper. Performs integer division, rounding up.
  * @param n Must be a positive number. Will be evaluated once.
@@ -159,6 +162,8 @@ typedef struct {
     bool msgBegin; /**< Used to track the first record of the message. */
     bool shortRecord; /**< When set to '1' indicates that a short record type is enabled. */
     bool shortMessage; /**< To Track if the length of the message is <= 254 bytes or not. */
+    bool direct; /**< Set when the message is created directly in the shared memory. See #NDEFT2T_CreateMessageDirect. */
+    bool collision; /**< Set when the tag reader wrote at the same time as a direct write to the shared memory. */
     /** @} */
 } NDEFT2T_INSTANCE_T;
 
@@ -176,10 +181,16 @@ int checkSizeOfNdeft2tInstance[(NDEFT2T_INSTANCE_SIZE == sizeof(NDEFT2T_INSTANCE
 
 static bool CreateRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T *pRecordInfo, NDEFT2T_RECORD_TYPE_T type,
                          NDEFT2T_TNF_T tnf, int hdrLen, bool typeStringPresent);
+static bool CommitMessage(void *pInstance);
+static void Write(NDEFT2T_INSTANCE_T *pInst, uint8_t *pDst, const void *pSrc, int size);
+static bool WriteSharedMemory(uint8_t *pDst, const uint8_t *pSrc, int size);
+#if NDEFT2T_DIFFERENTIAL_COMMIT == 1
+static bool WriteChangedPages(const uint32_t *pMsg, int words);
+#endif
 static uint8_t* DecodeNdefTlv(int *lenTlv);
 static bool ValidateNdefMsg(void *pInstance);
 #if NDEFT2T_EEPROM_COPY_SUPPPORT == 1
-static void CopyFromEeprom(uint8_t *pDst, const void * pSrc, int size);
+static void CopyFromEeprom(NDEFT2T_INSTANCE_T *pInst, uint8_t *pDst, const void * pSrc, int size);
 #endif
 static void EnableTermTlvDetection(void);
 static void DisableTermTlvDetection(void);
@@ -274,6 +285,8 @@ void NDEFT2T_CreateMessage(void *pInstance, uint8_t *pBuffer, int bufLen, bool s
     pInst->pLastRecordHdr = NULL;
     pInst->len = 0;
     pInst->shortMessage = shortMessage;
+    pInst->direct = false;
+    pInst->collision = false;
 
     /* Fill predefined bytes to start of buffer. The first is a pre-defined lock TLV (01 03 E8 0E 46) to enable
      * android stacks to resolve location of dynamic lock bits. Then, write an empty NDEF message header. The first
@@ -301,6 +314,29 @@ void NDEFT2T_CreateMessage(void *pInstance, uint8_t *pBuffer, int bufLen, bool s
     pInst->msgBegin = 1;
 }
 
+void NDEFT2T_CreateMessageDirect(void *pInstance)
+{
+    NDEFT2T_INSTANCE_T *pInst = (NDEFT2T_INSTANCE_T *)pInstance;
+    ASSERT(pInstance != NULL);
+
+    pInst->bufLen = NFC_SHARED_MEM_BYTE_SIZE;
+    pInst->pLastRecordHdr = NULL;
+    pInst->len = 0;
+    pInst->direct = true;
+
+    /* Space for a 3-byte length field is always reserved: the records then start word aligned, and never need to be
+     * moved. When the message turns out to be short, 2 NULL TLVs precede the NDEF TLV. See NDEFT2T_CommitMessage.
+     * Writing the default bytes also empties the NDEF message: a tag reader no longer sees the previous message while
+     * the new one is being created.
+     */
+    pInst->shortMessage = false;
+    pInst->collision = !Chip_NFC_WordWrite(NSS_NFC, (uint32_t *)NSS_NFC->BUF, (const uint32_t *)sDefaultBytes,
+                                           sizeof(sDefaultBytes) / 4);
+    pInst->pCursor = (uint8_t *)NSS_NFC->BUF + NDEFT2T_NDEF_PAYLOAD_START_OFFSET_LONG;
+    pInst->msgSize = NDEFT2T_NDEF_PAYLOAD_START_OFFSET_LONG + 1; /* 1 byte is reserved for the terminator TLV. */
+    pInst->msgBegin = 1;
+}
+
 bool NDEFT2T_CreateTextRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T *pRecordInfo)
 {
     ASSERT((pRecordInfo != NULL) && (pRecordInfo->pString != NULL));
@@ -360,21 +396,22 @@ bool NDEFT2T_WriteRecordPayload(void *pInstance, const void * pData, int size)
     /* Copy record payload to the message buffer and update the message buffer pointer. */
 #if NDEFT2T_EEPROM_COPY_SUPPPORT == 1
     if (isSourceEeprom) {
-        CopyFromEeprom(pInst->pCursor, pData, size);
+        CopyFromEeprom(pInst, pInst->pCursor, pData, size);
     }
     else
 #endif
     {
-        memcpy(pInst->pCursor, pData, (uint32_t)size);
+        Write(pInst, pInst->pCursor, pData, size);
     }
     pInst->pCursor += size;
-    return true;
+    return !pInst->collision;
 }
 
 void NDEFT2T_CommitRecord(void *pInstance)
 {
     NDEFT2T_INSTANCE_T *pInst = (NDEFT2T_INSTANCE_T *)pInstance;
     uint8_t *pCursor;
+    uint8_t lenField[NDEFT2T_LONG_PAYLOAD_LENGTH_LEN];
     int len;
 
     ASSERT((pInst != NULL) && (pInst->pCursor != NULL) && (pInst->pLastRecordHdr != NULL));
@@ -388,13 +425,15 @@ void NDEFT2T_CommitRecord(void *pInstance)
     /* Fill the payload length field with a single-byte or 4-byte format depending on whether the record type used is
      * a short one or not. */
     if (pInst->shortRecord) {
-        *pCursor++ = (uint8_t)len; /* Payload Length. */
+        lenField[0] = (uint8_t)len; /* Payload Length. */
+        Write(pInst, pCursor, lenField, NDEFT2T_SHORT_PAYLOAD_LENGTH_LEN);
     }
     else {
-        *pCursor++ = 0x00; /* Payload Length byte 3. Shared memory is only 512 bytes, so this can never be set. */
-        *pCursor++ = 0x00; /* Payload Length byte 2. Shared memory is only 512 bytes, so this can never be set. */
-        *pCursor++ = (uint8_t)((len >> 8) & 0xFF); /* Payload Length byte 1. */
-        *pCursor++ = (uint8_t)(len & 0xFF); /* Payload Length byte 0. */
+        lenField[0] = 0x00; /* Payload Length byte 3. Shared memory is only 512 bytes, so this can never be set. */
+        lenField[1] = 0x00; /* Payload Length byte 2. Shared memory is only 512 bytes, so this can never be set. */
+        lenField[2] = (uint8_t)((len >> 8) & 0xFF); /* Payload Length byte 1. */
+        lenField[3] = (uint8_t)(len & 0xFF); /* Payload Length byte 0. */
+        Write(pInst, pCursor, lenField, NDEFT2T_LONG_PAYLOAD_LENGTH_LEN);
     }
 
     /* Clear Message Begin(MB) bit as it is applicable only for the very first record. */
@@ -402,6 +441,15 @@ void NDEFT2T_CommitRecord(void *pInstance)
 }
 
 bool NDEFT2T_CommitMessage(void *pInstance)
+{
+    PROFILE_BEGIN(PROFILE_ID_NDEFT2T_COMMIT);
+    bool success = CommitMessage(pInstance);
+    PROFILE_END(PROFILE_ID_NDEFT2T_COMMIT);
+    return success;
+}
+
+/** @see NDEFT2T_CommitMessage. Split off to measure all of its exits as one profiling scope. */
+static bool CommitMessage(void *pInstance)
 {
     NDEFT2T_INSTANCE_T *pInst = (NDEFT2T_INSTANCE_T *)pInstance;
     uint32_t *pCursor;
@@ -413,9 +461,14 @@ bool NDEFT2T_CommitMessage(void *pInstance)
 #endif
     bool statusPayload = true;
     bool statusHdr = true;
+    uint8_t byte;
 
     ASSERT((pInstance != NULL) && (pInst->pCursor != NULL));
 
+    if (pInst->collision) {
+        /* The message in the shared memory is incomplete. Its length is still 0: leave it empty. */
+        return false;
+    }
     msgSize = pInst->msgSize;
 
     /* Extract L part of the NDEF message TLV to fix the header. */
@@ -434,14 +487,18 @@ bool NDEFT2T_CommitMessage(void *pInstance)
         ASSERT(pInst->pLastRecordHdr != NULL);
 
         /* Setting ME bit for last record header. */
-        *pInst->pLastRecordHdr = (*pInst->pLastRecordHdr) | (1 << 6);
+        byte = (uint8_t)(*pInst->pLastRecordHdr | (1 << 6));
+        Write(pInst, pInst->pLastRecordHdr, &byte, 1);
     }
 
     /* Get start of NDEF TLV in message buffer. */
     pCursor = (uint32_t*)(pInst->pCursor - (msgSize - 1) + NDEFT2T_NDEF_TLV_START_OFFSET);
 
+    if (pInst->direct) {
+        /* Nothing to correct: space for a 3-byte length field was reserved, which is also used for a short message. */
+    }
 #if NDEFT2T_MESSAGE_HEADER_LENGTH_CORRECTION == 1
-    if ((pInst->shortMessage == true) && (lenTlv > NDEFT2T_NDEF_SHORT_MSG_LIMIT)) {
+    else if ((pInst->shortMessage == true) && (lenTlv > NDEFT2T_NDEF_SHORT_MSG_LIMIT)) {
         msgSize += 2;
         if (msgSize > NFC_SHARED_MEM_BYTE_SIZE) {
             return false;
@@ -462,7 +519,7 @@ bool NDEFT2T_CommitMessage(void *pInstance)
     }
 
 #else /* NDEFT2T_MESSAGE_HEADER_LENGTH_CORRECTION */
-    if ((pInst->shortMessage == true) && (lenTlv > NDEFT2T_NDEF_SHORT_MSG_LIMIT)) {
+    else if ((pInst->shortMessage == true) && (lenTlv > NDEFT2T_NDEF_SHORT_MSG_LIMIT)) {
         return false;
     }
     else if ((pInst->shortMessage == false) && (lenTlv <= NDEFT2T_NDEF_SHORT_MSG_LIMIT)) {
@@ -470,7 +527,11 @@ bool NDEFT2T_CommitMessage(void *pInstance)
     }
 #endif /* NDEFT2T_MESSAGE_HEADER_LENGTH_CORRECTION */
 
-    *pInst->pCursor++ = TLV_TERMINATOR; /* Write Terminator TLV. */
+    byte = TLV_TERMINATOR;
+    Write(pInst, pInst->pCursor++, &byte, 1); /* Write Terminator TLV. */
+    if (pInst->collision) {
+        return false;
+    }
     pCursor = (uint32_t*)(pInst->pCursor - msgSize); /* Get start of message buffer. */
 
 #ifdef NDEFT2T_MSG_READ_CB
@@ -521,7 +582,16 @@ bool NDEFT2T_CommitMessage(void *pInstance)
         }
     }
 
-    memcpy((void *)NSS_NFC->BUF, pCursor, (uint32_t)msgSize);
+    if (!pInst->direct) {
+#if NDEFT2T_DIFFERENTIAL_COMMIT == 1
+        if (!WriteChangedPages(pCursor, msgSize / 4)) {
+            /* A tag reader wrote in the shared memory meanwhile: nothing can be assumed about its contents. */
+            memcpy((void *)NSS_NFC->BUF, pCursor, (uint32_t)msgSize);
+        }
+#else
+        memcpy((void *)NSS_NFC->BUF, pCursor, (uint32_t)msgSize);
+#endif
+    }
 
 #ifdef NDEFT2T_MSG_READ_CB
     if (sAutomaticMode) {
@@ -536,6 +606,10 @@ bool NDEFT2T_CommitMessage(void *pInstance)
                 | (NDEFT2T_NDEF_3BYTE_LEN_START << 8)
                 | TLV_NDEF);
     }
+    else if (pInst->direct) {
+        /* Two NULL TLVs fill up the space reserved for the 3-byte length field. */
+        ndefHdr = (int)((lenTlv << 24) | (TLV_NDEF << 16) | (TLV_NULL << 8) | TLV_NULL);
+    }
     else {
         ndefHdr = *((int*)(NFC_SHARED_MEM_START + 8)); /* Retrieve the NDEF message header. */
         ndefHdr &= (int)0xFFFF00FF; /* Clear length field, which is at at byte position 1. This might or might not be '0'
@@ -823,6 +897,7 @@ static bool CreateRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T *pR
     NDEFT2T_INSTANCE_T *pInst = (NDEFT2T_INSTANCE_T *)pInstance;
     bool shortRecord;
     int msgSize;
+    uint8_t header[NDEFT2T_MAX_RECORD_HEADER_FIXED_LENGTH + 2]; /* Fixed part, type and status byte or URI code. */
     uint8_t *pCursor;
     int typeStringLen;
 
@@ -848,14 +923,14 @@ static bool CreateRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T *pR
     }
     pInst->msgSize = msgSize;
 
-    /* Get current position of message buffer pointer. */
-    pCursor = pInst->pCursor;
+    /* The header is assembled first, then written at the current position of the message buffer pointer. */
+    pCursor = header;
     /* Reset payload length to zero as we are creating a new record. */
     pInst->len = 0;
 
     /* Preserve the latest record header location to be used to finalise the record header in NDEFT2T_CommitRecord()
      * function and also to set the Message begin bit in the last record of the message. */
-    pInst->pLastRecordHdr = pCursor;
+    pInst->pLastRecordHdr = pInst->pCursor;
     pInst->shortRecord = shortRecord;
 
     /* Form record header byte. Message End bit is set in NDEFT2T_CommitMessage function. */
@@ -872,7 +947,11 @@ static bool CreateRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T *pR
         *pCursor++ = 0; /* Preserving the pre-header length which is zero. */
     }
 
-    pCursor += 3 * (!shortRecord); /* payload Length is 4 bytes for normal records. */
+    if (!shortRecord) { /* payload Length is 4 bytes for normal records. */
+        *pCursor++ = 0;
+        *pCursor++ = 0;
+        *pCursor++ = 0;
+    }
 
     /* Assign type and any pre header status byte. */
     if (type == NDEFT2T_RECORD_TYPE_TEXT) {
@@ -884,15 +963,117 @@ static bool CreateRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T *pR
         *pCursor++ = (uint8_t)pRecordInfo->uriCode; /* URI code. */
     }
 
+    Write(pInst, pInst->pCursor, header, (int)(pCursor - header));
+    pInst->pCursor += pCursor - header;
+
     /* Copy the type string. For TEXT records, locale string gets copied here and for URI nothing gets copied. */
-    memcpy(pCursor, pRecordInfo->pString, (uint32_t)typeStringLen);
-    pCursor += typeStringLen; /* Increment message buffer by length of the type string. */
+    Write(pInst, pInst->pCursor, pRecordInfo->pString, typeStringLen);
+    pInst->pCursor += typeStringLen; /* Increment message buffer by length of the type string. */
 
-    /* Preserve current message buffer position. */
-    pInst->pCursor = pCursor;
+    return !pInst->collision;
+}
 
+/**
+ * This function copies bytes to the message being created: to the message buffer, or directly to the shared memory.
+ * A collision with a write by the tag reader is remembered in the instance.
+ * @param pInst : Base address of instance Buffer
+ * @param pDst : Destination pointer located in the message buffer or in the shared memory
+ * @param pSrc : Source pointer
+ * @param size : number of bytes to copy
+ */
+static void Write(NDEFT2T_INSTANCE_T *pInst, uint8_t *pDst, const void *pSrc, int size)
+{
+    if (pInst->direct) {
+        pInst->collision |= !WriteSharedMemory(pDst, pSrc, size);
+    }
+    else {
+        memcpy(pDst, pSrc, (uint32_t)size);
+    }
+}
+
+/**
+ * This function copies bytes to the shared memory, which only supports word writes. The bytes sharing a word with the
+ * copied bytes are read first and written back unchanged.
+ * @param pDst : Destination pointer located in the shared memory. May be unaligned.
+ * @param pSrc : Source pointer. May be unaligned.
+ * @param size : number of bytes to copy
+ * @return @c false if the tag reader wrote in the shared memory at the same time, @c true otherwise.
+ */
+static bool WriteSharedMemory(uint8_t *pDst, const uint8_t *pSrc, int size)
+{
+    uint32_t chunk[NDEFT2T_DIRECT_CHUNK_WORDS];
+    bool success = true;
+
+    while (size > 0) {
+        uint32_t *pWord = (uint32_t *)((uintptr_t)pDst & ~(uintptr_t)0x3);
+        int offset = (int)((uintptr_t)pDst & 0x3);
+        int n = (int)sizeof(chunk) - offset;
+        if (n > size) {
+            n = size;
+        }
+        int words = IDIVUP(offset + n, 4);
+
+        /* Keep the bytes before and after the copied ones in the first and last word. */
+        chunk[0] = pWord[0];
+        chunk[words - 1] = pWord[words - 1];
+        memcpy((uint8_t *)chunk + offset, pSrc, (uint32_t)n);
+        success &= Chip_NFC_WordWrite(NSS_NFC, pWord, chunk, words);
+
+        pDst += n;
+        pSrc += n;
+        size -= n;
+    }
+    return success;
+}
+
+#if NDEFT2T_DIFFERENTIAL_COMMIT == 1
+/**
+ * This function copies a message to the shared memory, only writing the pages - words - that differ. Before the first
+ * changed page is written, the length of the NDEF message TLV is cleared to hide the message from a tag reader. The
+ * final NDEF message TLV is to be written afterwards by the caller.
+ * @param pMsg : The complete message, including the lock and proprietary TLVs.
+ * @param words : Size of the message in words
+ * @return @c false if the tag reader wrote in the shared memory at the same time, @c true otherwise.
+ */
+static bool WriteChangedPages(const uint32_t *pMsg, int words)
+{
+    uint32_t *pBuf = (uint32_t *)NSS_NFC->BUF;
+    const int hdrPage = NDEFT2T_NDEF_TLV_START_OFFSET / 4;
+    uint32_t hdr = pMsg[hdrPage] & 0xFFFF00FF; /* Clear length field, which is at byte position 1. */
+    bool hidden = false;
+    int page = 0;
+    int end;
+
+    while (page < words) {
+        /* The NDEF message TLV is left out: its length is set separately. */
+        end = page;
+        while ((end < words) && (end != hdrPage) && (pBuf[end] != pMsg[end])) {
+            end++;
+        }
+        if (end == page) {
+            page++;
+        }
+        else {
+            if (!hidden) {
+                hidden = true;
+                if (!Chip_NFC_WordWrite(NSS_NFC, pBuf + hdrPage, &hdr, 1)) {
+                    return false;
+                }
+            }
+            if (!Chip_NFC_WordWrite(NSS_NFC, pBuf + page, pMsg + page, end - page)) {
+                return false;
+            }
+            page = end;
+        }
+    }
+
+    /* The caller fills in the length, but relies on the remainder of the NDEF message TLV page to be up to date. */
+    if (!hidden && ((pBuf[hdrPage] & 0xFFFF00FF) != hdr)) {
+        return Chip_NFC_WordWrite(NSS_NFC, pBuf + hdrPage, &hdr, 1);
+    }
     return true;
 }
+#endif
 
 /**
  * This function decodes the NDEF TLV Header to find the length (L) of the NDEF Message and to locate the start
@@ -972,17 +1153,32 @@ static bool ValidateNdefMsg(void *pInstance)
 
 #if NDEFT2T_EEPROM_COPY_SUPPPORT == 1
 /**
- * This function does the copying of payload stored in EEPROM data area to the message buffer.
- * @param pDst : Destination pointer located in the message buffer
+ * This function does the copying of payload stored in EEPROM data area to the message buffer, or directly to the
+ * shared memory.
+ * @param pInst : Base address of instance Buffer
+ * @param pDst : Destination pointer located in the message buffer or in the shared memory
  * @param pSrc : Source pointer located in EEPROM
  * @param size : payload length
  */
-static void CopyFromEeprom(uint8_t *pDst, const void * pSrc, int size)
+static void CopyFromEeprom(NDEFT2T_INSTANCE_T *pInst, uint8_t *pDst, const void * pSrc, int size)
 {
     int offset;
     offset = ((int)pSrc - EEPROM_START);
-    Chip_EEPROM_Read(NSS_EEPROM, offset, pDst, size);
-
+    if (pInst->direct) {
+        /* The shared memory only supports word writes: copy via a small intermediate buffer. */
+        uint8_t chunk[NDEFT2T_DIRECT_CHUNK_WORDS * 4];
+        while (size > 0) {
+            int n = (size < (int)sizeof(chunk)) ? size : (int)sizeof(chunk);
+            Chip_EEPROM_Read(NSS_EEPROM, offset, chunk, n);
+            Write(pInst, pDst, chunk, n);
+            offset += n;
+            pDst += n;
+            size -= n;
+        }
+    }
+    else {
+        Chip_EEPROM_Read(NSS_EEPROM, offset, pDst, size);
+    }
 }
 #endif
 
@@ -50,6 +50,8 @@
  *     caller is not sure of the size of the NDEF message being created or parsed. The caller must also ensure that
  *     the memory allocated for this buffer starts on a 32-bit aligned address in RAM and has a size that is a
  *     multiple of 4.
+ *     No message buffer is needed when the message is created directly in the shared memory, see
+ *     #NDEFT2T_CreateMessageDirect.
  *  - Record information structure: The exchange of type information (main type and extended properties) for the
  *     record being created or parsed is achieved through the data structures #NDEFT2T_CREATE_RECORD_INFO_T and
  *     #NDEFT2T_PARSE_RECORD_INFO_T respectively. In the case of message creation, the caller must allocate and
@@ -83,6 +85,17 @@
  *  - Step3: Call function #NDEFT2T_CommitMessage to finalize the NDEF message. The user cannot add any more
  *      records after this. The finalised message is copied to the shared memory at this stage.
  *
+ * @par Direct NDEF Message creation:
+ *  Calling #NDEFT2T_CreateMessageDirect instead of #NDEFT2T_CreateMessage in Step1 above creates the message directly
+ *  in the NFC shared memory. This saves a message buffer of up to #NFC_SHARED_MEM_BYTE_SIZE bytes, and the copy of the
+ *  complete message at the end. The NDEF message in the shared memory is emptied at the start, so a tag reader never
+ *  reads the previous message while the new one is being created. The length of the new message is written last, by
+ *  #NDEFT2T_CommitMessage: only then a tag reader can read it.
+ *  The NDEF message header always reserves space for a 3-byte length field, so that the records start word aligned and
+ *  never need to be moved. A short message is preceded by 2 NULL TLVs instead.
+ *  When a tag reader writes in the NFC shared memory while the message is being created, the remaining functions fail
+ *  and the message is left empty.
+ *
  * @par NDEF Message Parsing:
  *  The below steps outline the NDEF message parsing:
  *  - Step1: Call function #NDEFT2T_GetMessage to copy the NDEF message from shared memory into the message buffer.
@@ -154,7 +167,11 @@
  */
 
 /** Size of Instance buffer required by the NDEFT2T module for internal housekeeping. */
-#define NDEFT2T_INSTANCE_SIZE 24
+#if defined(NSS_SIM)
+    #define NDEFT2T_INSTANCE_SIZE 40 /* Pointers are 8 bytes wide on the 64-bit simulation host. */
+#else
+    #define NDEFT2T_INSTANCE_SIZE 28
+#endif
 
 /**
  * Calculates the overhead in bytes required for a TEXT record header.
@@ -366,6 +383,19 @@ void NDEFT2T_DisableMessageReadDetection(void);
  */
 void NDEFT2T_CreateMessage(void *pInstance, uint8_t *pBuffer, int bufLen, bool shortMessage);
 
+/**
+ * This function starts the process of creating an NDEF message directly in the NFC shared memory, and prepares for
+ * addition of one or more records into the message. A call to this function makes a new instantiation of the NDEFT2T
+ * module for message creation. Refer to section "Direct NDEF Message creation" for more details.
+ * @param pInstance : Base address of instance Buffer. The instance buffer preserves the necessary housekeeping
+ *                    information during an instantiation of the NDEFT2T module. The caller must ensure that the
+ *                    argument pInstance points to a buffer of size #NDEFT2T_INSTANCE_SIZE bytes.
+ * @note The NFC shared memory is changed: the NDEF message it holds is emptied. All further record creation functions
+ *  write directly in the NFC shared memory as well.
+ * @note #NDEFT2T_GetRecordPayload returns an address in the NFC shared memory.
+ */
+void NDEFT2T_CreateMessageDirect(void *pInstance);
+
 /**
  * This function creates a TEXT type record. The function will reserve space for the record header, fill known values
  * to the record header and initialize related instance variables. The function has to be called after calling
@@ -381,8 +411,9 @@ void NDEFT2T_CreateMessage(void *pInstance, uint8_t *pBuffer, int bufLen, bool s
  *         scenarios.
  *          -# Size of the NDEF message being created exceeds the size of message buffer allocated by caller
  *          -# Size of the NDEF message being created exceeds the size of the shared memory
+ *          -# A tag reader wrote in the shared memory during a direct message creation
  * @note The NFC shared memory is not changed. Only the internal buffer as given in the call to #NDEFT2T_CreateMessage
- *  is written to.
+ *  is written to - or the NFC shared memory after a call to #NDEFT2T_CreateMessageDirect.
  */
 bool NDEFT2T_CreateTextRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T *pRecordInfo);
 
@@ -401,8 +432,9 @@ bool NDEFT2T_CreateTextRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_
  *         The function returns false under the below scenarios.
  *          -# Size of the NDEF message being created exceeds the size of message buffer allocated by caller
  *          -# Size of the NDEF message being created exceeds the size of the shared memory
+ *          -# A tag reader wrote in the shared memory during a direct message creation
  * @note The NFC shared memory is not changed. Only the internal buffer as given in the call to #NDEFT2T_CreateMessage
- *  is written to.
+ *  is written to - or the NFC shared memory after a call to #NDEFT2T_CreateMessageDirect.
  */
 bool NDEFT2T_CreateExtRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T *pRecordInfo);
 
@@ -421,8 +453,9 @@ bool NDEFT2T_CreateExtRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T
  *         The function returns false under the below scenarios.
  *          -# Size of the NDEF message being created exceeds the size of message buffer allocated by caller
  *          -# Size of the NDEF message being created exceeds the size of the shared memory
+ *          -# A tag reader wrote in the shared memory during a direct message creation
  * @note The NFC shared memory is not changed. Only the internal buffer as given in the call to #NDEFT2T_CreateMessage
- *  is written to.
+ *  is written to - or the NFC shared memory after a call to #NDEFT2T_CreateMessageDirect.
  */
 bool NDEFT2T_CreateMimeRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T *pRecordInfo);
 
@@ -442,8 +475,9 @@ bool NDEFT2T_CreateMimeRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_
  *          -# Size of the NDEF message being created exceeds the size of message buffer allocated by caller
  *          -# Size of the NDEF message being created exceeds the size of the shared memory
  *          -# The NDEFT2T_CREATE_RECORD_INFO_T data structure field uriCode is not valid
+ *          -# A tag reader wrote in the shared memory during a direct message creation
  * @note The NFC shared memory is not changed. Only the internal buffer as given in the call to #NDEFT2T_CreateMessage
- *  is written to.
+ *  is written to - or the NFC shared memory after a call to #NDEFT2T_CreateMessageDirect.
  */
 bool NDEFT2T_CreateUriRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T *pRecordInfo);
 
@@ -461,8 +495,9 @@ bool NDEFT2T_CreateUriRecord(void *pInstance, const NDEFT2T_CREATE_RECORD_INFO_T
  *          -# Size of the NDEF message being created exceeds the size of the shared memory
  *          -# The NDEFT2T_CREATE_RECORD_INFO_T data structure field shortRecord is set and payload data size exceeds
  *             255 bytes.
+ *          -# A tag reader wrote in the shared memory during a direct message creation
  * @note The NFC shared memory is not changed. Only the internal buffer as given in the call to #NDEFT2T_CreateMessage
- *  is written to.
+ *  is written to - or the NFC shared memory after a call to #NDEFT2T_CreateMessageDirect.
  * @note When #NDEFT2T_EEPROM_COPY_SUPPPORT is set to '1', pData can be located in EEPROM read/write region. In that
  *  case, @b address must be given, @b not the offset. For example, provide #EEPROM_START to copy the data from the
  *  start of the EEPROM memory. The function will then internally take care of the copying from EEPROM to the message
@@ -475,7 +510,7 @@ bool NDEFT2T_WriteRecordPayload(void *pInstance, const void * pData, int size);
  * This function finalizes the record header and has to be called after the caller has copied the payload.
  * @param pInstance : Base address of instance Buffer
  * @note The NFC shared memory is not changed. Only the internal buffer as given in the call to #NDEFT2T_CreateMessage
- *  is written to.
+ *  is written to - or the NFC shared memory after a call to #NDEFT2T_CreateMessageDirect.
  */
 void NDEFT2T_CommitRecord(void *pInstance);
 
@@ -483,9 +518,11 @@ void NDEFT2T_CommitRecord(void *pInstance);
  * This function finalizes the NDEF message header. The function has to be called at the end of an NDEF message
  * creation after creating all records.
  * @param pInstance : Base address of instance Buffer
- * @return @c true
+ * @return @c false when a tag reader wrote in the shared memory during a direct message creation: the NDEF message in
+ *  the shared memory is then left empty. @c true otherwise.
  * @note The NFC shared memory is updated by copying the contents from the internal buffer (as given in the call to
- *  #NDEFT2T_CreateMessage).
+ *  #NDEFT2T_CreateMessage). After a call to #NDEFT2T_CreateMessageDirect, only the message header is written.
+ * @note In both cases, the length of the NDEF message is written last.
  */
 bool NDEFT2T_CommitMessage(void *pInstance);
 
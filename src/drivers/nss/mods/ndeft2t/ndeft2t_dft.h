@@ -24,6 +24,7 @@
  *  - Miscellaneous flags
  *      - #NDEFT2T_EEPROM_COPY_SUPPPORT
  *      - #NDEFT2T_MESSAGE_HEADER_LENGTH_CORRECTION
+ *      - #NDEFT2T_DIFFERENTIAL_COMMIT
  * @{
  */
 #ifndef __NDEFT2T_DFT_H_
@@ -45,6 +46,20 @@
     #define NDEFT2T_MESSAGE_HEADER_LENGTH_CORRECTION 1
 #endif
 
+/**
+ * Set this flag to '1' to let #NDEFT2T_CommitMessage only write the pages - 4 bytes - of the NFC shared memory that
+ * differ from the new message, and '0' to always copy the complete message.
+ * This helps when the same message is refreshed often with only a few changed values, e.g. a status message with a
+ * sensor reading, while a tag reader is present: less writes mean less chance of a collision with the tag reader.
+ * The message is hidden - by temporarily writing a zero length - before the first changed page is written, so a tag
+ * reader never reads a mix of old and new pages. When a tag reader writes in the shared memory meanwhile, the complete
+ * message is copied instead.
+ * @note Not applicable for messages created using #NDEFT2T_CreateMessageDirect, which are always written directly.
+ */
+#if !defined(NDEFT2T_DIFFERENTIAL_COMMIT)
+    #define NDEFT2T_DIFFERENTIAL_COMMIT 0
+#endif
+
 /* Diversity flags below are undefined by default. They are wrapped in a DOXYGEN precompilation flag to enable
  * documenting them properly. To define them and use the corresponding functionality of the module, make the correct
  * defines in app_sel.h or board_sel.h.
@@ -0,0 +1,67 @@
+#include "profile.h"
+
+/* ------------------------------------------------------------------------- */
+
+#if PROFILE_ENABLED
+static PROFILE_SCOPE_T sScopes[PROFILE_SCOPE_COUNT];
+#endif
+
+/* ------------------------------------------------------------------------- */
+
+void Profile_Init(void)
+{
+    Chip_TIMER_Init(NSS_TIMER32_0, CLOCK_PERIPHERAL_32TIMER0);
+    Chip_TIMER_PrescaleSet(NSS_TIMER32_0, 0);
+    Chip_TIMER_Reset(NSS_TIMER32_0);
+    Chip_TIMER_Enable(NSS_TIMER32_0);
+    Profile_Reset();
+}
+
+void Profile_Reset(void)
+{
+#if PROFILE_ENABLED
+    for (int id = 0; id < PROFILE_SCOPE_COUNT; id++) {
+        sScopes[id] = (PROFILE_SCOPE_T){.min = 0xFFFFFFFF};
+    }
+#endif
+}
+
+void Profile_Record(int id, uint32_t cycles)
+{
+#if PROFILE_ENABLED
+    ASSERT((id >= 0) && (id < PROFILE_SCOPE_COUNT));
+    PROFILE_SCOPE_T * pScope = &sScopes[id];
+    int bin = (cycles == 0) ? 0 : 32 - __builtin_clz(cycles);
+
+    pScope->count++;
+    pScope->total += cycles;
+    if (cycles < pScope->min) {
+        pScope->min = cycles;
+    }
+    if (cycles > pScope->max) {
+        pScope->max = cycles;
+    }
+    if (bin >= PROFILE_HISTOGRAM_BINS) {
+        bin = PROFILE_HISTOGRAM_BINS - 1;
+    }
+    if (pScope->histogram[bin] < 0xFFFF) {
+        pScope->histogram[bin]++;
+    }
+#else
+    (void)id;
+    (void)cycles;
+#endif
+}
+
+const PROFILE_SCOPE_T * Profile_GetScope(int id)
+{
+    const PROFILE_SCOPE_T * pScope = NULL;
+#if PROFILE_ENABLED
+    if ((id >= 0) && (id < PROFILE_SCOPE_COUNT)) {
+        pScope = &sScopes[id];
+    }
+#else
+    (void)id;
+#endif
+    return pScope;
+}
@@ -0,0 +1,130 @@
+#ifndef __PROFILE_H_
+#define __PROFILE_H_
+
+/** @defgroup MODS_NSS_PROFILE profile: Cycle-level profiling scopes
+ * @ingroup MODS_NSS
+ * The profile module runs CT32B0 as a free-running counter of system clock cycles, and measures the time spent in
+ * marked scopes. Per scope, it keeps the number of calls, the shortest, longest and total duration, and a log2
+ * histogram of the durations.
+ *
+ * @par Diversity
+ *  This module supports diversity, like enabling the scopes and the number of histogram bins.
+ *  Check @ref MODS_NSS_PROFILE_DFT for all diversity parameters.
+ *
+ * @par Scopes
+ *  The mods mark their costly operations themselves: see #PROFILE_ID_T. The application adds its own scopes by setting
+ *  #PROFILE_APP_SCOPE_COUNT and using the ids from #PROFILE_ID_FIRST_APP on. A scope is not re-entrant, and must not
+ *  be used under interrupt: the table is updated without locking.
+ *
+ * @par Reading out
+ *  - #Profile_GetScope gives access to the table, e.g. to send it over RTT.
+ *  - With #MSG_ENABLE_GETPROFILE, a tag reader fetches a scope with #MSG_ID_GETPROFILE.
+ *
+ * @par Example: measure a function of the application
+ *  @code
+ *      // in app_sel.h
+ *      #define PROFILE_ENABLED 1
+ *      #define PROFILE_APP_SCOPE_COUNT 1
+ *
+ *      // in the application
+ *      #define APP_PROFILE_ID_FILTER PROFILE_ID_FIRST_APP
+ *      Profile_Init();
+ *      ...
+ *      PROFILE_BEGIN(APP_PROFILE_ID_FILTER);
+ *      Filter(samples, count);
+ *      PROFILE_END(APP_PROFILE_ID_FILTER);
+ *  @endcode
+ *
+ * @{
+ */
+
+/* -------------------------------------------------------------------------
+ * Include files
+ * ------------------------------------------------------------------------- */
+
+#include "chip.h"
+#include "profile_dft.h"
+
+/* -------------------------------------------------------------------------
+ * Types and defines
+ * ------------------------------------------------------------------------- */
+
+/** The scopes marked in the mods and in lib_chip_nss. */
+typedef enum PROFILE_ID {
+    PROFILE_ID_STORAGE_FLUSH, /**< #Storage_DeInit: writing the marker and hint, and flushing the EEPROM */
+    PROFILE_ID_STORAGE_MOVE, /**< Compressing a block of samples from EEPROM and writing it to FLASH */
+    PROFILE_ID_COMPRESS_ENCODE, /**< #Compress_Encode */
+    PROFILE_ID_NDEFT2T_COMMIT, /**< #NDEFT2T_CommitMessage */
+    PROFILE_ID_I2C_TRANSFER, /**< #Chip_I2C_MasterTransfer */
+    PROFILE_ID_FIRST_APP /**< The first id available to the application. */
+} PROFILE_ID_T;
+
+/** The number of scopes in the table. */
+#define PROFILE_SCOPE_COUNT (PROFILE_ID_FIRST_APP + PROFILE_APP_SCOPE_COUNT)
+
+/** The measurements of one scope. All durations are in system clock cycles. */
+typedef struct PROFILE_SCOPE_S {
+    uint32_t count; /**< The number of completed calls. */
+    uint32_t min; /**< The shortest duration. @c 0xFFFFFFFF when @c count is 0. */
+    uint32_t max; /**< The longest duration. */
+    uint64_t total; /**< The sum of all durations. */
+    uint16_t histogram[PROFILE_HISTOGRAM_BINS]; /**< Calls per log2 duration bin, saturating at @c 0xFFFF. */
+} PROFILE_SCOPE_T;
+
+#if PROFILE_ENABLED
+/**
+ * Marks the start of a scope: to be followed by #PROFILE_END in the same block.
+ * @param id : A single identifier of type #PROFILE_ID_T, or a define expanding to one.
+ */
+#define PROFILE_BEGIN(id) uint32_t profileStart_##id = Profile_GetCycles()
+
+/**
+ * Marks the end of a scope started with #PROFILE_BEGIN, and records its duration. Place it before each return.
+ * @param id : The id given to #PROFILE_BEGIN.
+ */
+#define PROFILE_END(id) Profile_Record((id), Profile_GetCycles() - profileStart_##id)
+#else
+#define PROFILE_BEGIN(id)
+#define PROFILE_END(id)
+#endif
+
+/* -------------------------------------------------------------------------
+ * Exported function prototypes
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Starts CT32B0 counting system clock cycles from 0, and clears the table.
+ * @post The timer wraps after 2^32 cycles: 71 minutes at 1 MHz. Durations up to that long are measured correctly.
+ * @note CT32B0 is no longer available to the application.
+ */
+void Profile_Init(void);
+
+/**
+ * Clears the measurements of all scopes.
+ */
+void Profile_Reset(void);
+
+/**
+ * Adds one duration to a scope. Normally called through #PROFILE_END.
+ * @param id : The scope, below #PROFILE_SCOPE_COUNT.
+ * @param cycles : The duration in system clock cycles.
+ * @note Does nothing unless #PROFILE_ENABLED is set.
+ */
+void Profile_Record(int id, uint32_t cycles);
+
+/**
+ * Gives access to the measurements of one scope.
+ * @param id : The scope.
+ * @return The measurements, or @c NULL when @c id is out of range or when #PROFILE_ENABLED is not set.
+ */
+const PROFILE_SCOPE_T * Profile_GetScope(int id);
+
+/**
+ * @return The number of system clock cycles since #Profile_Init, modulo 2^32.
+ */
+static inline uint32_t Profile_GetCycles(void)
+{
+    return Chip_TIMER_ReadCount(NSS_TIMER32_0);
+}
+
+#endif /** @} */
@@ -0,0 +1,38 @@
+/** @defgroup MODS_NSS_PROFILE_DFT Diversity Settings
+ *  @ingroup MODS_NSS_PROFILE
+ * These 'defines' capture the diversity settings of the module. The displayed values refer to the default settings.
+ * To override the default settings, place the defines with their desired values in the application app_sel.h header
+ * file: the compiler will pick up your defines before parsing this file.
+ * @{
+ */
+#ifndef __PROFILE_DFT_H_
+#define __PROFILE_DFT_H_
+
+/**
+ * Set this define to 1 to compile the profiling scopes in. When 0, #PROFILE_BEGIN and #PROFILE_END expand to nothing
+ * and no table is allocated; #Profile_Init and #Profile_GetCycles remain available.
+ */
+#if !defined(PROFILE_ENABLED)
+    #define PROFILE_ENABLED 0
+#endif
+
+/**
+ * The number of scopes the application adds, with ids starting at #PROFILE_ID_FIRST_APP.
+ */
+#if !defined(PROFILE_APP_SCOPE_COUNT)
+    #define PROFILE_APP_SCOPE_COUNT 0
+#endif
+
+/**
+ * The number of bins of the log2 histogram of each scope. Bin 0 counts the durations of 0 cycles, bin @c n the
+ * durations in the range [2^(n-1), 2^n[. The last bin also counts all longer durations.
+ * Each bin costs 2 bytes of RAM per scope. With the default, the last bin starts at 2^18 cycles: 262 ms at 1 MHz.
+ */
+#if !defined(PROFILE_HISTOGRAM_BINS)
+    #define PROFILE_HISTOGRAM_BINS 20
+#endif
+#if (PROFILE_HISTOGRAM_BINS < 1) || (PROFILE_HISTOGRAM_BINS > 33)
+    #error PROFILE_HISTOGRAM_BINS must be in the range [1, 33]
+#endif
+
+#endif /** @} */
@@ -0,0 +1,102 @@
+#include <string.h>
+#include "ringbuf.h"
+
+/* -------------------------------------------------------------------------
+ * Private function prototypes
+ * ------------------------------------------------------------------------- */
+
+static void Copy(RINGBUF_T * pRing, uint32_t index, uint8_t * pElements, int count, bool toRing);
+
+/* -------------------------------------------------------------------------
+ * Private functions
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Copies @c count elements between @c pElements and the slots starting at counter value @c index, in at most two parts
+ * when the slots wrap around.
+ */
+static void Copy(RINGBUF_T * pRing, uint32_t index, uint8_t * pElements, int count, bool toRing)
+{
+    uint32_t slot = index & pRing->mask;
+    uint32_t first = (uint32_t)pRing->mask + 1 - slot;
+
+    if (first > (uint32_t)count) {
+        first = (uint32_t)count;
+    }
+    for (int part = 0; part < 2; part++) {
+        uint8_t * pSlot = pRing->pData + slot * pRing->elementSize;
+        size_t size = first * pRing->elementSize;
+        if (toRing) {
+            memcpy(pSlot, pElements, size);
+        }
+        else {
+            memcpy(pElements, pSlot, size);
+        }
+        pElements += size;
+        slot = 0;
+        first = (uint32_t)count - first;
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Exported functions
+ * ------------------------------------------------------------------------- */
+
+void RingBuf_Init(RINGBUF_T * pRing, void * pData, int elementSize, int capacity)
+{
+    ASSERT((pRing != NULL) && (pData != NULL));
+    ASSERT((elementSize >= 1) && (elementSize <= 0xFFFF));
+    ASSERT((capacity >= 1) && (capacity <= 0x8000) && ((capacity & (capacity - 1)) == 0));
+    pRing->pData = pData;
+    pRing->elementSize = (uint16_t)elementSize;
+    pRing->mask = (uint16_t)(capacity - 1);
+    pRing->head = 0;
+    pRing->tail = 0;
+    pRing->dropped = 0;
+}
+
+int RingBuf_Push(RINGBUF_T * pRing, const void * pElements, int count)
+{
+    uint32_t head = pRing->head;
+    int free = (int)((uint32_t)pRing->mask + 1 - (head - pRing->tail));
+
+    ASSERT((pElements != NULL) && (count > 0));
+    if (count > free) {
+        pRing->dropped += (uint32_t)(count - free);
+        count = free;
+    }
+    if (count > 0) {
+        Copy(pRing, head, (uint8_t *)pElements, count, true);
+        __DMB(); /* The elements are in place before the consumer can see them. */
+        pRing->head = head + (uint32_t)count;
+    }
+    return count;
+}
+
+int RingBuf_Pop(RINGBUF_T * pRing, void * pElements, int count)
+{
+    uint32_t tail = pRing->tail;
+    int available = (int)(pRing->head - tail);
+
+    ASSERT((pElements != NULL) && (count > 0));
+    __DMB(); /* The elements are read after the head that announced them. */
+    if (count > available) {
+        count = available;
+    }
+    if (count > 0) {
+        Copy(pRing, tail, pElements, count, false);
+        __DMB(); /* The elements are read before the producer can overwrite them. */
+        pRing->tail = tail + (uint32_t)count;
+    }
+    return count;
+}
+
+int RingBuf_GetCount(const RINGBUF_T * pRing)
+{
+    return (int)(pRing->head - pRing->tail);
+}
+
+int RingBuf_GetDropped(const RINGBUF_T * pRing)
+{
+    return (int)pRing->dropped;
+}
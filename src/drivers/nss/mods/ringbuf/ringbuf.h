@@ -0,0 +1,114 @@
+#ifndef __RINGBUF_H_
+#define __RINGBUF_H_
+
+/** @defgroup MODS_NSS_RINGBUF ringbuf: Lock-free single-producer single-consumer ring buffer
+ * @ingroup MODS_NSS
+ * The ring buffer module hands data over from one interrupt handler to the main loop, or the other way round, without
+ * disabling interrupts on either side. Each element is copied in and out: bursts are kept, up to the capacity of the
+ * ring, instead of being coalesced into a single flag.
+ *
+ * @par Lock-free on Cortex-M0+
+ *  The Cortex-M0+ has no exclusive load and store instructions. Instead, each index has a single owner: only the
+ *  producer writes @c head, only the consumer writes @c tail, and both are free-running 32-bit counters which are
+ *  loaded and stored atomically. A data memory barrier orders the copying of the elements with the update of the
+ *  index, so the other side never sees a slot before its data is complete, nor reuses a slot that is still being read.
+ *  This only holds with exactly one producer and one consumer per ring: use one ring per interrupt source.
+ *
+ * @par Capacity
+ *  The capacity is a power of two, so a slot is found by masking the counter. All @c capacity slots are usable.
+ *  The memory for the elements is provided by the caller.
+ *
+ * @par Example: hand button presses over to the main loop
+ *  @code
+ *      static uint32_t sPressData[8];
+ *      static RINGBUF_T sPresses;
+ *
+ *      void PIO0_IRQHandler(void) // producer
+ *      {
+ *          uint32_t pins = Chip_GPIO_GetMaskedInts(NSS_GPIO, 0);
+ *          Chip_GPIO_ClearInts(NSS_GPIO, 0, pins);
+ *          RingBuf_Push(&sPresses, &pins, 1);
+ *      }
+ *
+ *      RingBuf_Init(&sPresses, sPressData, sizeof(sPressData[0]), 8);
+ *      for (;;) { // consumer
+ *          uint32_t presses[8];
+ *          int count = RingBuf_Pop(&sPresses, presses, 8);
+ *          ...
+ *      }
+ *  @endcode
+ *
+ * @{
+ */
+
+/* -------------------------------------------------------------------------
+ * Include files
+ * ------------------------------------------------------------------------- */
+
+#include "chip.h"
+
+/* -------------------------------------------------------------------------
+ * Types and defines
+ * ------------------------------------------------------------------------- */
+
+/**
+ * A ring buffer. The fields are to be accessed via the functions of this module only.
+ * Each ring costs 20 bytes of RAM, plus the memory for the elements.
+ */
+typedef struct RINGBUF_S {
+    uint8_t * pData; /**< @c capacity elements of @c elementSize bytes each */
+    uint16_t elementSize;
+    uint16_t mask; /**< @c capacity - 1 */
+    volatile uint32_t head; /**< Number of elements pushed. Written by the producer only. */
+    volatile uint32_t tail; /**< Number of elements popped. Written by the consumer only. */
+    uint32_t dropped; /**< Number of elements that did not fit. Written by the producer only. */
+} RINGBUF_T;
+
+/* -------------------------------------------------------------------------
+ * Exported function prototypes
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Initializes a ring buffer: it is empty afterwards.
+ * @param pRing : May not be @c NULL. The ring buffer to initialize.
+ * @param pData : May not be @c NULL. Memory for @c capacity elements, to be used by the ring buffer only.
+ * @param elementSize : Must be in the range [1, 0xFFFF]. The size of one element, in bytes.
+ * @param capacity : Must be a power of two in the range [1, 0x8000]. The number of elements the ring can hold.
+ * @note Neither the producer nor the consumer may access the ring during the call.
+ */
+void RingBuf_Init(RINGBUF_T * pRing, void * pData, int elementSize, int capacity);
+
+/**
+ * Copies elements into the ring. Elements that do not fit are dropped and counted.
+ * @param pRing : May not be @c NULL.
+ * @param pElements : May not be @c NULL. The elements to push, in order.
+ * @param count : Must be positive. The number of elements at @c pElements.
+ * @return The number of elements pushed: the first elements at @c pElements.
+ * @note To be called by the producer only.
+ */
+int RingBuf_Push(RINGBUF_T * pRing, const void * pElements, int count);
+
+/**
+ * Copies the oldest elements out of the ring, and frees their slots.
+ * @param pRing : May not be @c NULL.
+ * @param pElements : May not be @c NULL. Room for @c count elements.
+ * @param count : Must be positive. The maximum number of elements to pop.
+ * @return The number of elements popped, oldest first, @c 0 when the ring is empty.
+ * @note To be called by the consumer only.
+ */
+int RingBuf_Pop(RINGBUF_T * pRing, void * pElements, int count);
+
+/**
+ * @param pRing : May not be @c NULL.
+ * @return The number of elements in the ring. Seen by the producer, the actual number can only be lower, seen by the
+ *  consumer, it can only be higher.
+ */
+int RingBuf_GetCount(const RINGBUF_T * pRing);
+
+/**
+ * @param pRing : May not be @c NULL.
+ * @return The number of elements dropped by #RingBuf_Push since #RingBuf_Init.
+ */
+int RingBuf_GetDropped(const RINGBUF_T * pRing);
+
+#endif /** @} */
@@ -0,0 +1,263 @@
+#include "runloop.h"
+
+/* -------------------------------------------------------------------------
+ * Private types and defines
+ * ------------------------------------------------------------------------- */
+
+/** The timer providing the time base and the wake-up from Sleep mode. */
+#define RUNLOOP_TIMER NSS_TIMER16_0
+
+/** The match register of #RUNLOOP_TIMER used to wake up from Sleep mode. */
+#define RUNLOOP_MATCH 0
+
+/** Longest single sleep, in ms. It must stay below the wrap-around time of the 16-bit timer. */
+#define RUNLOOP_MAX_SLEEP_MS 60000
+
+/** Number of ms per RTC tick. */
+#define RUNLOOP_MS_PER_RTC_TICK 1000
+
+/** A registered job. */
+typedef struct RUNLOOP_JOB_S {
+    pRunLoop_Job_t job; /**< @c NULL when the slot is free */
+    void * pArg; /**< Argument for @c job */
+    uint32_t due; /**< The next deadline, in ms since #RunLoop_Init */
+    uint32_t period; /**< The period in ms, or @c 0 for a one-shot job */
+} RUNLOOP_JOB_T;
+
+/* -------------------------------------------------------------------------
+ * Private function prototypes
+ * ------------------------------------------------------------------------- */
+
+static uint32_t UpdateTime(void);
+static int AddJob(pRunLoop_Job_t job, void * pArg, uint32_t delay, uint32_t period);
+static bool RunDueJobs(uint32_t now);
+static void Sleep(uint32_t now);
+
+/* -------------------------------------------------------------------------
+ * Private variables
+ * ------------------------------------------------------------------------- */
+
+static RUNLOOP_JOB_T sJobs[RUNLOOP_JOB_COUNT];
+static uint32_t sTime; /**< Time in ms since #RunLoop_Init, at the timer count #sCount */
+static uint16_t sCount; /**< Timer count at the previous call to #UpdateTime */
+static volatile bool sWakeRequested;
+
+/* -------------------------------------------------------------------------
+ * Private functions
+ * ------------------------------------------------------------------------- */
+
+/** Adds the ticks counted since the previous call to #sTime. @return The updated #sTime */
+static uint32_t UpdateTime(void)
+{
+    uint16_t count = (uint16_t)Chip_TIMER_ReadCount(RUNLOOP_TIMER);
+
+    sTime += (uint16_t)(count - sCount);
+    sCount = count;
+    return sTime;
+}
+
+/** @return The index of the free slot that now holds the job, or @c -1 */
+static int AddJob(pRunLoop_Job_t job, void * pArg, uint32_t delay, uint32_t period)
+{
+    ASSERT(job != NULL);
+    for (int handle = 0; handle < RUNLOOP_JOB_COUNT; handle++) {
+        RUNLOOP_JOB_T * pJob = &sJobs[handle];
+        if (pJob->job == NULL) {
+            pJob->pArg = pArg;
+            pJob->due = UpdateTime() + delay;
+            pJob->period = period;
+            pJob->job = job;
+            return handle;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Runs each job whose deadline has passed once. The deadline of a periodic job is moved before it is run, a one-shot
+ * job is removed before it is run: the job may then add or cancel jobs freely.
+ * @return Whether a job was run.
+ */
+static bool RunDueJobs(uint32_t now)
+{
+    bool ran = false;
+
+    for (int handle = 0; handle < RUNLOOP_JOB_COUNT; handle++) {
+        RUNLOOP_JOB_T * pJob = &sJobs[handle];
+        pRunLoop_Job_t job = pJob->job;
+        if ((job != NULL) && ((int32_t)(pJob->due - now) <= 0)) {
+            if (pJob->period > 0) {
+                pJob->due += pJob->period;
+                if ((int32_t)(pJob->due - now) <= 0) {
+                    pJob->due = now + pJob->period; /* Skip the missed runs. */
+                }
+            }
+            else {
+                pJob->job = NULL;
+            }
+            job(pJob->pArg);
+            ran = true;
+        }
+    }
+    return ran;
+}
+
+/**
+ * Sleeps in the deepest power mode that still meets the next deadline, until that deadline or until an interrupt
+ * occurs.
+ * @param now : The time as returned by #UpdateTime just before. No deadline may have passed at that time.
+ */
+static void Sleep(uint32_t now)
+{
+    uint32_t wait = RUNLOOP_MAX_SLEEP_MS;
+
+    for (int handle = 0; handle < RUNLOOP_JOB_COUNT; handle++) {
+        if ((sJobs[handle].job != NULL) && (sJobs[handle].due - now < wait)) {
+            wait = sJobs[handle].due - now;
+        }
+    }
+
+    /* Check and sleep atomically: a pending interrupt ends __WFI even while masked. */
+    __disable_irq();
+    if (!sWakeRequested) {
+        bool deep = (wait >= RUNLOOP_MS_PER_RTC_TICK + RUNLOOP_DEEPSLEEP_MARGIN_MS);
+#if defined(RUNLOOP_DEEPSLEEP_CB)
+        if (deep) {
+            extern bool RUNLOOP_DEEPSLEEP_CB(int ms);
+            deep = RUNLOOP_DEEPSLEEP_CB((int)wait);
+        }
+#endif
+        if (deep) {
+            /* The timer keeps counting in Deep Sleep mode, but only the RTC can end it. */
+            Chip_RTC_Wakeup_SetReload(NSS_RTC, (int)(wait - RUNLOOP_DEEPSLEEP_MARGIN_MS) / RUNLOOP_MS_PER_RTC_TICK);
+            Chip_RTC_Wakeup_SetControl(NSS_RTC, (RTC_WAKEUPCTRL_T)(RTC_WAKEUPCTRL_ENABLE | RTC_WAKEUPCTRL_START));
+            Chip_PMU_PowerMode_EnterDeepSleep();
+            Chip_RTC_Wakeup_SetControl(NSS_RTC, RTC_WAKEUPCTRL_DISABLE);
+        }
+        else {
+            Chip_TIMER_SetMatch(RUNLOOP_TIMER, RUNLOOP_MATCH, (uint16_t)(sCount + wait));
+            Chip_TIMER_ClearMatch(RUNLOOP_TIMER, RUNLOOP_MATCH);
+            Chip_TIMER_MatchEnableInt(RUNLOOP_TIMER, RUNLOOP_MATCH);
+            /* The match is only hit when the timer has not passed it yet. */
+            if ((uint16_t)(Chip_TIMER_ReadCount(RUNLOOP_TIMER) - sCount) < wait) {
+                Chip_PMU_PowerMode_EnterSleep();
+            }
+            Chip_TIMER_MatchDisableInt(RUNLOOP_TIMER, RUNLOOP_MATCH);
+        }
+    }
+    sWakeRequested = false;
+    __enable_irq(); /* The interrupt that ended the sleep is handled here. */
+}
+
+/* -------------------------------------------------------------------------
+ * Exported functions
+ * ------------------------------------------------------------------------- */
+
+/** Ends Sleep mode at the next deadline. Overrides the WEAK function in the startup module. */
+void CT16B0_IRQHandler(void)
+{
+    Chip_TIMER_ClearMatch(RUNLOOP_TIMER, RUNLOOP_MATCH);
+}
+
+/** Acknowledges the expiry of the RTC down-counter. Overrides the WEAK function in the startup module. */
+void RTC_IRQHandler(void)
+{
+    Chip_RTC_Int_ClearRawStatus(NSS_RTC, RTC_INT_WAKEUP);
+}
+
+/**
+ * The RTC as start logic source: ends Deep Sleep mode when the RTC down-counter expires.
+ * Overrides the WEAK function in the startup module.
+ */
+void RTCPWREQ_IRQHandler(void)
+{
+    Chip_SysCon_StartLogic_ClearStatus(SYSCON_STARTSOURCE_RTC);
+}
+
+void RunLoop_Init(void)
+{
+    for (int handle = 0; handle < RUNLOOP_JOB_COUNT; handle++) {
+        sJobs[handle].job = NULL;
+    }
+    sTime = 0;
+    sCount = 0;
+    sWakeRequested = false;
+
+    Chip_TIMER_Init(RUNLOOP_TIMER, CLOCK_PERIPHERAL_16TIMER0);
+    Chip_TIMER_PrescaleSet(RUNLOOP_TIMER, (uint32_t)(Chip_Clock_System_GetClockFreq() / 1000 - 1));
+    Chip_TIMER_MatchDisableInt(RUNLOOP_TIMER, RUNLOOP_MATCH);
+    Chip_TIMER_ResetOnMatchDisable(RUNLOOP_TIMER, RUNLOOP_MATCH);
+    Chip_TIMER_StopOnMatchDisable(RUNLOOP_TIMER, RUNLOOP_MATCH);
+    Chip_TIMER_Reset(RUNLOOP_TIMER);
+    Chip_TIMER_ClearMatch(RUNLOOP_TIMER, RUNLOOP_MATCH);
+    Chip_TIMER_Enable(RUNLOOP_TIMER);
+    NVIC_EnableIRQ(CT16B0_IRQn);
+
+    Chip_RTC_Init(NSS_RTC);
+    Chip_RTC_Wakeup_SetControl(NSS_RTC, RTC_WAKEUPCTRL_DISABLE);
+    Chip_RTC_Int_ClearRawStatus(NSS_RTC, RTC_INT_WAKEUP);
+    Chip_RTC_Int_SetEnabledMask(NSS_RTC, RTC_INT_WAKEUP);
+    Chip_SysCon_StartLogic_SetEnabledMask((SYSCON_STARTSOURCE_T)(Chip_SysCon_StartLogic_GetEnabledMask()
+                                                                 | SYSCON_STARTSOURCE_RTC));
+    Chip_SysCon_StartLogic_ClearStatus(SYSCON_STARTSOURCE_RTC);
+    NVIC_EnableIRQ(RTC_IRQn);
+    NVIC_EnableIRQ(RTCPWREQ_IRQn);
+}
+
+void RunLoop_DeInit(void)
+{
+    NVIC_DisableIRQ(RTCPWREQ_IRQn);
+    NVIC_DisableIRQ(RTC_IRQn);
+    Chip_SysCon_StartLogic_SetEnabledMask((SYSCON_STARTSOURCE_T)(Chip_SysCon_StartLogic_GetEnabledMask()
+                                                                 & ~(uint32_t)SYSCON_STARTSOURCE_RTC));
+    Chip_RTC_Int_SetEnabledMask(NSS_RTC, RTC_INT_NONE);
+    Chip_RTC_Wakeup_SetControl(NSS_RTC, RTC_WAKEUPCTRL_DISABLE);
+
+    NVIC_DisableIRQ(CT16B0_IRQn);
+    Chip_TIMER_Disable(RUNLOOP_TIMER);
+    Chip_TIMER_MatchDisableInt(RUNLOOP_TIMER, RUNLOOP_MATCH);
+    Chip_TIMER_DeInit(RUNLOOP_TIMER, CLOCK_PERIPHERAL_16TIMER0);
+
+    for (int handle = 0; handle < RUNLOOP_JOB_COUNT; handle++) {
+        sJobs[handle].job = NULL;
+    }
+}
+
+int RunLoop_AddPeriodicJob(pRunLoop_Job_t job, void * pArg, int periodMs)
+{
+    ASSERT(periodMs > 0);
+    return AddJob(job, pArg, (uint32_t)periodMs, (uint32_t)periodMs);
+}
+
+int RunLoop_AddOneShotJob(pRunLoop_Job_t job, void * pArg, int delayMs)
+{
+    ASSERT(delayMs >= 0);
+    return AddJob(job, pArg, (uint32_t)delayMs, 0);
+}
+
+void RunLoop_CancelJob(int handle)
+{
+    ASSERT((handle >= -1) && (handle < RUNLOOP_JOB_COUNT));
+    if (handle >= 0) {
+        sJobs[handle].job = NULL;
+    }
+}
+
+uint32_t RunLoop_GetTime(void)
+{
+    return UpdateTime();
+}
+
+void RunLoop_Wake(void)
+{
+    sWakeRequested = true;
+}
+
+void RunLoop_Step(void)
+{
+    uint32_t now = UpdateTime();
+
+    if (!RunDueJobs(now)) {
+        Sleep(now);
+    }
+}
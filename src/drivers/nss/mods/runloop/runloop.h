@@ -0,0 +1,146 @@
+#ifndef __RUNLOOP_H_
+#define __RUNLOOP_H_
+
+/** @defgroup MODS_NSS_RUNLOOP runloop: Tickless run loop with timed jobs
+ * @ingroup MODS_NSS
+ * The run loop module executes periodic and one-shot jobs at their deadlines, and lets the core sleep in between.
+ * There is no periodic tick: the core only wakes up for the next deadline, or for an interrupt of the application.
+ *
+ * @par Diversity
+ *  This module supports diversity, like the number of jobs and the use of Deep Sleep mode.
+ *  Check @ref MODS_NSS_RUNLOOP_DFT for all diversity parameters.
+ *
+ * @par Time base
+ *  CT16B0 counts milliseconds: it is prescaled from the system clock that is set when #RunLoop_Init is called. It runs
+ *  freely, also in Deep Sleep mode, and its first match register wakes up the core from Sleep mode. All times are
+ *  given in ms and are exact to the tick.
+ *
+ * @par Power modes
+ *  Between deadlines, the deepest power mode that still meets the next deadline is chosen:
+ *  - When the next deadline lies at least 1000 ms plus #RUNLOOP_DEEPSLEEP_MARGIN_MS ahead, the RTC wake-up
+ *      down-counter is started for the whole seconds that fit, and the core enters Deep Sleep mode. A timer match
+ *      cannot end Deep Sleep mode, the RTC does so through the start logic.
+ *  - Otherwise, or for the remainder, the core enters Sleep mode until the CT16B0 match.
+ *  Any enabled interrupt ends the sleep early. Deep Sleep mode can be vetoed by defining #RUNLOOP_DEEPSLEEP_CB.
+ *
+ * @par Jobs
+ *  Jobs are run by #RunLoop_Step, in thread mode, one after the other: a job runs to completion before the next one
+ *  starts. A periodic job keeps its phase: a late run does not shift the next deadline. When a run is so late that a
+ *  whole period was missed, the missed runs are skipped. Jobs may add and cancel jobs, including themselves.
+ *
+ * @par Interrupts
+ *  Interrupt handlers that leave work for the main loop must call #RunLoop_Wake after setting their flag. Otherwise, an
+ *  interrupt that fires after the main loop checked its flags and before #RunLoop_Step sleeps, is only looked at
+ *  after the next deadline.
+ *
+ * @note This mod owns CT16B0 and the RTC wake-up down-counter, and provides #CT16B0_IRQHandler,
+ *  #RTC_IRQHandler and #RTCPWREQ_IRQHandler.
+ * @note The system clock may not be changed after #RunLoop_Init.
+ *
+ * @par Example: sample a sensor at 10 Hz and report every minute
+ *  @code
+ *      RunLoop_Init();
+ *      RunLoop_AddPeriodicJob(Sample, NULL, 100);
+ *      RunLoop_AddPeriodicJob(Report, NULL, 60000);
+ *      for (;;) {
+ *          RunLoop_Step();
+ *          if (sButtonPressed) {
+ *              ...
+ *          }
+ *      }
+ *  @endcode
+ *
+ * @{
+ */
+
+/* -------------------------------------------------------------------------
+ * Include files
+ * ------------------------------------------------------------------------- */
+
+#include "chip.h"
+#include "runloop_dft.h"
+
+/* -------------------------------------------------------------------------
+ * Types and defines
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Function type of a job.
+ * @param pArg : The argument given when the job was added.
+ * @note Called in thread mode, from within #RunLoop_Step.
+ */
+typedef void (*pRunLoop_Job_t)(void * pArg);
+
+/**
+ * Callback function type to allow or forbid Deep Sleep mode.
+ * @param ms : The time until the next deadline, in ms.
+ * @return @c true to enter Deep Sleep mode, @c false to enter Sleep mode instead.
+ * @note Called in thread mode with interrupts disabled.
+ */
+typedef bool (*pRunLoop_DeepSleep_Cb_t)(int ms);
+
+/* -------------------------------------------------------------------------
+ * Exported function prototypes
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Initializes the module: removes all jobs, starts counting time from 0, and enables the wake-up sources.
+ * @pre The system clock is set, and is at least 1 kHz.
+ * @post CT16B0 is running, and the CT16B0, RTC and RTCPWREQ interrupts are enabled in NVIC. The RTC is enabled as
+ *  start logic source.
+ */
+void RunLoop_Init(void);
+
+/** Stops CT16B0 and the RTC down-counter, and disables their interrupts. The jobs are forgotten. */
+void RunLoop_DeInit(void);
+
+/**
+ * Adds a job that runs every @c periodMs ms, the first time @c periodMs ms from now.
+ * @param job : May not be @c NULL. The function to run.
+ * @param pArg : Passed as is to @c job.
+ * @param periodMs : Must be in the range [1, 0x7FFFFFFF]. The period in ms.
+ * @return A handle for #RunLoop_CancelJob, or @c -1 when #RUNLOOP_JOB_COUNT jobs are registered already.
+ * @note Must not be called under interrupt.
+ */
+int RunLoop_AddPeriodicJob(pRunLoop_Job_t job, void * pArg, int periodMs);
+
+/**
+ * Adds a job that runs once, @c delayMs ms from now.
+ * @param job : May not be @c NULL. The function to run.
+ * @param pArg : Passed as is to @c job.
+ * @param delayMs : Must be in the range [0, 0x7FFFFFFF]. The delay in ms. With @c 0, the job runs at the next call
+ *  to #RunLoop_Step.
+ * @return A handle for #RunLoop_CancelJob, or @c -1 when #RUNLOOP_JOB_COUNT jobs are registered already.
+ *  The handle is no longer valid once the job has run.
+ * @note Must not be called under interrupt.
+ */
+int RunLoop_AddOneShotJob(pRunLoop_Job_t job, void * pArg, int delayMs);
+
+/**
+ * Removes a job: it will not run anymore.
+ * @param handle : A handle returned by #RunLoop_AddPeriodicJob or #RunLoop_AddOneShotJob, or @c -1.
+ * @note Must not be called under interrupt.
+ */
+void RunLoop_CancelJob(int handle);
+
+/**
+ * @return The time in ms since #RunLoop_Init. Wraps around after about 49 days.
+ * @note Must not be called under interrupt.
+ */
+uint32_t RunLoop_GetTime(void);
+
+/**
+ * Makes the ongoing, or else the next, call to #RunLoop_Step return without sleeping (any further).
+ * @note To be called under interrupt, after setting a flag that is handled in the main loop.
+ */
+void RunLoop_Wake(void);
+
+/**
+ * Runs all jobs whose deadline has passed. When there was none, sleeps until the next deadline, or until an interrupt
+ * occurs, whichever comes first.
+ * To be called repeatedly from the main loop.
+ * @note Must not be called under interrupt.
+ */
+void RunLoop_Step(void);
+
+#endif /** @} */
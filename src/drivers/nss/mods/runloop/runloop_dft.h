@@ -0,0 +1,54 @@
+/** @defgroup MODS_NSS_RUNLOOP_DFT Diversity Settings
+ *  @ingroup MODS_NSS_RUNLOOP
+ * These 'defines' capture the diversity settings of the module. The displayed values refer to the default settings.
+ * To override the default settings, place the defines with their desired values in the application app_sel.h header
+ * file: the compiler will pick up your defines before parsing this file.
+ * @{
+ */
+#ifndef __RUNLOOP_DFT_H_
+#define __RUNLOOP_DFT_H_
+
+/**
+ * The maximum number of jobs that can be registered at the same time, periodic and one-shot jobs together.
+ * Each job costs 16 bytes of RAM.
+ */
+#if !defined(RUNLOOP_JOB_COUNT)
+    #define RUNLOOP_JOB_COUNT 4
+#endif
+#if (RUNLOOP_JOB_COUNT < 1) || (RUNLOOP_JOB_COUNT > 255)
+    #error RUNLOOP_JOB_COUNT must be in the range [1, 255]
+#endif
+
+/**
+ * Time in ms that is kept free before a deadline when sleeping in Deep Sleep mode. The RTC down-counter only counts
+ * whole ticks of about one second, its first tick can be partial, and the calibration of a tick is not perfect: the
+ * remainder of the wait is spent in Sleep mode.
+ * Deep Sleep mode is thus only used when the next deadline lies at least 1000 ms plus this margin ahead.
+ */
+#if !defined(RUNLOOP_DEEPSLEEP_MARGIN_MS)
+    #define RUNLOOP_DEEPSLEEP_MARGIN_MS 200
+#endif
+#if (RUNLOOP_DEEPSLEEP_MARGIN_MS < 0) || (RUNLOOP_DEEPSLEEP_MARGIN_MS > 10000)
+    #error RUNLOOP_DEEPSLEEP_MARGIN_MS must be in the range [0, 10000]
+#endif
+
+/* Diversity flags below are undefined by default. They are wrapped in a DOXYGEN precompilation flag to enable
+ * documenting them properly. To define them and use the corresponding functionality of the module, make the correct
+ * defines in app_sel.h or board_sel.h.
+ */
+#ifdef __DOXYGEN__
+#error This block of code may not be parsed using gcc.
+
+/**
+ * By default, the module enters Deep Sleep mode whenever the next deadline is far enough away. This requires that all
+ * interrupts that must wake up the core are also enabled as start logic source, and that no peripheral needs the
+ * clocks or the analog blocks that are switched off in Deep Sleep mode. When this does not always hold, define the
+ * callback function here: it is asked each time before Deep Sleep mode is entered.
+ * Set this define to the function to be called.
+ * @note The value set @b must have the same signature as @ref pRunLoop_DeepSleep_Cb_t
+ * @note This must be set to the name of a function, not a pointer to a function: no dereference will be made!
+ */
+#define RUNLOOP_DEEPSLEEP_CB application function of type pRunLoop_DeepSleep_Cb_t
+#endif
+
+#endif /** @} */
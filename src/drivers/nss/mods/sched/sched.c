@@ -0,0 +1,123 @@
+#include "sched.h"
+#include "runloop/runloop.h"
+
+/* -------------------------------------------------------------------------
+ * Private types and defines
+ * ------------------------------------------------------------------------- */
+
+/** A queued event. */
+typedef struct SCHED_EVENT_S {
+    pSched_Handler_t handler;
+    void * pArg; /**< Argument for @c handler */
+} SCHED_EVENT_T;
+
+/** The events of one priority, in the order they were posted. */
+typedef struct SCHED_QUEUE_S {
+    SCHED_EVENT_T events[SCHED_QUEUE_SIZE];
+    uint8_t head; /**< Index in @c events of the event to dispatch first */
+    uint8_t count; /**< Number of queued events */
+} SCHED_QUEUE_T;
+
+/* -------------------------------------------------------------------------
+ * Private variables
+ * ------------------------------------------------------------------------- */
+
+/** Accessed under interrupt: only with interrupts disabled. */
+static SCHED_QUEUE_T sQueues[SCHED_PRIORITY_COUNT];
+static volatile int sOverflowCount;
+
+/* -------------------------------------------------------------------------
+ * Exported functions
+ * ------------------------------------------------------------------------- */
+
+void Sched_Init(void)
+{
+    __disable_irq();
+    for (int priority = 0; priority < SCHED_PRIORITY_COUNT; priority++) {
+        sQueues[priority].head = 0;
+        sQueues[priority].count = 0;
+    }
+    sOverflowCount = 0;
+    __enable_irq();
+}
+
+bool Sched_Post(pSched_Handler_t handler, void * pArg, int priority)
+{
+    bool accepted = false;
+    uint32_t primask = __get_PRIMASK();
+
+    ASSERT(handler != NULL);
+    ASSERT((priority >= 0) && (priority < SCHED_PRIORITY_COUNT));
+    __disable_irq();
+    SCHED_QUEUE_T * pQueue = &sQueues[priority];
+    if (pQueue->count < SCHED_QUEUE_SIZE) {
+        SCHED_EVENT_T * pEvent = &pQueue->events[(pQueue->head + pQueue->count) % SCHED_QUEUE_SIZE];
+        pEvent->handler = handler;
+        pEvent->pArg = pArg;
+        pQueue->count++;
+        accepted = true;
+    }
+    else {
+        sOverflowCount++;
+    }
+    __set_PRIMASK(primask);
+    RunLoop_Wake();
+    return accepted;
+}
+
+bool Sched_Dispatch(void)
+{
+    SCHED_EVENT_T event = {NULL, NULL};
+
+    __disable_irq();
+    for (int priority = 0; priority < SCHED_PRIORITY_COUNT; priority++) {
+        SCHED_QUEUE_T * pQueue = &sQueues[priority];
+        if (pQueue->count > 0) {
+            event = pQueue->events[pQueue->head];
+            pQueue->head = (uint8_t)((pQueue->head + 1) % SCHED_QUEUE_SIZE);
+            pQueue->count--;
+            break;
+        }
+    }
+    __enable_irq();
+
+    if (event.handler == NULL) {
+        return false;
+    }
+    event.handler(event.pArg);
+    return true;
+}
+
+void Sched_Step(void)
+{
+    if (!Sched_Dispatch()) {
+        RunLoop_Step();
+    }
+}
+
+void Sched_Run(void)
+{
+    for (;;) {
+        Sched_Step();
+    }
+}
+
+int Sched_GetCount(int priority)
+{
+    int count = 0;
+
+    ASSERT((priority >= -1) && (priority < SCHED_PRIORITY_COUNT));
+    __disable_irq();
+    for (int p = 0; p < SCHED_PRIORITY_COUNT; p++) {
+        if ((priority == -1) || (priority == p)) {
+            count += sQueues[p].count;
+        }
+    }
+    __enable_irq();
+    return count;
+}
+
+int Sched_GetOverflowCount(void)
+{
+    return sOverflowCount;
+}
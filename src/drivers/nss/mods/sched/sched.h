@@ -0,0 +1,121 @@
+#ifndef __SCHED_H_
+#define __SCHED_H_
+
+/** @defgroup MODS_NSS_SCHED sched: Run-to-completion event scheduler
+ * @ingroup MODS_NSS
+ * The scheduler module moves work out of interrupt handlers and driver callbacks into thread mode. An interrupt handler
+ * posts an event - a handler function and its argument - and returns. The main loop dispatches the queued events one by
+ * one, highest priority first, and lets the core sleep when no event is queued.
+ *
+ * @par Diversity
+ *  This module supports diversity, like the number of priorities and the queue size.
+ *  Check @ref MODS_NSS_SCHED_DFT for all diversity parameters.
+ *
+ * @par Run to completion
+ *  A handler runs to completion before the next event is dispatched: handlers need no locking among each other.
+ *  Events of the same priority are dispatched in the order they were posted. An event of a higher priority is
+ *  dispatched before any queued event of a lower priority, but never preempts a running handler. Handlers must thus
+ *  stay short; long work is split over several events, each posting the next.
+ *
+ * @par Timers and drivers
+ *  Sleeping and timed work are left to the @ref MODS_NSS_RUNLOOP "run loop": #Sched_Step calls #RunLoop_Step when no
+ *  event is queued, and #Sched_Post calls #RunLoop_Wake. Timed work is a run loop job, which may post an event itself
+ *  to get a priority. Drivers report completions through their callback defines: point these to a function that posts
+ *  an event, e.g. @c I2CQ_DONE_CB, @c TMEAS_CB, @c NDEFT2T_MSG_AVAILABLE_CB and @c NDEFT2T_FIELD_STATUS_CB.
+ *
+ * @par Example: handle a sensor interrupt and NFC messages in thread mode
+ *  @code
+ *      void PIO0_IRQHandler(void)
+ *      {
+ *          Chip_GPIO_Int_ClearRawStatus(NSS_GPIO, 0, 1 << SENSOR_INT_PIN);
+ *          Sched_Post(Sensor_Read, NULL, 0);
+ *      }
+ *
+ *      void App_MsgAvailableCb(void) // NDEFT2T_MSG_AVAILABLE_CB
+ *      {
+ *          Sched_Post(Nfc_Parse, NULL, 1);
+ *      }
+ *
+ *      int main(void)
+ *      {
+ *          ...
+ *          RunLoop_Init();
+ *          Sched_Init();
+ *          RunLoop_AddPeriodicJob(Report, NULL, 60000);
+ *          Sched_Run();
+ *      }
+ *  @endcode
+ *
+ * @{
+ */
+
+/* -------------------------------------------------------------------------
+ * Include files
+ * ------------------------------------------------------------------------- */
+
+#include "chip.h"
+#include "sched_dft.h"
+
+/* -------------------------------------------------------------------------
+ * Types and defines
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Function type of an event handler.
+ * @param pArg : The argument given when the event was posted.
+ * @note Called in thread mode, from within #Sched_Dispatch.
+ */
+typedef void (*pSched_Handler_t)(void * pArg);
+
+/* -------------------------------------------------------------------------
+ * Exported function prototypes
+ * ------------------------------------------------------------------------- */
+
+/**
+ * Initializes the module: all queued events are dropped and the overflow count is reset.
+ * @pre The @ref MODS_NSS_RUNLOOP "run loop" is initialized before #Sched_Step is called.
+ */
+void Sched_Init(void);
+
+/**
+ * Queues an event.
+ * @param handler : May not be @c NULL. The function to call from #Sched_Dispatch.
+ * @param pArg : Passed as is to @c handler.
+ * @param priority : Must be in the range [0, #SCHED_PRIORITY_COUNT[. @c 0 is the highest priority.
+ * @return @c false when #SCHED_QUEUE_SIZE events of this priority are queued already: the event is dropped and
+ *  counted, see #Sched_GetOverflowCount.
+ * @note May be called under interrupt and in thread mode, also from within a handler.
+ */
+bool Sched_Post(pSched_Handler_t handler, void * pArg, int priority);
+
+/**
+ * Dequeues the event with the highest priority that was posted first, and calls its handler.
+ * @return Whether an event was dispatched.
+ * @note Must not be called under interrupt.
+ */
+bool Sched_Dispatch(void);
+
+/**
+ * Dispatches one event. When there was none, calls #RunLoop_Step: due jobs are run, or else the core sleeps until the
+ * next deadline or until an interrupt occurs.
+ * To be called repeatedly from the main loop.
+ * @note Must not be called under interrupt.
+ */
+void Sched_Step(void);
+
+/**
+ * Calls #Sched_Step forever. Does not return.
+ * @note Must not be called under interrupt.
+ */
+void Sched_Run(void);
+
+/**
+ * @param priority : Must be in the range [0, #SCHED_PRIORITY_COUNT[, or @c -1 for all priorities together.
+ * @return The number of queued events.
+ */
+int Sched_GetCount(int priority);
+
+/** @return The number of events that were dropped by #Sched_Post since #Sched_Init because their queue was full. */
+int Sched_GetOverflowCount(void);
+
+#endif /** @} */
@@ -0,0 +1,32 @@
+/** @defgroup MODS_NSS_SCHED_DFT Diversity Settings
+ *  @ingroup MODS_NSS_SCHED
+ * These 'defines' capture the diversity settings of the module. The displayed values refer to the default settings.
+ * To override the default settings, place the defines with their desired values in the application app_sel.h header
+ * file: the compiler will pick up your defines before parsing this file.
+ * @{
+ */
+#ifndef __SCHED_DFT_H_
+#define __SCHED_DFT_H_
+
+/**
+ * The number of priorities. Priority @c 0 is the highest, @c SCHED_PRIORITY_COUNT - 1 the lowest.
+ */
+#if !defined(SCHED_PRIORITY_COUNT)
+    #define SCHED_PRIORITY_COUNT 3
+#endif
+#if (SCHED_PRIORITY_COUNT < 1) || (SCHED_PRIORITY_COUNT > 8)
+    #error SCHED_PRIORITY_COUNT must be in the range [1, 8]
+#endif
+
+/**
+ * The maximum number of events that can be queued per priority. Each event costs 8 bytes of RAM.
+ * When a queue is full, further events of that priority are refused until an event is dispatched.
+ */
+#if !defined(SCHED_QUEUE_SIZE)
+    #define SCHED_QUEUE_SIZE 8
+#endif
+#if (SCHED_QUEUE_SIZE < 1) || (SCHED_QUEUE_SIZE > 255)
+    #error SCHED_QUEUE_SIZE must be in the range [1, 255]
+#endif
+
+#endif /** @} */
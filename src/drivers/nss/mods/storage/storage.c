@@ -11,6 +11,7 @@
 
 #include <string.h>
 #include "storage.h"
+#include "profile/profile.h"
 
 /**
  * @file
@@ -223,6 +224,17 @@
  *      +---------+                           +---------+
  *  @endcode
  *
+ *  @par Finding blocks in FLASH
+ *
+ *  The (compressed) data blocks in FLASH have a variable size: the location of a block is only known by adding the
+ *  sizes of all blocks before it. To avoid reading all block headers for each call to #Storage_Seek and
+ *  #Storage_GetCount, the locations are remembered in SRAM - see #Directory_t. The directory is emptied in
+ *  #Storage_Init and #Storage_Reset; the block headers are read once to fill it, the first time it is needed, and
+ *  each new block is added when it is moved to FLASH.
+ *  At most #STORAGE_BLOCK_DIRECTORY_SIZE locations are remembered. When more blocks are stored, every other location is
+ *  forgotten, after which only every second - then fourth, eighth, ... - block location is added. To find a block,
+ *  at most that many minus one block headers are read.
+ *
  *  @par Caching data
  *
  *  To reduce the number of EEPROM flushes, data is initially @b not stored in non-volatile memories EEPROM and
@@ -391,6 +403,12 @@
 /** The mask to use to zero out all possible 1 bits in #Marker_t.flashByteCursor */
 #define MARKER_CURSOR_ZERO_MASK 0xFFFF8003
 
+/**
+ * The maximum number of samples packed or unpacked in one go when writing to or reading from EEPROM. Determines the
+ * size of the buffer on the stack in #WriteSamplesToEeprom and #ReadSamplesFromEeprom.
+ */
+#define SAMPLE_RUN_COUNT 32
+
 /* ------------------------------------------------------------------------- */
 
 #if !STORAGE_FLASH_FIRST_PAGE
@@ -622,6 +640,14 @@ int checkSizeOfMarker[(SIZE_OF_MARKER == sizeof(Marker_t)) ? 1 : -1]; /* Dummy v
 /** If this construct doesn't compile, adjust #FIRST_BITS_OF_CACHE_SIZE. RecoverInfo_t must be exactly 32 bits in size */
 int checkSizeOfRecoverInfo[sizeof(RecoverInfo_t) == 4 ? 1 : -1]; /* Dummy variable since we can't use sizeof during precompilation. */
 
+#if STORAGE_FIELD_COUNT > 1
+/** If this construct doesn't compile, #STORAGE_TYPE does not consist of exactly #STORAGE_FIELD_COUNT fields of type #STORAGE_FIELD_TYPE. */
+int checkSizeOfRecordType[(sizeof(STORAGE_TYPE) == STORAGE_FIELD_COUNT * sizeof(STORAGE_FIELD_TYPE)) ? 1 : -1]; /* Dummy variable since we can't use sizeof during precompilation. */
+
+/** If this construct doesn't compile, #STORAGE_FIELD_BITSIZES does not list exactly #STORAGE_FIELD_COUNT bit sizes. */
+int checkFieldBitSizesCount[(sizeof((uint8_t[]){STORAGE_FIELD_BITSIZES}) == STORAGE_FIELD_COUNT) ? 1 : -1]; /* Dummy variable since we can't use sizeof during precompilation. */
+#endif
+
 #if STORAGE_MAX_SAMPLE_ALON_CACHE_COUNT != (((5 - STORAGE_FIRST_ALON_REGISTER) * 32 - (32 - FIRST_BITS_OF_CACHE_SIZE)) / STORAGE_BITSIZE)
     /* 5: there are 5 general purpose registers */
     /* 32: one word == 32 bits */
@@ -630,6 +656,32 @@ int checkSizeOfRecoverInfo[sizeof(RecoverInfo_t) == 4 ? 1 : -1]; /* Dummy variab
 
 #pragma GCC diagnostic pop
 
+/**
+ * Remembers where (compressed) data blocks start in FLASH.
+ * Block @c b, containing the samples with sequence numbers starting from @c b * #STORAGE_BLOCK_SIZE_IN_SAMPLES,
+ * starts at FLASH byte cursor @c entries[b / stride] when @c b is a multiple of @c stride.
+ * @note The directory is not stored: it is rebuilt from the block headers in FLASH after each #Storage_Init.
+ */
+typedef struct Directory_s {
+    /** The number of blocks added to the directory. When equal to the number of blocks in FLASH, it is up to date. */
+    int blockCount;
+
+    /** The FLASH byte cursor just after the last block added to the directory. */
+    int endCursor;
+
+    /** The difference in block number between two consecutive entries. A power of two. */
+    int stride;
+
+    /** The number of valid elements in @c entries. */
+    int entryCount;
+
+    /**
+     * FLASH byte cursors, relative to #STORAGE_FLASH_FIRST_PAGE, of the headers preceding every @c stride-th block.
+     * @see Storage_Instance_t.flashByteCursor
+     */
+    uint16_t entries[STORAGE_BLOCK_DIRECTORY_SIZE];
+} Directory_t;
+
 /* ------------------------------------------------------------------------- */
 
 /**
@@ -639,6 +691,10 @@ int checkSizeOfRecoverInfo[sizeof(RecoverInfo_t) == 4 ? 1 : -1]; /* Dummy variab
 __attribute__ ((section(".noinit")))
 static Storage_Instance_t sInstance;
 
+/** Where to find the (compressed) data blocks in FLASH. Emptied in #ResetInstance, filled by #UpdateDirectory. */
+__attribute__ ((section(".noinit")))
+static Directory_t sDirectory;
+
 /**
  * To reduce the call count to @c Chip_PMU_GetRetainedData and @c Chip_PMU_SetRetainedData, data is copied to SRAM in
  * #Storage_Init once, and copied back to GPREG in #Storage_DeInit once.
@@ -666,22 +722,42 @@ uint8_t sStorage_Workarea[STORAGE_WORKAREA_SIZE];
 #endif
 extern uint8_t STORAGE_WORKAREA[STORAGE_WORKAREA_SIZE];
 
+#if STORAGE_FIELD_COUNT > 1
+extern int STORAGE_COMPRESS_CB(const uint8_t * pPlanes, int bitCount, void * pOut);
+#else
 extern int STORAGE_COMPRESS_CB(int eepromByteOffset, int bitCount, void * pOut);
+#endif
 extern int STORAGE_DECOMPRESS_CB(const uint8_t * pData, int bitCount, void * pOut);
 
+#if STORAGE_FIELD_COUNT > 1
+/** The bit size of each field of a record. Checked against #STORAGE_BITSIZE in #Storage_Init. */
+static const uint8_t sFieldBitSizes[STORAGE_FIELD_COUNT] = {STORAGE_FIELD_BITSIZES};
+
+/**
+ * Where the planes are placed in #STORAGE_WORKAREA while moving a block to FLASH: after the memory used to prepare the
+ * pages to flash.
+ */
+#define PLANES_WORKAREA_OFFSET (STORAGE_WORKAREA_SIZE - STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES)
+#endif
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 /**
  * This is a dummy implementation to provoke fallback behavior: a plain copy from EEPROM to FLASH.
  * It is only used when #STORAGE_COMPRESS_CB is not overridden in an application specific @c app_sel.h header file
  * @see pStorage_CompressCb_t
+ * @see pStorage_CompressPlanesCb_t
  * @see STORAGE_COMPRESS_CB
- * @param eepromByteOffset unused
+ * @param eepromByteOffset unused - or @c pPlanes when #STORAGE_FIELD_COUNT is larger than 1
  * @param bitCount unused
  * @param pOut unused
  * @return @c 0
  */
+#if STORAGE_FIELD_COUNT > 1
+int Storage_DummyCompressCb(const uint8_t * pPlanes, int bitCount, void * pOut)
+#else
 int Storage_DummyCompressCb(int eepromByteOffset, int bitCount, void * pOut)
+#endif
 {
     return 0;
 }
@@ -707,14 +783,26 @@ int Storage_DummyDecompressCb(const uint8_t * pData, int bitCount, void * pOut)
 static void ResetInstance(void);
 static void ShiftAlignedData(uint8_t * pTo, const uint8_t * pFrom, const int bitAlignment, const int bitCount);
 static void ShiftUnalignedData(uint8_t * pTo, const uint8_t * pFrom, const int bitAlignment, const int bitCount);
+static void PackSamples(uint8_t * pTo, const int bitAlignment, const STORAGE_TYPE * pSamples, const int n);
+static void UnpackSamples(STORAGE_TYPE * pSamples, const uint8_t * pFrom, const int bitAlignment, const int n);
 #if STORAGE_SAMPLE_ALON_CACHE_COUNT > 0
 static bool CacheSample(const STORAGE_TYPE * pSample);
-static bool GetCachedSample(const int n, void * pData);
+static bool GetCachedSample(const int n, STORAGE_TYPE * pSample);
 #endif
 static void WriteToEeprom(const int bitCursor, const void * pData, const int bitCount);
 static void ReadFromEeprom(const unsigned int bitCursor, void * pData, const int bitCount);
+static void WriteSamplesToEeprom(const int bitCursor, const STORAGE_TYPE * pSamples, const int n);
+static void ReadSamplesFromEeprom(const int bitCursor, STORAGE_TYPE * pSamples, const int n);
+#if STORAGE_FIELD_COUNT > 1
+static STORAGE_FIELD_TYPE ToField(uint32_t bits, const int bitSize);
+static void OrBits(uint8_t * pTo, const int bitCursor, uint32_t value, const int bitCount);
+static uint32_t GetBits(const uint8_t * pFrom, const int bitCursor, const int bitCount);
+static void TransposeToPlanes(uint8_t * pPlanes);
+static void UnpackPlanes(STORAGE_TYPE * pSamples, const uint8_t * pPlanes, const int first, const int n);
+#endif
 static unsigned int FindMarker(Marker_t * pMarker);
 static int GetEepromCount(void);
+static void UpdateDirectory(void);
 static int GetFlashCount(void);
 #if STORAGE_FLASH_FIRST_PAGE <= STORAGE_FLASH_LAST_PAGE
 static bool WriteToFlash(const int pageCursor, const uint8_t * pData, const int pageCount);
@@ -744,6 +832,10 @@ static void ResetInstance(void)
     sInstance.readCursor = -1;
     sInstance.targetSequence = -1;
     sInstance.cachedBlockOffset = -1;
+    sDirectory.blockCount = 0;
+    sDirectory.endCursor = 0;
+    sDirectory.stride = 1;
+    sDirectory.entryCount = 0;
 }
 
 /**
@@ -858,6 +950,175 @@ static void ShiftUnalignedData(uint8_t * pTo, const uint8_t * pFrom, const int b
     }
 }
 
+#if STORAGE_FIELD_COUNT > 1
+/**
+ * Packs a run of records without padding bits: the fields of each record in order, each using its own bit size.
+ * Same technique as for single values: a 32-bit accumulator collects the bits of each field and hands out full bytes.
+ * @param pTo The location to copy to. The first @c bitAlignment LSBits of the first byte are not touched.
+ * @param bitAlignment The number of bits to disregard in @c pTo. Must be less than @c 8.
+ * @param pSamples The records to copy. Only the LSBits given in #STORAGE_FIELD_BITSIZES of each field are copied.
+ * @param n Must be strict positive. The number of records to copy.
+ * @post @code STORAGE_IDIVUP(n * STORAGE_BITSIZE + bitAlignment, 8) @endcode bytes will be written to @c pTo. The
+ *  remainder bits in the last byte are set to @c 0.
+ */
+static void PackSamples(uint8_t * pTo, const int bitAlignment, const STORAGE_TYPE * pSamples, const int n)
+{
+    ASSERT((bitAlignment >= 0) && (bitAlignment < 8));
+    ASSERT(n > 0);
+
+    /* bitCount is less than 8 before, and at most 8 + 24 - 1 after adding a field: the accumulator never overflows. */
+    uint32_t bits = *pTo & ((1U << bitAlignment) - 1);
+    int bitCount = bitAlignment;
+    for (int i = 0; i < n; i++) {
+        const STORAGE_FIELD_TYPE * pFields = (const STORAGE_FIELD_TYPE *)(pSamples + i);
+        for (int f = 0; f < STORAGE_FIELD_COUNT; f++) {
+            bits |= ((uint32_t)pFields[f] & ((1U << sFieldBitSizes[f]) - 1)) << bitCount;
+            bitCount += sFieldBitSizes[f];
+            while (bitCount >= 8) {
+                *pTo++ = (uint8_t)bits;
+                bits >>= 8;
+                bitCount -= 8;
+            }
+        }
+    }
+    if (bitCount > 0) {
+        *pTo = (uint8_t)bits;
+    }
+}
+
+/**
+ * Unpacks a run of records packed by #PackSamples.
+ * @param pSamples The records to copy to. For each field, the bits above its bit size are set to @c 0, or to its sign
+ *  bit.
+ * @param pFrom The location to copy from.
+ * @param bitAlignment The number of bits to disregard in @c pFrom. Must be less than @c 8.
+ * @param n Must be strict positive. The number of records to copy.
+ * @pre @code STORAGE_IDIVUP(n * STORAGE_BITSIZE + bitAlignment, 8) @endcode bytes must be available in @c pFrom. No
+ *  more bytes are read.
+ */
+static void UnpackSamples(STORAGE_TYPE * pSamples, const uint8_t * pFrom, const int bitAlignment, const int n)
+{
+    ASSERT((bitAlignment >= 0) && (bitAlignment < 8));
+    ASSERT(n > 0);
+
+    uint32_t bits = (uint32_t)*pFrom++ >> bitAlignment;
+    int bitCount = 8 - bitAlignment;
+    for (int i = 0; i < n; i++) {
+        STORAGE_FIELD_TYPE * pFields = (STORAGE_FIELD_TYPE *)(pSamples + i);
+        for (int f = 0; f < STORAGE_FIELD_COUNT; f++) {
+            const int bitSize = sFieldBitSizes[f];
+            while (bitCount < bitSize) {
+                bits |= (uint32_t)*pFrom++ << bitCount;
+                bitCount += 8;
+            }
+            pFields[f] = ToField(bits, bitSize);
+            bits >>= bitSize;
+            bitCount -= bitSize;
+        }
+    }
+}
+#elif STORAGE_BITSIZE <= 24
+/**
+ * Packs a run of samples, #STORAGE_BITSIZE bits each, without padding bits.
+ * A 32-bit accumulator collects the bits of the samples and hands out full bytes. All shifts and masks depend on
+ * #STORAGE_BITSIZE only and are resolved at compile time: there is no per-bit or per-sample loop.
+ * @param pTo The location to copy to. The first @c bitAlignment LSBits of the first byte are not touched.
+ * @param bitAlignment The number of bits to disregard in @c pTo. Must be less than @c 8.
+ * @param pSamples The samples to copy. Only the #STORAGE_BITSIZE LSBits of each sample are copied.
+ * @param n Must be strict positive. The number of samples to copy.
+ * @post @code STORAGE_IDIVUP(n * STORAGE_BITSIZE + bitAlignment, 8) @endcode bytes will be written to @c pTo. The
+ *  remainder bits in the last byte are set to @c 0.
+ */
+static void PackSamples(uint8_t * pTo, const int bitAlignment, const STORAGE_TYPE * pSamples, const int n)
+{
+    ASSERT((bitAlignment >= 0) && (bitAlignment < 8));
+    ASSERT(n > 0);
+
+    /* bitCount is less than 8 before, and less than 8 + STORAGE_BITSIZE after adding a sample: the accumulator
+     * never overflows.
+     */
+    uint32_t bits = *pTo & ((1U << bitAlignment) - 1);
+    int bitCount = bitAlignment;
+    for (int i = 0; i < n; i++) {
+        bits |= ((uint32_t)pSamples[i] & ((1U << STORAGE_BITSIZE) - 1)) << bitCount;
+        bitCount += STORAGE_BITSIZE;
+        while (bitCount >= 8) {
+            *pTo++ = (uint8_t)bits;
+            bits >>= 8;
+            bitCount -= 8;
+        }
+    }
+    if (bitCount > 0) {
+        *pTo = (uint8_t)bits;
+    }
+}
+
+/**
+ * Unpacks a run of samples packed by #PackSamples. Same technique: a 32-bit accumulator is filled with whole bytes;
+ * each sample is taken from its LSBits with a constant mask - or, if #STORAGE_SIGNED is set, a constant pair of shifts
+ * that also propagates the sign bit.
+ * @param pSamples The samples to copy to. The bits above #STORAGE_BITSIZE are set to @c 0, or to the sign bit.
+ * @param pFrom The location to copy from.
+ * @param bitAlignment The number of bits to disregard in @c pFrom. Must be less than @c 8.
+ * @param n Must be strict positive. The number of samples to copy.
+ * @pre @code STORAGE_IDIVUP(n * STORAGE_BITSIZE + bitAlignment, 8) @endcode bytes must be available in @c pFrom. No
+ *  more bytes are read.
+ */
+static void UnpackSamples(STORAGE_TYPE * pSamples, const uint8_t * pFrom, const int bitAlignment, const int n)
+{
+    ASSERT((bitAlignment >= 0) && (bitAlignment < 8));
+    ASSERT(n > 0);
+
+    uint32_t bits = (uint32_t)*pFrom++ >> bitAlignment;
+    int bitCount = 8 - bitAlignment;
+    for (int i = 0; i < n; i++) {
+        while (bitCount < STORAGE_BITSIZE) {
+            bits |= (uint32_t)*pFrom++ << bitCount;
+            bitCount += 8;
+        }
+#if STORAGE_SIGNED
+        pSamples[i] = (STORAGE_TYPE)((int32_t)(bits << (32 - STORAGE_BITSIZE)) >> (32 - STORAGE_BITSIZE));
+#else
+        pSamples[i] = (STORAGE_TYPE)(bits & ((1U << STORAGE_BITSIZE) - 1));
+#endif
+        bits >>= STORAGE_BITSIZE;
+        bitCount -= STORAGE_BITSIZE;
+    }
+}
+#else
+/**
+ * Packs a run of samples, #STORAGE_BITSIZE bits each, without padding bits.
+ * @note A 32-bit accumulator can not hold a sample plus a partial byte: the samples are copied one by one.
+ * @see ShiftAlignedData
+ */
+static void PackSamples(uint8_t * pTo, const int bitAlignment, const STORAGE_TYPE * pSamples, const int n)
+{
+    int bitOffset = bitAlignment;
+    for (int i = 0; i < n; i++) {
+        ShiftAlignedData(pTo + bitOffset / 8, (const uint8_t *)(pSamples + i), bitOffset % 8, STORAGE_BITSIZE);
+        bitOffset += STORAGE_BITSIZE;
+    }
+}
+
+/**
+ * Unpacks a run of samples packed by #PackSamples.
+ * @note A 32-bit accumulator can not hold a sample plus a partial byte: the samples are copied one by one.
+ * @see ShiftUnalignedData
+ */
+static void UnpackSamples(STORAGE_TYPE * pSamples, const uint8_t * pFrom, const int bitAlignment, const int n)
+{
+    int bitOffset = bitAlignment;
+    for (int i = 0; i < n; i++) {
+        ShiftUnalignedData((uint8_t *)(pSamples + i), pFrom + bitOffset / 8, bitOffset % 8, STORAGE_BITSIZE);
+        bitOffset += STORAGE_BITSIZE;
+#if STORAGE_SIGNED
+        int msbits = sizeof(STORAGE_TYPE) * 8 - STORAGE_BITSIZE;
+        pSamples[i] = (STORAGE_TYPE)((STORAGE_TYPE)(pSamples[i] << msbits) >> msbits);
+#endif
+    }
+}
+#endif
+
 /* ------------------------------------------------------------------------- */
 
 #if STORAGE_SAMPLE_ALON_CACHE_COUNT > 0
@@ -874,7 +1135,7 @@ static bool CacheSample(const STORAGE_TYPE * pSample)
         int bitCursor = (32 - FIRST_BITS_OF_CACHE_SIZE) + (spRecoverInfo->sampleCacheCount * STORAGE_BITSIZE);
         int byteOffset = bitCursor / 8;
         int bitAlignment = bitCursor % 8;
-        ShiftAlignedData(&sCache[byteOffset], (uint8_t *)pSample, bitAlignment, STORAGE_BITSIZE);
+        PackSamples(&sCache[byteOffset], bitAlignment, pSample, 1);
         spRecoverInfo->sampleCacheCount++;
         success = true;
     }
@@ -885,16 +1146,16 @@ static bool CacheSample(const STORAGE_TYPE * pSample)
 /**
  * Retrieves a sample cached in an earlier call to #CacheSample.
  * @param n A relative index. Determines the sample to copy. A value of 0 indicates the oldest sample that is present in #sCache.
- * @param pData May not be @c NULL. The sample is copied to the array pointed to.
+ * @param pSample May not be @c NULL. The sample is copied to the variable pointed to.
  * @return @c true if a sample was copied; @c false if less than @c n samples are stored in #sCache
  */
-static bool GetCachedSample(const int n, void * pData)
+static bool GetCachedSample(const int n, STORAGE_TYPE * pSample)
 {
     if (n < spRecoverInfo->sampleCacheCount) {
         int bitCursor = (32 - FIRST_BITS_OF_CACHE_SIZE) + (n * STORAGE_BITSIZE);
         int byteOffset = bitCursor / 8;
         int bitAlignment = bitCursor % 8;
-        ShiftUnalignedData((uint8_t *)pData, &sCache[byteOffset], bitAlignment, STORAGE_BITSIZE);
+        UnpackSamples(pSample, &sCache[byteOffset], bitAlignment, 1);
     }
     return n < spRecoverInfo->sampleCacheCount;
 }
@@ -955,6 +1216,178 @@ static void ReadFromEeprom(const unsigned int bitCursor, void * pData, const int
     ShiftUnalignedData((uint8_t *)pData, bytes, bitAlignment, bitCount);
 }
 
+/**
+ * Writes a run of samples to EEPROM, packed without padding bits.
+ * @pre EEPROM is initialized
+ * @pre Enough free space must be available in EEPROM starting from @c bitCursor
+ * @param bitCursor Must be positive. The first bit where to start writing.
+ * @param pSamples May not be @c NULL.
+ * @param n Must be strict positive. The number of samples to write.
+ * @post #sInstance is not touched.
+ */
+static void WriteSamplesToEeprom(const int bitCursor, const STORAGE_TYPE * pSamples, const int n)
+{
+    uint8_t bytes[STORAGE_IDIVUP(SAMPLE_RUN_COUNT * STORAGE_BITSIZE + 7, 8)];
+    int cursor = bitCursor;
+
+    ASSERT(bitCursor >= 0);
+    ASSERT(pSamples != NULL);
+    ASSERT(n > 0);
+
+    for (int i = 0; i < n; i += SAMPLE_RUN_COUNT) {
+        int count = ((n - i) < SAMPLE_RUN_COUNT) ? (n - i) : SAMPLE_RUN_COUNT;
+        int byteOffset = EEPROM_ABSOLUTE_FIRST_BYTE_OFFSET + cursor / 8;
+        int bitAlignment = cursor % 8;
+
+        /* Preserve the LSBits in the first byte, which were written previously. */
+        Chip_EEPROM_Read(NSS_EEPROM, byteOffset, bytes, 1);
+        PackSamples(bytes, bitAlignment, pSamples + i, count);
+        Chip_EEPROM_Write(NSS_EEPROM, byteOffset, bytes, STORAGE_IDIVUP(count * STORAGE_BITSIZE + bitAlignment, 8));
+        cursor += count * STORAGE_BITSIZE;
+    }
+}
+
+/**
+ * Reads a run of samples from EEPROM, written by #WriteSamplesToEeprom.
+ * @pre EEPROM is initialized
+ * @pre @c n samples are available in EEPROM starting from @c bitCursor
+ * @param bitCursor Must be positive. The bit position in EEPROM of the first sample to read.
+ * @param pSamples May not be @c NULL. Receives the samples, sign extended if #STORAGE_SIGNED is set.
+ * @param n Must be strict positive. The number of samples to read.
+ * @post #sInstance is not touched.
+ */
+static void ReadSamplesFromEeprom(const int bitCursor, STORAGE_TYPE * pSamples, const int n)
+{
+    uint8_t bytes[STORAGE_IDIVUP(SAMPLE_RUN_COUNT * STORAGE_BITSIZE + 7, 8)];
+    int cursor = bitCursor;
+
+    ASSERT(bitCursor >= 0);
+    ASSERT(pSamples != NULL);
+    ASSERT(n > 0);
+
+    for (int i = 0; i < n; i += SAMPLE_RUN_COUNT) {
+        int count = ((n - i) < SAMPLE_RUN_COUNT) ? (n - i) : SAMPLE_RUN_COUNT;
+        int byteOffset = EEPROM_ABSOLUTE_FIRST_BYTE_OFFSET + cursor / 8;
+        int bitAlignment = cursor % 8;
+
+        Chip_EEPROM_Read(NSS_EEPROM, byteOffset, bytes, STORAGE_IDIVUP(count * STORAGE_BITSIZE + bitAlignment, 8));
+        UnpackSamples(pSamples + i, bytes, bitAlignment, count);
+        cursor += count * STORAGE_BITSIZE;
+    }
+}
+
+#if STORAGE_FIELD_COUNT > 1
+/**
+ * Converts the LSBits of an accumulator to a field value.
+ * @param bits The field value is taken from the LSBits. The other bits are disregarded.
+ * @param bitSize The bit size of the field. Must be in the range [1, 24].
+ * @return The field value. The bits above @c bitSize are set to @c 0, or to the sign bit if #STORAGE_SIGNED is set.
+ */
+static STORAGE_FIELD_TYPE ToField(uint32_t bits, const int bitSize)
+{
+#if STORAGE_SIGNED
+    return (STORAGE_FIELD_TYPE)((int32_t)(bits << (32 - bitSize)) >> (32 - bitSize));
+#else
+    return (STORAGE_FIELD_TYPE)(bits & ((1U << bitSize) - 1));
+#endif
+}
+
+/**
+ * Adds a value to a bit buffer.
+ * @param pTo The buffer to copy to. The bits to copy to must be @c 0.
+ * @param bitCursor Must be positive. The position of the first bit to copy to.
+ * @param value Only the @c bitCount LSBits are copied.
+ * @param bitCount Must be in the range [1, 24].
+ */
+static void OrBits(uint8_t * pTo, const int bitCursor, uint32_t value, const int bitCount)
+{
+    const int shift = bitCursor % 8;
+
+    pTo += bitCursor / 8;
+    value = (value & ((1U << bitCount) - 1)) << shift;
+    for (int b = 0; b < bitCount + shift; b += 8) {
+        *pTo++ |= (uint8_t)value;
+        value >>= 8;
+    }
+}
+
+/**
+ * Copies a value from a bit buffer.
+ * @param pFrom The buffer to copy from.
+ * @param bitCursor Must be positive. The position of the first bit to copy.
+ * @param bitCount Must be in the range [1, 24].
+ * @return The value, in the @c bitCount LSBits. The other bits are @c 0.
+ */
+static uint32_t GetBits(const uint8_t * pFrom, const int bitCursor, const int bitCount)
+{
+    const int shift = bitCursor % 8;
+    uint32_t bits = 0;
+
+    pFrom += bitCursor / 8;
+    for (int b = 0; b < bitCount + shift; b += 8) {
+        bits |= (uint32_t)*pFrom++ << b;
+    }
+    return (bits >> shift) & ((1U << bitCount) - 1);
+}
+
+/**
+ * Copies the block of records stored in EEPROM to planes: first the first field of all records, then the second field
+ * of all records, and so on. Each plane is packed without padding bits, using the bit size of its field; the planes
+ * are placed back to back.
+ * @pre EEPROM is initialized, and contains #STORAGE_BLOCK_SIZE_IN_SAMPLES records from its first bit onwards.
+ * @param pPlanes May not be @c NULL. Room for #STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES bytes.
+ * @post #sInstance is not touched.
+ */
+static void TransposeToPlanes(uint8_t * pPlanes)
+{
+    STORAGE_TYPE records[SAMPLE_RUN_COUNT];
+    int planeCursors[STORAGE_FIELD_COUNT];
+    int planeStart = 0;
+
+    for (int f = 0; f < STORAGE_FIELD_COUNT; f++) {
+        planeCursors[f] = planeStart;
+        planeStart += STORAGE_BLOCK_SIZE_IN_SAMPLES * sFieldBitSizes[f];
+    }
+    memset(pPlanes, 0, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+
+    for (int i = 0; i < STORAGE_BLOCK_SIZE_IN_SAMPLES; i += SAMPLE_RUN_COUNT) {
+        int count = ((STORAGE_BLOCK_SIZE_IN_SAMPLES - i) < SAMPLE_RUN_COUNT) ? (STORAGE_BLOCK_SIZE_IN_SAMPLES - i)
+                                                                              : SAMPLE_RUN_COUNT;
+        ReadSamplesFromEeprom(i * STORAGE_BITSIZE, records, count);
+        for (int r = 0; r < count; r++) {
+            const STORAGE_FIELD_TYPE * pFields = (const STORAGE_FIELD_TYPE *)(records + r);
+            for (int f = 0; f < STORAGE_FIELD_COUNT; f++) {
+                OrBits(pPlanes, planeCursors[f], (uint32_t)pFields[f], sFieldBitSizes[f]);
+                planeCursors[f] += sFieldBitSizes[f];
+            }
+        }
+    }
+}
+
+/**
+ * Copies records from planes created by #TransposeToPlanes.
+ * @param pSamples May not be @c NULL. Receives the records, sign extended per field if #STORAGE_SIGNED is set.
+ * @param pPlanes May not be @c NULL. The planes of one block.
+ * @param first The index in the block of the first record to copy.
+ * @param n Must be strict positive. The number of records to copy.
+ */
+static void UnpackPlanes(STORAGE_TYPE * pSamples, const uint8_t * pPlanes, const int first, const int n)
+{
+    int planeStart = 0;
+
+    ASSERT((first >= 0) && (n > 0) && (first + n <= STORAGE_BLOCK_SIZE_IN_SAMPLES));
+    for (int f = 0; f < STORAGE_FIELD_COUNT; f++) {
+        const int bitSize = sFieldBitSizes[f];
+        int cursor = planeStart + first * bitSize;
+        for (int i = 0; i < n; i++) {
+            ((STORAGE_FIELD_TYPE *)(pSamples + i))[f] = ToField(GetBits(pPlanes, cursor, bitSize), bitSize);
+            cursor += bitSize;
+        }
+        planeStart += STORAGE_BLOCK_SIZE_IN_SAMPLES * bitSize;
+    }
+}
+#endif
+
 /* ------------------------------------------------------------------------- */
 
 /**
@@ -1031,19 +1464,39 @@ static int GetEepromCount(void)
     return sInstance.eepromBitCursor / STORAGE_BITSIZE;
 }
 
-/** @return The number of samples stored in FLASH. */
-static int GetFlashCount(void)
+/**
+ * Adds the (compressed) data blocks in FLASH that are not yet present in #sDirectory. Only the headers of these blocks
+ * are read: after #Storage_Init all blocks, later on only the newly moved block.
+ * @post @c sDirectory.endCursor equals @c sInstance.flashByteCursor
+ */
+static void UpdateDirectory(void)
 {
-    int sequenceCount = 0;
-    /* Loop over all the (compressed) data blocks in FLASH - each is storing the same amount of samples. */
-    int readCursor = 0;
-    while (readCursor < sInstance.flashByteCursor) {
-        uint8_t * header = FLASH_CURSOR_TO_BYTE_ADDRESS(readCursor);
+    while (sDirectory.endCursor < sInstance.flashByteCursor) {
+        if ((sDirectory.blockCount % sDirectory.stride) == 0) {
+            if (sDirectory.entryCount == STORAGE_BLOCK_DIRECTORY_SIZE) {
+                /* Keep the even entries only. The block to add is then at a multiple of the doubled stride. */
+                for (int i = 1; i < STORAGE_BLOCK_DIRECTORY_SIZE / 2; i++) {
+                    sDirectory.entries[i] = sDirectory.entries[2 * i];
+                }
+                sDirectory.entryCount = STORAGE_BLOCK_DIRECTORY_SIZE / 2;
+                sDirectory.stride *= 2;
+            }
+            sDirectory.entries[sDirectory.entryCount] = (uint16_t)sDirectory.endCursor;
+            sDirectory.entryCount++;
+        }
+        uint8_t * header = FLASH_CURSOR_TO_BYTE_ADDRESS(sDirectory.endCursor);
         int bitCount = (int)(header[0] | (header[1] << 8));
-        sequenceCount += STORAGE_BLOCK_SIZE_IN_SAMPLES;
-        readCursor += FLASH_BLOCK_SIZE(bitCount);
+        sDirectory.endCursor += FLASH_BLOCK_SIZE(bitCount);
+        sDirectory.blockCount++;
     }
-    return sequenceCount;
+}
+
+/** @return The number of samples stored in FLASH. */
+static int GetFlashCount(void)
+{
+    /* Each (compressed) data block in FLASH is storing the same amount of samples. */
+    UpdateDirectory();
+    return sDirectory.blockCount * STORAGE_BLOCK_SIZE_IN_SAMPLES;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -1124,10 +1577,19 @@ static int StoreSamplesInEeprom(const STORAGE_TYPE * pSamples, int n)
              * The if test above only tests for equality, so we will not needlessly try again on each added sample.
              */
         }
-        if (GetEepromCount() < STORAGE_MAX_BLOCK_SIZE_IN_SAMPLES) {
-            WriteToEeprom(sInstance.eepromBitCursor, pSamples + count, STORAGE_BITSIZE);
-            sInstance.eepromBitCursor += STORAGE_BITSIZE;
-            count++;
+        /* Write as many samples as possible at once, up to the next move to FLASH - or up to the end of EEPROM if an
+         * earlier move failed.
+         */
+        int limit = (GetEepromCount() < STORAGE_BLOCK_SIZE_IN_SAMPLES) ? STORAGE_BLOCK_SIZE_IN_SAMPLES
+                                                                        : STORAGE_MAX_BLOCK_SIZE_IN_SAMPLES;
+        int run = limit - GetEepromCount();
+        if (run > n - count) {
+            run = n - count;
+        }
+        if (run > 0) {
+            WriteSamplesToEeprom(sInstance.eepromBitCursor, pSamples + count, run);
+            sInstance.eepromBitCursor += run * STORAGE_BITSIZE;
+            count += run;
         }
         else {
             /* The EEPROM is fully filled with samples, and an earlier call to move data from EEPROM to FLASH failed
@@ -1171,6 +1633,7 @@ static bool MoveSamplesFromEepromToFlash(void)
     else {
         bool success;
         uint8_t * pOut = STORAGE_WORKAREA;
+        PROFILE_BEGIN(PROFILE_ID_STORAGE_MOVE);
 
         sInstance.cachedBlockOffset = -1;
 
@@ -1201,6 +1664,18 @@ static bool MoveSamplesFromEepromToFlash(void)
         /* c: The compress algorithm is to store the new (compressed) data block output just after the just copied data.
          * Skip the meta data header for now: that is filled in when the compression completed.
          */
+#if STORAGE_FIELD_COUNT > 1
+        /* Records are compressed - or stored - per field: the planes are placed after the pages to flash. */
+        uint8_t * pPlanes = STORAGE_WORKAREA + PLANES_WORKAREA_OFFSET;
+        TransposeToPlanes(pPlanes);
+        int bitCount = STORAGE_COMPRESS_CB(pPlanes, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS,
+                                           pOut + FLASH_DATA_HEADER_SIZE);
+        if ((bitCount <= 0) || (bitCount >= STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS)) {
+            /* Compression failed, or resulted in a larger block size: store the planes unaltered. */
+            memcpy(pOut + FLASH_DATA_HEADER_SIZE, pPlanes, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
+            bitCount = STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS;
+        }
+#else
         int bitCount = STORAGE_COMPRESS_CB(EEPROM_ABSOLUTE_FIRST_BYTE_OFFSET, STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS,
                                            pOut + FLASH_DATA_HEADER_SIZE);
         if ((bitCount <= 0) || (bitCount >= STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS)) {
@@ -1211,6 +1686,7 @@ static bool MoveSamplesFromEepromToFlash(void)
                              STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES);
             bitCount = STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS;
         }
+#endif
         int compressedDataSizeInBytes = STORAGE_IDIVUP(bitCount, 8);
 
         /* h: */
@@ -1246,8 +1722,9 @@ static bool MoveSamplesFromEepromToFlash(void)
             /* Update variables used when reading samples. */
             if (sInstance.readLocation == LOCATION_EEPROM) {
                 if (sInstance.readCursor < STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS) {
+                    /* The new block is not yet counted: its first sample has the sequence number GetFlashCount(). */
                     sInstance.readLocation = LOCATION_FLASH;
-                    sInstance.readSequence = GetFlashCount() - STORAGE_BLOCK_SIZE_IN_SAMPLES;
+                    sInstance.readSequence = GetFlashCount();
                     sInstance.readCursor = sInstance.flashByteCursor;
                 }
                 else {
@@ -1260,6 +1737,7 @@ static bool MoveSamplesFromEepromToFlash(void)
             }
             /* Only update flashByteCursor after updating readCursor & readSequence */
             sInstance.flashByteCursor = newFlashByteCursor;
+            UpdateDirectory();
 
             /* Now that everything has been copied from EEPROM to FLASH, the new marker is to be written at the
              * beginning of the assigned EEPROM space.
@@ -1276,6 +1754,7 @@ static bool MoveSamplesFromEepromToFlash(void)
             WriteToEeprom(oldEepromBitCursor, zeroMarker, sizeof(Marker_t) * 8);
         }
 
+        PROFILE_END(PROFILE_ID_STORAGE_MOVE);
         return success;
     }
 #endif
@@ -1426,6 +1905,16 @@ void Storage_Init(void)
 {
 #if !STORAGE_FLASH_FIRST_PAGE
     sStorageFlashFirstPage = ((int)&_etext + (int)&_edata - (int)&_data + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE;
+#endif
+#if STORAGE_FIELD_COUNT > 1
+    int bitSizeSum = 0;
+    for (int f = 0; f < STORAGE_FIELD_COUNT; f++) {
+        ASSERT((sFieldBitSizes[f] >= 1) && (sFieldBitSizes[f] <= 24)
+               && (sFieldBitSizes[f] <= sizeof(STORAGE_FIELD_TYPE) * 8));
+        bitSizeSum += sFieldBitSizes[f];
+    }
+    ASSERT(bitSizeSum == STORAGE_BITSIZE); /* Adjust STORAGE_BITSIZE or STORAGE_FIELD_BITSIZES. */
+    (void)bitSizeSum; /* ASSERT generates no code in a release build. */
 #endif
     ResetInstance();
 
@@ -1503,6 +1992,8 @@ void Storage_Init(void)
 
 void Storage_DeInit(void)
 {
+    PROFILE_BEGIN(PROFILE_ID_STORAGE_FLUSH);
+
     /* Write the marker, but only when samples have been added or when the module has been reset - to avoid hitting
      * the max write cycles of the EEPROM.
      */
@@ -1529,6 +2020,7 @@ void Storage_DeInit(void)
 
     spRecoverInfo->eepromBitCursor = (unsigned int)sInstance.eepromBitCursor & 0x7FFF;
     Chip_PMU_SetRetainedData((uint32_t *)sCache, STORAGE_FIRST_ALON_REGISTER, 5 - STORAGE_FIRST_ALON_REGISTER);
+    PROFILE_END(PROFILE_ID_STORAGE_FLUSH);
 }
 
 int Storage_GetCount(void)
@@ -1690,32 +2182,27 @@ bool Storage_Seek(int n)
 
     if (n < 0) { return false; }
 
-    int currentSequence = -1;
-    int currentCursor = -1;
-    int nextSequence = 0;
-    int nextCursor = 0;
+    int nextSequence = GetFlashCount();
+    int nextCursor;
 
-    /* Step through the (compressed) blocks in FLASH, counting the number of samples stored in there.
-     * If the count surpasses n we have found a block where the requested sample is stored in.
-     * - The cursor variables below indicate a byte offset in FLASH.
-     * - The sequence variables below indicate a sequence count.
-     */
-    while (nextCursor < sInstance.flashByteCursor) {
-        currentSequence = nextSequence;
-        currentCursor = nextCursor;
-        uint8_t * header = FLASH_CURSOR_TO_BYTE_ADDRESS(nextCursor);
-
-        int bitCount = (int)(header[0] | (header[1] << 8));
-        nextSequence += STORAGE_BLOCK_SIZE_IN_SAMPLES;
-        nextCursor += FLASH_BLOCK_SIZE(bitCount);
-        ASSERT((nextCursor & 0x3) == 0); /* Must be 32-bit word-aligned. */
-        if ((currentSequence <= n) && (n < nextSequence)) {
-            break;
+    if (n < nextSequence) {
+        /* Jump to the closest block in the directory, then step through the block headers up to the (compressed) block
+         * in FLASH where the requested sample is stored in.
+         * - The cursor variable below indicates a byte offset in FLASH.
+         * - The block variables below indicate a block number.
+         */
+        int block = n / STORAGE_BLOCK_SIZE_IN_SAMPLES;
+        int currentBlock = (block / sDirectory.stride) * sDirectory.stride;
+        int currentCursor = sDirectory.entries[block / sDirectory.stride];
+        while (currentBlock < block) {
+            uint8_t * header = FLASH_CURSOR_TO_BYTE_ADDRESS(currentCursor);
+            int bitCount = (int)(header[0] | (header[1] << 8));
+            currentCursor += FLASH_BLOCK_SIZE(bitCount);
+            currentBlock++;
         }
-    }
-    if ((currentSequence <= n) && (n < nextSequence)) {
+        ASSERT((currentCursor & 0x3) == 0); /* Must be 32-bit word-aligned. */
         sInstance.readLocation = LOCATION_FLASH;
-        sInstance.readSequence = currentSequence;
+        sInstance.readSequence = block * STORAGE_BLOCK_SIZE_IN_SAMPLES;
         sInstance.readCursor = currentCursor;
     }
     else {
@@ -1763,17 +2250,23 @@ int Storage_Read(STORAGE_TYPE * samples, int n)
         if (sInstance.readLocation == LOCATION_FLASH) {
             int blockSize = ReadAndCacheSamplesFromFlash(sInstance.readCursor);
             while (blockSize && (count < n) && (sInstance.readCursor < sInstance.flashByteCursor)) {
-                while ((count < n) && (sInstance.readSequence + STORAGE_BLOCK_SIZE_IN_SAMPLES > sInstance.targetSequence)) {
+                /* Copy all requested samples still available in this block at once. */
+                int run = sInstance.readSequence + STORAGE_BLOCK_SIZE_IN_SAMPLES - sInstance.targetSequence;
+                if (run > n - count) {
+                    run = n - count;
+                }
+                if (run > 0) {
+#if STORAGE_FIELD_COUNT > 1
+                    /* Blocks in FLASH hold planes, not records. */
+                    UnpackPlanes(samples + count, STORAGE_WORKAREA, sInstance.targetSequence - sInstance.readSequence,
+                                 run);
+#else
                     /* Determine the offset in bytes and the initial number of LSBits to ignore. */
                     int bitOffset = (sInstance.targetSequence - sInstance.readSequence) * STORAGE_BITSIZE;
-                    int byteOffset = bitOffset / 8;
-                    int bitAlignment = bitOffset % 8;
-
-                    ShiftUnalignedData((uint8_t *)(samples + count), STORAGE_WORKAREA + byteOffset, bitAlignment,
-                                       STORAGE_BITSIZE);
-                    bitOffset += STORAGE_BITSIZE;
-                    count++;
-                    sInstance.targetSequence++;
+                    UnpackSamples(samples + count, STORAGE_WORKAREA + bitOffset / 8, bitOffset % 8, run);
+#endif
+                    count += run;
+                    sInstance.targetSequence += run;
                 }
                 if (sInstance.readSequence + STORAGE_BLOCK_SIZE_IN_SAMPLES <= sInstance.targetSequence) {
                     /* A next sample is available in EEPROM or in the next (compressed) block of data in FLASH. */
@@ -1792,13 +2285,17 @@ int Storage_Read(STORAGE_TYPE * samples, int n)
         }
 
         if (sInstance.readLocation == LOCATION_EEPROM) {
-            while ((count < n) && (sInstance.readCursor < sInstance.eepromBitCursor)) {
-                ReadFromEeprom((unsigned int)sInstance.readCursor, samples + count, STORAGE_BITSIZE);
-                count++;
-                sInstance.readSequence++;
-                sInstance.readCursor += STORAGE_BITSIZE;
-                sInstance.targetSequence++;
-            };
+            int run = (sInstance.eepromBitCursor - sInstance.readCursor) / STORAGE_BITSIZE;
+            if (run > n - count) {
+                run = n - count;
+            }
+            if (run > 0) {
+                ReadSamplesFromEeprom(sInstance.readCursor, samples + count, run);
+                count += run;
+                sInstance.readSequence += run;
+                sInstance.readCursor += run * STORAGE_BITSIZE;
+                sInstance.targetSequence += run;
+            }
 
 #if STORAGE_SAMPLE_ALON_CACHE_COUNT > 0
             if (sInstance.readCursor >= sInstance.eepromBitCursor) {
@@ -1821,12 +2318,6 @@ int Storage_Read(STORAGE_TYPE * samples, int n)
 #endif
     }
 
-#if STORAGE_SIGNED
-    /* STORAGE_TYPE is signed: propagate the bit at position STORAGE_BITSIZE to the left */
-    int msbits = sizeof(STORAGE_TYPE) * 8 - STORAGE_BITSIZE;
-    for (int i = 0; i < count; i++) {
-        samples[i] = (STORAGE_TYPE)((STORAGE_TYPE)(samples[i] << msbits) >> msbits);
-    }
-#endif
+    /* If STORAGE_TYPE is signed, UnpackSamples has already propagated the bit at position STORAGE_BITSIZE. */
     return count;
 }
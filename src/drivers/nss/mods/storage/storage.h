@@ -52,6 +52,13 @@
  *  few samples may get lost. The number is dependent on the number of the reserved general purpose registers and the
  *  size of a sample, both of which (and more) can be tweaked using diversity settings.
  *
+ * @par Records
+ *  A sample can also be a record of up to 16 fields, e.g. the three axes of an accelerometer - see
+ *  #STORAGE_FIELD_COUNT. Each field keeps its own bit size and sign. Records are written and read as a whole; in EEPROM
+ *  they are placed back to back like any sample. Before a block is compressed and moved to FLASH, it is transposed into
+ *  one plane per field, so that the compress callback sees each channel as a series of its own. Interleaving the
+ *  channels as separate samples instead makes neighbouring values unrelated, which defeats most compression schemes.
+ *
  *
  * @par Diversity
  *  This module supports diversity settings. Some settings define the type and size of the sample. Others define the
@@ -118,6 +125,26 @@
  */
 typedef int (*pStorage_CompressCb_t)(int eepromByteOffset, int bitCount, void * pOut);
 
+/**
+ * Replaces #pStorage_CompressCb_t when #STORAGE_FIELD_COUNT is larger than 1. The samples are not handed over in
+ * EEPROM, but in SRAM, already transposed into planes: first the first field of all #STORAGE_BLOCK_SIZE_IN_SAMPLES
+ * records, then the second field of all records, and so on. Within each plane, the values are packed together, i.e.
+ * without any padding bits, using the bit size of that field as given in #STORAGE_FIELD_BITSIZES. The planes
+ * themselves are packed together as well.
+ * @param pPlanes A pointer to SRAM where the planes are stored.
+ * @param bitCount The total size of all planes. This argument will @b always equal
+ *  @c #STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS.
+ * @param pOut A pointer to SRAM where the compressed data must be stored in. The buffer has a size of
+ *  @c #STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES bytes.
+ * @return The size of the compressed data @b in @b bits. When @c 0 is returned, or a value bigger than or equal to
+ *  @c #STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS, the planes will be stored uncompressed instead, and the corresponding
+ *  decompression callback of type #pStorage_DecompressCb_t will not be called when reading out the data later.
+ *  The decompression callback must restore the planes, not the records.
+ * @warning It is @b not allowed to call any function of this module during the lifetime of the callback.
+ * @see STORAGE_COMPRESS_CB
+ */
+typedef int (*pStorage_CompressPlanesCb_t)(const uint8_t * pPlanes, int bitCount, void * pOut);
+
 /**
  * Whenever data is read from FLASH, the application is notified via a callback of this prototype. It then has a chance
  * to decompress the data before it is used to fulfill the read request #Storage_Read.
@@ -125,7 +152,8 @@ typedef int (*pStorage_CompressCb_t)(int eepromByteOffset, int bitCount, void *
  * - reading the data from FLASH using @c data as starting point,
  * - decompressing one block of compressed data stored from that point with size @c bitCount,
  * - storing the end result - #STORAGE_BLOCK_SIZE_IN_SAMPLES samples - in @c out. The samples @b must be written
- *  packed together, i.e. without any padding bits.
+ *  packed together, i.e. without any padding bits. When #STORAGE_FIELD_COUNT is larger than 1, the planes as given to
+ *  the #pStorage_CompressPlanesCb_t callback must be written instead.
  * @param pData The absolute byte address to FLASH memory where the start of the (compressed) data block is found.
  * @param bitCount The size in bits of the (compressed) data block.
  * @param pOut A pointer to SRAM where the compressed data must be stored in. The buffer has a size of
@@ -194,7 +222,8 @@ void Storage_Reset(bool checkFlash);
  * Stores @c n samples.
  * @pre EEPROM is initialized
  * @param pSamples Pointer to the start of the array where to copy the samples from. For each element of the array,
- *  only the #STORAGE_BITSIZE LSBits are copied.
+ *  only the #STORAGE_BITSIZE LSBits are copied. When #STORAGE_FIELD_COUNT is larger than 1, each element is a record:
+ *  for each field, only the LSBits given by #STORAGE_FIELD_BITSIZES are copied.
  * @param n The size of the array @c pSamples points to, in number of #STORAGE_TYPE elements.
  * @return The number of samples written. This value may be @c 0 or any number of samples less than or equal to @c n.
  * @note When a value less than @c n is returned, at least one of these errors occurred:
@@ -226,7 +255,8 @@ bool Storage_Seek(int n);
  * @note Multiple reads can be issued after calling #Storage_Seek once, each time fetching samples in sequence.
  * @param [out] pSamples : Pointer to an array of @n elements, where the read samples are copied to. Upon successful
  *  completion, each element will contain one sample, where only the #STORAGE_BITSIZE LSBits are used per
- *  element; the remainder MSBits are set to 0.
+ *  element; the remainder MSBits are set to 0 - or to the sign bit, see #STORAGE_SIGNED. When #STORAGE_FIELD_COUNT
+ *  is larger than 1, the same applies to each field of each record.
  * @param n : The size of the array @c samples points to, in number of #STORAGE_TYPE elements.
  * @return The number of samples read. This value may be @c 0 or any number of samples less than @c n.
  *  The remainder of the elements with a higher index may have been written to, but must be ignored.
@@ -42,9 +42,13 @@
  * - #STORAGE_TYPE
  * - #STORAGE_BITSIZE
  * - #STORAGE_SIGNED
+ * - #STORAGE_FIELD_COUNT
+ * - #STORAGE_FIELD_TYPE
+ * - #STORAGE_FIELD_BITSIZES
  * - #STORAGE_WORKAREA
  * - #STORAGE_WRITE_RECOVERY_EVERY_X_SAMPLES
  * - #STORAGE_BLOCK_SIZE_IN_SAMPLES
+ * - #STORAGE_BLOCK_DIRECTORY_SIZE
  * - #STORAGE_REDUCE_RECOVERY_WRITES
  * - #STORAGE_COMPRESS_CB
  * - #STORAGE_DECOMPRESS_CB
@@ -88,6 +92,12 @@
  *      - #STORAGE_TYPE
  *      - #STORAGE_BITSIZE
  *      - #STORAGE_SIGNED
+ *      When several channels are logged together, e.g. the three axes of an accelerometer, store them as one record
+ *      per sample instead of interleaving them as separate samples: each field then gets its own bit size, and each
+ *      channel is compressed as a series of its own.
+ *      - #STORAGE_FIELD_COUNT
+ *      - #STORAGE_FIELD_TYPE
+ *      - #STORAGE_FIELD_BITSIZES
  *
  *      Compression greatly increases the number of samples that can be stored, at the cost of the size of the
  *      compression library itself. Normally, the compression ratio is greater when more samples are compressed at
@@ -295,12 +305,71 @@
      *  when reading out samples from EEPROM or FLASH, this bit will be propagated left up to the MSBit of
      *  #STORAGE_TYPE.
      * - If not defined, the MSBits at positions #STORAGE_BITSIZE and up will be set to @c 0.
-     * @warning Setting this diversity flag to 1 while #STORAGE_TYPE is a structure, while raise compiler errors.
+     * When #STORAGE_FIELD_COUNT is larger than 1, this applies to each field of a record instead: the sign bit of each
+     * field is then at position @code (bit size of the field - 1) @endcode, and is propagated up to the MSBit of
+     * #STORAGE_FIELD_TYPE.
+     * @warning Setting this diversity flag to 1 while #STORAGE_TYPE is a structure, while raise compiler errors -
+     *  unless #STORAGE_FIELD_COUNT is larger than 1.
      * see #Storage_Read.
      */
     #define STORAGE_SIGNED 0
 #endif
 
+#ifndef STORAGE_FIELD_COUNT
+    /**
+     * The number of fields in one sample.
+     * - With the default value of @c 1, a sample is a single value: the #STORAGE_BITSIZE LSBits of #STORAGE_TYPE.
+     * - With a larger value, a sample is a record: #STORAGE_TYPE is then a structure - or an array - consisting of
+     *  exactly this number of members of type #STORAGE_FIELD_TYPE, without padding. Per field, the number of LSBits
+     *  given in #STORAGE_FIELD_BITSIZES is stored, and #STORAGE_BITSIZE must equal the sum of these bit sizes.
+     *  @n Records are stored back to back in EEPROM, as single values are. Before a block is compressed and moved to
+     *  FLASH, it is transposed into planes: first the first field of all records in the block, then the second field
+     *  of all records, and so on. Each plane then holds a single channel that varies smoothly, instead of unrelated
+     *  channels that alternate. #STORAGE_COMPRESS_CB is given the planes: see #pStorage_CompressPlanesCb_t.
+     *  #Storage_Write and #Storage_Read still handle whole records.
+     */
+    #define STORAGE_FIELD_COUNT 1
+#endif
+#if (STORAGE_FIELD_COUNT < 1) || (STORAGE_FIELD_COUNT > 16)
+    #error STORAGE_FIELD_COUNT must be in the range [1, 16]
+#endif
+#if (STORAGE_FIELD_COUNT > 1) && (!defined(STORAGE_FIELD_TYPE) || !defined(STORAGE_FIELD_BITSIZES))
+    #error STORAGE_FIELD_TYPE and STORAGE_FIELD_BITSIZES must be defined when STORAGE_FIELD_COUNT is larger than 1
+#endif
+#if (STORAGE_FIELD_COUNT > 1) && (STORAGE_BITSIZE > STORAGE_FIELD_COUNT * 24)
+    #error Invalid value for STORAGE_BITSIZE: it must equal the sum of STORAGE_FIELD_BITSIZES
+#endif
+
+/* Diversity flags below are undefined by default. They are wrapped in a DOXYGEN precompilation flag to enable
+ * documenting them properly. They are only used when #STORAGE_FIELD_COUNT is larger than 1.
+ */
+#ifdef __DOXYGEN__
+#error This block of code may not be parsed using gcc.
+
+/**
+ * The type of each field of a record. When writing, each #STORAGE_TYPE record given is read as an array of
+ * #STORAGE_FIELD_COUNT fields of this type; when reading, each record is filled in this way.
+ * @note Must be an integer type of at most 32 bits.
+ */
+#define STORAGE_FIELD_TYPE
+
+/**
+ * The bit sizes of the fields of a record, in order, as a comma separated list of #STORAGE_FIELD_COUNT integer
+ * constants. Each bit size must be in the range [1, 24], and may not exceed the size of #STORAGE_FIELD_TYPE.
+ * @par Example: a record with three accelerometer axes of 11 bits, and a 6-bit temperature delta
+ *  @code
+ *      typedef struct {int16_t x; int16_t y; int16_t z; int16_t temperature;} APP_RECORD_T;
+ *      #define STORAGE_TYPE APP_RECORD_T
+ *      #define STORAGE_FIELD_COUNT 4
+ *      #define STORAGE_FIELD_TYPE int16_t
+ *      #define STORAGE_FIELD_BITSIZES 11, 11, 11, 6
+ *      #define STORAGE_BITSIZE 39
+ *      #define STORAGE_SIGNED 1
+ *  @endcode
+ */
+#define STORAGE_FIELD_BITSIZES
+#endif
+
 /* ------------------------------------------------------------------------- */
 
 #ifndef STORAGE_WRITE_RECOVERY_EVERY_X_SAMPLES
@@ -391,14 +460,36 @@
     #error Invalid value for STORAGE_BLOCK_SIZE_IN_SAMPLES
 #endif
 
+#ifndef STORAGE_BLOCK_DIRECTORY_SIZE
+    /**
+     * The number of FLASH locations of (compressed) blocks of samples that are remembered in SRAM, to find the block
+     * holding a given sample without reading all block headers. Each location takes 2 bytes.
+     * When more blocks are stored, only every second, fourth, ... block location is remembered. Finding a block then
+     * requires reading at most one, three, ... block headers.
+     * @note Must be an even number.
+     */
+    #define STORAGE_BLOCK_DIRECTORY_SIZE 32
+#endif
+#if (STORAGE_BLOCK_DIRECTORY_SIZE < 2) || ((STORAGE_BLOCK_DIRECTORY_SIZE % 2) != 0)
+    #error Invalid value for STORAGE_BLOCK_DIRECTORY_SIZE
+#endif
+
 /** Defines the number of bits required to store one block of samples. */
 #define STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS (STORAGE_BLOCK_SIZE_IN_SAMPLES * STORAGE_BITSIZE)
 
 /** Defines the number of bytes required to store one block of samples. */
 #define STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES STORAGE_IDIVUP(STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BITS, 8)
 
-/** The size in bytes of the required memory for this module */
-#define STORAGE_WORKAREA_SIZE ((FLASH_PAGE_SIZE * 2) + STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES)
+/**
+ * The size in bytes of the required memory for this module. When #STORAGE_FIELD_COUNT is larger than 1, one more
+ * block is reserved to hold the planes to compress.
+ * @hideinitializer
+ */
+#if STORAGE_FIELD_COUNT > 1
+    #define STORAGE_WORKAREA_SIZE ((FLASH_PAGE_SIZE * 2) + 2 * STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES)
+#else
+    #define STORAGE_WORKAREA_SIZE ((FLASH_PAGE_SIZE * 2) + STORAGE_UNCOMPRESSED_BLOCK_SIZE_IN_BYTES)
+#endif
 
 #ifdef STORAGE_WORKAREA
     #undef STORAGE_WORKAREA_SELF_DEFINED
@@ -425,7 +516,8 @@
     /**
      * The name of the function - @b not a function pointer - of type #pStorage_CompressCb_t that is able to
      * compress #STORAGE_BLOCK_SIZE_IN_SAMPLES packed samples of type #STORAGE_TYPE where #STORAGE_BITSIZE bits
-     * are retained for each.
+     * are retained for each. When #STORAGE_FIELD_COUNT is larger than 1, the function must be of type
+     * #pStorage_CompressPlanesCb_t instead.
      * @note When not overridden, the default behavior is to store the data uncompressed, i.e. the data is copied from
      *  EEPROM to FLASH unmodified.
      * @hideinitializer
@@ -439,7 +531,7 @@
     /**
      * The name of the function - @b not a function pointer - of type #pStorage_DecompressCb_t that is able to
      * decompress #STORAGE_BLOCK_SIZE_IN_SAMPLES packed samples of type #STORAGE_TYPE where #STORAGE_BITSIZE bits
-     * are retained for each.
+     * are retained for each - or, when #STORAGE_FIELD_COUNT is larger than 1, their planes.
      * @hideinitializer
      */
     #define STORAGE_DECOMPRESS_CB Storage_DummyDecompressCb
@@ -133,6 +133,9 @@ int TMeas_Measure(TSEN_RESOLUTION_T resolution, TMEAS_FORMAT_T format, bool sync
 #endif
         {
             while (!(Chip_TSen_ReadStatus(NSS_TSEN, NULL) & TSEN_STATUS_MEASUREMENT_DONE)) {
+#if defined(NSS_SIM)
+                Sim_Poll();
+#endif
                 ; /* wait */
             }
             /* The remaining (RANGE) status bits, even when set, should not invalidate the temperature measurement,
@@ -0,0 +1,451 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sim_model.h"
+
+/* ------------------------------------------------------------------------- */
+
+/** Number of interrupt lines of the NVIC. */
+#define NVIC_IRQ_COUNT 32
+
+/** The virtual time is advanced with this amount when the firmware busy waits while nothing is scheduled. */
+#define POLL_QUANTUM_NS (1 * SIM_NS_PER_US)
+
+/** Reset value of SYSCON SYSCLKCTRL: the system clock divider is 16, giving 500 kHz. */
+#define SYSCLKCTRL_RESET_VALUE (4 << 1)
+
+/** Offset of the NFC UID in EEPROM, see #NSS_NFC_UID_BASE */
+#define NFC_UID_OFFSET 0xF9C
+
+/* ------------------------------------------------------------------------- */
+
+__attribute__((aligned(4))) uint8_t Sim_EepromMemory[EEPROM_NR_OF_R_ROWS * EEPROM_ROW_SIZE];
+__attribute__((aligned(4))) uint8_t Sim_FlashMemory[FLASH_NR_OF_R_SECTORS * FLASH_SECTOR_SIZE];
+NSS_I2C_T Sim_I2c;
+NSS_WWDT_T Sim_Wwdt;
+NSS_TIMER_T Sim_Timer16_0;
+NSS_TIMER_T Sim_Timer32_0;
+NSS_ADCDAC_T Sim_Adcdac0;
+NSS_FLASH_T Sim_Flash;
+NSS_EEPROM_T Sim_Eeprom;
+NSS_PMU_T Sim_Pmu;
+NSS_SSP_T Sim_Ssp0;
+NSS_IOCON_T Sim_Iocon;
+NSS_SYSCON_T Sim_Syscon;
+NSS_RTC_T Sim_Rtc;
+NSS_NFC_T Sim_Nfc;
+NSS_TSEN_T Sim_Tsen;
+NSS_I2D_T Sim_I2d;
+NSS_GPIO_T Sim_Gpio;
+SCB_Type Sim_Scb;
+
+/** The peripheral models, stepped in this order at each synchronization point. */
+static const struct {
+    void (*reset)(void);
+    uint64_t (*step)(uint64_t now);
+} sModels[] = {
+    {Sim_Eeprom_Reset, Sim_Eeprom_Step},
+    {Sim_Flash_Reset, Sim_Flash_Step},
+    {Sim_Nfc_Reset, Sim_Nfc_Step},
+    {Sim_Rtc_Reset, Sim_Rtc_Step},
+    {Sim_Tsen_Reset, Sim_Tsen_Step},
+    {Sim_I2c_Reset, Sim_I2c_Step},
+    {Sim_Gpio_Reset, Sim_Gpio_Step},
+    {Sim_Timer_Reset, Sim_Timer_Step}
+};
+
+/** The interrupt handlers, indexed by IRQn. Default implementations are given in sim_vectors.c. */
+static void (* const sVectors[NVIC_IRQ_COUNT])(void) = {
+    PIO0_0_IRQHandler, PIO0_1_IRQHandler, PIO0_2_IRQHandler, PIO0_3_IRQHandler,
+    PIO0_4_IRQHandler, PIO0_5_IRQHandler, PIO0_6_IRQHandler, PIO0_7_IRQHandler,
+    PIO0_8_IRQHandler, PIO0_9_IRQHandler, PIO0_10_IRQHandler, RFFIELD_IRQHandler,
+    RTCPWREQ_IRQHandler, NFC_IRQHandler, RTC_IRQHandler, I2C0_IRQHandler,
+    CT16B0_IRQHandler, PMUFLD_IRQHandler, CT32B0_IRQHandler, PMUBOD_IRQHandler,
+    SSP0_IRQHandler, TSEN_IRQHandler, C2D_IRQHandler, NULL,
+    I2D_IRQHandler, ADC_IRQHandler, WDT_IRQHandler, FLASH_IRQHandler,
+    EEPROM_IRQHandler, NULL, NULL, PIO0_IRQHandler
+};
+
+static const char * const sPeripheralNames[SIM_PERIPHERAL_COUNT] = {
+    "eeprom", "flash", "nfc", "rtc", "tsen", "i2c", "gpio", "timer"
+};
+
+static uint64_t sNow; /**< Virtual time in ns */
+static uint64_t sCycles; /**< Virtual time in system clock cycles */
+static uint64_t sCycleFraction; /**< Remainder of the cycle calculation, in units of 1 / #SIM_NS_PER_S cycles */
+static uint32_t sNvicEnabled;
+static uint32_t sNvicPending;
+static uint32_t sIrqLines; /**< Current level of the interrupt request lines, to count rising edges */
+static uint8_t sNvicPriority[NVIC_IRQ_COUNT];
+static uint32_t sPrimask;
+static bool sInHandler;
+static uint32_t sDispatchCount;
+static pSim_IdleCb_t sIdleCb;
+static pSim_IdleCb_t sTimedCb;
+static uint64_t sTimedCbTime; /**< Virtual time at which #sTimedCb is due */
+static SIM_STATS_T sStats[SIM_PERIPHERAL_COUNT];
+static SIM_POWER_T sPower;
+static uint64_t * sPowerNs = &sPower.activeNs; /**< The counter of the current power mode */
+
+/* ------------------------------------------------------------------------- */
+
+static SIM_PERIPHERAL_T IrqToPeripheral(IRQn_Type irq)
+{
+    switch (irq) {
+        case EEPROM_IRQn: return SIM_PERIPHERAL_EEPROM;
+        case FLASH_IRQn: return SIM_PERIPHERAL_FLASH;
+        case NFC_IRQn: return SIM_PERIPHERAL_NFC;
+        case RTC_IRQn: return SIM_PERIPHERAL_RTC;
+        case TSEN_IRQn: return SIM_PERIPHERAL_TSEN;
+        case I2C0_IRQn: return SIM_PERIPHERAL_I2C;
+        case CT16B0_IRQn: /* fallthrough */
+        case CT32B0_IRQn: return SIM_PERIPHERAL_TIMER;
+        default: return SIM_PERIPHERAL_GPIO;
+    }
+}
+
+/** Advances the virtual time to @c to, without handling any event. */
+static void Advance(uint64_t to)
+{
+    uint64_t frequency = Sim_GetSystemClockFrequency();
+    uint64_t delta = to - sNow;
+
+    /* Split in whole seconds and a remainder to avoid overflowing 64 bits. */
+    sCycles += (delta / SIM_NS_PER_S) * frequency;
+    sCycleFraction += (delta % SIM_NS_PER_S) * frequency;
+    sCycles += sCycleFraction / SIM_NS_PER_S;
+    sCycleFraction %= SIM_NS_PER_S;
+    *sPowerNs += delta;
+    sNow = to;
+}
+
+/** Steps all models, @return the time of the first scheduled event, guaranteed to lie in the future. */
+static uint64_t StepModels(void)
+{
+    uint64_t next = SIM_NEVER;
+    for (size_t i = 0; i < sizeof(sModels) / sizeof(sModels[0]); i++) {
+        uint64_t t = sModels[i].step(sNow);
+        if (t < next) {
+            next = t;
+        }
+    }
+    if (next <= sNow) {
+        next = sNow + 1;
+    }
+    return next;
+}
+
+/** Dispatches the pending and enabled interrupts, highest priority first, until none are left. */
+static void DispatchIrqs(void)
+{
+    while (!sInHandler && !sPrimask && (sNvicPending & sNvicEnabled)) {
+        uint32_t active = sNvicPending & sNvicEnabled;
+        int irq = -1;
+        for (int i = 0; i < NVIC_IRQ_COUNT; i++) {
+            if ((active & (1u << i)) && ((irq < 0) || (sNvicPriority[i] < sNvicPriority[irq]))) {
+                irq = i;
+            }
+        }
+        sNvicPending &= ~(1u << irq);
+        if (!sVectors[irq]) {
+            Sim_Fatal("interrupt without handler");
+        }
+        uint64_t * pPowerNs = sPowerNs;
+        sPowerNs = &sPower.activeNs; /* The handler runs, even when it woke up the core. */
+        sInHandler = true;
+        sDispatchCount++;
+        sVectors[irq]();
+        sInHandler = false;
+        sPowerNs = pPowerNs;
+        (void)StepModels(); /* Apply the register writes of the handler: this may re-assert interrupt lines. */
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+void Sim_SetIrqLine(IRQn_Type irq, bool level)
+{
+    uint32_t bit = 1u << irq;
+    if (level) {
+        if (!(sIrqLines & bit)) {
+            sStats[IrqToPeripheral(irq)].irqs++;
+        }
+        sIrqLines |= bit;
+        sNvicPending |= bit;
+    }
+    else {
+        sIrqLines &= ~bit;
+    }
+}
+
+void Sim_CountOp(SIM_PERIPHERAL_T peripheral, uint64_t latencyNs)
+{
+    SIM_STATS_T * pStats = &sStats[peripheral];
+    pStats->ops++;
+    pStats->busyNs += latencyNs;
+    pStats->busyCycles += latencyNs * Sim_GetSystemClockFrequency() / SIM_NS_PER_S;
+    if (latencyNs > pStats->maxLatencyNs) {
+        pStats->maxLatencyNs = latencyNs;
+    }
+}
+
+uint64_t Sim_CyclesToNs(uint64_t cycles)
+{
+    return cycles * SIM_NS_PER_S / Sim_GetSystemClockFrequency();
+}
+
+void Sim_Fatal(const char * message)
+{
+    fprintf(stderr, "sim: fatal at t=%llu ns: %s\n", (unsigned long long)sNow, message);
+    abort();
+}
+
+/* ------------------------------------------------------------------------- */
+
+void Sim_Init(void)
+{
+    memset(Sim_EepromMemory, 0, sizeof(Sim_EepromMemory));
+    memset(Sim_FlashMemory, 0xFF, sizeof(Sim_FlashMemory));
+    memset(&Sim_I2c, 0, sizeof(Sim_I2c));
+    memset(&Sim_Wwdt, 0, sizeof(Sim_Wwdt));
+    memset(&Sim_Timer16_0, 0, sizeof(Sim_Timer16_0));
+    memset(&Sim_Timer32_0, 0, sizeof(Sim_Timer32_0));
+    memset(&Sim_Adcdac0, 0, sizeof(Sim_Adcdac0));
+    memset(&Sim_Flash, 0, sizeof(Sim_Flash));
+    memset(&Sim_Eeprom, 0, sizeof(Sim_Eeprom));
+    memset(&Sim_Pmu, 0, sizeof(Sim_Pmu));
+    memset(&Sim_Ssp0, 0, sizeof(Sim_Ssp0));
+    memset(&Sim_Iocon, 0, sizeof(Sim_Iocon));
+    memset(&Sim_Syscon, 0, sizeof(Sim_Syscon));
+    memset(&Sim_Rtc, 0, sizeof(Sim_Rtc));
+    memset(&Sim_Nfc, 0, sizeof(Sim_Nfc));
+    memset(&Sim_Tsen, 0, sizeof(Sim_Tsen));
+    memset(&Sim_I2d, 0, sizeof(Sim_I2d));
+    memset(&Sim_Gpio, 0, sizeof(Sim_Gpio));
+    memset(&Sim_Scb, 0, sizeof(Sim_Scb));
+
+    /* Reset values the drivers depend on. The PMU access status is polled like the RTC one. */
+    SIM_REG(Sim_Syscon.SYSCLKCTRL) = SYSCLKCTRL_RESET_VALUE;
+    SIM_REG(Sim_Pmu.ACCSTAT) = 1;
+
+    /* A recognizable NFC UID, as found in the read-only part of the EEPROM. */
+    static const uint8_t uid[8] = {0x04, 0x53, 0x49, 0x4D, 0x00, 0x31, 0x52, 0x80};
+    memcpy(Sim_EepromMemory + NFC_UID_OFFSET, uid, sizeof(uid));
+
+    sNow = 0;
+    sCycles = 0;
+    sCycleFraction = 0;
+    sNvicEnabled = 0;
+    sNvicPending = 0;
+    sIrqLines = 0;
+    memset(sNvicPriority, 0, sizeof(sNvicPriority));
+    sPrimask = 0;
+    sInHandler = false;
+    sDispatchCount = 0;
+    sIdleCb = NULL;
+    sTimedCb = NULL;
+    sPowerNs = &sPower.activeNs;
+    for (size_t i = 0; i < sizeof(sModels) / sizeof(sModels[0]); i++) {
+        sModels[i].reset();
+    }
+    Sim_ResetStats();
+}
+
+uint64_t Sim_GetTime(void)
+{
+    return sNow;
+}
+
+uint64_t Sim_GetCycles(void)
+{
+    return sCycles;
+}
+
+uint32_t Sim_GetSystemClockFrequency(void)
+{
+    return NSS_SFRO_FREQUENCY >> ((Sim_Syscon.SYSCLKCTRL >> 1) & 0x7);
+}
+
+void Sim_Sync(void)
+{
+    (void)StepModels();
+    DispatchIrqs();
+}
+
+void Sim_Poll(void)
+{
+    Sim_Sync();
+    uint64_t next = StepModels();
+    if (next == SIM_NEVER) {
+        next = sNow + POLL_QUANTUM_NS;
+    }
+    Advance(next);
+    Sim_Sync();
+}
+
+void Sim_Delay(uint64_t ns)
+{
+    uint64_t target = sNow + ns;
+    Sim_Sync();
+    for (;;) {
+        uint64_t next = StepModels();
+        if (next >= target) {
+            break;
+        }
+        Advance(next);
+        Sim_Sync();
+    }
+    Advance(target);
+    Sim_Sync();
+}
+
+void Sim_SetIdleCb(pSim_IdleCb_t cb)
+{
+    sIdleCb = cb;
+}
+
+void Sim_SetTimedCb(uint64_t time, pSim_IdleCb_t cb)
+{
+    sTimedCbTime = time;
+    sTimedCb = cb;
+}
+
+const SIM_STATS_T * Sim_GetStats(SIM_PERIPHERAL_T peripheral)
+{
+    ASSERT(peripheral < SIM_PERIPHERAL_COUNT);
+    return &sStats[peripheral];
+}
+
+void Sim_ResetStats(void)
+{
+    memset(sStats, 0, sizeof(sStats));
+    memset(&sPower, 0, sizeof(sPower));
+}
+
+void Sim_PrintStats(FILE * stream, const char * prefix)
+{
+    for (int i = 0; i < SIM_PERIPHERAL_COUNT; i++) {
+        const SIM_STATS_T * pStats = &sStats[i];
+        fprintf(stream, "%s%speripheral=%s ops=%lu busy_ns=%llu busy_cycles=%llu max_latency_ns=%llu irqs=%lu\n",
+                prefix ? prefix : "", prefix ? " " : "", sPeripheralNames[i], (unsigned long)pStats->ops,
+                (unsigned long long)pStats->busyNs, (unsigned long long)pStats->busyCycles,
+                (unsigned long long)pStats->maxLatencyNs, (unsigned long)pStats->irqs);
+    }
+    fprintf(stream, "%s%score=arm active_ns=%llu sleep_ns=%llu deep_sleep_ns=%llu\n", prefix ? prefix : "",
+            prefix ? " " : "", (unsigned long long)sPower.activeNs, (unsigned long long)sPower.sleepNs,
+            (unsigned long long)sPower.deepSleepNs);
+}
+
+const SIM_POWER_T * Sim_GetPower(void)
+{
+    return &sPower;
+}
+
+void Sim_AssertFailed(const char * file, int line)
+{
+    fprintf(stderr, "sim: assertion failed at %s:%d (t=%llu ns)\n", file, line, (unsigned long long)sNow);
+    abort();
+}
+
+/* ------------------------------------------------------------------------- */
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    ASSERT((IRQn >= 0) && (IRQn < NVIC_IRQ_COUNT));
+    sNvicEnabled |= 1u << IRQn;
+    DispatchIrqs();
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    ASSERT((IRQn >= 0) && (IRQn < NVIC_IRQ_COUNT));
+    sNvicEnabled &= ~(1u << IRQn);
+}
+
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+    ASSERT((IRQn >= 0) && (IRQn < NVIC_IRQ_COUNT));
+    return (sNvicPending >> IRQn) & 1;
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    ASSERT((IRQn >= 0) && (IRQn < NVIC_IRQ_COUNT));
+    sNvicPending |= 1u << IRQn;
+    DispatchIrqs();
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    ASSERT((IRQn >= 0) && (IRQn < NVIC_IRQ_COUNT));
+    sNvicPending &= ~(1u << IRQn);
+}
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    ASSERT((IRQn >= 0) && (IRQn < NVIC_IRQ_COUNT));
+    sNvicPriority[IRQn] = (uint8_t)(priority & ((1 << __NVIC_PRIO_BITS) - 1));
+}
+
+uint32_t NVIC_GetPriority(IRQn_Type IRQn)
+{
+    ASSERT((IRQn >= 0) && (IRQn < NVIC_IRQ_COUNT));
+    return sNvicPriority[IRQn];
+}
+
+void NVIC_SystemReset(void)
+{
+    Sim_Fatal("system reset requested");
+}
+
+void Sim_Core_WaitForInterrupt(void)
+{
+    uint32_t dispatchCount = sDispatchCount;
+
+    Sim_Sync();
+    sPowerNs = (Sim_Scb.SCR & SCB_SCR_SLEEPDEEP_Msk) ? &sPower.deepSleepNs : &sPower.sleepNs;
+    for (;;) {
+        /* Wake-up: an interrupt was handled, or one is pending but masked by PRIMASK or by the active handler. */
+        if ((sDispatchCount != dispatchCount) || (sNvicPending & sNvicEnabled)) {
+            sPowerNs = &sPower.activeNs;
+            return;
+        }
+        uint64_t next = StepModels();
+        if (sTimedCb && (sTimedCbTime <= next)) {
+            if (sTimedCbTime > sNow) {
+                Advance(sTimedCbTime);
+            }
+            pSim_IdleCb_t cb = sTimedCb;
+            sTimedCb = NULL;
+            cb();
+            Sim_Sync();
+            continue;
+        }
+        if (next == SIM_NEVER) {
+            if (!sIdleCb) {
+                Sim_Fatal("waiting for an interrupt that can never come");
+            }
+            pSim_IdleCb_t cb = sIdleCb;
+            sIdleCb = NULL; /* Detects a callback that does not provide a wake-up source. */
+            cb();
+            sIdleCb = cb;
+            Sim_Sync();
+            if ((sDispatchCount == dispatchCount) && !(sNvicPending & sNvicEnabled) && (StepModels() == SIM_NEVER)) {
+                Sim_Fatal("idle callback provided no wake-up source");
+            }
+            continue;
+        }
+        Advance(next);
+        Sim_Sync();
+    }
+}
+
+void Sim_Core_SetPrimask(uint32_t primask)
+{
+    sPrimask = primask & 1;
+    DispatchIrqs();
+}
+
+uint32_t Sim_Core_GetPrimask(void)
+{
+    return sPrimask;
+}
@@ -0,0 +1,352 @@
+#ifndef __SIM_H_
+#define __SIM_H_
+
+/**
+ * @defgroup SIM sim: Host-native simulation of the NHS3152
+ *
+ * When the tree is compiled with @c NSS_SIM defined, @c chip.h includes this file as its last step. All memories and
+ * peripheral register blocks are then backed by host objects instead of fixed addresses, and lib_chip_nss and the mods
+ * compile unmodified for x86 Linux. This allows the storage, event, msg, ndeft2t and compress code paths to run at
+ * host speed, e.g. in CI, without a J-Link or a board.
+ *
+ * @par Virtual time
+ *  The simulator keeps a virtual time in nanoseconds. Code that runs on the host CPU takes no virtual time: time only
+ *  advances when the firmware waits for hardware, i.e. in:
+ *  - #Chip_Clock_System_BusyWait_us and #Chip_Clock_System_BusyWait_ms
+ *  - @c __WFI, and thus the PMU power modes
+ *  - the wait loops of the drivers: EEPROM programming, I2C transfers, temperature measurements
+ *  - host side stimuli that model an external party, e.g. #Sim_Nfc_ReaderWrite
+ *  The virtual time is also expressed in system clock cycles, using the divider set in SYSCON at each moment.
+ *
+ * @par Peripheral models
+ *  The register blocks are plain memory. Each simulated peripheral is a model that inspects its register block at a
+ *  synchronization point (#Sim_Sync), applies the side effects a write has on real hardware (write-1-to-clear
+ *  registers, command registers, start bits, ...) and schedules its next event. Simulated are:
+ *  - EEPROM: erase/program timing of a row, the done flag and interrupt, a program counter per row.
+ *  - FLASH: the IAP API is replaced; erase, program, blank check and compare operate on a 32 kB host array.
+ *  - NFC: shared memory, a reader that reads and writes pages, field on/off, the interrupt flags and target address.
+ *  - RTC: the time counter and the wake-up down-counter, with a tick of one second.
+ *  - TSEN: conversion time per resolution and a host defined temperature.
+ *  - I2C: the master state machine at register level, with byte timing derived from SCLH and SCLL, talking to host
+ *    defined slave devices.
+ *  - GPIO: port data, direction, host driven input levels and edge/level interrupts.
+ *  - TIMER: CT16B0 and CT32B0 count in virtual time, with match interrupts, resets and stops.
+ *
+ * @par Statistics
+ *  Per simulated peripheral, the number of operations, the busy time (both in ns and in system clock cycles), the
+ *  maximum latency of a single operation and the number of raised interrupts are counted. See #Sim_GetStats and
+ *  #Sim_PrintStats. The virtual time is also split over the power modes of the core: active, Sleep and Deep Sleep,
+ *  depending on SLEEPDEEP when @c __WFI is executed. See #Sim_GetPower.
+ *
+ * @par Limitations
+ *  - Interrupts only preempt the firmware at a synchronization point, never in the middle of arbitrary code.
+ *  - Interrupts do not nest.
+ *  - Timing values are model values: see the @c SIM_*_TIME_US defines below to align them with measurements.
+ *  - The start logic (PIO0_n, RFFIELD, RTCPWREQ) interrupts are not raised.
+ *
+ * @{
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/* ------------------------------------------------------------------------- */
+
+/** Time (in us) needed to erase and program one EEPROM row. */
+#ifndef SIM_EEPROM_PROGRAM_TIME_US
+    #define SIM_EEPROM_PROGRAM_TIME_US 2500
+#endif
+
+/** Time (in us) needed to program one FLASH page. */
+#ifndef SIM_FLASH_PROGRAM_TIME_US
+    #define SIM_FLASH_PROGRAM_TIME_US 1000
+#endif
+
+/** Time (in us) needed to erase FLASH pages or sectors. */
+#ifndef SIM_FLASH_ERASE_TIME_US
+    #define SIM_FLASH_ERASE_TIME_US 2000
+#endif
+
+/** Time (in us) a reader needs for a READ command: 16 bytes of data at 106 kbit/s. */
+#ifndef SIM_NFC_READ_TIME_US
+    #define SIM_NFC_READ_TIME_US 1500
+#endif
+
+/** Time (in us) a reader needs for a WRITE command of 4 bytes, including the acknowledgment. */
+#ifndef SIM_NFC_WRITE_TIME_US
+    #define SIM_NFC_WRITE_TIME_US 1000
+#endif
+
+/* ------------------------------------------------------------------------- */
+
+/** Memories and register blocks backing the simulated address map. */
+extern uint8_t Sim_EepromMemory[EEPROM_NR_OF_R_ROWS * EEPROM_ROW_SIZE];
+extern uint8_t Sim_FlashMemory[FLASH_NR_OF_R_SECTORS * FLASH_SECTOR_SIZE];
+extern NSS_I2C_T Sim_I2c;
+extern NSS_WWDT_T Sim_Wwdt;
+extern NSS_TIMER_T Sim_Timer16_0;
+extern NSS_TIMER_T Sim_Timer32_0;
+extern NSS_ADCDAC_T Sim_Adcdac0;
+extern NSS_FLASH_T Sim_Flash;
+extern NSS_EEPROM_T Sim_Eeprom;
+extern NSS_PMU_T Sim_Pmu;
+extern NSS_SSP_T Sim_Ssp0;
+extern NSS_IOCON_T Sim_Iocon;
+extern NSS_SYSCON_T Sim_Syscon;
+extern NSS_RTC_T Sim_Rtc;
+extern NSS_NFC_T Sim_Nfc;
+extern NSS_TSEN_T Sim_Tsen;
+extern NSS_I2D_T Sim_I2d;
+extern NSS_GPIO_T Sim_Gpio;
+
+#undef EEPROM_START
+#undef FLASH_START
+#undef NSS_I2C_BASE
+#undef NSS_WWDT_BASE
+#undef NSS_TIMER16_0_BASE
+#undef NSS_TIMER32_0_BASE
+#undef NSS_ADCDAC0_BASE
+#undef NSS_FLASH_BASE
+#undef NSS_EEPROM_BASE
+#undef NSS_PMU_BASE
+#undef NSS_SSP0_BASE
+#undef NSS_IOCON_BASE
+#undef NSS_SYSCON_BASE
+#undef NSS_RTC_BASE
+#undef NSS_NFC_BASE
+#undef NSS_TSEN_BASE
+#undef NSS_I2D_BASE
+#undef NSS_GPIO_BASE
+
+/* The executable is linked without PIE: all addresses below fit in an int, just as they do on target. */
+#define EEPROM_START ((intptr_t)Sim_EepromMemory)
+#define FLASH_START ((intptr_t)Sim_FlashMemory)
+#define NSS_I2C_BASE ((intptr_t)&Sim_I2c)
+#define NSS_WWDT_BASE ((intptr_t)&Sim_Wwdt)
+#define NSS_TIMER16_0_BASE ((intptr_t)&Sim_Timer16_0)
+#define NSS_TIMER32_0_BASE ((intptr_t)&Sim_Timer32_0)
+#define NSS_ADCDAC0_BASE ((intptr_t)&Sim_Adcdac0)
+#define NSS_FLASH_BASE ((intptr_t)&Sim_Flash)
+#define NSS_EEPROM_BASE ((intptr_t)&Sim_Eeprom)
+#define NSS_PMU_BASE ((intptr_t)&Sim_Pmu)
+#define NSS_SSP0_BASE ((intptr_t)&Sim_Ssp0)
+#define NSS_IOCON_BASE ((intptr_t)&Sim_Iocon)
+#define NSS_SYSCON_BASE ((intptr_t)&Sim_Syscon)
+#define NSS_RTC_BASE ((intptr_t)&Sim_Rtc)
+#define NSS_NFC_BASE ((intptr_t)&Sim_Nfc)
+#define NSS_TSEN_BASE ((intptr_t)&Sim_Tsen)
+#define NSS_I2D_BASE ((intptr_t)&Sim_I2d)
+#define NSS_GPIO_BASE ((intptr_t)&Sim_Gpio)
+
+/* ------------------------------------------------------------------------- */
+
+/** The simulated peripherals for which statistics are kept. */
+typedef enum SIM_PERIPHERAL {
+    SIM_PERIPHERAL_EEPROM, /**< EEPROM row erase/program operations */
+    SIM_PERIPHERAL_FLASH, /**< FLASH erase and program operations via IAP */
+    SIM_PERIPHERAL_NFC, /**< Reader commands */
+    SIM_PERIPHERAL_RTC, /**< Expirations of the wake-up down-counter */
+    SIM_PERIPHERAL_TSEN, /**< Temperature conversions */
+    SIM_PERIPHERAL_I2C, /**< Bus conditions and bytes transferred */
+    SIM_PERIPHERAL_GPIO, /**< Input and output pin transitions */
+    SIM_PERIPHERAL_TIMER, /**< Match events of CT16B0 and CT32B0 */
+    SIM_PERIPHERAL_COUNT /**< Number of simulated peripherals. Not a peripheral. */
+} SIM_PERIPHERAL_T;
+
+/** Statistics of one simulated peripheral. */
+typedef struct SIM_STATS_S {
+    uint32_t ops; /**< Number of completed operations */
+    uint64_t busyNs; /**< Total virtual time the peripheral was busy, in ns */
+    uint64_t busyCycles; /**< Total virtual time the peripheral was busy, in system clock cycles */
+    uint64_t maxLatencyNs; /**< Longest single operation, in ns */
+    uint32_t irqs; /**< Number of times the peripheral raised its interrupt */
+} SIM_STATS_T;
+
+/** Virtual time spent in each power mode of the ARM core. */
+typedef struct SIM_POWER_S {
+    uint64_t activeNs; /**< Running code, busy waits and the wait loops of the drivers included */
+    uint64_t sleepNs; /**< In @c __WFI with SLEEPDEEP cleared: Sleep mode */
+    uint64_t deepSleepNs; /**< In @c __WFI with SLEEPDEEP set: Deep Sleep mode */
+} SIM_POWER_T;
+
+/** Called when the firmware waits for an interrupt while no simulated peripheral has an event scheduled. */
+typedef void (*pSim_IdleCb_t)(void);
+
+/**
+ * Restores the power-on state: memories, registers, virtual time, NVIC and statistics.
+ * @post The FLASH memory is erased (@c 0xFF), the EEPROM memory is @c 0x00.
+ * @note To be called before anything else, and again between independent runs.
+ */
+void Sim_Init(void);
+
+/** @return The virtual time, in ns, since #Sim_Init */
+uint64_t Sim_GetTime(void);
+
+/** @return The number of system clock cycles since #Sim_Init, taking clock divider changes into account */
+uint64_t Sim_GetCycles(void);
+
+/** @return The current system clock frequency in Hz, as configured in SYSCON */
+uint32_t Sim_GetSystemClockFrequency(void);
+
+/**
+ * Lets every peripheral model react on the register writes done since the previous synchronization, then dispatches
+ * the pending and enabled interrupts. Virtual time does not advance.
+ */
+void Sim_Sync(void);
+
+/**
+ * To be called from within a busy wait loop that waits on hardware. Synchronizes, then advances virtual time up to
+ * the next peripheral event - or by 1 us when no event is scheduled - and synchronizes again.
+ */
+void Sim_Poll(void);
+
+/**
+ * Advances the virtual time with @c ns nanoseconds, handling all peripheral events and interrupts on the way.
+ * @param ns The time to wait.
+ */
+void Sim_Delay(uint64_t ns);
+
+/**
+ * Registers a function that is called when the firmware waits for an interrupt that can never come: no interrupt is
+ * pending and no peripheral has an event scheduled. The callback typically plays the role of the outside world, e.g.
+ * an NFC reader. When no callback is registered or when the callback does not raise an interrupt either,
+ * the simulation is aborted.
+ * @param cb The function to call, or @c NULL.
+ */
+void Sim_SetIdleCb(pSim_IdleCb_t cb);
+
+/**
+ * Registers a function that is called once, at a given virtual time, while the firmware waits for an interrupt. Unlike
+ * the idle callback, it is also called when peripheral events are scheduled later on, e.g. a timer that wakes up the
+ * firmware periodically. When the firmware is not waiting at that time, the call is postponed to its next wait.
+ * The callback may register itself again.
+ * @param time The virtual time, in ns.
+ * @param cb The function to call, or @c NULL to cancel.
+ */
+void Sim_SetTimedCb(uint64_t time, pSim_IdleCb_t cb);
+
+/**
+ * Retrieves the statistics of one peripheral.
+ * @param peripheral The peripheral to query.
+ * @return A pointer to the statistics, valid until the next call to #Sim_Init.
+ */
+const SIM_STATS_T * Sim_GetStats(SIM_PERIPHERAL_T peripheral);
+
+/**
+ * Retrieves the time spent per power mode. The average current of a code path follows from these and the currents
+ * per power mode in the datasheet.
+ * @return A pointer to the statistics, valid until the next call to #Sim_Init.
+ */
+const SIM_POWER_T * Sim_GetPower(void);
+
+/**
+ * Clears the statistics of all peripherals and of the power modes. Virtual time and peripheral state are not changed.
+ */
+void Sim_ResetStats(void);
+
+/**
+ * Writes the statistics of all peripherals, one line per peripheral, then the time per power mode of the core, as
+ * space separated @c key=value pairs.
+ * @param stream The stream to write to.
+ * @param prefix Written at the start of each line, e.g. the name of a benchmark. May be @c NULL.
+ */
+void Sim_PrintStats(FILE * stream, const char * prefix);
+
+/**
+ * Called by the #ASSERT macro when the condition fails: prints the location and aborts.
+ * @param file The source file.
+ * @param line The line in the source file.
+ */
+void Sim_AssertFailed(const char * file, int line);
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Places or removes an NFC reader.
+ * @param on @c true to power the NFC front-end and select the tag, @c false to remove the field.
+ */
+void Sim_Nfc_SetField(bool on);
+
+/**
+ * Models a Type 2 Tag WRITE command: writes one page of 4 bytes.
+ * @param page The absolute NFC page number. The shared memory starts at page 4.
+ * @param pData The 4 bytes to write.
+ * @return @c false when the page does not map onto the shared memory or when the field is off.
+ */
+bool Sim_Nfc_ReaderWrite(int page, const uint8_t * pData);
+
+/**
+ * Models a Type 2 Tag READ command: reads 4 consecutive pages.
+ * @param page The absolute NFC page number of the first page to read. The shared memory starts at page 4.
+ * @param pData Receives 16 bytes. Bytes that do not map onto the shared memory are @c 0.
+ * @return @c false when the field is off.
+ */
+bool Sim_Nfc_ReaderRead(int page, uint8_t * pData);
+
+/**
+ * Sets the temperature measured by the next conversions of the temperature sensor.
+ * @param native The temperature in native format 1-(9,6): Kelvin multiplied by 64.
+ */
+void Sim_Tsen_SetNative(int native);
+
+/**
+ * Drives a GPIO pin from outside the chip. The level only has effect while the pin is an input, and raises a pin
+ * interrupt when configured accordingly.
+ * @param pin The PIO0 pin number.
+ * @param level The level driven on the pin.
+ */
+void Sim_Gpio_SetInput(int pin, bool level);
+
+/**
+ * @return The level of a pin, as seen from outside the chip.
+ * @param pin The PIO0 pin number.
+ */
+bool Sim_Gpio_GetOutput(int pin);
+
+/** Models a slave device on the I2C bus. All callbacks are mandatory. */
+typedef struct SIM_I2C_DEVICE_S {
+    uint8_t address; /**< The 7-bit slave address */
+    void * pContext; /**< Passed unmodified to each callback */
+    /** A (repeated) start followed by the own address: @c read is @c true for SLA+R. Return @c true to ACK. */
+    bool (*start)(void * pContext, bool read);
+    /** A byte written by the master. Return @c true to ACK. */
+    bool (*write)(void * pContext, uint8_t data);
+    /** The master reads a byte. @c ack tells whether the master will acknowledge the byte. */
+    uint8_t (*read)(void * pContext, bool ack);
+    /** A stop condition. */
+    void (*stop)(void * pContext);
+} SIM_I2C_DEVICE_T;
+
+/**
+ * Connects a slave device to the I2C bus. At most 8 devices can be connected.
+ * @param pDevice Must remain valid until the next call to #Sim_Init.
+ */
+void Sim_I2c_AddDevice(const SIM_I2C_DEVICE_T * pDevice);
+
+/** A slave device with 256 byte registers and an auto-incrementing register pointer, like most sensors. */
+typedef struct SIM_I2C_REGDEVICE_S {
+    SIM_I2C_DEVICE_T device; /**< Filled in by #Sim_I2c_AddRegDevice */
+    uint8_t regs[256]; /**< The register contents, free to be modified by the host at any time */
+    uint8_t pointer; /**< The current register pointer */
+    bool pointerSet; /**< Internal: whether the first byte of the current write was received */
+    /** Optional: called before a register is read by the master, to refresh its contents. */
+    void (*onRead)(struct SIM_I2C_REGDEVICE_S * pRegDevice, uint8_t reg);
+    /** Optional: called after a register was written by the master. */
+    void (*onWrite)(struct SIM_I2C_REGDEVICE_S * pRegDevice, uint8_t reg);
+} SIM_I2C_REGDEVICE_T;
+
+/**
+ * Initializes and connects a register based slave device.
+ * @param pRegDevice Must remain valid until the next call to #Sim_Init. @c regs, @c onRead and @c onWrite are kept.
+ * @param address The 7-bit slave address.
+ */
+void Sim_I2c_AddRegDevice(SIM_I2C_REGDEVICE_T * pRegDevice, uint8_t address);
+
+/**
+ * @return The number of erase/program cycles of one EEPROM row since #Sim_Init.
+ * @param row The EEPROM row.
+ */
+uint32_t Sim_Eeprom_GetProgramCount(int row);
+
+#endif /** @} */
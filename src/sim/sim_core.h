@@ -0,0 +1,70 @@
+#ifndef __SIM_CORE_H_
+#define __SIM_CORE_H_
+
+/**
+ * @defgroup SIM_CORE sim_core: Cortex-M0+ core peripherals for the host-native simulation build
+ * @ingroup SIM
+ *
+ * Replaces @c core_cm0plus.h when the tree is compiled with @c NSS_SIM defined. Only the subset of CMSIS used by
+ * lib_chip_nss, the mods and the application is provided:
+ * - the register qualifiers @c __I, @c __O and @c __IO
+ * - the NVIC API: interrupts are dispatched by the simulator, see #Sim_Sync
+ * - @c SCB->SCR, used by the PMU driver to select between sleep and deep sleep
+ * - @c __WFI: advances virtual time up to the next peripheral event and dispatches the pending interrupts
+ * - barriers, @c __NOP, PRIMASK and the byte reversal intrinsics
+ *
+ * @{
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+    #define __I volatile /**< Defines 'read only' permissions */
+#else
+    #define __I volatile const /**< Defines 'read only' permissions */
+#endif
+#define __O volatile /**< Defines 'write only' permissions */
+#define __IO volatile /**< Defines 'read / write' permissions */
+
+/** System Control Block: only the System Control Register is used by the drivers. */
+typedef struct {
+    __IO uint32_t SCR; /**< System Control Register */
+} SCB_Type;
+
+#define SCB_SCR_SLEEPDEEP_Pos 2 /**< SCB SCR: SLEEPDEEP position */
+#define SCB_SCR_SLEEPDEEP_Msk (1UL << SCB_SCR_SLEEPDEEP_Pos) /**< SCB SCR: SLEEPDEEP mask */
+
+extern SCB_Type Sim_Scb; /**< Backing store of the simulated System Control Block */
+#define SCB (&Sim_Scb) /**< SCB configuration struct */
+
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn);
+void NVIC_SetPendingIRQ(IRQn_Type IRQn);
+void NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+uint32_t NVIC_GetPriority(IRQn_Type IRQn);
+void NVIC_SystemReset(void);
+
+void Sim_Core_WaitForInterrupt(void);
+void Sim_Core_SetPrimask(uint32_t primask);
+uint32_t Sim_Core_GetPrimask(void);
+
+#define __WFI() Sim_Core_WaitForInterrupt() /**< Wait For Interrupt: sleeps in virtual time */
+#define __WFE() Sim_Core_WaitForInterrupt() /**< Wait For Event: treated as #__WFI */
+#define __SEV() do { } while (0) /**< Send Event: no other core to wake up */
+#define __NOP() do { } while (0) /**< No Operation */
+#define __ISB() __asm__ volatile ("" ::: "memory") /**< Instruction Synchronization Barrier */
+#define __DSB() __asm__ volatile ("" ::: "memory") /**< Data Synchronization Barrier */
+#define __DMB() __asm__ volatile ("" ::: "memory") /**< Data Memory Barrier */
+
+#define __enable_irq() Sim_Core_SetPrimask(0) /**< Clears PRIMASK: pending interrupts are dispatched immediately */
+#define __disable_irq() Sim_Core_SetPrimask(1) /**< Sets PRIMASK */
+#define __get_PRIMASK() Sim_Core_GetPrimask() /**< Returns PRIMASK */
+#define __set_PRIMASK(x) Sim_Core_SetPrimask(x) /**< Sets PRIMASK */
+
+#define __REV(x) __builtin_bswap32(x) /**< Reverse byte order (32 bit) */
+#define __REV16(x) ((uint32_t)((((uint32_t)(x) & 0xFF00FF00UL) >> 8) | (((uint32_t)(x) & 0x00FF00FFUL) << 8))) /**< Reverse byte order within each halfword */
+#define __REVSH(x) ((int16_t)__builtin_bswap16((uint16_t)(x))) /**< Reverse byte order in a signed halfword */
+
+#endif /** @} */
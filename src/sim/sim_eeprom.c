@@ -0,0 +1,75 @@
+#include <string.h>
+#include "sim_model.h"
+
+/** Erase/program bits in the EEPROM command register */
+#define CMD_ERASE_PROGRAM 6
+
+/** Program done status bit in the EEPROM interrupt registers */
+#define PROG_DONE_STATUS_BIT (1 << 2)
+
+/**
+ * The EEPROM controller latches the row that was written last: the erase/program command operates on that row.
+ * A snapshot of the memory is taken at each step to find it.
+ */
+static uint8_t sShadow[EEPROM_NR_OF_R_ROWS * EEPROM_ROW_SIZE];
+
+static bool sBusy;
+static int sRow;
+static uint64_t sStart;
+static uint64_t sDone;
+static uint32_t sProgramCount[EEPROM_NR_OF_R_ROWS];
+
+/* ------------------------------------------------------------------------- */
+
+void Sim_Eeprom_Reset(void)
+{
+    memcpy(sShadow, Sim_EepromMemory, sizeof(sShadow));
+    sBusy = false;
+    sRow = 0;
+    memset(sProgramCount, 0, sizeof(sProgramCount));
+}
+
+uint64_t Sim_Eeprom_Step(uint64_t now)
+{
+    /* Interrupt status and enable: set and clear registers. */
+    SIM_REG(Sim_Eeprom.INT_STATUS) = (Sim_Eeprom.INT_STATUS & ~Sim_Eeprom.INT_CLR_STATUS) | Sim_Eeprom.INT_SET_STATUS;
+    SIM_REG(Sim_Eeprom.INT_ENABLE) = (Sim_Eeprom.INT_ENABLE & ~Sim_Eeprom.INT_CLR_ENABLE) | Sim_Eeprom.INT_SET_ENABLE;
+    Sim_Eeprom.INT_CLR_STATUS = 0;
+    Sim_Eeprom.INT_SET_STATUS = 0;
+    Sim_Eeprom.INT_CLR_ENABLE = 0;
+    Sim_Eeprom.INT_SET_ENABLE = 0;
+
+    /* Find the row touched by the firmware since the previous step. */
+    for (int row = 0; row < EEPROM_NR_OF_R_ROWS; row++) {
+        int offset = row * EEPROM_ROW_SIZE;
+        if (memcmp(sShadow + offset, Sim_EepromMemory + offset, EEPROM_ROW_SIZE)) {
+            if (row >= EEPROM_NR_OF_RW_ROWS) {
+                Sim_Fatal("write to a read-only EEPROM row");
+            }
+            sRow = row;
+            memcpy(sShadow + offset, Sim_EepromMemory + offset, EEPROM_ROW_SIZE);
+        }
+    }
+
+    if (!sBusy && ((Sim_Eeprom.CMD & 0x7) == CMD_ERASE_PROGRAM)) {
+        sBusy = true;
+        sStart = now;
+        sDone = now + SIM_EEPROM_PROGRAM_TIME_US * SIM_NS_PER_US;
+    }
+    if (sBusy && (now >= sDone)) {
+        sBusy = false;
+        Sim_Eeprom.CMD = 0;
+        SIM_REG(Sim_Eeprom.INT_STATUS) |= PROG_DONE_STATUS_BIT;
+        sProgramCount[sRow]++;
+        Sim_CountOp(SIM_PERIPHERAL_EEPROM, now - sStart);
+    }
+
+    Sim_SetIrqLine(EEPROM_IRQn, (Sim_Eeprom.INT_STATUS & Sim_Eeprom.INT_ENABLE) != 0);
+    return sBusy ? sDone : SIM_NEVER;
+}
+
+uint32_t Sim_Eeprom_GetProgramCount(int row)
+{
+    ASSERT((row >= 0) && (row < EEPROM_NR_OF_R_ROWS));
+    return sProgramCount[row];
+}
@@ -0,0 +1,197 @@
+#include <string.h>
+#include "sim_model.h"
+
+/*
+ * Replaces iap_nss.c in the simulation build: the IAP commands operate directly on Sim_FlashMemory.
+ * The real implementation passes pointers through 32 bit command arrays to the ROM, which cannot work on a 64 bit host.
+ * Erase and program operations keep the CPU busy, just as the ROM code does: virtual time advances accordingly.
+ */
+
+/** Contents of an erased flash word */
+#define ERASED_WORD 0xFFFFFFFFu
+
+/** Part ID of the NHS3152 */
+#define PART_ID 0x4E310020
+
+/** Boot ROM version: major.minor in the two lowest bytes */
+#define BOOT_VERSION 0x0101
+
+/** Sectors unprotected by Chip_IAP_Flash_PrepareSector: an erase or program command protects them again. */
+static uint32_t sPreparedSectors;
+
+/* ------------------------------------------------------------------------- */
+
+static bool IsPrepared(uint32_t sectorStart, uint32_t sectorEnd)
+{
+    for (uint32_t s = sectorStart; s <= sectorEnd; s++) {
+        if (!(sPreparedSectors & (1u << s))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Keeps the CPU busy with a flash operation, and counts it. */
+static void Busy(uint64_t ns)
+{
+    Sim_Delay(ns);
+    Sim_CountOp(SIM_PERIPHERAL_FLASH, ns);
+}
+
+/* ------------------------------------------------------------------------- */
+
+void Sim_Flash_Reset(void)
+{
+    sPreparedSectors = 0;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+uint64_t Sim_Flash_Step(uint64_t now)
+{
+    return SIM_NEVER;
+}
+
+uint32_t Chip_IAP_ReadFactorySettings(uint32_t address)
+{
+    return 0;
+}
+#pragma GCC diagnostic pop
+
+uint32_t Chip_IAP_ReadPartID(void)
+{
+    return PART_ID;
+}
+
+int Chip_IAP_ReadBootVersion(void)
+{
+    return BOOT_VERSION;
+}
+
+void Chip_IAP_ReadUID(uint32_t uid[4])
+{
+    ASSERT(uid != 0);
+    memcpy(uid, NSS_NFC_UID, 8);
+    uid[2] = 0;
+    uid[3] = 0;
+}
+
+IAP_STATUS_T Chip_IAP_Flash_PrepareSector(uint32_t sectorStart, uint32_t sectorEnd)
+{
+    if ((sectorStart > sectorEnd) || (sectorEnd >= FLASH_NR_OF_RW_SECTORS)) {
+        return IAP_STATUS_INVALID_SECTOR;
+    }
+    for (uint32_t s = sectorStart; s <= sectorEnd; s++) {
+        sPreparedSectors |= 1u << s;
+    }
+    return IAP_STATUS_CMD_SUCCESS;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+IAP_STATUS_T Chip_IAP_Flash_EraseSector(uint32_t sectorStart, uint32_t sectorEnd, uint32_t kHzSysClk)
+{
+    if ((sectorStart > sectorEnd) || (sectorEnd >= FLASH_NR_OF_RW_SECTORS)) {
+        return IAP_STATUS_INVALID_SECTOR;
+    }
+    if (!IsPrepared(sectorStart, sectorEnd)) {
+        return IAP_STATUS_SECTOR_NOT_PREPARED;
+    }
+    memset(Sim_FlashMemory + sectorStart * FLASH_SECTOR_SIZE, 0xFF, (sectorEnd - sectorStart + 1) * FLASH_SECTOR_SIZE);
+    sPreparedSectors = 0;
+    Busy(SIM_FLASH_ERASE_TIME_US * SIM_NS_PER_US);
+    return IAP_STATUS_CMD_SUCCESS;
+}
+
+IAP_STATUS_T Chip_IAP_Flash_ErasePage(uint32_t pageStart, uint32_t pageEnd, uint32_t kHzSysClk)
+{
+    if ((pageStart > pageEnd) || (pageEnd >= FLASH_NR_OF_RW_SECTORS * FLASH_PAGES_PER_SECTOR)) {
+        return IAP_STATUS_INVALID_SECTOR;
+    }
+    if (!IsPrepared(pageStart / FLASH_PAGES_PER_SECTOR, pageEnd / FLASH_PAGES_PER_SECTOR)) {
+        return IAP_STATUS_SECTOR_NOT_PREPARED;
+    }
+    memset(Sim_FlashMemory + pageStart * FLASH_PAGE_SIZE, 0xFF, (pageEnd - pageStart + 1) * FLASH_PAGE_SIZE);
+    sPreparedSectors = 0;
+    Busy(SIM_FLASH_ERASE_TIME_US * SIM_NS_PER_US);
+    return IAP_STATUS_CMD_SUCCESS;
+}
+
+IAP_STATUS_T Chip_IAP_Flash_Program(const void *pSrc, const void *pFlash, uint32_t size, uint32_t kHzSysClk)
+{
+    intptr_t offset = (intptr_t)pFlash - FLASH_START;
+
+    if ((intptr_t)pSrc & 0x3) {
+        return IAP_STATUS_SRC_ADDR_ERROR;
+    }
+    if (offset % FLASH_PAGE_SIZE) {
+        return IAP_STATUS_DST_ADDR_ERROR;
+    }
+    if ((offset < 0) || (offset + (intptr_t)size > FLASH_NR_OF_RW_SECTORS * FLASH_SECTOR_SIZE)) {
+        return IAP_STATUS_DST_ADDR_NOT_MAPPED;
+    }
+    if ((size == 0) || (size % FLASH_PAGE_SIZE)) {
+        return IAP_STATUS_COUNT_ERROR;
+    }
+    if (!IsPrepared((uint32_t)offset / FLASH_SECTOR_SIZE, ((uint32_t)offset + size - 1) / FLASH_SECTOR_SIZE)) {
+        return IAP_STATUS_SECTOR_NOT_PREPARED;
+    }
+
+    /* A word can be written once after an erase. Writing all 1s or the same content again is allowed. */
+    const uint32_t * src = pSrc;
+    uint32_t * dst = (uint32_t *)(Sim_FlashMemory + offset);
+    for (uint32_t i = 0; i < size / 4; i++) {
+        if ((src[i] != ERASED_WORD) && (dst[i] != ERASED_WORD) && (src[i] != dst[i])) {
+            Sim_Fatal("flash word programmed twice without erase");
+        }
+        if (src[i] != ERASED_WORD) {
+            dst[i] = src[i];
+        }
+    }
+    sPreparedSectors = 0;
+    Busy((size / FLASH_PAGE_SIZE) * SIM_FLASH_PROGRAM_TIME_US * SIM_NS_PER_US);
+    return IAP_STATUS_CMD_SUCCESS;
+}
+#pragma GCC diagnostic pop
+
+IAP_STATUS_T Chip_IAP_Flash_SectorBlankCheck(uint32_t sectorStart, uint32_t sectorEnd, uint32_t *pOffset, uint32_t *pContent)
+{
+    if ((sectorStart > sectorEnd) || (sectorEnd >= FLASH_NR_OF_R_SECTORS)) {
+        return IAP_STATUS_INVALID_SECTOR;
+    }
+    const uint32_t * p = (const uint32_t *)(Sim_FlashMemory + sectorStart * FLASH_SECTOR_SIZE);
+    uint32_t words = (sectorEnd - sectorStart + 1) * FLASH_SECTOR_SIZE / 4;
+    for (uint32_t i = 0; i < words; i++) {
+        if (p[i] != ERASED_WORD) {
+            if (pOffset) {
+                *pOffset = i;
+            }
+            if (pContent) {
+                *pContent = p[i];
+            }
+            return IAP_STATUS_SECTOR_NOT_BLANK;
+        }
+    }
+    return IAP_STATUS_CMD_SUCCESS;
+}
+
+IAP_STATUS_T Chip_IAP_Compare(const void *pAddress1, const void *pAddress2, uint32_t size, uint32_t *pOffset)
+{
+    if (((intptr_t)pAddress1 & 0x3) || ((intptr_t)pAddress2 & 0x3)) {
+        return IAP_STATUS_ADDR_ERROR;
+    }
+    if (size % 4) {
+        return IAP_STATUS_COUNT_ERROR;
+    }
+    const uint32_t * p1 = pAddress1;
+    const uint32_t * p2 = pAddress2;
+    for (uint32_t i = 0; i < size / 4; i++) {
+        if (p1[i] != p2[i]) {
+            if (pOffset) {
+                *pOffset = i;
+            }
+            return IAP_STATUS_COMPARE_ERROR;
+        }
+    }
+    return IAP_STATUS_CMD_SUCCESS;
+}
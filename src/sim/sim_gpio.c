@@ -0,0 +1,89 @@
+#include "sim_model.h"
+
+/** Number of PIO0 pins */
+#define PIN_COUNT 12
+
+/** All pins */
+#define PORT_MASK ((1u << PIN_COUNT) - 1)
+
+/**
+ * The DATA register is address masked: the firmware only uses the single pin masks and the full port mask. These are
+ * the slots the model observes and keeps up to date.
+ */
+#define SLOT_COUNT (PIN_COUNT + 1)
+
+static uint32_t sSlots[SLOT_COUNT]; /**< DATA values as last written by the model */
+static uint32_t sOut; /**< Output latch */
+static uint32_t sIn; /**< Levels driven from outside the chip */
+static uint32_t sLevel; /**< Pin levels at the previous step */
+
+/* ------------------------------------------------------------------------- */
+
+static uint32_t SlotMask(int slot)
+{
+    return (slot < PIN_COUNT) ? (1u << slot) : PORT_MASK;
+}
+
+/* ------------------------------------------------------------------------- */
+
+void Sim_Gpio_Reset(void)
+{
+    sOut = 0;
+    sIn = 0;
+    sLevel = 0;
+    for (int slot = 0; slot < SLOT_COUNT; slot++) {
+        sSlots[slot] = 0;
+    }
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+uint64_t Sim_Gpio_Step(uint64_t now)
+{
+    for (int slot = 0; slot < SLOT_COUNT; slot++) {
+        uint32_t mask = SlotMask(slot);
+        if (Sim_Gpio.DATA[mask] != sSlots[slot]) {
+            sOut = (sOut & ~mask) | (Sim_Gpio.DATA[mask] & mask);
+        }
+    }
+
+    uint32_t level = ((sOut & Sim_Gpio.DIR) | (sIn & ~Sim_Gpio.DIR)) & PORT_MASK;
+    uint32_t changed = level ^ sLevel;
+    uint32_t rising = changed & level;
+    uint32_t falling = changed & ~level;
+    uint32_t edge = (Sim_Gpio.IBE & changed) | (~Sim_Gpio.IBE & ((Sim_Gpio.IEV & rising) | (~Sim_Gpio.IEV & falling)));
+    uint32_t active = ~(level ^ Sim_Gpio.IEV); /* Level sensitive: the pin is at the configured level */
+
+    /* Edges are latched until cleared; a level sensitive status follows the pin and cannot be cleared. */
+    uint32_t latched = ((Sim_Gpio.RIS & ~Sim_Gpio.IC) | edge) & ~Sim_Gpio.IS;
+    Sim_Gpio.IC = 0;
+    SIM_REG(Sim_Gpio.RIS) = (latched | (active & Sim_Gpio.IS)) & PORT_MASK;
+    SIM_REG(Sim_Gpio.MIS) = Sim_Gpio.RIS & Sim_Gpio.IE;
+    Sim_SetIrqLine(PIO0_IRQn, Sim_Gpio.MIS != 0);
+
+    for (uint32_t c = changed; c; c &= c - 1) {
+        Sim_CountOp(SIM_PERIPHERAL_GPIO, 0);
+    }
+    sLevel = level;
+    for (int slot = 0; slot < SLOT_COUNT; slot++) {
+        uint32_t mask = SlotMask(slot);
+        sSlots[slot] = level & mask;
+        Sim_Gpio.DATA[mask] = sSlots[slot];
+    }
+    return SIM_NEVER;
+}
+#pragma GCC diagnostic pop
+
+void Sim_Gpio_SetInput(int pin, bool level)
+{
+    ASSERT((pin >= 0) && (pin < PIN_COUNT));
+    sIn = (sIn & ~(1u << pin)) | ((uint32_t)level << pin);
+    Sim_Sync();
+}
+
+bool Sim_Gpio_GetOutput(int pin)
+{
+    ASSERT((pin >= 0) && (pin < PIN_COUNT));
+    Sim_Sync();
+    return (sLevel >> pin) & 1;
+}
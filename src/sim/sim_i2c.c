@@ -0,0 +1,285 @@
+#include <string.h>
+#include "sim_model.h"
+
+/* Control bits, as in i2c_nss.c */
+#define CON_AA (1UL << 2)
+#define CON_SI (1UL << 3)
+#define CON_STO (1UL << 4)
+#define CON_STA (1UL << 5)
+#define CON_I2EN (1UL << 6)
+#define CON_MASK (CON_AA | CON_SI | CON_STO | CON_STA | CON_I2EN)
+
+/**
+ * Marks a CONSET value written by the model. When absent, the firmware wrote CONSET since the previous step. The bit
+ * is outside of the control bits: the firmware never looks at it.
+ */
+#define CONSET_MODEL_MARK (1UL << 31)
+
+/* Status codes of the master state machine */
+#define STAT_START 0x08
+#define STAT_REPEATED_START 0x10
+#define STAT_SLAW_ACK 0x18
+#define STAT_SLAW_NACK 0x20
+#define STAT_DATA_TX_ACK 0x28
+#define STAT_DATA_TX_NACK 0x30
+#define STAT_SLAR_ACK 0x40
+#define STAT_SLAR_NACK 0x48
+#define STAT_DATA_RX_ACK 0x50
+#define STAT_DATA_RX_NACK 0x58
+#define STAT_IDLE 0xF8
+
+/** Bus bit time used when SCLH and SCLL are not configured: 100 kHz. */
+#define DEFAULT_BIT_NS (10 * SIM_NS_PER_US)
+
+/** Maximum number of slave devices on the bus */
+#define MAX_DEVICES 8
+
+/** The bus operation in progress. */
+typedef enum ACTION {
+    ACTION_NONE,
+    ACTION_START,
+    ACTION_REPEATED_START,
+    ACTION_ADDRESS,
+    ACTION_TX,
+    ACTION_RX,
+    ACTION_STOP
+} ACTION_T;
+
+static const SIM_I2C_DEVICE_T * sDevices[MAX_DEVICES];
+static int sDeviceCount;
+static const SIM_I2C_DEVICE_T * sSelected; /**< The device that acknowledged its address, if any */
+static uint32_t sCon;
+static uint32_t sStat;
+static ACTION_T sAction;
+static uint64_t sDone;
+static uint64_t sTransactionStart;
+
+/* ------------------------------------------------------------------------- */
+
+static uint64_t BitTime(void)
+{
+    uint32_t cycles = Sim_I2c.SCLH + Sim_I2c.SCLL;
+    return cycles ? Sim_CyclesToNs(cycles) : DEFAULT_BIT_NS;
+}
+
+static void Schedule(ACTION_T action, uint64_t now, uint32_t bits)
+{
+    sAction = action;
+    sDone = now + bits * BitTime();
+}
+
+static const SIM_I2C_DEVICE_T * FindDevice(uint8_t address)
+{
+    for (int i = 0; i < sDeviceCount; i++) {
+        if (sDevices[i]->address == address) {
+            return sDevices[i];
+        }
+    }
+    return NULL;
+}
+
+static bool IsMasterState(uint32_t stat)
+{
+    return (stat >= STAT_START) && (stat <= STAT_DATA_RX_NACK);
+}
+
+/** Decides on the next bus operation, based on the control bits set by the firmware. */
+static void Begin(uint64_t now)
+{
+    if (sCon & CON_STO) {
+        if (IsMasterState(sStat)) {
+            Schedule(ACTION_STOP, now, 1);
+        }
+        else {
+            sCon &= ~CON_STO; /* Nothing to stop */
+        }
+    }
+    else if (sCon & CON_STA) {
+        if (sStat == STAT_IDLE) {
+            sTransactionStart = now;
+            Schedule(ACTION_START, now, 1);
+        }
+        else if (IsMasterState(sStat)) {
+            Schedule(ACTION_REPEATED_START, now, 1);
+        }
+    }
+    else {
+        switch (sStat) {
+            case STAT_START:
+            case STAT_REPEATED_START:
+                Schedule(ACTION_ADDRESS, now, 9);
+                break;
+            case STAT_SLAW_ACK:
+            case STAT_DATA_TX_ACK:
+                Schedule(ACTION_TX, now, 9);
+                break;
+            case STAT_SLAR_ACK:
+            case STAT_DATA_RX_ACK:
+                Schedule(ACTION_RX, now, 9);
+                break;
+            default:
+                break; /* Waiting for a stop or a repeated start */
+        }
+    }
+}
+
+/** Completes the bus operation in progress. */
+static void Complete(uint64_t now)
+{
+    uint8_t data = (uint8_t)Sim_I2c.DAT;
+    bool ack;
+
+    switch (sAction) {
+        case ACTION_START:
+            sStat = STAT_START;
+            break;
+        case ACTION_REPEATED_START:
+            sStat = STAT_REPEATED_START;
+            break;
+        case ACTION_ADDRESS: {
+            bool read = (data & 1) != 0;
+            const SIM_I2C_DEVICE_T * pDevice = FindDevice(data >> 1);
+            ack = pDevice && pDevice->start(pDevice->pContext, read);
+            sSelected = ack ? pDevice : NULL;
+            if (read) {
+                sStat = ack ? STAT_SLAR_ACK : STAT_SLAR_NACK;
+            }
+            else {
+                sStat = ack ? STAT_SLAW_ACK : STAT_SLAW_NACK;
+            }
+            break;
+        }
+        case ACTION_TX:
+            ack = sSelected->write(sSelected->pContext, data);
+            sStat = ack ? STAT_DATA_TX_ACK : STAT_DATA_TX_NACK;
+            break;
+        case ACTION_RX:
+            ack = (sCon & CON_AA) != 0;
+            Sim_I2c.DAT = sSelected->read(sSelected->pContext, ack);
+            sStat = ack ? STAT_DATA_RX_ACK : STAT_DATA_RX_NACK;
+            break;
+        case ACTION_STOP:
+            if (sSelected) {
+                sSelected->stop(sSelected->pContext);
+                sSelected = NULL;
+            }
+            sCon &= ~CON_STO;
+            sStat = STAT_IDLE;
+            Sim_CountOp(SIM_PERIPHERAL_I2C, now - sTransactionStart);
+            break;
+        default:
+            break;
+    }
+    if (sAction != ACTION_STOP) {
+        sCon |= CON_SI;
+    }
+    sAction = ACTION_NONE;
+}
+
+/* ------------------------------------------------------------------------- */
+
+void Sim_I2c_Reset(void)
+{
+    sDeviceCount = 0;
+    sSelected = NULL;
+    sCon = 0;
+    sStat = STAT_IDLE;
+    sAction = ACTION_NONE;
+    Sim_I2c.CONSET = CONSET_MODEL_MARK;
+    SIM_REG(Sim_I2c.STAT) = STAT_IDLE;
+}
+
+uint64_t Sim_I2c_Step(uint64_t now)
+{
+    /* Apply CONCLR, then CONSET: the order used by the driver when both are written in one go. */
+    uint32_t conset = Sim_I2c.CONSET;
+    sCon &= ~Sim_I2c.CONCLR;
+    if (!(conset & CONSET_MODEL_MARK)) {
+        sCon |= conset & CON_MASK;
+    }
+    Sim_I2c.CONCLR = 0;
+
+    if (!(sCon & CON_I2EN)) {
+        sSelected = NULL;
+        sStat = STAT_IDLE;
+        sAction = ACTION_NONE;
+    }
+    else {
+        if ((sAction != ACTION_NONE) && (now >= sDone)) {
+            Complete(now);
+        }
+        if ((sAction == ACTION_NONE) && !(sCon & CON_SI)) {
+            Begin(now);
+        }
+    }
+
+    Sim_I2c.CONSET = sCon | CONSET_MODEL_MARK;
+    SIM_REG(Sim_I2c.STAT) = sStat;
+    Sim_SetIrqLine(I2C0_IRQn, (sCon & CON_SI) != 0);
+    return (sAction != ACTION_NONE) ? sDone : SIM_NEVER;
+}
+
+void Sim_I2c_AddDevice(const SIM_I2C_DEVICE_T * pDevice)
+{
+    ASSERT(sDeviceCount < MAX_DEVICES);
+    sDevices[sDeviceCount++] = pDevice;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static bool RegDevice_Start(void * pContext, bool read)
+{
+    SIM_I2C_REGDEVICE_T * pRegDevice = pContext;
+    if (!read) {
+        pRegDevice->pointerSet = false;
+    }
+    return true;
+}
+
+static bool RegDevice_Write(void * pContext, uint8_t data)
+{
+    SIM_I2C_REGDEVICE_T * pRegDevice = pContext;
+    if (!pRegDevice->pointerSet) {
+        pRegDevice->pointer = data;
+        pRegDevice->pointerSet = true;
+    }
+    else {
+        uint8_t reg = pRegDevice->pointer++;
+        pRegDevice->regs[reg] = data;
+        if (pRegDevice->onWrite) {
+            pRegDevice->onWrite(pRegDevice, reg);
+        }
+    }
+    return true;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+static uint8_t RegDevice_Read(void * pContext, bool ack)
+{
+    SIM_I2C_REGDEVICE_T * pRegDevice = pContext;
+    uint8_t reg = pRegDevice->pointer++;
+    if (pRegDevice->onRead) {
+        pRegDevice->onRead(pRegDevice, reg);
+    }
+    return pRegDevice->regs[reg];
+}
+
+static void RegDevice_Stop(void * pContext)
+{
+    /* The register pointer is kept: a read without a preceding write continues where the previous access stopped. */
+}
+#pragma GCC diagnostic pop
+
+void Sim_I2c_AddRegDevice(SIM_I2C_REGDEVICE_T * pRegDevice, uint8_t address)
+{
+    pRegDevice->device.address = address;
+    pRegDevice->device.pContext = pRegDevice;
+    pRegDevice->device.start = RegDevice_Start;
+    pRegDevice->device.write = RegDevice_Write;
+    pRegDevice->device.read = RegDevice_Read;
+    pRegDevice->device.stop = RegDevice_Stop;
+    pRegDevice->pointer = 0;
+    pRegDevice->pointerSet = false;
+    Sim_I2c_AddDevice(&pRegDevice->device);
+}
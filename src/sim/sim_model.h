@@ -0,0 +1,91 @@
+#ifndef __SIM_MODEL_H_
+#define __SIM_MODEL_H_
+
+/**
+ * @defgroup SIM_MODEL sim_model: Interface between the simulator core and the peripheral models
+ * @ingroup SIM
+ *
+ * Each peripheral model exports a reset and a step function. The core calls the step function of all models at each
+ * synchronization point, with the current virtual time. A model then:
+ * - applies the register writes done by the firmware since its previous step,
+ * - completes the operations that are due,
+ * - updates its interrupt line with #Sim_SetIrqLine,
+ * - and returns the virtual time of its next event, or #SIM_NEVER.
+ *
+ * Write-only registers with a side effect (e.g. interrupt clear registers) are reset to 0 by the model after being
+ * applied, so that any non-zero value found at the next step is a new write.
+ *
+ * @{
+ */
+
+#include "chip.h"
+
+/** Returned by a model step function when no event is scheduled. */
+#define SIM_NEVER UINT64_MAX
+
+/** Gives the model write access to a register that is read-only for the firmware. */
+#define SIM_REG(reg) (*(volatile uint32_t *)&(reg))
+
+/** Nanoseconds per microsecond, for readability of the timing calculations. */
+#define SIM_NS_PER_US 1000ULL
+
+/** Nanoseconds per second. */
+#define SIM_NS_PER_S 1000000000ULL
+
+/**
+ * Sets or clears the interrupt request line of a peripheral. The NVIC latches a high level as pending.
+ * @param irq The interrupt.
+ * @param level The level of the line.
+ */
+void Sim_SetIrqLine(IRQn_Type irq, bool level);
+
+/**
+ * Adds one completed operation to the statistics of a peripheral.
+ * @param peripheral The peripheral.
+ * @param latencyNs The time the operation kept the peripheral busy.
+ */
+void Sim_CountOp(SIM_PERIPHERAL_T peripheral, uint64_t latencyNs);
+
+/**
+ * Converts a number of system clock cycles to ns, using the current clock frequency.
+ * @param cycles The number of cycles.
+ * @return The duration in ns.
+ */
+uint64_t Sim_CyclesToNs(uint64_t cycles);
+
+/**
+ * Stops the simulation with a message on stderr.
+ * @param message What went wrong.
+ */
+void Sim_Fatal(const char * message);
+
+void Sim_Eeprom_Reset(void);
+uint64_t Sim_Eeprom_Step(uint64_t now);
+
+void Sim_Flash_Reset(void);
+/**
+ * Flash operations are executed synchronously by the IAP replacement: there is nothing to step.
+ * @param now The virtual time.
+ * @return #SIM_NEVER
+ */
+uint64_t Sim_Flash_Step(uint64_t now);
+
+void Sim_Nfc_Reset(void);
+uint64_t Sim_Nfc_Step(uint64_t now);
+
+void Sim_Rtc_Reset(void);
+uint64_t Sim_Rtc_Step(uint64_t now);
+
+void Sim_Tsen_Reset(void);
+uint64_t Sim_Tsen_Step(uint64_t now);
+
+void Sim_I2c_Reset(void);
+uint64_t Sim_I2c_Step(uint64_t now);
+
+void Sim_Gpio_Reset(void);
+uint64_t Sim_Gpio_Step(uint64_t now);
+
+void Sim_Timer_Reset(void);
+uint64_t Sim_Timer_Step(uint64_t now);
+
+#endif /** @} */
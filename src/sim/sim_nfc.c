@@ -0,0 +1,121 @@
+#include <string.h>
+#include "sim_model.h"
+
+/** Page offset of the shared memory in the tag memory map */
+#define SHARED_MEM_PAGE_OFFSET 4
+
+/** Number of pages of the shared memory */
+#define SHARED_MEM_PAGE_COUNT ((int)(sizeof(Sim_Nfc.BUF) / sizeof(Sim_Nfc.BUF[0])))
+
+/** Direction bit in LAST_ACCESS: set for a write access */
+#define LAST_ACCESS_DIR_WRITE (1 << 16)
+
+/** Capability Container, page 3 of the tag: NDEF 1.0, 512 bytes of data area, read/write access */
+static const uint8_t sCapabilityContainer[4] = {0xE1, 0x10, 0x40, 0x00};
+
+static bool sFieldOn;
+
+/* ------------------------------------------------------------------------- */
+
+static void UpdateIrq(void)
+{
+    SIM_REG(Sim_Nfc.MIS) = Sim_Nfc.RIS & Sim_Nfc.IMSC;
+    Sim_SetIrqLine(NFC_IRQn, Sim_Nfc.MIS != 0);
+}
+
+static void Raise(uint32_t flags)
+{
+    SIM_REG(Sim_Nfc.RIS) |= flags;
+    UpdateIrq();
+}
+
+/** Copies the 4 bytes of an NFC page as seen by a reader. */
+static void ReadPage(int page, uint8_t * pDest)
+{
+    if (page < 2) {
+        memcpy(pDest, NSS_NFC_UID->bytes + 4 * page, 4);
+    }
+    else if (page == 3) {
+        memcpy(pDest, sCapabilityContainer, 4);
+    }
+    else if ((page >= SHARED_MEM_PAGE_OFFSET) && (page < SHARED_MEM_PAGE_OFFSET + SHARED_MEM_PAGE_COUNT)) {
+        memcpy(pDest, (const void *)&Sim_Nfc.BUF[page - SHARED_MEM_PAGE_OFFSET], 4);
+    }
+    else {
+        memset(pDest, 0, 4);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+
+void Sim_Nfc_Reset(void)
+{
+    sFieldOn = false;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+uint64_t Sim_Nfc_Step(uint64_t now)
+{
+    SIM_REG(Sim_Nfc.RIS) &= ~Sim_Nfc.IC;
+    Sim_Nfc.IC = 0;
+    UpdateIrq();
+    return SIM_NEVER;
+}
+#pragma GCC diagnostic pop
+
+void Sim_Nfc_SetField(bool on)
+{
+    sFieldOn = on;
+    if (on) {
+        SIM_REG(Sim_Nfc.SR) = NFC_STATUS_POR | NFC_STATUS_PLL | NFC_STATUS_SEL;
+        Raise(NFC_INT_RFPOWER | NFC_INT_RFSELECT);
+    }
+    else {
+        SIM_REG(Sim_Nfc.SR) = 0;
+        Raise(NFC_INT_NFCOFF);
+    }
+    Sim_Sync();
+}
+
+bool Sim_Nfc_ReaderWrite(int page, const uint8_t * pData)
+{
+    uint64_t latency = SIM_NFC_WRITE_TIME_US * SIM_NS_PER_US;
+
+    if (!sFieldOn || (page < SHARED_MEM_PAGE_OFFSET) || (page >= SHARED_MEM_PAGE_OFFSET + SHARED_MEM_PAGE_COUNT)) {
+        return false;
+    }
+    Sim_Delay(latency);
+    memcpy((void *)&Sim_Nfc.BUF[page - SHARED_MEM_PAGE_OFFSET], pData, 4);
+    SIM_REG(Sim_Nfc.LAST_ACCESS) = ((uint32_t)page << 8) | (uint32_t)page | LAST_ACCESS_DIR_WRITE;
+    Sim_CountOp(SIM_PERIPHERAL_NFC, latency);
+    Raise(NFC_INT_MEMWRITE | (((uint32_t)page == Sim_Nfc.TARGET) ? NFC_INT_TARGETWRITE : 0));
+    Sim_Sync();
+
+    /* The memory write status is not sticky: it is only visible during the access. */
+    SIM_REG(Sim_Nfc.RIS) &= ~(uint32_t)NFC_INT_MEMWRITE;
+    UpdateIrq();
+    return true;
+}
+
+bool Sim_Nfc_ReaderRead(int page, uint8_t * pData)
+{
+    uint64_t latency = SIM_NFC_READ_TIME_US * SIM_NS_PER_US;
+    uint32_t flags = NFC_INT_MEMREAD;
+
+    if (!sFieldOn || (page < 0)) {
+        return false;
+    }
+    Sim_Delay(latency);
+    for (int i = 0; i < 4; i++) {
+        ReadPage(page + i, pData + 4 * i);
+        if ((uint32_t)(page + i) == Sim_Nfc.TARGET) {
+            flags |= NFC_INT_TARGETREAD;
+        }
+    }
+    SIM_REG(Sim_Nfc.LAST_ACCESS) = ((uint32_t)page << 8) | (uint32_t)(page + 3);
+    Sim_CountOp(SIM_PERIPHERAL_NFC, latency);
+    Raise(flags);
+    Sim_Sync();
+    return true;
+}
@@ -0,0 +1,78 @@
+#include "sim_model.h"
+
+/** Status bit in SR: the wake-up down-counter is running */
+#define SR_WAKEUP_RUNNING (1 << 3)
+
+/** Duration of one RTC tick. The calibration value is not taken into account: a tick is always one second. */
+#define TICK_NS SIM_NS_PER_S
+
+static uint64_t sTimeBase; /**< Virtual time at which TIME was 0 */
+static uint32_t sTime; /**< Value of TIME as last written by the model: another value was written by the firmware */
+static uint32_t sCr; /**< Value of CR as last written by the model */
+static uint32_t sSleept; /**< Value of SLEEPT as last written by the model */
+static bool sRunning;
+static uint64_t sWakeup; /**< Virtual time at which the down-counter reaches 0 */
+
+/* ------------------------------------------------------------------------- */
+
+static void StartDownCounter(uint64_t now)
+{
+    sRunning = Sim_Rtc.SLEEPT > 0;
+    sWakeup = now + Sim_Rtc.SLEEPT * TICK_NS;
+}
+
+/* ------------------------------------------------------------------------- */
+
+void Sim_Rtc_Reset(void)
+{
+    sTimeBase = 0;
+    sTime = 0;
+    sCr = 0;
+    sSleept = 0;
+    sRunning = false;
+    SIM_REG(Sim_Rtc.ACCSTAT) = 1;
+}
+
+uint64_t Sim_Rtc_Step(uint64_t now)
+{
+    /* Time counter: detect a write, then count. */
+    if (Sim_Rtc.TIME != sTime) {
+        sTimeBase = now - Sim_Rtc.TIME * TICK_NS;
+    }
+    sTime = (uint32_t)((now - sTimeBase) / TICK_NS);
+    Sim_Rtc.TIME = sTime;
+
+    /* Wake-up down-counter */
+    if (Sim_Rtc.CR != sCr) {
+        if (!(Sim_Rtc.CR & RTC_WAKEUPCTRL_ENABLE)) {
+            sRunning = false;
+        }
+        else if (Sim_Rtc.CR & RTC_WAKEUPCTRL_START) {
+            StartDownCounter(now);
+        }
+        Sim_Rtc.CR &= ~(uint32_t)RTC_WAKEUPCTRL_START;
+        sCr = Sim_Rtc.CR;
+    }
+    if (Sim_Rtc.SLEEPT != sSleept) {
+        sSleept = Sim_Rtc.SLEEPT;
+        if ((Sim_Rtc.CR & RTC_WAKEUPCTRL_ENABLE) && (Sim_Rtc.CR & RTC_WAKEUPCTRL_AUTO)) {
+            StartDownCounter(now);
+        }
+    }
+    if (sRunning && (now >= sWakeup)) {
+        sRunning = false;
+        SIM_REG(Sim_Rtc.RIS) |= RTC_INT_WAKEUP;
+        Sim_CountOp(SIM_PERIPHERAL_RTC, Sim_Rtc.SLEEPT * TICK_NS);
+    }
+    SIM_REG(Sim_Rtc.VAL) = sRunning ? (uint32_t)((sWakeup - now + TICK_NS - 1) / TICK_NS) : 0;
+    SIM_REG(Sim_Rtc.SR) = sRunning ? SR_WAKEUP_RUNNING : 0;
+
+    /* Interrupts */
+    SIM_REG(Sim_Rtc.RIS) &= ~Sim_Rtc.ICR;
+    Sim_Rtc.ICR = 0;
+    SIM_REG(Sim_Rtc.MIS) = Sim_Rtc.RIS & Sim_Rtc.IMSC;
+    Sim_SetIrqLine(RTC_IRQn, Sim_Rtc.MIS != 0);
+
+    /* The time counter is derived from the virtual time at each step: only the down-counter needs an event. */
+    return sRunning ? sWakeup : SIM_NEVER;
+}
@@ -0,0 +1,168 @@
+#include "sim_model.h"
+
+/** Number of match registers per timer */
+#define MATCH_COUNT 4
+
+/**
+ * Marks an IR value written by the model. When absent, the firmware wrote IR since the previous step: the written bits
+ * are cleared. The bit is outside of the match flags: the firmware never looks at it.
+ */
+#define IR_MODEL_MARK (1UL << 31)
+
+/** The state kept by the model for one timer. */
+typedef struct TIMER_STATE_S {
+    NSS_TIMER_T * pTimer;
+    IRQn_Type irq;
+    uint32_t mask; /**< Counter width */
+    uint32_t tc; /**< TC as last written by the model */
+    uint32_t pc; /**< PC as last written by the model */
+    uint32_t ir; /**< Match flags */
+    uint64_t cycles; /**< System clock cycles at the previous step */
+} TIMER_STATE_T;
+
+static TIMER_STATE_T sTimers[2] = {
+    {&Sim_Timer16_0, CT16B0_IRQn, 0xFFFF, 0, 0, 0, 0},
+    {&Sim_Timer32_0, CT32B0_IRQn, 0xFFFFFFFF, 0, 0, 0, 0}
+};
+
+/* ------------------------------------------------------------------------- */
+
+/** @return Whether TC goes to 0 at the next tick, because it equals a match register with reset on match enabled */
+static bool IsResetPending(const TIMER_STATE_T * pState)
+{
+    for (int n = 0; n < MATCH_COUNT; n++) {
+        if ((pState->pTimer->MCR & TIMER_RESET_ON_MATCH(n)) && (pState->tc == pState->pTimer->MR[n])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @return The number of ticks until TC becomes equal to the closest match register with any action enabled */
+static uint64_t TicksToMatch(const TIMER_STATE_T * pState, uint32_t * pHits)
+{
+    uint64_t ticks = UINT64_MAX;
+    uint32_t tc = pState->tc;
+    uint64_t offset = 0;
+
+    if (IsResetPending(pState)) {
+        tc = 0;
+        offset = 1;
+    }
+    *pHits = 0;
+    for (int n = 0; n < MATCH_COUNT; n++) {
+        if (pState->pTimer->MCR & (0x7u << (n * 3))) {
+            uint64_t distance = (pState->pTimer->MR[n] - tc) & pState->mask;
+            if (distance == 0) {
+                distance = (uint64_t)pState->mask + 1;
+            }
+            distance += offset;
+            if (distance < ticks) {
+                ticks = distance;
+                *pHits = 1u << n;
+            }
+            else if (distance == ticks) {
+                *pHits |= 1u << n;
+            }
+        }
+    }
+    return ticks;
+}
+
+/** Counts @c ticks timer ticks, handling the match actions on the way. */
+static void Count(TIMER_STATE_T * pState, uint64_t ticks)
+{
+    NSS_TIMER_T * pTimer = pState->pTimer;
+
+    while (ticks > 0) {
+        uint32_t hits;
+        uint64_t distance = TicksToMatch(pState, &hits);
+        if (distance > ticks) {
+            if (IsResetPending(pState)) {
+                pState->tc = 0;
+                ticks--;
+            }
+            pState->tc = (uint32_t)((pState->tc + ticks) & pState->mask);
+            return;
+        }
+        pState->tc = pTimer->MR[__builtin_ctz(hits)];
+        ticks -= distance;
+        for (int n = 0; n < MATCH_COUNT; n++) {
+            if (hits & (1u << n)) {
+                Sim_CountOp(SIM_PERIPHERAL_TIMER, 0);
+                if (pTimer->MCR & TIMER_INT_ON_MATCH(n)) {
+                    pState->ir |= TIMER_IR_CLR(n);
+                }
+                if (pTimer->MCR & TIMER_STOP_ON_MATCH(n)) {
+                    pTimer->TCR &= ~TIMER_ENABLE;
+                    ticks = 0;
+                }
+            }
+        }
+        if (IsResetPending(pState) && (pState->tc == 0)) {
+            return; /* Match register 0 with reset: TC stays 0 */
+        }
+    }
+}
+
+static uint64_t StepTimer(TIMER_STATE_T * pState, uint64_t now)
+{
+    NSS_TIMER_T * pTimer = pState->pTimer;
+    uint64_t cycles = Sim_GetCycles();
+    uint64_t next = SIM_NEVER;
+
+    /* Firmware writes */
+    if (pTimer->TC != pState->tc) {
+        pState->tc = pTimer->TC & pState->mask;
+    }
+    if (pTimer->PC != pState->pc) {
+        pState->pc = pTimer->PC;
+    }
+    if (!(pTimer->IR & IR_MODEL_MARK)) {
+        pState->ir &= ~pTimer->IR;
+    }
+
+    if (pTimer->TCR & TIMER_RESET) {
+        pState->tc = 0;
+        pState->pc = 0;
+    }
+    else if (pTimer->TCR & TIMER_ENABLE) {
+        uint64_t total = pState->pc + (cycles - pState->cycles);
+        uint64_t prescale = (uint64_t)pTimer->PR + 1;
+        pState->pc = (uint32_t)(total % prescale);
+        Count(pState, total / prescale);
+
+        uint32_t hits;
+        uint64_t ticks = TicksToMatch(pState, &hits);
+        if ((pTimer->TCR & TIMER_ENABLE) && (ticks != UINT64_MAX)) {
+            next = now + Sim_CyclesToNs(ticks * prescale - pState->pc) + 1;
+        }
+    }
+    pState->cycles = cycles;
+
+    pTimer->TC = pState->tc;
+    pTimer->PC = pState->pc;
+    pTimer->IR = pState->ir | IR_MODEL_MARK;
+    Sim_SetIrqLine(pState->irq, pState->ir != 0);
+    return next;
+}
+
+/* ------------------------------------------------------------------------- */
+
+void Sim_Timer_Reset(void)
+{
+    for (int i = 0; i < 2; i++) {
+        sTimers[i].tc = 0;
+        sTimers[i].pc = 0;
+        sTimers[i].ir = 0;
+        sTimers[i].cycles = 0;
+        sTimers[i].pTimer->IR = IR_MODEL_MARK;
+    }
+}
+
+uint64_t Sim_Timer_Step(uint64_t now)
+{
+    uint64_t next16 = StepTimer(&sTimers[0], now);
+    uint64_t next32 = StepTimer(&sTimers[1], now);
+    return (next16 < next32) ? next16 : next32;
+}
@@ -0,0 +1,73 @@
+#include "sim_model.h"
+
+/** Start bit in CR */
+#define CR_START (1 << 0)
+
+/** Measurement ready bit in RIS, MIS and ICR */
+#define INT_RDY (1 << 0)
+
+/** Native value of 25 degrees Celsius */
+#define NATIVE_25C ((27315 + 2500) * 64 / 100)
+
+/** Conversion time in us per resolution, see #TSEN_RESOLUTION_T */
+static const uint32_t sConversionTimeUs[8] = {4000, 4000, 4000, 7000, 14000, 26000, 50000, 100000};
+
+static int sNative;
+static bool sBusy;
+static uint64_t sStart;
+static uint64_t sDone;
+
+/* ------------------------------------------------------------------------- */
+
+void Sim_Tsen_Reset(void)
+{
+    sNative = NATIVE_25C;
+    sBusy = false;
+}
+
+uint64_t Sim_Tsen_Step(uint64_t now)
+{
+    if (!sBusy && (Sim_Tsen.CR & CR_START)) {
+        sBusy = true;
+        sStart = now;
+        sDone = now + sConversionTimeUs[(Sim_Tsen.SP0 >> 1) & 0x7] * SIM_NS_PER_US;
+        SIM_REG(Sim_Tsen.RIS) &= ~(uint32_t)INT_RDY;
+    }
+    if (sBusy && (now >= sDone)) {
+        TSEN_RESOLUTION_T resolution = (TSEN_RESOLUTION_T)((Sim_Tsen.SP0 >> 1) & 0x7);
+        int native = sNative;
+        int16_t dr;
+
+        /* The result is truncated to the resolution: the lower bits of the 1-(9,6) format are 0. */
+        if (resolution > TSEN_7BITS) {
+            native &= ~((1 << (TSEN_12BITS - resolution)) - 1);
+        }
+        else {
+            native &= ~((1 << (TSEN_12BITS - TSEN_7BITS)) - 1);
+        }
+        dr = (int16_t)native;
+        sBusy = false;
+        Sim_Tsen.CR &= ~(uint32_t)CR_START;
+        SIM_REG(Sim_Tsen.DR) = (uint32_t)(uint16_t)dr;
+        SIM_REG(Sim_Tsen.SR) = TSEN_STATUS_MEASUREMENT_SUCCESS | ((uint32_t)resolution << 5);
+        SIM_REG(Sim_Tsen.RIS) |= INT_RDY;
+        if (((int)(int16_t)Sim_Tsen.TLO) > dr) {
+            SIM_REG(Sim_Tsen.RIS) |= TSEN_INT_THRESHOLD_LOW;
+        }
+        if (((int)(int16_t)Sim_Tsen.THI) < dr) {
+            SIM_REG(Sim_Tsen.RIS) |= TSEN_INT_THRESHOLD_HIGH;
+        }
+        Sim_CountOp(SIM_PERIPHERAL_TSEN, now - sStart);
+    }
+
+    SIM_REG(Sim_Tsen.RIS) &= ~Sim_Tsen.ICR;
+    Sim_Tsen.ICR = 0;
+    SIM_REG(Sim_Tsen.MIS) = Sim_Tsen.RIS & Sim_Tsen.IMSC;
+    Sim_SetIrqLine(TSEN_IRQn, Sim_Tsen.MIS != 0);
+    return sBusy ? sDone : SIM_NEVER;
+}
+
+void Sim_Tsen_SetNative(int native)
+{
+    sNative = native;
+}
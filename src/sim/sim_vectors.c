@@ -0,0 +1,47 @@
+#include "sim_model.h"
+
+/* startup.c is not part of the simulation build: it provides the same weak handlers here. */
+
+#define ALIAS(f) __attribute__ ((weak, alias (#f)))
+
+/** Default interrupt handler. Should never be entered. */
+static void defaultIntHandler(void)
+{
+    Sim_Fatal("unhandled interrupt");
+}
+
+void NMI_Handler(void)       ALIAS(defaultIntHandler);
+void HardFault_Handler(void) ALIAS(defaultIntHandler);
+void SVC_Handler(void)       ALIAS(defaultIntHandler);
+void PendSV_Handler(void)    ALIAS(defaultIntHandler);
+void SysTick_Handler(void)   ALIAS(defaultIntHandler);
+
+void PIO0_0_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PIO0_1_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PIO0_2_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PIO0_3_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PIO0_4_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PIO0_5_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PIO0_6_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PIO0_7_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PIO0_8_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PIO0_9_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PIO0_10_IRQHandler(void)  ALIAS(defaultIntHandler);
+void RFFIELD_IRQHandler(void)  ALIAS(defaultIntHandler);
+void RTCPWREQ_IRQHandler(void) ALIAS(defaultIntHandler);
+void NFC_IRQHandler(void)      ALIAS(defaultIntHandler);
+void RTC_IRQHandler(void)      ALIAS(defaultIntHandler);
+void I2C0_IRQHandler(void)     ALIAS(defaultIntHandler);
+void CT16B0_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PMUFLD_IRQHandler(void)   ALIAS(defaultIntHandler);
+void CT32B0_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PMUBOD_IRQHandler(void)   ALIAS(defaultIntHandler);
+void SSP0_IRQHandler(void)     ALIAS(defaultIntHandler);
+void TSEN_IRQHandler(void)     ALIAS(defaultIntHandler);
+void C2D_IRQHandler(void)      ALIAS(defaultIntHandler);
+void I2D_IRQHandler(void)      ALIAS(defaultIntHandler);
+void ADC_IRQHandler(void)      ALIAS(defaultIntHandler);
+void WDT_IRQHandler(void)      ALIAS(defaultIntHandler);
+void FLASH_IRQHandler(void)    ALIAS(defaultIntHandler);
+void EEPROM_IRQHandler(void)   ALIAS(defaultIntHandler);
+void PIO0_IRQHandler(void)     ALIAS(defaultIntHandler);
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""Decodes the binary trace records of src/application/trace.c back to text or CSV.
+
+The input is a raw capture of the trace RTT channel, e.g. made with
+    JLinkRTTLogger -Device NHS3152 -If SWD -Speed 4000 -RTTChannel 1 trace.bin
+or a dump of the channel buffer. Each record is
+    [uint8 id][uint32 timestamp in system clock cycles][arguments]
+all little endian, with the arguments of each id listed in trace_events.h.
+The timestamps are converted to time on the host: pass the system clock of
+the firmware with --clock when it differs from SYSTEMCLOCK in board.h.
+
+LOG records only carry the offset of their format string in the logstr
+section of the firmware: pass the matching main.elf with --elf.
+"""
+
+import argparse
+import csv
+import os
+import re
+import struct
+import sys
+
+HEADER = struct.Struct('<BI')
+CLOCK = 1000000
+EVENTS_H = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'src', 'application', 'trace_events.h')
+EVENT_RE = re.compile(r'X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*,\s*"([bBhHiIqQ]*|\*)"\s*\)')
+LOG_ARGS = '*'
+LOG_HEADER = struct.Struct('<H')
+LOG_ARG = struct.Struct('<I')
+CONVERSION_RE = re.compile(r'%[-+ #0]*\d*(?:\.\d+)?(?:hh|h|l|z|t)?([diuxXoc%])|%')
+LOG_SECTION = 'logstr'
+
+
+def load_events(path):
+    """Returns (name, format, struct) per event id, in the order of TRACE_EVENTS. LOG events have no struct."""
+    with open(path) as f:
+        text = f.read()
+    return [(name, fmt, None if args == LOG_ARGS else struct.Struct('<' + args))
+            for name, fmt, args in EVENT_RE.findall(text)]
+
+
+def load_strings(path):
+    """Returns the contents of the logstr section of an ELF file, 32 or 64 bit, little endian."""
+    with open(path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF' or elf[5] != 1:
+        raise ValueError('%s: not a little endian ELF file' % path)
+    if elf[4] == 1:
+        shoff, = struct.unpack_from('<I', elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', elf, 0x2e)
+        header = struct.Struct('<IIIIII')
+    else:
+        shoff, = struct.unpack_from('<Q', elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', elf, 0x3a)
+        header = struct.Struct('<IIQQQQ')
+    sections = [header.unpack_from(elf, shoff + i * shentsize) for i in range(shnum)]
+    names = sections[shstrndx]
+    for name, _, _, _, offset, size in sections:
+        end = elf.index(b'\0', names[4] + name)
+        if elf[names[4] + name:end].decode() == LOG_SECTION:
+            return elf[offset:offset + size]
+    raise ValueError('%s: no %s section' % (path, LOG_SECTION))
+
+
+def format_log(strings, data, offset):
+    """Formats the LOG record at offset. Returns the text and the offset behind the record."""
+    string, = LOG_HEADER.unpack_from(data, offset)
+    offset += LOG_HEADER.size
+    if strings is None:
+        raise ValueError('LOG record found: pass the firmware with --elf')
+    fmt = strings[string:strings.index(b'\0', string)].decode()
+    text = ''
+    start = 0
+    for conversion in CONVERSION_RE.finditer(fmt):
+        text += fmt[start:conversion.start()]
+        start = conversion.end()
+        kind = conversion.group(1)
+        if kind is None:
+            raise ValueError('unsupported conversion in LOG format "%s"' % fmt)
+        if kind == '%':
+            text += '%'
+            continue
+        if offset + LOG_ARG.size > len(data):
+            raise IndexError('truncated LOG record')
+        value, = LOG_ARG.unpack_from(data, offset)
+        offset += LOG_ARG.size
+        spec = re.sub(r'(hh|h|l|z|t)', '', conversion.group(0)[:-1])
+        if kind in 'di':
+            text += (spec + 'd') % (value - (1 << 32) if value & 0x80000000 else value)
+        elif kind == 'c':
+            text += (spec + 'c') % chr(value & 0xFF)
+        else:
+            text += (spec + kind.replace('u', 'd')) % value
+    return text + fmt[start:], offset
+
+
+def decode(data, events, strings=None):
+    """Yields (timestamp in cycles, event, arguments); the 32-bit timestamps are unwrapped.
+    The argument of a LOG record is its formatted text."""
+    offset = 0
+    last = None
+    high = 0
+    while offset + HEADER.size <= len(data):
+        event_id, timestamp = HEADER.unpack_from(data, offset)
+        if event_id >= len(events):
+            raise ValueError('unknown event id %d at offset %d' % (event_id, offset))
+        event = events[event_id]
+        start = offset
+        offset += HEADER.size
+        try:
+            if event[2] is None:
+                text, offset = format_log(strings, data, offset)
+                args = (text,)
+            else:
+                args = event[2].unpack_from(data, offset)
+                offset += event[2].size
+        except (IndexError, struct.error):
+            offset = start
+            break
+        if last is not None and timestamp < last:
+            high += 1 << 32
+        last = timestamp
+        yield high + timestamp, event, args
+    if offset != len(data):
+        sys.stderr.write('%d trailing bytes ignored\n' % (len(data) - offset))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('capture', help='binary capture of the trace channel, - for stdin')
+    parser.add_argument('--csv', action='store_true', help='write CSV: timestamp_us,event,arguments...')
+    parser.add_argument('--events', default=EVENTS_H, help='trace_events.h to take the event list from')
+    parser.add_argument('--elf', help='the firmware that made the capture, to take the LOG format strings from')
+    parser.add_argument('--clock', type=int, default=CLOCK,
+                        help='system clock of the firmware in Hz, to convert the timestamps (default: %(default)s)')
+    options = parser.parse_args()
+    if options.clock <= 0:
+        parser.error('--clock must be positive')
+
+    events = load_events(options.events)
+    strings = load_strings(options.elf) if options.elf else None
+    if options.capture == '-':
+        data = sys.stdin.buffer.read()
+    else:
+        with open(options.capture, 'rb') as f:
+            data = f.read()
+
+    if options.csv:
+        writer = csv.writer(sys.stdout)
+        writer.writerow(['timestamp_us', 'event', 'args'])
+        for timestamp, event, args in decode(data, events, strings):
+            writer.writerow(['%.3f' % (timestamp * 1e6 / options.clock), event[0]] + list(args))
+    else:
+        for timestamp, event, args in decode(data, events, strings):
+            sys.stdout.write('[%12.6f] %s\n' % (timestamp / options.clock, event[1] % args))
+
+
+if __name__ == '__main__':
+    main()